@@ -20,6 +20,7 @@
 #ifndef TILEDARRAY_ARRAY_H__INCLUDED
 #define TILEDARRAY_ARRAY_H__INCLUDED
 
+#include <tiledarray_fwd.h>
 #include <TiledArray/replicator.h>
 #include <TiledArray/pmap/replicated_pmap.h>
 //#include <TiledArray/tensor.h>
@@ -45,7 +46,7 @@ namespace TiledArray {
   /// \tparam DIM The number of dimensions for this array object
   /// \tparam Tile The tile type [ Default = \c Tensor<T> ]
   template <typename T, unsigned int DIM,
-      typename Tile = Tensor<T, Eigen::aligned_allocator<T> >,
+      typename Tile = Tensor<T, typename detail::default_allocator<T>::type>,
       typename Policy = DensePolicy >
   class Array {
   public:
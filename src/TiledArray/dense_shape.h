@@ -110,6 +110,9 @@ namespace TiledArray {
 
     static DenseShape perm(const Permutation&) { return DenseShape(); }
 
+    template <typename TR>
+    static DenseShape fuse(const TR&, const TR&) { return DenseShape(); }
+
     template <typename Scalar>
     static DenseShape scale(const Scalar) { return DenseShape(); }
 
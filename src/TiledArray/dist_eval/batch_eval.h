@@ -0,0 +1,240 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_BATCH_EVAL_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_BATCH_EVAL_H__INCLUDED
+
+#include <TiledArray/dist_eval/dist_eval.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Distributed evaluator of a batch slice
+
+    /// This object gives access to the tiles of one slice of a distributed
+    /// evaluator, where the batch dimensions lead. The tiles of the slice
+    /// are the contiguous block of tiles of the argument that starts at
+    /// \c offset. The argument is not evaluated by this object; it must be
+    /// evaluated by the owner of the slices, and the process map of the
+    /// slice must be consistent with the process map of the argument.
+    /// \tparam Arg The argument distributed evaluator type
+    template <typename Arg>
+    class BatchSliceEvalImpl : public Arg::impl_type {
+    public:
+      typedef BatchSliceEvalImpl<Arg> BatchSliceEvalImpl_; ///< This object type
+      typedef typename Arg::impl_type DistEvalImpl_; ///< The base class type
+      typedef typename DistEvalImpl_::TensorImpl_ TensorImpl_; ///< The base, base class type
+      typedef Arg arg_type; ///< The argument type
+      typedef typename DistEvalImpl_::size_type size_type; ///< Size type
+      typedef typename DistEvalImpl_::shape_type shape_type; ///< Shape type
+      typedef typename DistEvalImpl_::pmap_interface pmap_interface; ///< Process map interface type
+      typedef typename DistEvalImpl_::trange_type trange_type; ///< Tiled range type
+      typedef typename DistEvalImpl_::value_type value_type; ///< Tile type
+
+    private:
+
+      arg_type arg_; ///< The argument
+      size_type offset_; ///< The argument index of the first tile of the slice
+
+    public:
+
+      /// Construct a batch slice evaluator
+
+      /// \param arg The argument
+      /// \param world The world where the tensor lives
+      /// \param trange The tiled range of the slice
+      /// \param shape The shape of the slice
+      /// \param pmap The tile-process map of the slice
+      /// \param offset The argument index of the first tile of the slice
+      BatchSliceEvalImpl(const arg_type& arg, World& world,
+          const trange_type& trange, const shape_type& shape,
+          const std::shared_ptr<pmap_interface>& pmap, const size_type offset) :
+        DistEvalImpl_(world, trange, shape, pmap, Permutation()),
+        arg_(arg), offset_(offset)
+      {
+        TA_ASSERT((offset_ + TensorImpl_::size()) <= arg_.size());
+      }
+
+      virtual ~BatchSliceEvalImpl() { }
+
+      /// Get tile at index \c i
+
+      /// \param i The index of the tile
+      /// \return A \c Future to the tile at index i
+      virtual Future<value_type> get_tile(size_type i) const {
+        TA_ASSERT(TensorImpl_::is_local(i));
+        return arg_.get(offset_ + i);
+      }
+
+      /// Discard a tile that is not needed
+
+      /// This function handles the cleanup for tiles that are not needed in
+      /// subsequent computation.
+      /// \param i The index of the tile
+      virtual void discard_tile(size_type i) const { arg_.discard(offset_ + i); }
+
+    private:
+
+      /// Evaluate the tiles of this tensor
+
+      /// The argument is evaluated by the owner of the slices, so there is
+      /// nothing to do.
+      /// \return Zero
+      virtual int internal_eval() { return 0; }
+
+    }; // class BatchSliceEvalImpl
+
+
+    /// Batch, distributed tensor evaluator
+
+    /// This object assembles the tiles of a tensor where the batch dimensions
+    /// lead, and the tiles of each batch slice are evaluated by a separate
+    /// distributed evaluator (e.g. a SUMMA evaluator of batch slices of
+    /// \c left and \c right ). The slices are evaluated concurrently.
+    /// \tparam Left The left argument type
+    /// \tparam Right The right argument type
+    /// \tparam Batch The batch slice evaluator type
+    /// \tparam Policy The tensor policy class
+    template <typename Left, typename Right, typename Batch, typename Policy>
+    class BatchEvalImpl : public DistEvalImpl<typename Batch::value_type, Policy> {
+    public:
+      typedef BatchEvalImpl<Left, Right, Batch, Policy> BatchEvalImpl_; ///< This object type
+      typedef DistEvalImpl<typename Batch::value_type, Policy> DistEvalImpl_; ///< The base class type
+      typedef typename DistEvalImpl_::TensorImpl_ TensorImpl_; ///< The base, base class type
+      typedef Left left_type; ///< The left-hand argument type
+      typedef Right right_type; ///< The right-hand argument type
+      typedef Batch batch_type; ///< The batch slice evaluator type
+      typedef typename DistEvalImpl_::size_type size_type; ///< Size type
+      typedef typename DistEvalImpl_::shape_type shape_type; ///< Shape type
+      typedef typename DistEvalImpl_::pmap_interface pmap_interface; ///< Process map interface type
+      typedef typename DistEvalImpl_::trange_type trange_type; ///< Tiled range type
+      typedef typename DistEvalImpl_::value_type value_type; ///< Tile type
+
+    private:
+
+      left_type left_; ///< Left argument
+      right_type right_; ///< Right argument
+      std::vector<batch_type> batches_; ///< The batch slice evaluators
+
+    public:
+
+      /// Construct a batch evaluator
+
+      /// \param left The left-hand argument
+      /// \param right The right-hand argument
+      /// \param batches The evaluators of the batch slices of the result, which
+      /// use the slices of \c left and \c right
+      /// \param world The world where the tensor lives
+      /// \param trange The tiled range object
+      /// \param shape The tensor shape object
+      /// \param pmap The tile-process map
+      /// \param perm The permutation that is applied to tile indices
+      /// \note The trange, shape, and pmap are assumed to be in the final,
+      /// permuted, state for the result.
+      BatchEvalImpl(const left_type& left, const right_type& right,
+          const std::vector<batch_type>& batches, World& world,
+          const trange_type& trange, const shape_type& shape,
+          const std::shared_ptr<pmap_interface>& pmap, const Permutation& perm) :
+        DistEvalImpl_(world, trange, shape, pmap, perm),
+        left_(left), right_(right), batches_(batches)
+      {
+        TA_ASSERT(! batches_.empty());
+        TA_ASSERT((batches_.size() * batches_.front().size()) == TensorImpl_::size());
+      }
+
+      virtual ~BatchEvalImpl() { }
+
+      /// Get tile at index \c i
+
+      /// \param i The index of the tile
+      /// \return A \c Future to the tile at index i
+      /// \throw TiledArray::Exception When tile \c i is owned by a remote node.
+      /// \throw TiledArray::Exception When tile \c i a zero tile.
+      virtual Future<value_type> get_tile(size_type i) const {
+        TA_ASSERT(TensorImpl_::is_local(i));
+        TA_ASSERT(! TensorImpl_::is_zero(i));
+
+        // The tile is sent by the process that evaluates it in its slice
+        const size_type source_index = DistEvalImpl_::perm_index_to_source(i);
+        const size_type slice_size = batches_.front().size();
+        const ProcessID source =
+            batches_[source_index / slice_size].owner(source_index % slice_size);
+
+        const madness::DistributedID key(DistEvalImpl_::id(), i);
+        return TensorImpl_::get_world().gop.template recv<value_type>(source, key);
+      }
+
+      /// Discard a tile that is not needed
+
+      /// This function handles the cleanup for tiles that are not needed in
+      /// subsequent computation.
+      /// \param i The index of the tile
+      virtual void discard_tile(size_type i) const { get_tile(i); }
+
+    private:
+
+      /// Evaluate the tiles of this tensor
+
+      /// This function will evaluate the children of this distributed evaluator
+      /// and evaluate the tiles for this distributed evaluator. It will block
+      /// until the tasks for the children and the batch slices are evaluated
+      /// (not for the tasks of this object).
+      /// \return The number of tiles that will be set by this process
+      virtual int internal_eval() {
+        // Evaluate child tensors, which are shared by the batch slices
+        left_.eval();
+        right_.eval();
+
+        // Start the evaluation of all batch slices
+        for(batch_type& batch : batches_)
+          batch.eval();
+
+        // Forward the local, non-zero tiles of each slice to the result
+        size_type task_count = 0ul;
+        const size_type slice_size = batches_.front().size();
+        for(size_type b = 0ul, offset = 0ul; b < batches_.size(); ++b, offset += slice_size) {
+          const batch_type& batch = batches_[b];
+          typename pmap_interface::const_iterator it = batch.pmap()->begin();
+          const typename pmap_interface::const_iterator end = batch.pmap()->end();
+          for(; it != end; ++it) {
+            const size_type index = *it;
+            if(batch.is_zero(index)) continue;
+
+            DistEvalImpl_::set_tile(DistEvalImpl_::perm_index_to_target(offset + index),
+                batch.get(index));
+            ++task_count;
+          }
+        }
+
+        // Wait for child tensors and the batch slices to be evaluated, and
+        // process tasks while waiting.
+        left_.wait();
+        right_.wait();
+        for(batch_type& batch : batches_)
+          batch.wait();
+
+        return task_count;
+      }
+
+    }; // class BatchEvalImpl
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_BATCH_EVAL_H__INCLUDED
@@ -0,0 +1,293 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_COMPRESSED_TILE_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_COMPRESSED_TILE_H__INCLUDED
+
+#include <TiledArray/tensor.h>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Check that a tile type can be compressed by \c CompressedTile
+
+    /// \tparam Tile The tile type
+    template <typename Tile>
+    struct is_compressible_tile : public std::false_type { };
+
+    template <typename T, typename A>
+    struct is_compressible_tile<Tensor<T, A> > : public std::is_arithmetic<T> { };
+
+    /// Compressed tile
+
+    /// The elements of the tile are stored with a reduced width, where
+    /// floating point elements may be truncated to single or bfloat16
+    /// precision when the truncation error is below a tolerance. The bytes
+    /// of the elements are shuffled (i.e. the first byte of all elements
+    /// is followed by the second byte of all elements, etc.), and the runs
+    /// of zero bytes are encoded by their length. Shuffled bytes of elements
+    /// with a small magnitude or a common exponent have long zero runs. The
+    /// encoded bytes are used when they are smaller than the element bytes.
+    /// \tparam Tile The tile type
+    template <typename Tile>
+    class CompressedTile {
+    public:
+      typedef CompressedTile<Tile> CompressedTile_; ///< This object type
+      typedef Tile tile_type; ///< The tile type
+      typedef typename Tile::value_type numeric_type; ///< The tile element type
+
+      static_assert(is_compressible_tile<Tile>::value,
+          "CompressedTile requires a tensor of arithmetic elements.");
+
+    private:
+
+      Range range_; ///< The tile range
+      unsigned int width_; ///< The number of bytes of each stored element
+      bool encoded_; ///< Flag for shuffled and zero run-length encoded data
+      std::vector<unsigned char> data_; ///< The stored bytes
+
+      /// Select the width of the stored elements
+
+      /// \param tile The tile
+      /// \param tolerance The maximum absolute error of the stored elements
+      /// \return 2 for bfloat16 or 4 for single precision elements if the
+      /// truncation error is below \c tolerance , otherwise the size of the
+      /// tile elements
+      static unsigned int select_width(const Tile& tile, const double tolerance) {
+        if(! std::is_floating_point<numeric_type>::value || (tolerance <= 0.0))
+          return sizeof(numeric_type);
+
+        double max = 0.0;
+        const numeric_type* restrict const data = tile.data();
+        for(std::size_t i = 0ul; i < tile.size(); ++i)
+          max = std::max(max, std::abs(double(data[i])));
+
+        // The relative rounding errors are 2^-8 for bfloat16 and 2^-24 for
+        // single precision, which are doubled to cover the double rounding
+        // of double precision elements.
+        if((sizeof(numeric_type) > 2ul) && ((max * std::ldexp(1.0, -7)) <= tolerance))
+          return 2u;
+        if((sizeof(numeric_type) > 4ul) && ((max * std::ldexp(1.0, -23)) <= tolerance))
+          return 4u;
+        return sizeof(numeric_type);
+      }
+
+      /// Round a single precision value to bfloat16
+
+      /// \param value The value to be rounded
+      /// \return The bits of the nearest bfloat16 value
+      static std::uint16_t to_bfloat16(const float value) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        if(std::isnan(value))
+          return std::uint16_t((bits >> 16) | 0x0040u);
+        bits += 0x7fffu + ((bits >> 16) & 1u);
+        return std::uint16_t(bits >> 16);
+      }
+
+      /// Convert bfloat16 to single precision
+
+      /// \param bits The bits of the bfloat16 value
+      /// \return The single precision value
+      static float from_bfloat16(const std::uint16_t bits) {
+        const std::uint32_t value_bits = std::uint32_t(bits) << 16;
+        float value;
+        std::memcpy(&value, &value_bits, sizeof(value));
+        return value;
+      }
+
+      /// Zero run-length encoding of shuffled bytes
+
+      /// Each control byte \c c is followed by <tt>c + 1</tt> literal bytes
+      /// when <tt>c < 128</tt>, or encodes a run of <tt>c - 127</tt> zero
+      /// bytes.
+      /// \param bytes The bytes to be encoded
+      /// \param n The number of bytes
+      /// \return The encoded bytes
+      static std::vector<unsigned char> encode(const unsigned char* const bytes,
+          const std::size_t n)
+      {
+        std::vector<unsigned char> result;
+        result.reserve(n);
+        std::size_t i = 0ul;
+        while(i < n) {
+          if(bytes[i] == 0u) {
+            std::size_t run = 1ul;
+            while((i + run < n) && (run < 128ul) && (bytes[i + run] == 0u))
+              ++run;
+            result.push_back(static_cast<unsigned char>(127ul + run));
+            i += run;
+          } else {
+            std::size_t run = 1ul;
+            while((i + run < n) && (run < 128ul) && (bytes[i + run] != 0u))
+              ++run;
+            result.push_back(static_cast<unsigned char>(run - 1ul));
+            result.insert(result.end(), bytes + i, bytes + i + run);
+            i += run;
+          }
+
+          // Stop when the encoding is not smaller
+          if(result.size() >= n)
+            break;
+        }
+
+        return result;
+      }
+
+      /// Decode zero run-length encoded bytes
+
+      /// \param[out] bytes The decoded bytes
+      /// \param n The number of decoded bytes
+      void decode(unsigned char* const bytes, const std::size_t n) const {
+        std::size_t i = 0ul;
+        std::vector<unsigned char>::const_iterator it = data_.begin();
+        while(i < n) {
+          TA_ASSERT(it != data_.end());
+          const std::size_t c = *it++;
+          if(c < 128ul) {
+            TA_ASSERT((i + c + 1ul) <= n);
+            std::copy(it, it + (c + 1ul), bytes + i);
+            it += c + 1ul;
+            i += c + 1ul;
+          } else {
+            TA_ASSERT((i + c - 127ul) <= n);
+            std::fill_n(bytes + i, c - 127ul, 0u);
+            i += c - 127ul;
+          }
+        }
+      }
+
+    public:
+
+      /// Default constructor
+
+      /// Constructs a compressed empty tile.
+      CompressedTile() : range_(), width_(0u), encoded_(false), data_() { }
+
+      /// Compress a tile
+
+      /// \param tile The tile to be compressed
+      /// \param tolerance The maximum absolute error of the elements of
+      /// floating point tiles; zero for lossless compression
+      CompressedTile(const Tile& tile, const double tolerance) :
+        range_(), width_(0u), encoded_(false), data_()
+      {
+        if(tile.empty())
+          return;
+
+        range_ = tile.range();
+        width_ = select_width(tile, tolerance);
+
+        // Store the elements with the selected width
+        const std::size_t n = tile.size();
+        const numeric_type* restrict const data = tile.data();
+        std::vector<unsigned char> bytes(n * width_);
+        if(width_ == sizeof(numeric_type)) {
+          std::memcpy(bytes.data(), data, bytes.size());
+        } else if(width_ == 4u) {
+          for(std::size_t i = 0ul; i < n; ++i) {
+            const float value = data[i];
+            std::memcpy(bytes.data() + i * 4ul, &value, 4ul);
+          }
+        } else {
+          for(std::size_t i = 0ul; i < n; ++i) {
+            const std::uint16_t value = to_bfloat16(float(data[i]));
+            std::memcpy(bytes.data() + i * 2ul, &value, 2ul);
+          }
+        }
+
+        // Shuffle and encode the element bytes
+        std::vector<unsigned char> shuffled(bytes.size());
+        for(std::size_t i = 0ul; i < n; ++i)
+          for(unsigned int b = 0u; b < width_; ++b)
+            shuffled[b * n + i] = bytes[i * width_ + b];
+        data_ = encode(shuffled.data(), shuffled.size());
+        encoded_ = (data_.size() < bytes.size());
+        if(! encoded_)
+          data_.swap(bytes);
+      }
+
+      /// Decompress the tile
+
+      /// \return The decompressed tile
+      Tile decompress() const {
+        if(! width_)
+          return Tile();
+
+        const std::size_t n = range_.volume();
+        std::vector<unsigned char> bytes;
+        if(encoded_) {
+          std::vector<unsigned char> shuffled(n * width_);
+          decode(shuffled.data(), shuffled.size());
+          bytes.resize(shuffled.size());
+          for(std::size_t i = 0ul; i < n; ++i)
+            for(unsigned int b = 0u; b < width_; ++b)
+              bytes[i * width_ + b] = shuffled[b * n + i];
+        } else {
+          bytes = data_;
+        }
+
+        Tile result(range_);
+        numeric_type* restrict const data = result.data();
+        if(width_ == sizeof(numeric_type)) {
+          std::memcpy(data, bytes.data(), bytes.size());
+        } else if(width_ == 4u) {
+          for(std::size_t i = 0ul; i < n; ++i) {
+            float value;
+            std::memcpy(&value, bytes.data() + i * 4ul, 4ul);
+            data[i] = value;
+          }
+        } else {
+          for(std::size_t i = 0ul; i < n; ++i) {
+            std::uint16_t value;
+            std::memcpy(&value, bytes.data() + i * 2ul, 2ul);
+            data[i] = from_bfloat16(value);
+          }
+        }
+
+        return result;
+      }
+
+      /// Stored element width accessor
+
+      /// \return The number of bytes of each stored element
+      unsigned int width() const { return width_; }
+
+      /// Compressed size accessor
+
+      /// \return The number of bytes of compressed data
+      std::size_t size() const { return data_.size(); }
+
+      /// Serialize the compressed tile
+
+      /// \tparam Archive The archive type
+      /// \param ar The archive
+      template <typename Archive>
+      void serialize(Archive& ar) { ar & range_ & width_ & encoded_ & data_; }
+
+    }; // class CompressedTile
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_COMPRESSED_TILE_H__INCLUDED
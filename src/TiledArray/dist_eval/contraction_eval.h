@@ -21,16 +21,17 @@
 #define TILEDARRAY_DIST_EVAL_CONTRACTION_EVAL_H__INCLUDED
 
 #include <TiledArray/dist_eval/dist_eval.h>
+#include <TiledArray/dist_eval/compressed_tile.h>
+#include <TiledArray/dist_eval/summa_config.h>
+#include <TiledArray/dist_eval/summa_group_cache.h>
+#include <TiledArray/dist_eval/summa_trace.h>
 #include <TiledArray/proc_grid.h>
 #include <TiledArray/reduce_task.h>
+#include <TiledArray/tile_op/tile_interface.h>
 #include <TiledArray/tile_op/type_traits.h>
 #include <TiledArray/shape.h>
-
-//#define TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL 1
-//#define TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE 1
-//#define TILEDARRAY_ENABLE_SUMMA_TRACE_STEP 1
-//#define TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST 1
-//#define TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE 1
+#include <deque>
+#include <functional>
 
 namespace TiledArray {
   namespace detail {
@@ -45,7 +46,10 @@ namespace TiledArray {
     /// dimensional cyclic distribution, and that the row phase of the left-hand
     /// argument and the column phase of the right-hand argument are equal to
     /// the number of rows and columns, respectively, in the \c ProcGrid object
-    /// passed to the constructor.
+    /// passed to the constructor. When the process grid has more than one
+    /// layer, each layer evaluates a contiguous slice of the inner dimension
+    /// (2.5D SUMMA), and the partial result tiles are reduced on the first
+    /// layer.
     template <typename Left, typename Right, typename Op, typename Policy>
     class Summa :
         public DistEvalImpl<typename Op::result_type, Policy>,
@@ -79,10 +83,20 @@ namespace TiledArray {
       // Dimension information
       const size_type k_; ///< Number of tiles in the inner dimension
       const ProcGrid proc_grid_; ///< Process grid for this contraction
+      const size_type k_begin_; ///< First inner dimension tile of this process's layer
+      const size_type k_end_; ///< End of the inner dimension tiles of this process's layer
 
       // Contraction results
       ReducePairTask<op_type>* reduce_tasks_; ///< A pointer to the reduction tasks
 
+      class MemoryGate;
+      std::shared_ptr<MemoryGate> memory_gate_; ///< Memory bound for SUMMA steps (null when unbounded)
+      bool screen_; ///< Screen tile pairs with tile norms
+      SummaConfig::BcastCompression compression_; ///< Compression of broadcast tiles
+      double compression_tolerance_; ///< Maximum absolute error of broadcast tile elements
+      std::shared_ptr<const SummaGroupCache::Schedule> schedule_; ///< Cached broadcast schedule (null when not cached)
+      std::function<Future<value_type>(size_type)> target_; ///< Tiles that the result is added to (empty when not accumulating)
+
       // Constant used to iterate over columns and rows of left_ and right_, respectively.
       const size_type left_start_local_; ///< The starting point of left column iterator ranges (just add k for specific columns)
       const size_type left_end_; ///< The end of the left column iterator ranges
@@ -107,9 +121,9 @@ namespace TiledArray {
 
       // Process groups --------------------------------------------------------
 
-      /// Process group factory function
+      /// Process list factory function
 
-      /// This function generates a sparse process group.
+      /// This function generates the process list of a sparse process group.
       /// \tparam Shape The shape type
       /// \tparam ProcMap The process map operation type
       /// \param shape The shape that will be used to select processes that are
@@ -117,19 +131,18 @@ namespace TiledArray {
       /// \param index The first index of the row or column range
       /// \param end The end of the row or column range
       /// \param stride The row or column index stride
-      /// \param k The broadcast group index
       /// \param max_group_size The maximum number of processes in the result
       /// group, which is equal to the number of process in this process row or
       /// column as defined by \c proc_grid_.
-      /// \param key_offset The key that will be used to identify the process group
+      /// \param k The broadcast group index
       /// \param proc_map The operator that will convert a process row/column
       /// into a process
-      /// \return A sparse process group that includes process in the row or
-      /// column of this process as defined by \c proc_grid_.
+      /// \return The list of processes, in the row or column of this process
+      /// as defined by \c proc_grid_, that are included in the process group
       template <typename Shape, typename ProcMap>
-      madness::Group make_group(const Shape& shape, size_type index,
+      std::vector<ProcessID> make_proc_list(const Shape& shape, size_type index,
           const size_type end, const size_type stride, const size_type max_group_size,
-          const size_type k, const size_type key_offset, const ProcMap& proc_map) const
+          const size_type k, const ProcMap& proc_map) const
       {
         // Generate the list of processes in rank_row
         std::vector<ProcessID> proc_list(max_group_size, -1);
@@ -159,21 +172,56 @@ namespace TiledArray {
         // Truncate invalid process id's
         proc_list.resize(count);
 
+        return proc_list;
+      }
+
+      /// Process group factory function
+
+      /// \param proc_list The list of processes included in the group
+      /// \param k The broadcast group index
+      /// \param key_offset The key that will be used to identify the process group
+      /// \return A sparse process group that includes the processes in
+      /// \c proc_list
+      madness::Group make_group(const std::vector<ProcessID>& proc_list,
+          const size_type k, const size_type key_offset) const
+      {
         return madness::Group(TensorImpl_::get_world(), proc_list,
             madness::DistributedID(DistEvalImpl_::id(), k + key_offset));
       }
 
+      /// Row process list factory function
+
+      /// \param k The broadcast group index
+      /// \return The process list of the row process group
+      std::vector<ProcessID> make_row_proc_list(const size_type k) const {
+        const size_type right_begin_k = k * proc_grid_.cols();
+        const size_type right_end_k = right_begin_k + proc_grid_.cols();
+        return make_proc_list(right_.shape(), right_begin_k, right_end_k,
+            right_stride_, proc_grid_.proc_cols(), k,
+            [&](const ProcGrid::size_type col) { return proc_grid_.map_col(col); });
+      }
+
+      /// Column process list factory function
+
+      /// \param k The broadcast group index
+      /// \return The process list of the column process group
+      std::vector<ProcessID> make_col_proc_list(const size_type k) const {
+        return make_proc_list(left_.shape(), k, left_end_, left_stride_,
+            proc_grid_.proc_rows(), k,
+            [&](const ProcGrid::size_type row) { return proc_grid_.map_row(row); });
+      }
+
       /// Row process group factory function
 
       /// \param k The broadcast group index
       /// \return A row process group
       madness::Group make_row_group(const size_type k) const {
+        SummaTraceScope trace("row_group", "k", k);
+
         // Construct the sparse broadcast group
-        const size_type right_begin_k = k * proc_grid_.cols();
-        const size_type right_end_k = right_begin_k + proc_grid_.cols();
-        return make_group(right_.shape(), right_begin_k, right_end_k,
-            right_stride_, proc_grid_.proc_cols(), k, k_,
-            [&](const ProcGrid::size_type col) { return proc_grid_.map_col(col); });
+        if(schedule_)
+          return schedule_->row_groups[k - k_begin_];
+        return make_group(make_row_proc_list(k), k, k_);
       }
 
       /// Column process group factory function
@@ -181,14 +229,33 @@ namespace TiledArray {
       /// \param k The broadcast group index
       /// \return A column process group
       madness::Group make_col_group(const size_type k) const {
+        SummaTraceScope trace("col_group", "k", k);
+
         // Construct the sparse broadcast group
-        return make_group(left_.shape(), k, left_end_, left_stride_,
-            proc_grid_.proc_rows(), k, 0ul,
-            [&](const ProcGrid::size_type row) { return proc_grid_.map_row(row); });
+        if(schedule_)
+          return schedule_->col_groups[k - k_begin_];
+        return make_group(make_col_proc_list(k), k, 0ul);
       }
 
       // Broadcast kernels -----------------------------------------------------
 
+      /// Broadcast arrival trace callback
+
+      /// This callback records the arrival of a broadcast tile and deletes
+      /// itself.
+      class TraceArrival : public madness::CallbackInterface {
+      private:
+        const size_type index_; ///< The index of the broadcast tile
+
+      public:
+        TraceArrival(const size_type index) : index_(index) { }
+
+        virtual void notify() {
+          SummaTrace::instant("bcast_recv", "tile", index_);
+          delete this;
+        }
+      }; // class TraceArrival
+
       /// Tile conversion task function
 
       /// \tparam Tile The input tile type
@@ -231,6 +298,103 @@ namespace TiledArray {
       }
 
 
+      // Broadcast compression -----------------------------------------------
+
+      /// Tile compression task function
+
+      /// \tparam Tile The tile type
+      /// \param tile The tile to be compressed
+      /// \param tolerance The maximum absolute error of the tile elements
+      /// \return The compressed tile
+      template <typename Tile>
+      static CompressedTile<Tile> compress_tile_task(const Tile& tile, const double tolerance) {
+        CompressedTile<Tile> result(tile, tolerance);
+        SummaConfig::bcast_bytes_() += tile.size() * sizeof(typename Tile::value_type);
+        SummaConfig::bcast_compressed_bytes_() += result.size();
+        return result;
+      }
+
+      /// Tile decompression task function
+
+      /// \tparam Tile The tile type
+      /// \param tile The compressed tile
+      /// \return The decompressed tile
+      template <typename Tile>
+      static Tile decompress_tile_task(const CompressedTile<Tile>& tile) {
+        return tile.decompress();
+      }
+
+      /// Seed tile copy task function
+
+      /// \param tile The target tile
+      /// \return A deep copy of \c tile
+      static value_type clone_seed_task(const value_type& tile) {
+        using TiledArray::clone;
+        return clone(tile);
+      }
+
+      /// Broadcast a tile that cannot be compressed
+
+      /// \tparam Tile The tile type
+      /// \param key The broadcast key
+      /// \param tile The tile, which is set on non-root processes
+      /// \param group_root The root process of the broadcast
+      /// \param group The process group where the tile will be broadcast
+      template <typename Tile>
+      void bcast_tile(const madness::DistributedID& key, Future<Tile>& tile,
+          const ProcessID group_root, const madness::Group& group, std::false_type) const
+      {
+        TensorImpl_::get_world().gop.bcast(key, tile, group_root, group);
+      }
+
+      /// Broadcast a tile that may be compressed
+
+      /// When broadcast compression is enabled, the root process broadcasts
+      /// the compressed tile, and the other processes decompress it once it
+      /// arrives.
+      /// \tparam Tile The tile type
+      /// \param key The broadcast key
+      /// \param tile The tile, which is set on non-root processes
+      /// \param group_root The root process of the broadcast
+      /// \param group The process group where the tile will be broadcast
+      template <typename Tile>
+      void bcast_tile(const madness::DistributedID& key, Future<Tile>& tile,
+          const ProcessID group_root, const madness::Group& group, std::true_type) const
+      {
+        if(compression_ == SummaConfig::uncompressed) {
+          bcast_tile(key, tile, group_root, group, std::false_type());
+          return;
+        }
+
+        World& world = TensorImpl_::get_world();
+        if(group.rank() == group_root) {
+          Future<CompressedTile<Tile> > compressed = world.taskq.add(
+              & Summa_::template compress_tile_task<Tile>, tile,
+              compression_tolerance_, madness::TaskAttributes::hipri());
+          world.gop.bcast(key, compressed, group_root, group);
+        } else {
+          Future<CompressedTile<Tile> > compressed;
+          world.gop.bcast(key, compressed, group_root, group);
+          tile.set(world.taskq.add(& Summa_::template decompress_tile_task<Tile>,
+              compressed, madness::TaskAttributes::hipri()));
+        }
+      }
+
+      /// Broadcast a tile
+
+      /// \tparam Tile The tile type
+      /// \param key The broadcast key
+      /// \param tile The tile, which is set on non-root processes
+      /// \param group_root The root process of the broadcast
+      /// \param group The process group where the tile will be broadcast
+      template <typename Tile>
+      void bcast_tile(const madness::DistributedID& key, Future<Tile>& tile,
+          const ProcessID group_root, const madness::Group& group) const
+      {
+        bcast_tile(key, tile, group_root, group, is_compressible_tile<Tile>());
+      }
+
+
       /// Collect non-zero tiles from \c arg
 
       /// \tparam Arg The argument type
@@ -303,36 +467,27 @@ namespace TiledArray {
         TA_ASSERT(group.size() > 0);
         TA_ASSERT(group_root < group.size());
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST
-        std::stringstream ss;
-        ss  << "bcast: rank=" << TensorImpl_::get_world().rank()
-            << " root=" << group.world_rank(group_root)
-            << " groupid=(" << group.id().first << "," << group.id().second
-            << ") keyoffset=" << key_offset << " group={ ";
-        for(ProcessID group_proc = 0; group_proc < group.size(); ++group_proc)
-          ss << group.world_rank(group_proc) << " ";
-        ss << "} tiles={ ";
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST
+        const bool trace = SummaTrace::enabled();
+        const bool is_root = (group.rank() == group_root);
 
         // Iterate over tiles to be broadcast
         for(typename std::vector<Datum>::iterator it = vec.begin(); it != vec.end(); ++it) {
           const size_type index = it->first * stride + start;
 
+          // Record the broadcast of the tile and its arrival
+          if(trace) {
+            if(is_root)
+              SummaTrace::instant("bcast_post", "tile", index);
+            else
+              it->second.register_callback(new TraceArrival(index));
+          }
+
           // Broadcast the tile
           const madness::DistributedID key(DistEvalImpl_::id(), index + key_offset);
-          TensorImpl_::get_world().gop.bcast(key, it->second, group_root, group);
-
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST
-          ss  << index << " ";
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST
+          bcast_tile(key, it->second, group_root, group);
         }
 
         TA_ASSERT(vec.size() > 0ul);
-
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST
-        ss << "}\n";
-        printf(ss.str().c_str());
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST
       }
 
       // Broadcast specialization for left and right arguments -----------------
@@ -341,7 +496,7 @@ namespace TiledArray {
       ProcessID get_row_group_root(const size_type k, const madness::Group& row_group) const {
         ProcessID group_root = k % proc_grid_.proc_cols();
         if(! right_.shape().is_dense() && row_group.size() < proc_grid_.proc_cols()) {
-          const ProcessID world_root = proc_grid_.rank_row() * proc_grid_.proc_cols() + group_root;
+          const ProcessID world_root = proc_grid_.map_col(group_root);
           group_root = row_group.rank(world_root);
         }
         return group_root;
@@ -350,7 +505,7 @@ namespace TiledArray {
       ProcessID get_col_group_root(const size_type k, const madness::Group& col_group) const {
         ProcessID group_root = k % proc_grid_.proc_rows();
         if(! left_.shape().is_dense() && col_group.size() < proc_grid_.proc_rows()) {
-          const ProcessID world_root = group_root * proc_grid_.proc_cols() + proc_grid_.rank_col();
+          const ProcessID world_root = proc_grid_.map_row(group_root);
           group_root = col_group.rank(world_root);
         }
         return group_root;
@@ -405,7 +560,7 @@ namespace TiledArray {
                 // Broadcast the tile
                 const madness::DistributedID key(DistEvalImpl_::id(), index);
                 auto tile = get_tile(left_, index);
-                TensorImpl_::get_world().gop.bcast(key, tile, group_root, row_group);
+                bcast_tile(key, tile, group_root, row_group);
               }
             } else {
               // Discard column k of left_.
@@ -448,7 +603,7 @@ namespace TiledArray {
                 // Broadcast the tile
                 const madness::DistributedID key(DistEvalImpl_::id(), index + left_.size());
                 auto tile = get_tile(right_, index);
-                TensorImpl_::get_world().gop.bcast(key, tile, group_root, col_group);
+                bcast_tile(key, tile, group_root, col_group);
               }
             } else {
               // Broadcast row k of right_.
@@ -473,12 +628,12 @@ namespace TiledArray {
       /// non-zero tiles in this processes column.
       /// \param k The first row to search
       /// \return The first row, greater than or equal to \c k with non-zero
-      /// tiles, or \c k_ if none is found.
+      /// tiles, or \c k_end_ if none is found.
       size_type iterate_row(size_type k) const {
         // Iterate over k's until a non-zero tile is found or the end of the
         // matrix is reached.
         size_type end = k * proc_grid_.cols();
-        for(; k < k_; ++k) {
+        for(; k < k_end_; ++k) {
           // Search for non-zero tiles in row k of right
           size_type i = end + proc_grid_.rank_col();
           end += proc_grid_.cols();
@@ -497,11 +652,11 @@ namespace TiledArray {
       /// checks for non-zero tiles in this process's row.
       /// \param k The first column to test for non-zero tiles
       /// \return The first column, greater than or equal to \c k, that contains
-      /// a non-zero tile. If no non-zero tile is not found, return \c k_.
+      /// a non-zero tile. If no non-zero tile is not found, return \c k_end_.
       size_type iterate_col(size_type k) const {
         // Iterate over k's until a non-zero tile is found or the end of the
         // matrix is reached.
-        for(; k < k_; ++k)
+        for(; k < k_end_; ++k)
           // Search row k for non-zero tiles
           for(size_type i = left_start_local_ + k; i < left_end_; i += left_stride_local_)
             if(! left_.shape().is_zero(i))
@@ -515,13 +670,11 @@ namespace TiledArray {
 
       /// Search for the next k-th column and row of the left- and right-hand
       /// arguments, respectively, that both contain non-zero tiles. This search
-      /// only checks for non-zero tiles in this process's row or column. If a
-      /// non-zero, local tile is found that does not contribute to local
-      /// contractions, the tiles will be immediately broadcast.
+      /// only checks for non-zero tiles in this process's row or column.
       /// \param k The first row/column to check
       /// \return The next k-th column and row of the left- and right-hand
       /// arguments, respectively, that both have non-zero tiles
-      size_type iterate_sparse(const size_type k) const {
+      size_type find_sparse(const size_type k) const {
         // Initial step for k_col and k_row.
         size_type k_col = iterate_col(k);
         size_type k_row = iterate_row(k_col);
@@ -535,19 +688,37 @@ namespace TiledArray {
           }
         }
 
-        if(k < k_row) {
+        return k_col;
+      }
+
+      /// Find the next k where the left- and right-hand argument have non-zero tiles
+
+      /// Search for the next k-th column and row of the left- and right-hand
+      /// arguments, respectively, that both contain non-zero tiles. This search
+      /// only checks for non-zero tiles in this process's row or column. If a
+      /// non-zero, local tile is found that does not contribute to local
+      /// contractions, the tiles will be immediately broadcast.
+      /// \param k The first row/column to check
+      /// \return The next k-th column and row of the left- and right-hand
+      /// arguments, respectively, that both have non-zero tiles
+      size_type iterate_sparse(const size_type k) const {
+        // Use the cached iteration sequence when available
+        const size_type k_next = (schedule_ && (k < k_end_) ?
+            schedule_->next[k - k_begin_] : find_sparse(k));
+
+        if(k < k_next) {
           // Spawn a task to broadcast any local columns of left that were skipped
           TensorImpl_::get_world().taskq.add(shared_from_this(),
-              & Summa_::bcast_col_range_task, k, k_row,
+              & Summa_::bcast_col_range_task, k, k_next,
               madness::TaskAttributes::hipri());
 
           // Spawn a task to broadcast any local rows of right that were skipped
           TensorImpl_::get_world().taskq.add(shared_from_this(),
-              & Summa_::bcast_row_range_task, k, k_col,
+              & Summa_::bcast_row_range_task, k, k_next,
               madness::TaskAttributes::hipri());
         }
 
-        return k_col;
+        return k_next;
       }
 
 
@@ -567,28 +738,124 @@ namespace TiledArray {
       }
 
 
+      // Broadcast schedule functions ------------------------------------------
+
+      /// Zero tile pattern fingerprint of a sparse shape
+
+      /// \tparam T The shape value type
+      /// \param shape The shape
+      /// \return The fingerprint of \c shape
+      template <typename T>
+      static std::size_t fingerprint(const SparseShape<T>& shape) { return shape.fingerprint(); }
+
+      /// Zero tile pattern fingerprint of a dense shape
+
+      /// \return Zero, since dense shapes have no zero tiles
+      static std::size_t fingerprint(const DenseShape&) { return 0ul; }
+
+      /// Construct the broadcast schedule key of this contraction
+
+      /// \return A key that identifies the sparsity patterns of the arguments
+      /// and the process grid of this process
+      SummaGroupCache::Key make_schedule_key() const {
+        SummaGroupCache::Key key;
+        key.grid = { k_, k_begin_, k_end_, proc_grid_.rows(), proc_grid_.cols(),
+            proc_grid_.proc_rows(), proc_grid_.proc_cols(), proc_grid_.proc_layers(),
+            size_type(proc_grid_.map_row(0ul)), size_type(proc_grid_.map_col(0ul)),
+            left_.size(), right_.size() };
+        key.left = fingerprint(left_.shape());
+        key.right = fingerprint(right_.shape());
+
+        return key;
+      }
+
+      /// Construct the broadcast schedule of this contraction
+
+      /// \return The row and column broadcast groups and the sequence of
+      /// non-zero iterations of this process
+      std::shared_ptr<const SummaGroupCache::Schedule> make_schedule() const {
+        std::shared_ptr<SummaGroupCache::Schedule> schedule =
+            std::make_shared<SummaGroupCache::Schedule>();
+        const size_type n = k_end_ - k_begin_;
+        schedule->k_begin = k_begin_;
+
+        // Find the next non-zero iteration for each k
+        schedule->next.resize(n, k_end_);
+        for(size_type i = n; i > 0ul; --i) {
+          const size_type k = k_begin_ + i - 1ul;
+          schedule->next[i - 1ul] = ((iterate_col(k) == k) && (iterate_row(k) == k) ?
+              k : (i < n ? schedule->next[i] : k_end_));
+        }
+
+        // Construct the broadcast groups, which are identified by this
+        // evaluator in all evaluations that reuse them
+        schedule->row_groups.reserve(n);
+        schedule->col_groups.reserve(n);
+        for(size_type k = k_begin_; k < k_end_; ++k) {
+          schedule->row_groups.push_back(make_group(make_row_proc_list(k), k, k_));
+          schedule->col_groups.push_back(make_group(make_col_proc_list(k), k, 0ul));
+        }
+
+        return schedule;
+      }
+
+      /// Get the broadcast schedule of this contraction from the cache
+
+      /// The schedule is constructed and added to the cache if the cache does
+      /// not contain a schedule for this contraction.
+      /// \return The broadcast schedule of this contraction
+      std::shared_ptr<const SummaGroupCache::Schedule> cached_schedule() const {
+        SummaTraceScope trace("schedule", "k", k_begin_);
+
+        const SummaGroupCache::Key key = make_schedule_key();
+        std::shared_ptr<const SummaGroupCache::Schedule> schedule =
+            SummaGroupCache::find(key);
+        if(! schedule) {
+          schedule = make_schedule();
+          SummaGroupCache::insert(key, schedule);
+        }
+
+        return schedule;
+      }
+
+
       // Initialization functions ----------------------------------------------
 
+      /// Seed a reduce task with a target tile
+
+      /// The target tile is the initial value of the reduction, so the tile
+      /// contractions are added to it. Target tiles are only added on the
+      /// first process layer, where the partial results of the layers are
+      /// reduced. The reduce task accumulates into its seed in place, so it
+      /// is seeded with a deep copy of the target tile; shallow copies of
+      /// the target tile are not changed.
+      /// \param reduce_task The reduce task of the result tile
+      /// \param index The index of the result tile
+      void seed(ReducePairTask<op_type>& reduce_task, const size_type index) const {
+        if(proc_grid_.rank_layer() != 0u)
+          return;
+
+        using TiledArray::empty;
+        const Future<value_type> tile = target_(index);
+        if(tile.probe()) {
+          if(! empty(tile.get()))
+            reduce_task.seed(Future<value_type>(clone_seed_task(tile.get())));
+        } else {
+          reduce_task.seed(TensorImpl_::get_world().taskq.add(
+              & Summa_::clone_seed_task, tile, madness::TaskAttributes::hipri()));
+        }
+      }
+
       /// Initialize reduce tasks and construct broadcast groups
       size_type initialize(const DenseShape&) {
         // Construct static broadcast groups for dense arguments
-        const madness::DistributedID col_did(DistEvalImpl_::id(), 0ul);
-        col_group_ = proc_grid_.make_col_group(col_did);
-        const madness::DistributedID row_did(DistEvalImpl_::id(), k_);
-        row_group_ = proc_grid_.make_row_group(row_did);
-
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-        std::stringstream ss;
-        ss << "init: rank=" << TensorImpl_::get_world().rank()
-           << "\n    col_group_=(" << col_did.first << ", " << col_did.second << ") { ";
-        for(ProcessID gproc = 0ul; gproc < col_group_.size(); ++gproc)
-          ss << col_group_.world_rank(gproc) << " ";
-        ss << "}\n    row_group_=(" << row_did.first << ", " << row_did.second << ") { ";
-        for(ProcessID gproc = 0ul; gproc < row_group_.size(); ++gproc)
-          ss << row_group_.world_rank(gproc) << " ";
-        ss << "}\n";
-        printf(ss.str().c_str());
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
+        {
+          SummaTraceScope trace("groups", "k", k_begin_);
+          const madness::DistributedID col_did(DistEvalImpl_::id(), 0ul);
+          col_group_ = proc_grid_.make_col_group(col_did);
+          const madness::DistributedID row_did(DistEvalImpl_::id(), k_);
+          row_group_ = proc_grid_.make_row_group(row_did);
+        }
 
         // Allocate memory for the reduce pair tasks.
         std::allocator<ReducePairTask<op_type> > alloc;
@@ -600,6 +867,15 @@ namespace TiledArray {
           // Initialize the reduction task
           ReducePairTask<op_type>* restrict const reduce_task = reduce_tasks_ + t;
           new(reduce_task) ReducePairTask<op_type>(TensorImpl_::get_world(), op_);
+
+          if(target_) {
+            // Compute the index of the t-th local tile
+            const size_type row = proc_grid_.rank_row()
+                + (t / proc_grid_.local_cols()) * proc_grid_.proc_rows();
+            const size_type col = proc_grid_.rank_col()
+                + (t % proc_grid_.local_cols()) * proc_grid_.proc_cols();
+            seed(*reduce_task, row * proc_grid_.cols() + col);
+          }
         }
 
         return proc_grid_.local_size();
@@ -609,11 +885,6 @@ namespace TiledArray {
       template <typename Shape>
       size_type initialize(const Shape& shape) {
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-        std::stringstream ss;
-        ss << "    initialize rank=" << TensorImpl_::get_world().rank() << " tiles={ ";
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-
         // Allocate memory for the reduce pair tasks.
         std::allocator<ReducePairTask<op_type> > alloc;
         reduce_tasks_ = alloc.allocate(proc_grid_.local_size());
@@ -639,11 +910,9 @@ namespace TiledArray {
             // Skip zero tiles
             if(! shape.is_zero(DistEvalImpl_::perm_index_to_target(index))) {
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-              ss << index << " ";
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-
               new(reduce_task) ReducePairTask<op_type>(TensorImpl_::get_world(), op_);
+              if(target_)
+                seed(*reduce_task, index);
               ++tile_count;
             } else {
               // Construct an empty task to represent zero tiles.
@@ -652,30 +921,91 @@ namespace TiledArray {
           }
         }
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-        ss << "}\n";
-        printf(ss.str().c_str());
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-
         return tile_count;
       }
 
       size_type initialize() {
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-        printf("init: start rank=%i\n", TensorImpl_::get_world().rank());
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
+        SummaTraceScope trace("initialize", "tiles", proc_grid_.local_size());
+        return initialize(TensorImpl_::shape());
+      }
 
-        const size_type result = initialize(TensorImpl_::shape());
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-        printf("init: finish rank=%i\n", TensorImpl_::get_world().rank());
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
+      // Finalize functions ----------------------------------------------------
 
-        return result;
+      /// Reduce the partial result tiles of two layers
+
+      /// \param left The partial result tile of the first layer
+      /// \param right The partial result tile of the second layer
+      /// \return The sum of \c left and \c right
+      value_type reduce_layer_tiles(value_type left, const value_type& right) const {
+        using TiledArray::empty;
+        if(empty(right))
+          return left;
+        if(empty(left))
+          return right;
+
+        op_(left, right);
+        return left;
       }
 
+      /// Partial result tile key
+
+      /// The keys of the partial result tiles of the layers follow the keys
+      /// of the broadcast argument tiles, <tt>[0, left_.size() +
+      /// right_.size())</tt>, and the keys of the remote result tile
+      /// requests, <tt>[0, size())</tt>, which share the same id.
+      /// \param layer The layer of the partial result tile
+      /// \param perm_index The permuted index of the result tile
+      /// \return The key of the partial result tile
+      madness::DistributedID layer_key(const size_type layer, const size_type perm_index) const {
+        TA_ASSERT(layer > 0ul);
+        const size_type first = std::max(left_.size() + right_.size(), TensorImpl_::size());
+        return madness::DistributedID(DistEvalImpl_::id(),
+            first + (layer - 1ul) * TensorImpl_::size() + perm_index);
+      }
 
-      // Finalize functions ----------------------------------------------------
+      /// Set a result tile
+
+      /// When the process grid has more than one layer, the partial result
+      /// tile of each layer is sent to the first layer, where the partial
+      /// result tiles are reduced and the result tile is set. A layer that
+      /// has no tile contractions for the tile contributes an empty tile.
+      /// \param perm_index The permuted index of the result tile
+      /// \param reduce_task The reduction task for the result tile
+      void finalize_tile(const size_type perm_index, ReducePairTask<op_type>& reduce_task) {
+        if(proc_grid_.proc_layers() <= 1u) {
+          DistEvalImpl_::set_tile(perm_index, reduce_task.submit());
+          return;
+        }
+
+        World& world = TensorImpl_::get_world();
+        Future<value_type> tile;
+        if(reduce_task.count()) {
+          tile = reduce_task.submit();
+        } else {
+          reduce_task.destroy();
+          tile.set(value_type());
+        }
+
+        if(proc_grid_.rank_layer() == 0u) {
+          // Reduce the partial result tiles of the other layers
+          for(size_type layer = 1ul; layer < proc_grid_.proc_layers(); ++layer) {
+            const Future<value_type> partial = world.gop.template
+                recv<value_type>(proc_grid_.map_layer(layer), layer_key(layer, perm_index));
+            tile = world.taskq.add(shared_from_this(), & Summa_::reduce_layer_tiles,
+                tile, partial, madness::TaskAttributes::hipri());
+          }
+
+          DistEvalImpl_::set_tile(perm_index, tile);
+        } else {
+          // Send the partial result tile to the first layer
+          world.gop.send(proc_grid_.map_layer(0ul),
+              layer_key(proc_grid_.rank_layer(), perm_index), tile);
+
+          // Record the assignment of a tile
+          tile.register_callback(this);
+        }
+      }
 
       /// Set the result tiles, destroy reduce tasks, and destroy broadcast groups
       void finalize(const DenseShape&) {
@@ -696,8 +1026,7 @@ namespace TiledArray {
 
 
             // Set the result tile
-            DistEvalImpl_::set_tile(DistEvalImpl_::perm_index_to_target(index),
-                reduce_task->submit());
+            finalize_tile(DistEvalImpl_::perm_index_to_target(index), *reduce_task);
 
             // Destroy the the reduce task
             reduce_task->~ReducePairTask<op_type>();
@@ -713,11 +1042,6 @@ namespace TiledArray {
       template <typename Shape>
       void finalize(const Shape& shape) {
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
-        std::stringstream ss;
-        ss << "    finalize rank=" << TensorImpl_::get_world().rank() << " tiles={ ";
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
-
         // Initialize iteration variables
         size_type row_start = proc_grid_.rank_row() * proc_grid_.cols();
         size_type row_end = row_start + proc_grid_.cols();
@@ -738,12 +1062,8 @@ namespace TiledArray {
             // Skip zero tiles
             if(! shape.is_zero(perm_index)) {
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
-              ss << index << " ";
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
-
               // Set the result tile
-              DistEvalImpl_::set_tile(perm_index, reduce_task->submit());
+              finalize_tile(perm_index, *reduce_task);
             }
 
             // Destroy the the reduce task
@@ -754,23 +1074,11 @@ namespace TiledArray {
         // Deallocate the memory for the reduce pair tasks.
         std::allocator<ReducePairTask<op_type> >().deallocate(reduce_tasks_,
             proc_grid_.local_size());
-
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
-        ss << "}\n";
-        printf(ss.str().c_str());
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
       }
 
       void finalize() {
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
-        printf("finalize: start rank=%i\n", TensorImpl_::get_world().rank());
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
-
+        SummaTraceScope trace("finalize", "tiles", proc_grid_.local_size());
         finalize(TensorImpl_::shape());
-
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
-        printf("finalize: finish rank=%i\n", TensorImpl_::get_world().rank());
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
       }
 
       /// SUMMA finalization task
@@ -862,15 +1170,63 @@ namespace TiledArray {
         }
       }
 
-#define TILEDARRAY_DISABLE_TILE_CONTRACTION_FILTER
-#ifndef TILEDARRAY_DISABLE_TILE_CONTRACTION_FILTER
+      /// Check that tile pairs can be screened for a shape type
+
+      /// \return \c true for \c SparseShape, otherwise \c false
+      template <typename T>
+      static typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+      is_screenable(const SparseShape<T>&) { return true; }
+
+      /// Check that tile pairs can be screened for a shape type
+
+      /// \return \c true for \c SparseShape, otherwise \c false
+      template <typename Shape>
+      static bool is_screenable(const Shape&) { return false; }
+
+      /// Compute the normalized norm of an argument tile
+
+      /// \tparam Arg The argument type
+      /// \param arg The argument that holds the tile
+      /// \param index The index of the tile in \c arg
+      /// \param tile The argument tile
+      /// \return The actual tile norm divided by the tile volume, if the tile
+      /// has arrived, otherwise the shape estimate of the normalized norm
+      template <typename Arg>
+      static float tile_norm(const Arg& arg, const size_type index,
+          const Future<typename Arg::eval_type>& tile)
+      {
+        if(tile.probe()) {
+          using TiledArray::norm;
+          return float(norm(tile.get())) / float(arg.trange().make_tile_range(index).volume());
+        }
+
+        return arg.shape()[index];
+      }
+
+      /// Compute the volume of the inner dimensions of iteration \c k
+
+      /// \param k The SUMMA iteration
+      /// \return The number of elements in the inner dimensions of tile \c k
+      float inner_volume(const size_type k) const {
+        // The product of the volumes of tile (0,k) of left_ and tile (k,0)
+        // of right_, divided by the volume of result tile (0,0), is equal to
+        // the square of the inner volume.
+        const float left_volume = left_.trange().make_tile_range(k).volume();
+        const float right_volume =
+            right_.trange().make_tile_range(k * proc_grid_.cols()).volume();
+        const float result_volume = TensorImpl_::trange().make_tile_range(
+            DistEvalImpl_::perm_index_to_target(0ul)).volume();
+        return std::sqrt(left_volume * right_volume / result_volume);
+      }
+
       /// Schedule local contraction tasks for \c col and \c row tile pairs
 
       /// Schedule tile contractions for each tile pair of \c row and \c col. A
       /// callback to \c task will be registered with each tile contraction
       /// task. This version of contract is used when shape_type is
-      /// \c SparseShape. It skips tile contractions that have a negligible
-      /// contribution to the result tile.
+      /// \c SparseShape. When tile-pair screening is enabled, it skips tile
+      /// contractions that have a negligible contribution to the result tile,
+      /// except for the first tile contraction of each result tile.
       /// \tparam T The shape value type
       /// \param k The k step for this contraction set
       /// \param col A column of tiles from the left-hand argument
@@ -882,42 +1238,216 @@ namespace TiledArray {
           const std::vector<col_datum>& col, const std::vector<row_datum>& row,
           madness::TaskInterface* const task)
       {
-        // Cache row shape data.
-        std::vector<typename SparseShape<T>::value_type> row_shape_values;
-        row_shape_values.reserve(row.size());
-        const size_type row_start = k * proc_grid_.cols() + proc_grid_.rank_col();
-        for(size_type j = 0ul; j < row.size(); ++j)
-          row_shape_values.push_back(right_.shape()[row_start + (row[j].first * right_stride_local_)]);
-
-        const size_type col_start = left_start_local_ + k;
-        const float threshold_k = TensorImpl_::shape().threshold() / typename SparseShape<T>::value_type(k_);
+        // Cache the normalized norms of the row and column tiles
+        std::vector<float> col_norms, row_norms;
+        float threshold_k = 0.0f;
+        if(screen_) {
+          col_norms.reserve(col.size());
+          const size_type col_start = left_start_local_ + k;
+          for(size_type i = 0ul; i < col.size(); ++i)
+            col_norms.push_back(tile_norm(left_,
+                col_start + (col[i].first * left_stride_local_), col[i].second));
+
+          row_norms.reserve(row.size());
+          const size_type row_start = k * proc_grid_.cols() + proc_grid_.rank_col();
+          for(size_type j = 0ul; j < row.size(); ++j)
+            row_norms.push_back(tile_norm(right_,
+                row_start + (row[j].first * right_stride_local_), row[j].second));
+
+          // Scale the column norms by the square of the inner volume, such
+          // that the product of column and row norms bounds the normalized
+          // contribution to the result tile norm, as in SparseShape::gemm.
+          const float volume = inner_volume(k);
+          for(float& norm : col_norms)
+            norm *= volume * volume;
+
+          threshold_k = SparseShape<T>::threshold() / float(k_);
+        }
+
         // Iterate over the row
+        std::size_t skipped = 0ul;
         for(size_type i = 0ul; i != col.size(); ++i) {
           // Compute the local, result-tile offset
           const size_type offset = col[i].first * proc_grid_.local_cols();
 
-          // Get the shape data for col_it tile
-          const typename SparseShape<T>::value_type col_shape_value =
-              left_.shape()[col_start + (col[i].first * left_stride_local_)];
-
           // Iterate over columns
           for(size_type j = 0ul; j < row.size(); ++j) {
-            if((col_shape_value * row_shape_values[j]) < threshold_k)
+            ReducePairTask<op_type>& reduce_task = reduce_tasks_[offset + row[j].first];
+
+            // Skip zero tiles
+            if(! reduce_task)
+              continue;
+
+            // Skip tile pairs with a negligible contribution
+            if(screen_ && ((col_norms[i] * row_norms[j]) < threshold_k)
+                && (reduce_task.count() > 0)) {
+              ++skipped;
               continue;
+            }
 
             if(task)
               task->inc();
-            reduce_tasks_[offset + row[j].first].add(col[i].second, row[j].second, task);
+            reduce_task.add(col[i].second, row[j].second, task);
           }
         }
+
+        if(skipped)
+          SummaConfig::skipped_contractions_() += skipped;
       }
-#endif // TILEDARRAY_DISABLE_TILE_CONTRACTION_FILTER
 
       void contract(const size_type k, const std::vector<col_datum>& col,
           const std::vector<row_datum>& row, madness::TaskInterface* const task)
       { contract(TensorImpl_::shape(), k, col, row, task); }
 
 
+      // Memory bound ----------------------------------------------------------
+
+      /// Memory gate for SUMMA steps
+
+      /// The memory gate tracks the argument tile memory that is reserved by
+      /// the SUMMA steps in flight on this process. Requests are granted in
+      /// the order they are made, and a request is always granted when no
+      /// memory is reserved, so the contraction can always make progress.
+      class MemoryGate {
+      private:
+        typedef std::pair<std::size_t, Future<bool> > request_type;
+
+        madness::Spinlock lock_; ///< Gate lock
+        const std::size_t limit_; ///< The number of bytes that may be reserved
+        std::size_t reserved_; ///< The number of bytes currently reserved
+        std::deque<request_type> requests_; ///< Requests waiting for memory
+
+      public:
+
+        /// Constructor
+
+        /// \param limit The number of bytes that may be reserved at once
+        MemoryGate(const std::size_t limit) :
+          lock_(), limit_(limit), reserved_(0ul), requests_()
+        { }
+
+        /// Memory limit accessor
+
+        /// \return The number of bytes that may be reserved at once
+        std::size_t limit() const { return limit_; }
+
+        /// Reserve memory
+
+        /// \param bytes The number of bytes to be reserved
+        /// \return A future that is set once the memory has been reserved
+        Future<bool> acquire(const std::size_t bytes) {
+          madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+          if(requests_.empty() && ((reserved_ == 0ul) || (reserved_ + bytes <= limit_))) {
+            reserved_ += bytes;
+            return Future<bool>(true);
+          }
+
+          requests_.emplace_back(bytes, Future<bool>());
+          return requests_.back().second;
+        }
+
+        /// Release reserved memory
+
+        /// Waiting requests are granted, in order, while they fit in the
+        /// memory limit.
+        /// \param bytes The number of bytes to be released
+        void release(const std::size_t bytes) {
+          std::vector<Future<bool> > granted;
+          {
+            madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+            TA_ASSERT(reserved_ >= bytes);
+            reserved_ -= bytes;
+            while(! requests_.empty() && ((reserved_ == 0ul) ||
+                (reserved_ + requests_.front().first <= limit_)))
+            {
+              reserved_ += requests_.front().first;
+              granted.push_back(requests_.front().second);
+              requests_.pop_front();
+            }
+          }
+
+          // Set the futures outside the lock since it will start tasks
+          for(auto& future : granted)
+            future.set(true);
+        }
+
+      }; // class MemoryGate
+
+      /// Memory release task
+
+      /// This task releases the memory reserved by a SUMMA step once all tile
+      /// contractions of the step are complete, and then notifies the step
+      /// task that depends on those contractions.
+      class ReleaseTask : public madness::TaskInterface {
+      private:
+        std::shared_ptr<Summa_> owner_; ///< The owner of this task
+        const std::size_t bytes_; ///< The memory reserved by the step
+        madness::TaskInterface* const task_; ///< The dependent step task
+
+      public:
+        ReleaseTask(const std::shared_ptr<Summa_>& owner, const std::size_t bytes,
+            madness::TaskInterface* const task) :
+          madness::TaskInterface(1, madness::TaskAttributes::hipri()),
+          owner_(owner), bytes_(bytes), task_(task)
+        { }
+
+        virtual ~ReleaseTask() { }
+
+        virtual void run(const madness::TaskThreadEnv&) {
+          owner_->memory_gate_->release(bytes_);
+          task_->notify();
+        }
+
+      }; // class ReleaseTask
+
+      /// Tile-pair screening task
+
+      /// This task schedules the tile contractions of a SUMMA step once all
+      /// argument tiles of the step have arrived, so tile pairs are screened
+      /// with the actual tile norms.
+      class ScreenTask : public madness::TaskInterface {
+      private:
+        std::shared_ptr<Summa_> owner_; ///< The owner of this task
+        const size_type k_; ///< The SUMMA iteration
+        std::vector<col_datum> col_; ///< The column tiles of left_
+        std::vector<row_datum> row_; ///< The row tiles of right_
+        madness::TaskInterface* const task_; ///< The task that depends on the tile contractions
+        madness::TaskInterface* const finalize_task_; ///< The SUMMA finalization task
+
+        /// Add a dependency on the tiles of \c vec
+        template <typename Datum>
+        void depend(std::vector<Datum>& vec) {
+          for(typename std::vector<Datum>::iterator it = vec.begin(); it != vec.end(); ++it) {
+            if(it->second.probe()) continue;
+            madness::DependencyInterface::inc();
+            it->second.register_callback(this);
+          }
+        }
+
+      public:
+        ScreenTask(const std::shared_ptr<Summa_>& owner, const size_type k,
+            const std::vector<col_datum>& col, const std::vector<row_datum>& row,
+            madness::TaskInterface* const task,
+            madness::TaskInterface* const finalize_task) :
+          madness::TaskInterface(0ul, madness::TaskAttributes::hipri()),
+          owner_(owner), k_(k), col_(col), row_(row), task_(task),
+          finalize_task_(finalize_task)
+        {
+          depend(col_);
+          depend(row_);
+        }
+
+        virtual ~ScreenTask() { }
+
+        virtual void run(const madness::TaskThreadEnv&) {
+          owner_->contract(k_, col_, row_, task_);
+          task_->notify();
+          finalize_task_->notify();
+        }
+
+      }; // class ScreenTask
+
+
       // SUMMA step task -------------------------------------------------------
 
 
@@ -935,6 +1465,7 @@ namespace TiledArray {
         FinalizeTask* finalize_task_; ///< The SUMMA finalization task
         StepTask* next_step_task_ = nullptr; ///< The next SUMMA step task
         StepTask* tail_step_task_ = nullptr; ///< The next SUMMA step task
+        std::size_t step_memory_ = 0ul; ///< The memory reserved for this step
 
         void get_col(const size_type k) {
           owner_->get_col(k, col_);
@@ -946,6 +1477,12 @@ namespace TiledArray {
           this->notify();
         }
 
+        void get_row_col(const size_type k, bool) {
+          owner_->get_col(k, col_);
+          owner_->get_row(k, row_);
+          this->notify();
+        }
+
       public:
 
         StepTask(const std::shared_ptr<Summa_>& owner, int finalize_ndep) :
@@ -973,6 +1510,16 @@ namespace TiledArray {
         virtual ~StepTask() { }
 
         void spawn_get_row_col_tasks(const size_type k) {
+          if(owner_->memory_gate_) {
+            // Collect the tiles for iteration k once the memory is available
+            step_memory_ = owner_->step_memory(k);
+            madness::DependencyInterface::inc();
+            world_.taskq.add(this, & StepTask::get_row_col, k,
+                owner_->memory_gate_->acquire(step_memory_),
+                madness::TaskAttributes::hipri());
+            return;
+          }
+
           // Submit the task to collect column tiles of left for iteration k
           madness::DependencyInterface::inc();
           world_.taskq.add(this, & StepTask::get_col, k, madness::TaskAttributes::hipri());
@@ -982,12 +1529,28 @@ namespace TiledArray {
           world_.taskq.add(this, & StepTask::get_row, k, madness::TaskAttributes::hipri());
         }
 
+        /// Schedule the tile contractions of iteration \c k
+
+        /// \param k The SUMMA iteration
+        /// \param task The task that depends on the tile contractions
+        void contract(const size_type k, madness::TaskInterface* const task) {
+          if(owner_->screen_) {
+            // Screen tile pairs once the tiles of this step have arrived
+            task->inc();
+            finalize_task_->inc();
+            world_.taskq.add(new ScreenTask(owner_, k, col_, row_, task,
+                finalize_task_));
+          } else {
+            owner_->contract(k, col_, row_, task);
+          }
+        }
+
         template <typename Derived>
         void make_next_step_tasks(Derived* task, size_type depth) {
           TA_ASSERT(depth > 0);
           // Set the depth to be no greater than the maximum number steps
-          if(depth > owner_->k_)
-            depth = owner_->k_;
+          if(depth > (owner_->k_end_ - owner_->k_begin_))
+            depth = owner_->k_end_ - owner_->k_begin_;
 
           // Spawn the first (depth - 1) step tasks
           for(; depth > 0ul; --depth) {
@@ -1002,11 +1565,9 @@ namespace TiledArray {
 
         template <typename Derived, typename GroupType>
         void run(const size_type k, const GroupType& row_group, const GroupType& col_group) {
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_STEP
-          printf("step:  start rank=%i k=%lu\n", owner_->get_world().rank(), k);
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_STEP
+          SummaTraceScope trace("step", "k", k);
 
-          if(k < owner_->k_) {
+          if(k < owner_->k_end_) {
             // Initialize next tail task and submit next task
             TA_ASSERT(next_step_task_);
             next_step_task_->tail_step_task_ =
@@ -1021,11 +1582,21 @@ namespace TiledArray {
                 madness::TaskAttributes::hipri());
 
             // Submit tasks for the contraction of col and row tiles.
-            owner_->contract(k, col_, row_, tail_step_task_);
+            TA_ASSERT(tail_step_task_);
+            if(owner_->memory_gate_) {
+              // The memory for this step is released, and the tail task is
+              // notified, when the contractions are done.
+              ReleaseTask* const release_task =
+                  new ReleaseTask(owner_, step_memory_, tail_step_task_);
+              contract(k, release_task);
+              world_.taskq.add(release_task);
+              release_task->notify();
+            } else {
+              contract(k, tail_step_task_);
+              tail_step_task_->notify();
+            }
 
             // Notify task dependencies
-            TA_ASSERT(tail_step_task_);
-            tail_step_task_->notify();
             finalize_task_->notify();
 
           } else if(finalize_task_) {
@@ -1045,10 +1616,6 @@ namespace TiledArray {
 
             tail_step_task_->notify();
           }
-
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_STEP
-          printf("step: finish rank=%i k=%lu\n", owner_->get_world().rank(), k);
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_STEP
         }
 
       }; // class StepTask
@@ -1060,17 +1627,18 @@ namespace TiledArray {
 
       public:
         DenseStepTask(const std::shared_ptr<Summa_>& owner, const size_type depth) :
-          StepTask(owner, owner->k_ + 1ul), k_(0)
+          StepTask(owner, owner->k_end_ - owner->k_begin_ + 1ul), k_(owner->k_begin_)
         {
-          StepTask::make_next_step_tasks(this, depth);
+          // Tiles must be requested in order of k for the memory gate
           StepTask::spawn_get_row_col_tasks(k_);
+          StepTask::make_next_step_tasks(this, depth);
         }
 
         DenseStepTask(DenseStepTask* const parent, const int ndep) :
           StepTask(parent, ndep), k_(parent->k_ + 1ul)
         {
           // Spawn tasks to get k-th row and column tiles
-          if(k_ < owner_->k_)
+          if(k_ < owner_->k_end_)
             StepTask::spawn_get_row_col_tasks(k_);
         }
 
@@ -1099,7 +1667,7 @@ namespace TiledArray {
           k = owner_->iterate_sparse(k + offset);
           k_.set(k);
 
-          if(k < owner_->k_) {
+          if(k < owner_->k_end_) {
             // NOTE: The order of task submissions is dependent on the order in
             // which we want the tasks to complete.
 
@@ -1131,13 +1699,13 @@ namespace TiledArray {
           // Spawn a task to find the next non-zero iteration
           madness::DependencyInterface::inc();
           world_.taskq.add(this, & SparseStepTask::iterate_task,
-              0ul, 0ul, madness::TaskAttributes::hipri());
+              owner->k_begin_, 0ul, madness::TaskAttributes::hipri());
         }
 
         SparseStepTask(SparseStepTask* const parent, const int ndep) :
           StepTask(parent, ndep)
         {
-          if(parent->k_.probe() && (parent->k_.get() >= owner_->k_)) {
+          if(parent->k_.probe() && (parent->k_.get() >= owner_->k_end_)) {
             // Avoid running extra tasks if not needed.
             k_.set(parent->k_.get());
           } else {
@@ -1180,7 +1748,11 @@ namespace TiledArray {
         left_(left), right_(right), op_(op),
         row_group_(), col_group_(),
         k_(k), proc_grid_(proc_grid),
-        reduce_tasks_(NULL),
+        k_begin_(proc_grid.local_size() ? proc_grid.layer_begin(k, proc_grid.rank_layer()) : 0ul),
+        k_end_(proc_grid.local_size() ? proc_grid.layer_begin(k, proc_grid.rank_layer() + 1ul) : 0ul),
+        reduce_tasks_(NULL), memory_gate_(), screen_(false),
+        compression_(SummaConfig::uncompressed), compression_tolerance_(0.0),
+        schedule_(), target_(),
         left_start_local_(proc_grid_.rank_row() * k),
         left_end_(left.size()),
         left_stride_(k),
@@ -1191,6 +1763,26 @@ namespace TiledArray {
 
       virtual ~Summa() { }
 
+      /// Add the result of the contraction to the tiles of an array
+
+      /// The tiles of \c target are used as the initial values of the tile
+      /// reductions, so the result tiles hold the sum of the \c target tiles
+      /// and the tile contractions. The tiles of \c target are updated in
+      /// place. This must be called before the contraction is evaluated, the
+      /// contraction must not permute the result, and the shape of this
+      /// tensor must include the non-zero tiles of \c target.
+      /// \tparam A The array type
+      /// \param target The array that holds the tiles that the result is
+      /// added to
+      template <typename A>
+      void accumulate_to(const A& target) {
+        TA_ASSERT(target.trange() == TensorImpl_::trange());
+        target_ = [target] (const size_type index) -> Future<value_type> {
+          return (target.is_zero(index) ? Future<value_type>(value_type()) :
+              target.find(index));
+        };
+      }
+
       /// Get tile at index \c i
 
       /// \param i The index of the tile
@@ -1209,11 +1801,14 @@ namespace TiledArray {
         // Compute process coordinate of tile in the process grid
         const size_type proc_row = tile_row % proc_grid_.proc_rows();
         const size_type proc_col = tile_col % proc_grid_.proc_cols();
-        // Compute the process that owns tile
-        const ProcessID source = proc_row * proc_grid_.proc_cols() + proc_col;
+        // Compute the process that owns tile, where the processes of the
+        // grid may be shifted (see ProcGrid::shift() )
+        World& world = TensorImpl_::get_world();
+        const ProcessID source = (proc_row * proc_grid_.proc_cols() + proc_col
+            + proc_grid_.proc_offset()) % world.size();
 
         const madness::DistributedID key(DistEvalImpl_::id(), i);
-        return TensorImpl_::get_world().gop.template recv<value_type>(source, key);
+        return world.gop.template recv<value_type>(source, key);
       }
 
 
@@ -1226,55 +1821,110 @@ namespace TiledArray {
 
     private:
 
+      /// Estimate the memory required by the argument tiles of a SUMMA step
+
+      /// \param k The SUMMA iteration
+      /// \return The number of bytes in the non-zero tiles of column \c k of
+      /// \c left_ and row \c k of \c right_ that are used by this process, or
+      /// zero if iteration \c k does not contribute to local result tiles.
+      std::size_t step_memory(const size_type k) const {
+        // Sum the volume of local rows in column k of left_
+        std::size_t left_volume = 0ul;
+        for(size_type i = left_start_local_ + k; i < left_end_; i += left_stride_local_)
+          if(! left_.shape().is_zero(i))
+            left_volume += left_.trange().make_tile_range(i).volume();
+
+        // Sum the volume of local columns in row k of right_
+        std::size_t right_volume = 0ul;
+        size_type j = k * proc_grid_.cols();
+        const size_type row_end = j + proc_grid_.cols();
+        for(j += proc_grid_.rank_col(); j < row_end; j += right_stride_local_)
+          if(! right_.shape().is_zero(j))
+            right_volume += right_.trange().make_tile_range(j).volume();
+
+        if((left_volume == 0ul) || (right_volume == 0ul))
+          return 0ul;
+
+        return left_volume * sizeof(typename scalar_type<typename left_type::eval_type>::type)
+            + right_volume * sizeof(typename scalar_type<typename right_type::eval_type>::type);
+      }
+
+      /// Estimate the memory required by the local result tiles
+
+      /// \return The number of bytes in the non-zero result tiles that are
+      /// accumulated by this process
+      std::size_t result_memory() const {
+        // Initialize iteration variables
+        size_type row_start = proc_grid_.rank_row() * proc_grid_.cols();
+        size_type row_end = row_start + proc_grid_.cols();
+        row_start += proc_grid_.rank_col();
+        const size_type col_stride = // The stride to iterate down a column
+            proc_grid_.proc_rows() * proc_grid_.cols();
+        const size_type row_stride = // The stride to iterate across a row
+            proc_grid_.proc_cols();
+        const size_type end = TensorImpl_::size();
+
+        // Sum the volume of all local, non-zero tiles
+        std::size_t volume = 0ul;
+        for(; row_start < end; row_start += col_stride, row_end += col_stride) {
+          for(size_type index = row_start; index < row_end; index += row_stride) {
+            const size_type perm_index = DistEvalImpl_::perm_index_to_target(index);
+            if(! TensorImpl_::is_zero(perm_index))
+              volume += TensorImpl_::trange().make_tile_range(perm_index).volume();
+          }
+        }
+
+        return volume * sizeof(typename scalar_type<value_type>::type);
+      }
+
       /// Adjust iteration depth based on memory constraints
 
+      /// The depth is reduced until the argument tiles of any <tt>depth + 1</tt>
+      /// consecutive, non-zero SUMMA iterations fit in \c available_memory.
       /// \param depth The unbounded iteration depth
-      /// \param left_sparsity The fraction of zero tiles in the left-hand matrix
-      /// \param right_sparsity The fraction of zero tiles in the right-hand matrix
+      /// \param available_memory The number of bytes available for argument
+      /// tiles
       /// \return The memory bounded iteration depth
-      /// \thorw TiledArray::Exception When the memory bounded iteration depth
-      /// is less than 1.
-      size_type mem_bound_depth(size_type depth, float left_sparsity, float right_sparsity) {
-
-        // Check if a memory bound has been set
-        const std::size_t available_memory = 1ul;
-        if(available_memory) {
-
-          // Compute the average memory requirement per iteration of this process
-          const std::size_t local_memory_per_iter_left =
-              (left_.trange().elements().volume() / left_.trange().tiles().volume()) *
-              sizeof(typename scalar_type<typename left_type::eval_type>::type) *
-              proc_grid_.local_rows() * (1.0f - left_sparsity);
-          const std::size_t local_memory_per_iter_right =
-              (right_.trange().elements().volume() / right_.trange().tiles().volume()) *
-              sizeof(typename scalar_type<typename right_type::eval_type>::type) *
-              proc_grid_.local_cols() * (1.0f - right_sparsity);
-
-          // Compute the maximum number of iterations based on available memory
-          const size_type mem_bound_depth =
-              ((local_memory_per_iter_left + local_memory_per_iter_right) /
-              available_memory) * 0.8;
-
-          // Check if the memory bounded depth is less than the optimal depth
-          if(depth > mem_bound_depth) {
-
-            // Adjust the depth based on the available memory
-            switch(mem_bound_depth) {
-              case 0:
-                // When memory bound depth is
-                TA_EXCEPTION("Insufficient memory available for SUMMA");
-                break;
-              case 1:
-                if(TensorImpl_::get_world().rank() == 0)
-                  printf("!! WARNING TiledArray: Insufficient memory available for SUMMA.\n"
-                         "!! WARNING TiledArray: Performance may be slow.\n");
-              default:
-                depth = mem_bound_depth;
-            }
-          }
+      size_type mem_bound_depth(size_type depth, const std::size_t available_memory) const {
+        // Compute the prefix sum of the memory required by non-zero iterations
+        std::vector<std::size_t> prefix(1ul, 0ul);
+        prefix.reserve(k_end_ - k_begin_ + 1ul);
+        for(size_type k = k_begin_; k < k_end_; ++k) {
+          const std::size_t bytes = step_memory(k);
+          if(bytes)
+            prefix.push_back(prefix.back() + bytes);
+        }
+        const size_type steps = prefix.size() - 1ul;
+        if(steps == 0ul)
+          return depth;
+
+        // Find the maximum memory required by n consecutive iterations
+        auto max_memory = [&] (const size_type n) -> std::size_t {
+          std::size_t result = 0ul;
+          for(size_type first = 0ul; first + n <= steps; ++first)
+            result = std::max(result, prefix[first + n] - prefix[first]);
+          return result;
+        };
+
+        if(max_memory(1ul) > available_memory) {
+          if(TensorImpl_::get_world().rank() == 0)
+            printf("!! WARNING TiledArray: Insufficient memory available for SUMMA.\n"
+                   "!! WARNING TiledArray: Performance may be slow.\n");
+          return 1ul;
         }
 
-        return depth;
+        // Binary search for the largest number of concurrent iterations that
+        // fit in the available memory.
+        size_type lower = 1ul, upper = std::min(depth + 1ul, steps);
+        while(lower < upper) {
+          const size_type n = (lower + upper + 1ul) / 2ul;
+          if(max_memory(n) <= available_memory)
+            lower = n;
+          else
+            upper = n - 1ul;
+        }
+
+        return std::max<size_type>(lower - 1ul, 1ul);
       }
 
       /// Evaluate the tiles of this tensor
@@ -1285,17 +1935,12 @@ namespace TiledArray {
       /// this object).
       /// \return The number of tiles that will be set by this process
       virtual int internal_eval() {
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
-        printf("eval: start eval children rank=%i\n", TensorImpl_::get_world().rank());
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
-
         // Start evaluate child tensors
-        left_.eval();
-        right_.eval();
-
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
-        printf("eval: finished eval children rank=%i\n", TensorImpl_::get_world().rank());
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
+        {
+          SummaTraceScope trace("eval_children", "tiles", proc_grid_.local_size());
+          left_.eval();
+          right_.eval();
+        }
 
         size_type tile_count = 0ul;
         if(proc_grid_.local_size() > 0ul) {
@@ -1310,15 +1955,33 @@ namespace TiledArray {
           size_type depth = TILEDARRAY_SUMMA_DEPTH;
 #endif //TILEDARRAY_SUMMA_DEPTH
 
+          // Screen tile pairs of sparse contractions
+          screen_ = SummaConfig::screening() && is_screenable(TensorImpl_::shape());
+
+          // Compress broadcast tiles
+          compression_ = SummaConfig::bcast_compression();
+          if(compression_ == SummaConfig::lossy)
+            compression_tolerance_ = SummaConfig::bcast_tolerance();
+
+          // Bound the memory used by concurrent SUMMA iterations
+          const std::size_t memory_limit = SummaConfig::memory_limit();
+          if(memory_limit) {
+            const std::size_t result_bytes = result_memory();
+            const std::size_t available_memory =
+                (memory_limit > result_bytes ? memory_limit - result_bytes : 0ul);
+            memory_gate_ = std::make_shared<MemoryGate>(available_memory);
+          }
+
           // Construct the first SUMMA iteration task
           if(TensorImpl_::shape().is_dense()) {
 #ifndef TILEDARRAY_SUMMA_DEPTH
-            if(depth > k_) depth = k_;
+            if(depth > (k_end_ - k_begin_)) depth = k_end_ - k_begin_;
+#endif //TILEDARRAY_SUMMA_DEPTH
 
             // Modify the number of concurrent iterations based on the available
             // memory.
-//            depth = mem_bound_depth(depth, 0.0f, 0.0f);
-#endif //TILEDARRAY_SUMMA_DEPTH
+            if(memory_gate_)
+              depth = mem_bound_depth(depth, memory_gate_->limit());
             TensorImpl_::get_world().taskq.add(new DenseStepTask(shared_from_this(),
                 depth));
           } else {
@@ -1335,28 +1998,29 @@ namespace TiledArray {
 
             // Compute the new depth
             depth = float(depth) * (1.0f - 1.35638f * std::log2(frac_non_zero)) + 0.5f;
-            if(depth > k_) depth = k_;
+            if(depth > (k_end_ - k_begin_)) depth = k_end_ - k_begin_;
+#endif // TILEDARRAY_SUMMA_DEPTH
 
             // Modify the number of concurrent iterations based on the available
             // memory and sparsity of the argument tensors.
-//            depth = mem_bound_depth(depth, left_sparsity, right_sparsity);
-#endif // TILEDARRAY_SUMMA_DEPTH
+            if(memory_gate_)
+              depth = mem_bound_depth(depth, memory_gate_->limit());
+
+            // Reuse the broadcast schedule of a previous evaluation
+            if(SummaGroupCache::enabled())
+              schedule_ = cached_schedule();
+
             TensorImpl_::get_world().taskq.add(new SparseStepTask(shared_from_this(),
                 depth));
           }
         }
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
-        printf("eval: start wait children rank=%i\n", TensorImpl_::get_world().rank());
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
-
         // Wait for child tensors to be evaluated, and process tasks while waiting.
-        left_.wait();
-        right_.wait();
-
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
-        printf("eval: finished wait children rank=%i\n", TensorImpl_::get_world().rank());
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
+        {
+          SummaTraceScope trace("wait_children", "tiles", proc_grid_.local_size());
+          left_.wait();
+          right_.wait();
+        }
 
         return tile_count;
       }
@@ -0,0 +1,306 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_FUSE_EVAL_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_FUSE_EVAL_H__INCLUDED
+
+#include <TiledArray/dist_eval/dist_eval.h>
+#include <TiledArray/pmap/fused_pmap.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Distributed evaluator that fuses the tiles of its argument
+
+    /// Each tile of this object is assembled from a block of adjacent tiles
+    /// of the argument, where the zero tiles of the argument are filled with
+    /// zeros. The argument must be distributed such that the tiles of each
+    /// fused tile are owned by the process that owns the fused tile (see
+    /// \c FusedPmap ), so the fused tiles are assembled without
+    /// communication. Argument tiles that are lazy (e.g. array tiles) are
+    /// evaluated before they are copied into the fused tile.
+    /// \tparam Arg The argument distributed evaluator type
+    /// \tparam Policy The tensor policy class
+    template <typename Arg, typename Policy>
+    class FuseEvalImpl :
+        public DistEvalImpl<typename eval_trait<typename Arg::value_type>::type, Policy>,
+        public std::enable_shared_from_this<FuseEvalImpl<Arg, Policy> >
+    {
+    public:
+      typedef FuseEvalImpl<Arg, Policy> FuseEvalImpl_; ///< This object type
+      typedef DistEvalImpl<typename eval_trait<typename Arg::value_type>::type,
+          Policy> DistEvalImpl_; ///< The base class type
+      typedef typename DistEvalImpl_::TensorImpl_ TensorImpl_; ///< The base, base class type
+      typedef Arg arg_type; ///< The argument type
+      typedef typename arg_type::value_type arg_value_type; ///< The argument tile type
+      typedef typename DistEvalImpl_::size_type size_type; ///< Size type
+      typedef typename DistEvalImpl_::shape_type shape_type; ///< Shape type
+      typedef typename DistEvalImpl_::pmap_interface pmap_interface; ///< Process map interface type
+      typedef typename DistEvalImpl_::trange_type trange_type; ///< Tiled range type
+      typedef typename DistEvalImpl_::value_type value_type; ///< Tile type
+      typedef typename value_type::numeric_type numeric_type; ///< Tile element type
+
+    private:
+
+      arg_type arg_; ///< The argument
+      std::shared_ptr<const std::vector<size_type> > fused_index_; ///< The fused tile of each argument tile
+
+    public:
+
+      /// Construct a fusing evaluator
+
+      /// \param arg The argument
+      /// \param world The world where the tensor lives
+      /// \param trange The tiled range of the fused tiles
+      /// \param shape The shape of the fused tiles
+      /// \param pmap The tile-process map of the fused tiles
+      /// \param fused_index The fused tile index of each argument tile
+      FuseEvalImpl(const arg_type& arg, World& world, const trange_type& trange,
+          const shape_type& shape, const std::shared_ptr<pmap_interface>& pmap,
+          const std::shared_ptr<const std::vector<size_type> >& fused_index) :
+        DistEvalImpl_(world, trange, shape, pmap, Permutation()),
+        arg_(arg), fused_index_(fused_index)
+      {
+        TA_ASSERT(fused_index_->size() == arg_.size());
+      }
+
+      virtual ~FuseEvalImpl() { }
+
+      /// Get tile at index \c i
+
+      /// \param i The index of the tile
+      /// \return A \c Future to the tile at index i
+      /// \throw TiledArray::Exception When tile \c i is owned by a remote node.
+      /// \throw TiledArray::Exception When tile \c i a zero tile.
+      virtual Future<value_type> get_tile(size_type i) const {
+        TA_ASSERT(TensorImpl_::is_local(i));
+        TA_ASSERT(! TensorImpl_::is_zero(i));
+        const madness::DistributedID key(DistEvalImpl_::id(), i);
+        return TensorImpl_::get_world().gop.template recv<value_type>(
+            TensorImpl_::get_world().rank(), key);
+      }
+
+      /// Discard a tile that is not needed
+
+      /// This function handles the cleanup for tiles that are not needed in
+      /// subsequent computation.
+      /// \param i The index of the tile
+      virtual void discard_tile(size_type i) const { get_tile(i); }
+
+    private:
+
+      /// Task function that assembles a fused tile
+
+      /// \param i The index of the fused tile
+      /// \param tiles The non-zero argument tiles of the fused tile
+      void fuse_tile(const size_type i, const std::vector<Future<arg_value_type> >& tiles) {
+        value_type result(TensorImpl_::trange().make_tile_range(i), numeric_type(0));
+        for(const Future<arg_value_type>& arg_tile : tiles) {
+          const value_type tile = static_cast<value_type>(arg_tile.get());
+          result.block(tile.range().lobound(), tile.range().upbound()) = tile;
+        }
+
+        DistEvalImpl_::set_tile(i, result);
+      }
+
+      /// Evaluate the tiles of this tensor
+
+      /// This function will evaluate the argument and schedule the assembly
+      /// of the local, non-zero fused tiles. It will block until the tasks
+      /// for the argument are evaluated (not for the tasks of this object).
+      /// \return The number of tiles that will be set by this process
+      virtual int internal_eval() {
+        // Convert pimpl to this object type so it can be used in tasks
+        std::shared_ptr<FuseEvalImpl_> self =
+            std::enable_shared_from_this<FuseEvalImpl_>::shared_from_this();
+
+        // Evaluate argument
+        arg_.eval();
+
+        // Collect the local, non-zero argument tiles of each fused tile
+        std::vector<std::vector<Future<arg_value_type> > > tiles(TensorImpl_::size());
+        typename pmap_interface::const_iterator it = arg_.pmap()->begin();
+        const typename pmap_interface::const_iterator end = arg_.pmap()->end();
+        for(; it != end; ++it) {
+          const size_type index = *it;
+          if(! arg_.is_zero(index))
+            tiles[(*fused_index_)[index]].push_back(arg_.get(index));
+        }
+
+        // Schedule the assembly of the fused tiles
+        size_type task_count = 0ul;
+        for(size_type i = 0ul; i < tiles.size(); ++i) {
+          if(tiles[i].empty()) continue;
+          TA_ASSERT(TensorImpl_::is_local(i));
+          TA_ASSERT(! TensorImpl_::is_zero(i));
+
+          TensorImpl_::get_world().taskq.add(self, & FuseEvalImpl_::fuse_tile,
+              i, tiles[i]);
+          ++task_count;
+        }
+
+        // Wait for local tiles of argument to be evaluated
+        arg_.wait();
+
+        return task_count;
+      }
+
+    }; // class FuseEvalImpl
+
+
+    /// Distributed evaluator that splits fused tiles
+
+    /// Each tile of this object is a block of a fused tile of the argument
+    /// (e.g. the result of a contraction of fused tiles), which is
+    /// extracted by the process that owns the fused tile.
+    /// \tparam Arg The argument distributed evaluator type
+    /// \tparam Policy The tensor policy class
+    template <typename Arg, typename Policy>
+    class SplitEvalImpl :
+        public DistEvalImpl<typename Arg::value_type, Policy>,
+        public std::enable_shared_from_this<SplitEvalImpl<Arg, Policy> >
+    {
+    public:
+      typedef SplitEvalImpl<Arg, Policy> SplitEvalImpl_; ///< This object type
+      typedef DistEvalImpl<typename Arg::value_type, Policy> DistEvalImpl_; ///< The base class type
+      typedef typename DistEvalImpl_::TensorImpl_ TensorImpl_; ///< The base, base class type
+      typedef Arg arg_type; ///< The argument type
+      typedef typename DistEvalImpl_::size_type size_type; ///< Size type
+      typedef typename DistEvalImpl_::shape_type shape_type; ///< Shape type
+      typedef typename DistEvalImpl_::pmap_interface pmap_interface; ///< Process map interface type
+      typedef typename DistEvalImpl_::trange_type trange_type; ///< Tiled range type
+      typedef typename DistEvalImpl_::value_type value_type; ///< Tile type
+      typedef typename value_type::numeric_type numeric_type; ///< Tile element type
+
+    private:
+
+      arg_type arg_; ///< The argument with fused tiles
+      std::shared_ptr<const std::vector<size_type> > fused_index_; ///< The fused tile of each tile
+
+    public:
+
+      /// Construct a splitting evaluator
+
+      /// \param arg The argument with fused tiles
+      /// \param world The world where the tensor lives
+      /// \param trange The tiled range object
+      /// \param shape The tensor shape object
+      /// \param pmap The tile-process map
+      /// \param fused_index The fused tile index of each tile
+      SplitEvalImpl(const arg_type& arg, World& world, const trange_type& trange,
+          const shape_type& shape, const std::shared_ptr<pmap_interface>& pmap,
+          const std::shared_ptr<const std::vector<size_type> >& fused_index) :
+        DistEvalImpl_(world, trange, shape, pmap, Permutation()),
+        arg_(arg), fused_index_(fused_index)
+      {
+        TA_ASSERT(fused_index_->size() == TensorImpl_::size());
+      }
+
+      virtual ~SplitEvalImpl() { }
+
+      /// Get tile at index \c i
+
+      /// \param i The index of the tile
+      /// \return A \c Future to the tile at index i
+      /// \throw TiledArray::Exception When tile \c i is owned by a remote node.
+      /// \throw TiledArray::Exception When tile \c i a zero tile.
+      virtual Future<value_type> get_tile(size_type i) const {
+        TA_ASSERT(TensorImpl_::is_local(i));
+        TA_ASSERT(! TensorImpl_::is_zero(i));
+        const ProcessID source = arg_.owner((*fused_index_)[i]);
+        const madness::DistributedID key(DistEvalImpl_::id(), i);
+        return TensorImpl_::get_world().gop.template recv<value_type>(source, key);
+      }
+
+      /// Discard a tile that is not needed
+
+      /// This function handles the cleanup for tiles that are not needed in
+      /// subsequent computation.
+      /// \param i The index of the tile
+      virtual void discard_tile(size_type i) const { get_tile(i); }
+
+    private:
+
+      /// Task function that splits a fused tile
+
+      /// \param tiles The indices of the non-zero tiles of the fused tile
+      /// \param fused_tile The fused tile
+      void split_tile(const std::vector<size_type>& tiles,
+          const value_type& fused_tile)
+      {
+        for(const size_type i : tiles) {
+          const typename trange_type::tile_range_type range =
+              TensorImpl_::trange().make_tile_range(i);
+          DistEvalImpl_::set_tile(i, (fused_tile.empty() ?
+              value_type(range, numeric_type(0)) :
+              value_type(fused_tile.block(range.lobound(), range.upbound()))));
+        }
+      }
+
+      /// Evaluate the tiles of this tensor
+
+      /// This function will evaluate the argument and schedule the split of
+      /// the local, non-zero fused tiles. It will block until the tasks for
+      /// the argument are evaluated (not for the tasks of this object).
+      /// \return The number of tiles that will be set by this process
+      virtual int internal_eval() {
+        // Convert pimpl to this object type so it can be used in tasks
+        std::shared_ptr<SplitEvalImpl_> self =
+            std::enable_shared_from_this<SplitEvalImpl_>::shared_from_this();
+
+        // Evaluate argument
+        arg_.eval();
+
+        // Collect the non-zero tiles of each local fused tile
+        std::vector<std::vector<size_type> > tiles(arg_.size());
+        for(size_type i = 0ul; i < fused_index_->size(); ++i) {
+          const size_type fused = (*fused_index_)[i];
+          if(arg_.is_local(fused) && ! TensorImpl_::is_zero(i))
+            tiles[fused].push_back(i);
+        }
+
+        // Schedule the split of the local, non-zero fused tiles
+        size_type task_count = 0ul;
+        typename pmap_interface::const_iterator it = arg_.pmap()->begin();
+        const typename pmap_interface::const_iterator end = arg_.pmap()->end();
+        for(; it != end; ++it) {
+          const size_type fused = *it;
+          if(arg_.is_zero(fused)) continue;
+
+          if(tiles[fused].empty()) {
+            arg_.discard(fused);
+          } else {
+            TensorImpl_::get_world().taskq.add(self, & SplitEvalImpl_::split_tile,
+                tiles[fused], arg_.get(fused));
+            task_count += tiles[fused].size();
+          }
+        }
+
+        // Wait for local tiles of argument to be evaluated
+        arg_.wait();
+
+        return task_count;
+      }
+
+    }; // class SplitEvalImpl
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_FUSE_EVAL_H__INCLUDED
@@ -0,0 +1,252 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_SUMMA_CONFIG_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_SUMMA_CONFIG_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <cstddef>
+#include <atomic>
+
+namespace TiledArray {
+  namespace detail {
+
+    template <typename, typename, typename, typename> class Summa;
+
+  } // namespace detail
+
+  /// Runtime parameters for SUMMA contractions
+
+  /// These parameters are process-local and are read when a contraction is
+  /// evaluated, so they should be set before the expression is evaluated and
+  /// should be the same on all processes.
+  class SummaConfig {
+  public:
+
+    /// Broadcast compression modes
+    typedef enum {
+      uncompressed = 0, ///< Tiles are broadcast as is
+      lossless = 1, ///< Tile bytes are shuffled and zero run-length encoded
+      lossy = 2 ///< As \c lossless , where floating point elements may be truncated
+    } BcastCompression;
+
+  private:
+    template <typename, typename, typename, typename>
+    friend class detail::Summa;
+
+    static std::atomic<std::size_t>& memory_limit_() {
+      static std::atomic<std::size_t> memory_limit(0ul);
+      return memory_limit;
+    }
+
+    static std::atomic<bool>& screening_() {
+      static std::atomic<bool> screening(false);
+      return screening;
+    }
+
+    static std::atomic<std::size_t>& skipped_contractions_() {
+      static std::atomic<std::size_t> skipped_contractions(0ul);
+      return skipped_contractions;
+    }
+
+    static std::atomic<BcastCompression>& bcast_compression_() {
+      static std::atomic<BcastCompression> bcast_compression(uncompressed);
+      return bcast_compression;
+    }
+
+    static std::atomic<double>& bcast_tolerance_() {
+      static std::atomic<double> bcast_tolerance(0.0);
+      return bcast_tolerance;
+    }
+
+    static std::atomic<std::size_t>& bcast_bytes_() {
+      static std::atomic<std::size_t> bcast_bytes(0ul);
+      return bcast_bytes;
+    }
+
+    static std::atomic<std::size_t>& bcast_compressed_bytes_() {
+      static std::atomic<std::size_t> bcast_compressed_bytes(0ul);
+      return bcast_compressed_bytes;
+    }
+
+    static std::atomic<bool>& sparse_grid_() {
+      static std::atomic<bool> sparse_grid(false);
+      return sparse_grid;
+    }
+
+    static std::atomic<double>& grid_flops_per_element_() {
+      static std::atomic<double> grid_flops_per_element(64.0);
+      return grid_flops_per_element;
+    }
+
+    static std::atomic<double>& grid_latency_() {
+      static std::atomic<double> grid_latency(1024.0);
+      return grid_latency;
+    }
+
+  public:
+
+    /// Memory limit accessor
+
+    /// \return The maximum number of bytes that a SUMMA contraction may use
+    /// on this process for argument tiles and result tiles, or zero if the
+    /// memory usage is not bounded.
+    static std::size_t memory_limit() { return memory_limit_(); }
+
+    /// Set the memory limit for SUMMA contractions
+
+    /// When set, the number of SUMMA iterations that are evaluated
+    /// concurrently is limited such that the estimated memory usage of the
+    /// broadcast argument tiles and the local result tiles stays below
+    /// \c limit. The inner dimension of a contraction is only divided among
+    /// process layers (2.5D SUMMA) when a limit is set and the replicated
+    /// partial result tiles fit in half of it.
+    /// \param limit The memory limit in bytes; a value of zero disables the
+    /// memory bound (default)
+    static void set_memory_limit(const std::size_t limit) { memory_limit_() = limit; }
+
+    /// Tile-pair screening accessor
+
+    /// \return \c true if tile pairs with a negligible contribution are
+    /// skipped in sparse contractions, otherwise \c false.
+    static bool screening() { return screening_(); }
+
+    /// Enable or disable tile-pair screening
+
+    /// When enabled, a tile contraction of a sparse SUMMA iteration is
+    /// skipped if the product of the left- and right-hand tile norms is
+    /// below the zero threshold divided by the number of iterations. The
+    /// norms are estimated from the argument shapes, and the actual tile
+    /// norms are used once the tiles have arrived. At least one tile
+    /// contraction is kept for each non-zero result tile.
+    /// \param screening If \c true, tile pairs are screened [ default = false ]
+    static void set_screening(const bool screening) { screening_() = screening; }
+
+    /// Skipped tile contraction counter accessor
+
+    /// \return The number of tile contractions that have been skipped by
+    /// tile-pair screening on this process
+    static std::size_t skipped_contractions() { return skipped_contractions_(); }
+
+    /// Reset the skipped tile contraction counter
+    static void reset_skipped_contractions() { skipped_contractions_() = 0ul; }
+
+    /// Broadcast compression accessor
+
+    /// \return The compression mode of the tiles that are broadcast by SUMMA
+    static BcastCompression bcast_compression() { return bcast_compression_(); }
+
+    /// Set the broadcast compression mode
+
+    /// When enabled, tensor tiles of arithmetic elements are compressed by
+    /// the root of a SUMMA broadcast and decompressed once on arrival,
+    /// before they are contracted. With \c lossy compression, floating point
+    /// elements are truncated to single or bfloat16 precision when the
+    /// absolute truncation error of all elements of the tile is below
+    /// \c bcast_tolerance() ; tiles are compressed without loss until a
+    /// tolerance is set. The mode must be the same on all processes.
+    /// \param compression The compression mode [ default = uncompressed ]
+    static void set_bcast_compression(const BcastCompression compression)
+    { bcast_compression_() = compression; }
+
+    /// Lossy broadcast tolerance accessor
+
+    /// \return The maximum absolute error of the elements of tiles that are
+    /// broadcast with \c lossy compression
+    static double bcast_tolerance() { return bcast_tolerance_(); }
+
+    /// Set the lossy broadcast tolerance
+
+    /// The tolerance bounds the error of each argument element, so the error
+    /// of a result element is at most <tt>tolerance * k * (|a| + |b|)</tt>,
+    /// where \c k is the size of the contracted dimensions, and \c |a| and
+    /// \c |b| are the largest argument elements. It should be chosen with
+    /// the accuracy required of the result in mind.
+    /// \param tolerance The maximum absolute error of broadcast tile
+    /// elements; zero disables truncation [ default = 0 ]
+    static void set_bcast_tolerance(const double tolerance) {
+      TA_ASSERT(tolerance >= 0.0);
+      bcast_tolerance_() = tolerance;
+    }
+
+    /// Broadcast byte counter accessor
+
+    /// \return The number of bytes of the tiles that have been compressed
+    /// for SUMMA broadcasts on this process
+    static std::size_t bcast_bytes() { return bcast_bytes_(); }
+
+    /// Compressed broadcast byte counter accessor
+
+    /// \return The number of compressed bytes of the tiles that have been
+    /// compressed for SUMMA broadcasts on this process
+    static std::size_t bcast_compressed_bytes() { return bcast_compressed_bytes_(); }
+
+    /// Reset the broadcast byte counters
+    static void reset_bcast_bytes() {
+      bcast_bytes_() = 0ul;
+      bcast_compressed_bytes_() = 0ul;
+    }
+
+    /// Sparse process grid selection accessor
+
+    /// \return \c true if the process grid of a sparse contraction is
+    /// selected with the sparse cost model, otherwise \c false.
+    static bool sparse_grid() { return sparse_grid_(); }
+
+    /// Enable or disable sparse process grid selection
+
+    /// When enabled, the process grid of a contraction with a sparse
+    /// argument is selected with a cost model that uses the argument shapes
+    /// (see \c detail::ProcGrid ), instead of the dense communication model.
+    /// The model is tuned with \c set_grid_cost() . The setting must be the
+    /// same on all processes.
+    /// \param sparse_grid If \c true, sparse process grids are selected with
+    /// the cost model [ default = false ]
+    static void set_sparse_grid(const bool sparse_grid) { sparse_grid_() = sparse_grid; }
+
+    /// Sparse grid flop rate accessor
+
+    /// \return The number of flops per element received that is used by the
+    /// sparse process grid cost model
+    static double grid_flops_per_element() { return grid_flops_per_element_(); }
+
+    /// Sparse grid latency accessor
+
+    /// \return The message latency, in units of the time required to receive
+    /// one element, that is used by the sparse process grid cost model
+    static double grid_latency() { return grid_latency_(); }
+
+    /// Set the machine balance of the sparse process grid cost model
+
+    /// \param flops_per_element The number of flops that a process performs
+    /// in the time required to receive one element [ default = 64 ]
+    /// \param latency The message latency, in units of the time required to
+    /// receive one element [ default = 1024 ]
+    static void set_grid_cost(const double flops_per_element, const double latency) {
+      TA_ASSERT(flops_per_element > 0.0);
+      TA_ASSERT(latency >= 0.0);
+      grid_flops_per_element_() = flops_per_element;
+      grid_latency_() = latency;
+    }
+
+  }; // class SummaConfig
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_SUMMA_CONFIG_H__INCLUDED
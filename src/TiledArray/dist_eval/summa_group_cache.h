@@ -0,0 +1,217 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_SUMMA_GROUP_CACHE_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_SUMMA_GROUP_CACHE_H__INCLUDED
+
+#include <TiledArray/madness.h>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace TiledArray {
+  namespace detail {
+
+    template <typename, typename, typename, typename> class Summa;
+
+  } // namespace detail
+
+  /// Cache of sparse SUMMA broadcast schedules
+
+  /// A sparse SUMMA evaluation constructs a broadcast group for each row and
+  /// column of the argument tile grids, and it searches the argument shapes
+  /// for the iterations with non-zero tiles. When the cache is enabled, the
+  /// broadcast groups and the sequence of non-zero iterations are stored, and
+  /// they are reused by later evaluations with the same argument sparsity
+  /// patterns and process grid. This is intended for iterative algorithms
+  /// that evaluate the same contraction many times. The sparsity patterns are
+  /// identified by the fingerprints of the argument shapes (see
+  /// \c SparseShape::fingerprint() ), which are computed once per shape, so
+  /// a cache hit does not scan the argument shapes.
+  /// \note The cache is process-local. The cached groups keep the id of the
+  /// evaluation that constructed them, so all processes must hit or miss the
+  /// cache together. This holds when the cache is enabled, cleared, and
+  /// resized on all processes at the same point, since contractions are
+  /// evaluated in the same order on all processes, and the key of a
+  /// contraction is determined by its process grid and argument shapes.
+  class SummaGroupCache {
+  public:
+
+    /// Broadcast schedule of a sparse SUMMA evaluation
+    struct Schedule {
+      std::size_t k_begin; ///< The first iteration of this process's layer
+      std::vector<std::size_t> next; ///< The next non-zero iteration at or after <tt>k_begin + i</tt>
+      std::vector<madness::Group> row_groups; ///< Row broadcast groups of iterations <tt>k_begin + i</tt>
+      std::vector<madness::Group> col_groups; ///< Column broadcast groups of iterations <tt>k_begin + i</tt>
+    }; // struct Schedule
+
+    /// Schedule key
+    struct Key {
+      std::vector<std::size_t> grid; ///< The process grid and inner dimension parameters
+      std::size_t left; ///< The zero tile pattern fingerprint of the left-hand argument
+      std::size_t right; ///< The zero tile pattern fingerprint of the right-hand argument
+
+      /// Hash of the key
+
+      /// \return A hash of the key
+      std::size_t hash() const {
+        std::size_t seed = left;
+        madness::hash_combine(seed, right);
+        for(std::size_t x : grid)
+          madness::hash_combine(seed, x);
+        return seed;
+      }
+
+      bool operator==(const Key& other) const {
+        return (grid == other.grid) && (left == other.left) && (right == other.right);
+      }
+    }; // struct Key
+
+  private:
+    template <typename, typename, typename, typename>
+    friend class detail::Summa;
+
+    /// Cache entry
+    struct Entry {
+      std::size_t hash; ///< The key hash
+      Key key; ///< The schedule key
+      std::shared_ptr<const Schedule> schedule; ///< The cached schedule
+    }; // struct Entry
+
+    static std::atomic<bool>& enabled_() {
+      static std::atomic<bool> enabled(false);
+      return enabled;
+    }
+
+    static std::mutex& mutex_() {
+      static std::mutex mutex;
+      return mutex;
+    }
+
+    static std::size_t& capacity_() {
+      static std::size_t capacity = 16ul;
+      return capacity;
+    }
+
+    static std::deque<Entry>& entries_() {
+      static std::deque<Entry> entries;
+      return entries;
+    }
+
+    static std::size_t& hits_() {
+      static std::size_t hits = 0ul;
+      return hits;
+    }
+
+    /// Find a cached schedule
+
+    /// \param key The schedule key
+    /// \return The schedule for \c key, or an empty pointer if it is not cached
+    static std::shared_ptr<const Schedule> find(const Key& key) {
+      const std::size_t hash = key.hash();
+      std::lock_guard<std::mutex> lock(mutex_());
+      for(const Entry& entry : entries_()) {
+        if((entry.hash == hash) && (entry.key == key)) {
+          ++hits_();
+          return entry.schedule;
+        }
+      }
+      return std::shared_ptr<const Schedule>();
+    }
+
+    /// Add a schedule to the cache
+
+    /// When the cache is full, the oldest schedule is discarded.
+    /// \param key The schedule key
+    /// \param schedule The schedule for \c key
+    static void insert(const Key& key, const std::shared_ptr<const Schedule>& schedule) {
+      const std::size_t hash = key.hash();
+      std::lock_guard<std::mutex> lock(mutex_());
+      std::deque<Entry>& entries = entries_();
+      if(capacity_() == 0ul)
+        return;
+      while(entries.size() >= capacity_())
+        entries.pop_front();
+      entries.push_back(Entry{ hash, key, schedule });
+    }
+
+  public:
+
+    /// Check that the cache is enabled
+
+    /// \return \c true if sparse SUMMA schedules are cached on this process
+    static bool enabled() { return enabled_().load(std::memory_order_relaxed); }
+
+    /// Enable or disable the cache
+
+    /// Disabling the cache does not discard cached schedules.
+    /// \param enable If \c true, sparse SUMMA schedules are cached [ default = true ]
+    static void enable(const bool enable = true) { enabled_() = enable; }
+
+    /// Cache capacity accessor
+
+    /// \return The maximum number of cached schedules
+    static std::size_t capacity() {
+      std::lock_guard<std::mutex> lock(mutex_());
+      return capacity_();
+    }
+
+    /// Set the cache capacity
+
+    /// \param capacity The maximum number of cached schedules [ default = 16 ]
+    static void set_capacity(const std::size_t capacity) {
+      std::lock_guard<std::mutex> lock(mutex_());
+      capacity_() = capacity;
+      std::deque<Entry>& entries = entries_();
+      while(entries.size() > capacity)
+        entries.pop_front();
+    }
+
+    /// Number of cached schedules
+
+    /// \return The number of schedules in the cache
+    static std::size_t size() {
+      std::lock_guard<std::mutex> lock(mutex_());
+      return entries_().size();
+    }
+
+    /// Number of cache hits
+
+    /// \return The number of evaluations that reused a cached schedule on
+    /// this process
+    static std::size_t hits() {
+      std::lock_guard<std::mutex> lock(mutex_());
+      return hits_();
+    }
+
+    /// Discard all cached schedules and reset the hit counter
+    static void clear() {
+      std::lock_guard<std::mutex> lock(mutex_());
+      entries_().clear();
+      hits_() = 0ul;
+    }
+
+  }; // class SummaGroupCache
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_SUMMA_GROUP_CACHE_H__INCLUDED
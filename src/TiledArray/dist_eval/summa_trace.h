@@ -0,0 +1,251 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_SUMMA_TRACE_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_SUMMA_TRACE_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace TiledArray {
+
+  /// Timeline recorder for SUMMA contractions
+
+  /// When enabled, SUMMA contractions record timestamped events for the
+  /// start and finish of each iteration, the broadcast and arrival of each
+  /// argument tile, the construction of broadcast groups, the tile GEMMs, and
+  /// the finalization of the result. Events are stored in per-thread buffers,
+  /// so recording does not require synchronization, and the only cost of a
+  /// disabled recorder is the check of a flag. The recorded events of a
+  /// process can be written as a Chrome trace (JSON) file, which can be
+  /// viewed with \c chrome://tracing or Perfetto.
+  /// \note The recorder is process-local. Each process should write its own
+  /// trace file; events are tagged with the rank of the process, so the
+  /// \c traceEvents arrays of several files may be merged into one trace.
+  class SummaTrace {
+  public:
+
+    /// Trace event
+    struct Event {
+      const char* name; ///< Event name
+      const char* arg_name; ///< Name of the event argument
+      long arg; ///< Event argument (e.g. iteration or tile index)
+      std::int64_t ts; ///< Time stamp in microseconds
+      std::int64_t dur; ///< Duration in microseconds (complete events only)
+      char ph; ///< Chrome trace event phase ('X' = complete, 'i' = instant)
+    }; // struct Event
+
+  private:
+
+    /// Event buffer of a single thread
+    struct Buffer {
+      unsigned int tid; ///< Thread index
+      std::vector<Event> events; ///< Recorded events
+    }; // struct Buffer
+
+    static std::atomic<bool>& enabled_() {
+      static std::atomic<bool> enabled(false);
+      return enabled;
+    }
+
+    static std::mutex& mutex_() {
+      static std::mutex mutex;
+      return mutex;
+    }
+
+    static std::vector<std::unique_ptr<Buffer> >& buffers_() {
+      static std::vector<std::unique_ptr<Buffer> > buffers;
+      return buffers;
+    }
+
+    /// Event buffer of the calling thread
+
+    /// The buffer is registered the first time a thread records an event.
+    /// Buffers are owned by the recorder so that events outlive the threads
+    /// that recorded them.
+    static Buffer& buffer() {
+      static thread_local Buffer* buffer = nullptr;
+      if(! buffer) {
+        std::lock_guard<std::mutex> lock(mutex_());
+        std::vector<std::unique_ptr<Buffer> >& buffers = buffers_();
+        buffers.emplace_back(new Buffer());
+        buffer = buffers.back().get();
+        buffer->tid = buffers.size() - 1ul;
+        buffer->events.reserve(1024ul);
+      }
+      return *buffer;
+    }
+
+    static void record(const char* name, const char* arg_name, const long arg,
+        const std::int64_t ts, const std::int64_t dur, const char ph)
+    {
+      buffer().events.push_back(Event{ name, arg_name, arg, ts, dur, ph });
+    }
+
+  public:
+
+    /// Check that event recording is enabled
+
+    /// \return \c true if events are recorded on this process
+    static bool enabled() { return enabled_().load(std::memory_order_relaxed); }
+
+    /// Enable or disable event recording
+
+    /// \param enable If \c true, SUMMA events are recorded [ default = true ]
+    static void enable(const bool enable = true) { enabled_() = enable; }
+
+    /// Current time stamp
+
+    /// \return The current time in microseconds
+    static std::int64_t now() {
+      return std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /// Record an instant event
+
+    /// \param name The event name
+    /// \param arg_name The name of the event argument
+    /// \param arg The event argument
+    static void instant(const char* name, const char* arg_name, const long arg) {
+      if(enabled())
+        record(name, arg_name, arg, now(), 0, 'i');
+    }
+
+    /// Record a complete event
+
+    /// \param name The event name
+    /// \param arg_name The name of the event argument
+    /// \param arg The event argument
+    /// \param start The time stamp of the event start
+    static void complete(const char* name, const char* arg_name, const long arg,
+        const std::int64_t start)
+    {
+      record(name, arg_name, arg, start, now() - start, 'X');
+    }
+
+    /// Number of recorded events
+
+    /// \return The number of events recorded on this process
+    static std::size_t size() {
+      std::lock_guard<std::mutex> lock(mutex_());
+      std::size_t n = 0ul;
+      for(const auto& buffer : buffers_())
+        n += buffer->events.size();
+      return n;
+    }
+
+    /// Discard all recorded events
+
+    /// \note This function should not be called while a contraction is
+    /// being evaluated.
+    static void clear() {
+      std::lock_guard<std::mutex> lock(mutex_());
+      for(auto& buffer : buffers_())
+        buffer->events.clear();
+    }
+
+    /// Write the recorded events as a Chrome trace
+
+    /// \param os The output stream
+    /// \param rank The rank of this process, which is used as the process id
+    /// of the events
+    /// \note This function should not be called while a contraction is
+    /// being evaluated.
+    static void write(std::ostream& os, const int rank) {
+      std::lock_guard<std::mutex> lock(mutex_());
+      os << "{\"traceEvents\":[";
+      bool first = true;
+      for(const auto& buffer : buffers_()) {
+        for(const Event& event : buffer->events) {
+          os << (first ? "\n" : ",\n") << "{\"name\":\"" << event.name
+             << "\",\"cat\":\"summa\",\"ph\":\"" << event.ph
+             << "\",\"ts\":" << event.ts;
+          if(event.ph == 'X')
+            os << ",\"dur\":" << event.dur;
+          else
+            os << ",\"s\":\"t\"";
+          os << ",\"pid\":" << rank << ",\"tid\":" << buffer->tid
+             << ",\"args\":{\"" << event.arg_name << "\":" << event.arg << "}}";
+          first = false;
+        }
+      }
+      os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+
+    /// Write the recorded events to a Chrome trace file
+
+    /// \param filename The name of the trace file
+    /// \param rank The rank of this process, which is used as the process id
+    /// of the events
+    /// \throw TiledArray::Exception When the file cannot be opened.
+    static void write(const std::string& filename, const int rank) {
+      std::ofstream file(filename.c_str());
+      if(! file.is_open())
+        TA_EXCEPTION("SummaTrace::write(): unable to open the trace file.");
+      write(file, rank);
+    }
+
+  }; // class SummaTrace
+
+  namespace detail {
+
+    /// Scoped SUMMA trace event
+
+    /// This object records a complete event that spans the lifetime of the
+    /// object, if event recording was enabled when it was constructed.
+    class SummaTraceScope {
+    private:
+      const char* name_; ///< Event name
+      const char* arg_name_; ///< Name of the event argument
+      long arg_; ///< Event argument
+      std::int64_t start_; ///< Time stamp of the event start, or -1 if disabled
+
+    public:
+      /// Constructor
+
+      /// \param name The event name
+      /// \param arg_name The name of the event argument
+      /// \param arg The event argument
+      SummaTraceScope(const char* name, const char* arg_name, const long arg) :
+        name_(name), arg_name_(arg_name), arg_(arg),
+        start_(SummaTrace::enabled() ? SummaTrace::now() : -1)
+      { }
+
+      SummaTraceScope(const SummaTraceScope&) = delete;
+      SummaTraceScope& operator=(const SummaTraceScope&) = delete;
+
+      ~SummaTraceScope() {
+        if(start_ >= 0)
+          SummaTrace::complete(name_, arg_name_, arg_, start_);
+      }
+    }; // class SummaTraceScope
+
+  } // namespace detail
+} // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_SUMMA_TRACE_H__INCLUDED
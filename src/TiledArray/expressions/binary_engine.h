@@ -229,6 +229,15 @@ namespace TiledArray {
         return perm * left_.trange();
       }
 
+      /// Check that this expression depends on an array
+
+      /// \param id The id of the array
+      /// \return \c true if either argument of this expression depends on the
+      /// array with the id \c id
+      bool depends_on(const madness::uniqueidT& id) const {
+        return left_.depends_on(id) || right_.depends_on(id);
+      }
+
       /// Construct the distributed evaluator for this expression
 
       /// \return The distributed evaluator that will evaluate this expression
@@ -27,9 +27,18 @@
 #define TILEDARRAY_EXPRESSIONS_CONT_ENGINE_H__INCLUDED
 
 #include <TiledArray/expressions/binary_engine.h>
+#include <TiledArray/expressions/cont_plan_cache.h>
+#include <TiledArray/expressions/tile_fusion.h>
 #include <TiledArray/dist_eval/contraction_eval.h>
+#include <TiledArray/dist_eval/batch_eval.h>
+#include <TiledArray/dist_eval/fuse_eval.h>
+#include <TiledArray/pmap/batch_pmap.h>
+#include <TiledArray/pmap/fused_pmap.h>
 #include <TiledArray/tile_op/contract_reduce.h>
+#include <TiledArray/math/strided_gemm.h>
 #include <TiledArray/proc_grid.h>
+#include <limits>
+#include <typeinfo>
 
 namespace TiledArray {
   namespace expressions {
@@ -37,6 +46,30 @@ namespace TiledArray {
     // Forward declarations
     template <typename, typename> class MultExpr;
     template <typename, typename> class ScalMultExpr;
+    template <typename, typename, typename> class MixedMultExpr;
+    template <typename> class TsrEngine;
+    template <typename> class ScalTsrEngine;
+
+    /// Check for contraction arguments that may be used in their native layout
+
+    /// The tiles of array arguments are permuted by the tile operation of the
+    /// argument, which may be skipped when the tiles support contractions of
+    /// arguments that are not in matrix form.
+    /// \tparam E The argument engine type
+    template <typename E>
+    struct is_native_cont_arg : public std::false_type { };
+
+    template <typename A>
+    struct is_native_cont_arg<TsrEngine<A> > :
+        public std::integral_constant<bool,
+            TiledArray::detail::is_tensor<typename A::value_type>::value>
+    { };
+
+    template <typename A>
+    struct is_native_cont_arg<ScalTsrEngine<A> > :
+        public std::integral_constant<bool,
+            TiledArray::detail::is_tensor<typename A::value_type>::value>
+    { };
 
     /// Multiplication expression engine
 
@@ -67,6 +100,12 @@ namespace TiledArray {
       typedef typename EngineTrait<Derived>::trange_type trange_type; ///< Tiled range type
       typedef typename EngineTrait<Derived>::shape_type shape_type; ///< Shape type
       typedef typename EngineTrait<Derived>::pmap_interface pmap_interface; ///< Process map interface type
+      typedef ContPlan<typename left_type::shape_type, typename right_type::shape_type,
+          shape_type> plan_type; ///< Contraction plan type
+      typedef std::integral_constant<bool,
+          TiledArray::detail::is_tensor<typename eval_trait<typename left_type::value_type>::type>::value &&
+          TiledArray::detail::is_tensor<typename eval_trait<typename right_type::value_type>::type>::value &&
+          TiledArray::detail::is_tensor<value_type>::value> is_fusable; ///< Tile fusion is supported for these tile types
 
     protected:
 
@@ -100,9 +139,24 @@ namespace TiledArray {
       VariableList right_vars_; ///< Right-hand variable list
       TensorOp left_op_; ///< Left-hand operation
       TensorOp right_op_; ///< Right-hand operation
+      unsigned int batch_rank_; ///< The number of batch variables, which lead all variable lists
+      shape_type batch_shape_; ///< The non-permuted result shape of a batched contraction
       op_type op_; ///< Tile operation
       TiledArray::detail::ProcGrid proc_grid_; ///< Process grid for the contraction
       size_type K_; ///< Inner dimension size
+      std::shared_ptr<const plan_type> plan_; ///< Cached plan for the argument sparsity (null if none)
+      std::shared_ptr<plan_type> next_plan_; ///< Plan that will be cached (null when not caching)
+      std::string plan_key_; ///< Key of the cached plan
+      bool fuse_; ///< Contract the fused tiles of the arguments (see \c TileFusion )
+      trange_type fused_left_trange_; ///< Left-hand fused tiled range
+      trange_type fused_right_trange_; ///< Right-hand fused tiled range
+      trange_type fused_trange_; ///< Result fused tiled range
+      typename left_type::shape_type fused_left_shape_; ///< Left-hand fused shape
+      typename right_type::shape_type fused_right_shape_; ///< Right-hand fused shape
+      shape_type fused_shape_; ///< Result fused shape
+      std::shared_ptr<const std::vector<std::size_t> > left_fused_index_; ///< Left-hand fused tile of each tile
+      std::shared_ptr<const std::vector<std::size_t> > right_fused_index_; ///< Right-hand fused tile of each tile
+      std::shared_ptr<const std::vector<std::size_t> > fused_index_; ///< Result fused tile of each tile
 
 
       static unsigned int
@@ -125,8 +179,12 @@ namespace TiledArray {
       template <typename L, typename R>
       ContEngine(const MultExpr<L, R>& expr) :
         BinaryEngine_(expr), factor_(1), left_vars_(), right_vars_(),
-        left_op_(permute_to_no_trans), right_op_(permute_to_no_trans), op_(),
-        proc_grid_(), K_(1u)
+        left_op_(permute_to_no_trans), right_op_(permute_to_no_trans),
+        batch_rank_(0u), batch_shape_(), op_(),
+        proc_grid_(), K_(1u), plan_(), next_plan_(), plan_key_(), fuse_(false),
+        fused_left_trange_(), fused_right_trange_(), fused_trange_(),
+        fused_left_shape_(), fused_right_shape_(), fused_shape_(),
+        left_fused_index_(), right_fused_index_(), fused_index_()
       { }
 
       /// Constructor
@@ -137,8 +195,29 @@ namespace TiledArray {
       template <typename L, typename R>
       ContEngine(const ScalMultExpr<L, R>& expr) :
         BinaryEngine_(expr), factor_(expr.factor()), left_vars_(), right_vars_(),
-        left_op_(permute_to_no_trans), right_op_(permute_to_no_trans), op_(),
-        proc_grid_(), K_(1u)
+        left_op_(permute_to_no_trans), right_op_(permute_to_no_trans),
+        batch_rank_(0u), batch_shape_(), op_(),
+        proc_grid_(), K_(1u), plan_(), next_plan_(), plan_key_(), fuse_(false),
+        fused_left_trange_(), fused_right_trange_(), fused_trange_(),
+        fused_left_shape_(), fused_right_shape_(), fused_shape_(),
+        left_fused_index_(), right_fused_index_(), fused_index_()
+      { }
+
+      /// Constructor
+
+      /// \tparam L The left-hand argument expression type
+      /// \tparam R The right-hand argument expression type
+      /// \tparam T The result tile type
+      /// \param expr The parent expression
+      template <typename L, typename R, typename T>
+      ContEngine(const MixedMultExpr<L, R, T>& expr) :
+        BinaryEngine_(expr), factor_(expr.factor()), left_vars_(), right_vars_(),
+        left_op_(permute_to_no_trans), right_op_(permute_to_no_trans),
+        batch_rank_(0u), batch_shape_(), op_(),
+        proc_grid_(), K_(1u), plan_(), next_plan_(), plan_key_(), fuse_(false),
+        fused_left_trange_(), fused_right_trange_(), fused_trange_(),
+        fused_left_shape_(), fused_right_shape_(), fused_shape_(),
+        left_fused_index_(), right_fused_index_(), fused_index_()
       { }
 
       // Pull base class functions into this class.
@@ -153,6 +232,10 @@ namespace TiledArray {
       /// result of this expression will be permuted to match \c target_vars.
       /// \param target_vars The target variable list for this expression
       void perm_vars(const VariableList& target_vars) {
+        // The variables of batched contractions are already in target order
+        if(batch_rank_)
+          return;
+
         // Only permute if the arguments can be permuted
         if((left_op_ == permute_to_no_trans) || (right_op_ == permute_to_no_trans)) {
 
@@ -340,6 +423,113 @@ namespace TiledArray {
 
       }
 
+      /// Initialize the variable list of this expression
+
+      /// Variables that appear in both arguments and in \c target_vars are
+      /// batch variables, which are neither contracted nor fused into the
+      /// *GEMM dimensions. The arguments and the result are permuted such that
+      /// the batch variables lead, in target order, followed by the outer
+      /// and inner variables (i.e. <tt>C[B...,M...,N...] =
+      /// A[B...,M...,K...] * B[B...,K...,N...]</tt> ). If there are no batch
+      /// variables, the variable lists are initialized as in \c init_vars()
+      /// and permuted to match \c target_vars .
+      /// \param target_vars The target variable list for this expression
+      /// \throw TiledArray::Exception When a variable of a batched
+      /// contraction does not appear in exactly two of the arguments and the
+      /// result, or in all three.
+      void init_vars(const VariableList& target_vars) {
+        const unsigned int left_rank = left_.vars().dim();
+        const unsigned int right_rank = right_.vars().dim();
+        const unsigned int target_rank = target_vars.dim();
+
+        // Collect the batch variables in target order
+        std::vector<std::string> batch_vars;
+        for(unsigned int i = 0u; i < target_rank; ++i) {
+          const std::string& var = target_vars[i];
+          if((find(left_.vars(), var, 0u, left_rank) < left_rank) &&
+              (find(right_.vars(), var, 0u, right_rank) < right_rank))
+            batch_vars.push_back(var);
+        }
+
+        if(batch_vars.empty()) {
+          init_vars();
+          perm_vars(target_vars);
+          return;
+        }
+
+        batch_rank_ = batch_vars.size();
+
+        // Get non-const references to the argument variable lists.
+        std::vector<std::string>& left_vars =
+            const_cast<std::vector<std::string>&>(left_vars_.data());
+        std::vector<std::string>& right_vars =
+            const_cast<std::vector<std::string>&>(right_vars_.data());
+        std::vector<std::string>& result_vars =
+            const_cast<std::vector<std::string>&>(vars_.data());
+        left_vars = batch_vars;
+        right_vars = batch_vars;
+        result_vars = batch_vars;
+
+        // Extract the left- and right-hand outer variables in target order.
+        std::vector<std::string> right_outer_vars;
+        for(unsigned int i = 0u; i < target_rank; ++i) {
+          const std::string& var = target_vars[i];
+          const bool in_left = (find(left_.vars(), var, 0u, left_rank) < left_rank);
+          const bool in_right = (find(right_.vars(), var, 0u, right_rank) < right_rank);
+          if(in_left && ! in_right) {
+            left_vars.push_back(var);
+            result_vars.push_back(var);
+          } else if(in_right && ! in_left) {
+            right_outer_vars.push_back(var);
+          }
+        }
+
+        // Extract the inner variables in the order of the left-hand argument.
+        for(unsigned int i = 0u; i < left_rank; ++i) {
+          const std::string& var = left_.vars()[i];
+          if((find(right_.vars(), var, 0u, right_rank) < right_rank) &&
+              (find(target_vars, var, 0u, target_rank) == target_rank))
+          {
+            left_vars.push_back(var);
+            right_vars.push_back(var);
+          }
+        }
+
+        right_vars.insert(right_vars.end(), right_outer_vars.begin(), right_outer_vars.end());
+        result_vars.insert(result_vars.end(), right_outer_vars.begin(), right_outer_vars.end());
+
+        TA_USER_ASSERT((left_vars.size() == left_rank) &&
+            (right_vars.size() == right_rank) && (result_vars.size() == target_rank),
+            "The variables of a batched contraction must appear in exactly two "
+            "of the arguments and the result, or in all three.");
+
+        // Arguments that are in batched matrix form are used as is; otherwise
+        // they are permuted to that form.
+        if(left_vars_ == left_.vars()) {
+          left_op_ = no_trans;
+          left_.permute_tiles(false);
+        } else {
+          left_.perm_vars(left_vars_);
+        }
+        if(right_vars_ == right_.vars()) {
+          right_op_ = no_trans;
+          right_.permute_tiles(false);
+        } else {
+          right_.perm_vars(right_vars_);
+        }
+      }
+
+      /// Batch rank accessor
+
+      /// \return The number of batch variables of this contraction
+      unsigned int batch_rank() const { return batch_rank_; }
+
+      /// Tile fusion flag accessor
+
+      /// \return \c true if this contraction is evaluated with the fused
+      /// tiles of the arguments
+      bool is_fused() const { return fuse_; }
+
       /// Initialize result tensor structure
 
       /// This function will initialize the permutation, tiled range, and shape
@@ -359,105 +549,489 @@ namespace TiledArray {
             (right_op_ == trans ? madness::cblas::Trans : madness::cblas::NoTrans);
 
 
+        // Find a cached plan with the same argument shapes
+        if(ContPlanCache::enabled() && ! batch_rank_)
+          init_plan(target_vars);
+        const bool cached_shape = plan_ &&
+            is_same_shape(plan_->left_shape, left_.shape()) &&
+            is_same_shape(plan_->right_shape, right_.shape());
+
+        // Select the arguments that are contracted with fused tiles or in
+        // their native layout
+        Permutation left_perm, right_perm;
+        init_fusion(left_op, right_op, target_vars, is_fusable());
+        if(! fuse_)
+          init_native_args(left_op, right_op, left_perm, right_perm);
+
         if(target_vars != vars_) {
           // Initialize permuted structure
           perm_ = ExprEngine_::make_perm(target_vars);
           op_ = op_type(left_op, right_op, factor_, vars_.dim(), left_vars_.dim(),
-              right_vars_.dim(), (permute_tiles_ ? perm_ : Permutation()));
+              right_vars_.dim(), (permute_tiles_ ? perm_ : Permutation()),
+              left_perm, right_perm, batch_rank_);
           trange_ = ContEngine_::make_trange(perm_);
-          shape_ = ContEngine_::make_shape(perm_);
+          if(batch_rank_) {
+            // The batch slices are evaluated with the non-permuted shape
+            batch_shape_ = ContEngine_::make_shape();
+            shape_ = batch_shape_.perm(perm_);
+          } else {
+            shape_ = (cached_shape ? plan_->shape : ContEngine_::make_shape(perm_));
+          }
         } else {
           // Initialize non-permuted structure
           op_ = op_type(left_op, right_op, factor_, vars_.dim(), left_vars_.dim(),
-              right_vars_.dim());
+              right_vars_.dim(), Permutation(), left_perm, right_perm, batch_rank_);
           trange_ = ContEngine_::make_trange();
-          shape_ = ContEngine_::make_shape();
+          shape_ = (cached_shape ? plan_->shape : ContEngine_::make_shape());
+          if(batch_rank_)
+            batch_shape_ = shape_;
+        }
+
+        if(fuse_) {
+          fused_trange_ = make_trange(fused_left_trange_, fused_right_trange_, perm_);
+          fused_shape_ = shape_.fuse(trange_, fused_trange_);
+        }
+
+        if(next_plan_)
+          next_plan_->shape = shape_;
+      }
+
+      /// Zero slab flags of an argument
+
+      /// A slab is the set of tiles with the same coordinate in one
+      /// dimension. It is zero if all of its tiles are zero.
+      /// \tparam S The shape type
+      /// \param shape The argument shape
+      /// \param trange The argument tiled range
+      /// \return The zero slab flags of each dimension of \c trange
+      template <typename S>
+      static std::vector<std::vector<bool> >
+      zero_slabs(const S& shape, const trange_type& trange) {
+        const unsigned int rank = trange.tiles().rank();
+        const size_type* restrict const lower = trange.tiles().lobound_data();
+        const size_type* restrict const extent = trange.tiles().extent_data();
+
+        std::vector<std::vector<bool> > zero(rank);
+        for(unsigned int i = 0u; i < rank; ++i)
+          zero[i].assign(extent[i], ! shape.is_dense());
+
+        if(! shape.is_dense()) {
+          const size_type n = trange.tiles().volume();
+          for(size_type t = 0ul; t < n; ++t) {
+            if(shape.is_zero(t)) continue;
+            const auto index = trange.tiles().idx(t);
+            for(unsigned int i = 0u; i < rank; ++i)
+              zero[i][index[i] - lower[i]] = false;
+          }
+        }
+
+        return zero;
+      }
+
+      /// Tile fusion is not supported for these tile types
+      void init_fusion(const madness::cblas::CBLAS_TRANSPOSE,
+          const madness::cblas::CBLAS_TRANSPOSE, const VariableList&,
+          std::false_type)
+      { }
+
+      /// Initialize the fused tiled ranges and shapes of the arguments
+
+      /// When tile fusion is enabled (see \c TileFusion ), the adjacent tiles
+      /// of each argument dimension are fused, where the contracted
+      /// dimensions of both arguments are fused in the same way. Tiles are
+      /// fused only when both arguments are in matrix form after the argument
+      /// tiles are permuted, and the result tiles are permuted to the target
+      /// layout, such that fused tiles are blocks of the argument and result
+      /// tiles.
+      /// \param left_op The left-hand matrix operation
+      /// \param right_op The right-hand matrix operation
+      /// \param target_vars The target variable list for the result tensor
+      void init_fusion(const madness::cblas::CBLAS_TRANSPOSE left_op,
+          const madness::cblas::CBLAS_TRANSPOSE right_op,
+          const VariableList& target_vars, std::true_type)
+      {
+        if(! TileFusion::enabled() || batch_rank_ ||
+            (left_op != madness::cblas::NoTrans) ||
+            (right_op != madness::cblas::NoTrans) ||
+            ((target_vars != vars_) && ! permute_tiles_))
+          return;
+
+        const unsigned int left_rank = left_vars_.dim();
+        const unsigned int right_rank = right_vars_.dim();
+        const unsigned int inner_rank = (left_rank + right_rank - vars_.dim()) >> 1;
+        const unsigned int left_outer_rank = left_rank - inner_rank;
+
+        // The contracted dimensions must be coformal (see make_trange() )
+        for(unsigned int i = left_outer_rank, j = 0u; i < left_rank; ++i, ++j)
+          if(left_.trange().data()[i] != right_.trange().data()[j])
+            return;
+
+        const std::vector<std::vector<bool> > left_zero =
+            zero_slabs(left_.shape(), left_.trange());
+        const std::vector<std::vector<bool> > right_zero =
+            zero_slabs(right_.shape(), right_.trange());
+        const std::size_t extent = TileFusion::extent();
+
+        // Fuse the outer and contracted dimensions of the arguments. A
+        // contracted slab is zero if it is zero in either argument.
+        typename trange_type::Ranges left_ranges(left_.trange().data());
+        typename trange_type::Ranges right_ranges(right_.trange().data());
+        for(unsigned int i = 0u; i < left_outer_rank; ++i)
+          left_ranges[i] = TileFusion::fuse(left_ranges[i], left_zero[i], extent);
+        for(unsigned int i = left_outer_rank, j = 0u; i < left_rank; ++i, ++j) {
+          std::vector<bool> zero(left_zero[i]);
+          for(std::size_t x = 0ul; x < zero.size(); ++x)
+            zero[x] = zero[x] || right_zero[j][x];
+          left_ranges[i] = TileFusion::fuse(left_ranges[i], zero, extent);
+          right_ranges[j] = left_ranges[i];
+        }
+        for(unsigned int j = inner_rank; j < right_rank; ++j)
+          right_ranges[j] = TileFusion::fuse(right_ranges[j], right_zero[j], extent);
+
+        fused_left_trange_ = trange_type(left_ranges.begin(), left_ranges.end());
+        fused_right_trange_ = trange_type(right_ranges.begin(), right_ranges.end());
+        fuse_ = (fused_left_trange_ != left_.trange()) ||
+            (fused_right_trange_ != right_.trange());
+
+        if(fuse_) {
+          fused_left_shape_ = left_.shape().fuse(left_.trange(), fused_left_trange_);
+          fused_right_shape_ = right_.shape().fuse(right_.trange(), fused_right_trange_);
+        }
+      }
+
+      /// Select the arguments that are contracted in their native layout
+
+      /// Arguments that are not in matrix form are permuted tile by tile
+      /// before they are contracted. For array arguments, the tile permutation
+      /// is skipped when \c math::StridedGemm can contract the tiles in their
+      /// native layout, so only the tile coordinates are permuted. Contracting
+      /// both arguments in their native layout is preferred.
+      /// \param left_op The left-hand matrix operation
+      /// \param right_op The right-hand matrix operation
+      /// \param[out] left_perm The permutation that takes left-hand tiles to
+      /// matrix form, or an empty permutation if they are permuted by the
+      /// argument
+      /// \param[out] right_perm The permutation that takes right-hand tiles to
+      /// matrix form, or an empty permutation if they are permuted by the
+      /// argument
+      void init_native_args(const madness::cblas::CBLAS_TRANSPOSE left_op,
+          const madness::cblas::CBLAS_TRANSPOSE right_op,
+          Permutation& left_perm, Permutation& right_perm)
+      {
+        // Batched contractions are not supported by math::StridedGemm
+        if(batch_rank_)
+          return;
+
+        const bool left_native = is_native_cont_arg<left_type>::value &&
+            (left_op_ == permute_to_no_trans) && left_.perm();
+        const bool right_native = is_native_cont_arg<right_type>::value &&
+            (right_op_ == permute_to_no_trans) && right_.perm();
+        if(! (left_native || right_native))
+          return;
+
+        const math::GemmHelper gemm_helper(left_op, right_op, vars_.dim(),
+            left_vars_.dim(), right_vars_.dim());
+        if(left_native && right_native && math::StridedGemm::is_supported(
+            gemm_helper, left_.perm(), right_.perm()))
+        {
+          left_perm = left_.perm();
+          right_perm = right_.perm();
+        } else if(left_native && math::StridedGemm::is_supported(gemm_helper,
+            left_.perm(), Permutation()))
+        {
+          left_perm = left_.perm();
+        } else if(right_native && math::StridedGemm::is_supported(gemm_helper,
+            Permutation(), right_.perm()))
+        {
+          right_perm = right_.perm();
         }
+
+        if(left_perm)
+          left_.permute_tiles(false);
+        if(right_perm)
+          right_.permute_tiles(false);
+      }
+
+      /// Zero tile flags of a shape
+
+      /// \tparam S The shape type
+      /// \param shape The shape
+      /// \param n The number of tiles in \c shape
+      /// \return A vector of flags that are \c true for the zero tiles of
+      /// \c shape
+      template <typename S>
+      static std::vector<bool> zero_flags(const S& shape, const size_type n) {
+        std::vector<bool> flags(n, false);
+        if(! shape.is_dense())
+          for(size_type i = 0ul; i < n; ++i)
+            flags[i] = shape.is_zero(i);
+        return flags;
+      }
+
+      /// Initialize the contraction plan
+
+      /// Construct the plan that will be cached for this contraction, and find
+      /// the cached plan with the same key and argument sparsity, if any. The
+      /// plan key includes the expression type, the variable lists, the
+      /// scaling factor, the SUMMA memory limit and process grid settings,
+      /// and the argument tiled ranges.
+      /// \param target_vars The target variable list for the result tensor
+      void init_plan(const VariableList& target_vars) {
+        std::stringstream ss;
+        // Stream the scaling factor with enough digits to distinguish all
+        // values of the (real or complex) floating point scalar types
+        ss.precision(std::numeric_limits<long double>::max_digits10);
+        ss << typeid(Derived).name() << " " << target_vars << " " << vars_
+           << " " << left_vars_ << " " << right_vars_ << " " << factor_
+           << " " << permute_tiles_ << " " << SummaConfig::memory_limit()
+           << " " << SummaConfig::sparse_grid()
+           << " " << SummaConfig::grid_flops_per_element()
+           << " " << SummaConfig::grid_latency()
+           << " " << TileFusion::extent()
+           << " " << left_.trange() << " " << right_.trange();
+        plan_key_ = ss.str();
+
+        next_plan_ = std::make_shared<plan_type>();
+        next_plan_->left_zero = zero_flags(left_.shape(), left_.trange().tiles().volume());
+        next_plan_->right_zero = zero_flags(right_.shape(), right_.trange().tiles().volume());
+        next_plan_->left_shape = left_.shape();
+        next_plan_->right_shape = right_.shape();
+        next_plan_->world = nullptr;
+
+        plan_ = ContPlanCache::find<plan_type>(plan_key_);
+        if(plan_ && ((plan_->left_zero != next_plan_->left_zero) ||
+            (plan_->right_zero != next_plan_->right_zero)))
+          plan_.reset();
+      }
+
+      /// Compute the number of process layers for the contraction
+
+      /// The inner dimension of the contraction is divided among process
+      /// layers (2.5D SUMMA) when a 2D process grid would leave processes
+      /// idle, or when there are enough processes that the broadcast of
+      /// small argument panels dominates the communication time. Each layer
+      /// holds partial result tiles, so layers are only used when a SUMMA
+      /// memory limit is set, and the number of layers is limited such that
+      /// the partial result tiles use no more than half of it.
+      /// \param nprocs The number of processes
+      /// \param M The number of result tile rows
+      /// \param N The number of result tile columns
+      /// \param m The number of result element rows
+      /// \param n The number of result element columns
+      /// \return The number of process layers
+      size_type proc_layers(const size_type nprocs, const size_type M,
+          const size_type N, const size_type m, const size_type n) const
+      {
+        // The memory headroom for the replicated partial result tiles is
+        // only known when a memory limit is set
+        const std::size_t memory_limit = SummaConfig::memory_limit();
+        if(memory_limit == 0ul)
+          return 1ul;
+
+        // Use the processes that are idle in a 2D process grid
+        size_type layers = std::max<size_type>(nprocs / (M * N), 1ul);
+
+        // Use a 3D process grid for large process counts
+        if(nprocs >= 8ul)
+          layers = std::max<size_type>(layers, std::cbrt(double(nprocs)) + 0.01);
+
+        // Each layer must have at least one inner dimension tile
+        layers = std::min(layers, K_);
+
+        // Limit the memory used by the replicated partial result tiles
+        const double result_bytes = double(m) * double(n) * double(sizeof(scalar_type));
+        while((layers > 1ul) && ((result_bytes * layers / nprocs) > (memory_limit / 2ul)))
+          --layers;
+
+        return layers;
       }
 
       /// Initialize result tensor distribution
 
       /// This function will initialize the world and process map for the result
-      /// tensor.
+      /// tensor. The process grid of a contraction with fused tiles is
+      /// computed from the fused tiles, and each argument and result tile is
+      /// owned by the process that owns its fused tile.
       /// \param world The world were the result will be distributed
       /// \param pmap The process map for the result tensor tiles
       void init_distribution(World* world, std::shared_ptr<pmap_interface> pmap) {
         const unsigned int inner_rank = op_.gemm_helper().num_contract_ranks();
         const unsigned int left_rank = op_.gemm_helper().left_rank();
         const unsigned int right_rank = op_.gemm_helper().right_rank();
-        const unsigned int left_outer_rank = left_rank - inner_rank;
+        const unsigned int left_outer_end = left_rank - inner_rank;
+
+        // Get the (fused) argument tiled ranges and shapes
+        const trange_type& left_trange = (fuse_ ? fused_left_trange_ : left_.trange());
+        const trange_type& right_trange = (fuse_ ? fused_right_trange_ : right_.trange());
+        const typename left_type::shape_type& left_shape =
+            (fuse_ ? fused_left_shape_ : left_.shape());
+        const typename right_type::shape_type& right_shape =
+            (fuse_ ? fused_right_shape_ : right_.shape());
 
         // Get pointers to the argument sizes
         const size_type* restrict const left_tiles_size =
-            left_.trange().tiles().extent_data();
+            left_trange.tiles().extent_data();
         const size_type* restrict const left_element_size =
-            left_.trange().elements().extent_data();
+            left_trange.elements().extent_data();
         const size_type* restrict const right_tiles_size =
-            right_.trange().tiles().extent_data();
+            right_trange.tiles().extent_data();
         const size_type* restrict const right_element_size =
-            right_.trange().elements().extent_data();
+            right_trange.elements().extent_data();
 
         // Compute the fused sizes of the contraction
-        size_type M = 1ul, m = 1ul, N = 1ul, n = 1ul;
+        size_type B = 1ul, M = 1ul, m = 1ul, N = 1ul, n = 1ul, k = 1ul;
         unsigned int i = 0u;
-        for(; i < left_outer_rank; ++i) {
+        for(; i < batch_rank_; ++i)
+          B *= left_tiles_size[i];
+        for(; i < left_outer_end; ++i) {
           M *= left_tiles_size[i];
           m *= left_element_size[i];
         }
-        for(; i < left_rank; ++i)
+        for(; i < left_rank; ++i) {
           K_ *= left_tiles_size[i];
-        for(i = inner_rank; i < right_rank; ++i) {
+          k *= left_element_size[i];
+        }
+        for(i = batch_rank_ + inner_rank; i < right_rank; ++i) {
           N *= right_tiles_size[i];
           n *= right_element_size[i];
         }
 
-        // Construct the process grid.
-        proc_grid_ = TiledArray::detail::ProcGrid(*world, M, N, m, n);
+        // Construct the process grid. For sparse arguments, the grid may be
+        // selected with a cost model that uses the argument shapes.
+        // The grid of a cached plan is reused when the argument sparsity is
+        // unchanged. All batch slices of a batched contraction use the same
+        // grid.
+        if(plan_ && (plan_->world == world)) {
+          proc_grid_ = plan_->proc_grid;
+          ContPlanCache::hit();
+        } else {
+          const size_type layers = proc_layers(world->size(), M, N, m, n);
+          if(batch_rank_ || (! SummaConfig::sparse_grid()) ||
+              (left_shape.is_dense() && right_shape.is_dense()))
+            proc_grid_ = TiledArray::detail::ProcGrid(*world, M, N, m, n, layers);
+          else
+            proc_grid_ = TiledArray::detail::ProcGrid(*world, M, N, m, n, K_, k,
+                left_shape, right_shape, layers,
+                SummaConfig::grid_flops_per_element(),
+                SummaConfig::grid_latency());
+        }
 
-        // Initialize children
-        left_.init_distribution(world, proc_grid_.make_row_phase_pmap(K_));
-        right_.init_distribution(world, proc_grid_.make_col_phase_pmap(K_));
+        // Cache the plan for this contraction
+        if(next_plan_) {
+          next_plan_->world = world;
+          next_plan_->proc_grid = proc_grid_;
+          ContPlanCache::insert(plan_key_, next_plan_);
+          next_plan_.reset();
+        }
+        plan_.reset();
+
+        if(batch_rank_) {
+          // Distribute each batch slice of the children and the result with
+          // the process grid, where consecutive slices are shifted past the
+          // processes of the grid so that grids that include only part of
+          // world are spread across processes
+          const size_type stride = proc_grid_.proc_span();
+          left_.init_distribution(world, std::make_shared<TiledArray::detail::BatchPmap>(
+              *world, B, proc_grid_.make_row_phase_pmap(K_), stride));
+          right_.init_distribution(world, std::make_shared<TiledArray::detail::BatchPmap>(
+              *world, B, proc_grid_.make_col_phase_pmap(K_), stride));
+          if(! pmap)
+            pmap = std::make_shared<TiledArray::detail::BatchPmap>(*world, B,
+                proc_grid_.make_pmap(), stride);
+        } else if(fuse_) {
+          // Distribute the tiles of the children and the result such that
+          // the tiles of each fused tile are owned by the same process
+          left_fused_index_ = std::make_shared<const std::vector<std::size_t> >(
+              TiledArray::detail::fused_tile_index(left_.trange(), fused_left_trange_));
+          right_fused_index_ = std::make_shared<const std::vector<std::size_t> >(
+              TiledArray::detail::fused_tile_index(right_.trange(), fused_right_trange_));
+          fused_index_ = std::make_shared<const std::vector<std::size_t> >(
+              TiledArray::detail::fused_tile_index(trange_, fused_trange_));
+          left_.init_distribution(world, std::make_shared<TiledArray::detail::FusedPmap>(
+              *world, proc_grid_.make_row_phase_pmap(K_), left_fused_index_));
+          right_.init_distribution(world, std::make_shared<TiledArray::detail::FusedPmap>(
+              *world, proc_grid_.make_col_phase_pmap(K_), right_fused_index_));
+          if(! pmap)
+            pmap = std::make_shared<TiledArray::detail::FusedPmap>(*world,
+                proc_grid_.make_pmap(), fused_index_);
+        } else {
+          // Initialize children
+          left_.init_distribution(world, proc_grid_.make_row_phase_pmap(K_));
+          right_.init_distribution(world, proc_grid_.make_col_phase_pmap(K_));
 
-        // Initialize the process map in not already defined
-        if(! pmap)
-          pmap = proc_grid_.make_pmap();
+          // Initialize the process map in not already defined
+          if(! pmap)
+            pmap = proc_grid_.make_pmap();
+        }
         ExprEngine_::init_distribution(world, pmap);
       }
 
+      /// Construct the SUMMA evaluator for this expression
+
+      /// \param shape The shape of the result
+      /// \return The SUMMA evaluator implementation
+      std::shared_ptr<TiledArray::detail::Summa<typename left_type::dist_eval_type,
+          typename right_type::dist_eval_type, op_type, policy> >
+      make_summa(const shape_type& shape) const {
+        // Define the impl type
+        typedef TiledArray::detail::Summa<typename left_type::dist_eval_type,
+            typename right_type::dist_eval_type, op_type, policy> impl_type;
+
+        typename left_type::dist_eval_type left = left_.make_dist_eval();
+        typename right_type::dist_eval_type right = right_.make_dist_eval();
+
+        return std::shared_ptr<impl_type>(
+            new impl_type(left, right, *world_, trange_, shape, pmap_, perm_,
+            op_, K_, proc_grid_));
+      }
+
       /// Tiled range factory function
 
       /// \param perm The permutation to be applied to the array
       /// \return The result tiled range
       trange_type make_trange(const Permutation& perm = Permutation()) const {
+        return make_trange(left_.trange(), right_.trange(), perm);
+      }
+
+      /// Tiled range factory function
+
+      /// \param left_trange The left-hand argument tiled range
+      /// \param right_trange The right-hand argument tiled range
+      /// \param perm The permutation to be applied to the array
+      /// \return The result tiled range
+      trange_type make_trange(const trange_type& left_trange,
+          const trange_type& right_trange, const Permutation& perm) const
+      {
         // Compute iteration limits
         const unsigned int left_rank = op_.gemm_helper().left_rank();
         const unsigned int right_rank = op_.gemm_helper().right_rank();
         const unsigned int inner_rank = op_.gemm_helper().num_contract_ranks();
-        const unsigned int left_outer_rank = left_rank - inner_rank;
+        const unsigned int left_outer_end = left_rank - inner_rank;
 
         // Construct the trange input and compute the gemm sizes
         typename trange_type::Ranges ranges(op_.gemm_helper().result_rank());
         unsigned int i = 0ul;
-        for(unsigned int x = 0ul; x < left_outer_rank; ++x, ++i) {
+        for(unsigned int x = 0ul; x < left_outer_end; ++x, ++i) {
           const unsigned int pi = (perm ? perm[i] : i);
-          ranges[pi] = left_.trange().data()[x];
+          ranges[pi] = left_trange.data()[x];
         }
-        for(unsigned int x = inner_rank; x < right_rank; ++x, ++i) {
+        for(unsigned int x = batch_rank_ + inner_rank; x < right_rank; ++x, ++i) {
           const unsigned int pi = (perm ? perm[i] : i);
-          ranges[pi] = right_.trange().data()[x];
+          ranges[pi] = right_trange.data()[x];
         }
 
 #ifndef NDEBUG
 
         // Get left and right tile extents.
         const auto* restrict const left_extent =
-            left_.trange().tiles().extent_data();
+            left_trange.tiles().extent_data();
         const auto* restrict const right_extent =
-            right_.trange().tiles().extent_data();
+            right_trange.tiles().extent_data();
 
-        // Check that the contracted dimensions are coformal (equal).
-        for(unsigned int l = left_outer_rank, r = 0ul; l < left_rank; ++l, ++r) {
-          if(left_.trange().data()[l] != right_.trange().data()[r]) {
+        // Check that the batch and contracted dimensions are coformal (equal).
+        for(unsigned int r = 0u; r < (batch_rank_ + inner_rank); ++r) {
+          const unsigned int l = (r < batch_rank_ ? r : r - batch_rank_ + left_outer_end);
+          if(left_trange.data()[l] != right_trange.data()[r]) {
             if(World::get_default().rank() == 0) {
 
               if(left_extent[l] == right_extent[r]) {
@@ -467,8 +1041,8 @@ namespace TiledArray {
               } else {
                 TA_USER_ERROR_MESSAGE( "The contracted dimensions of the left- " \
                     "and right-hand arguments are not coformal:" \
-                    << "\n    left  = " << left_.trange() \
-                    << "\n    right = " << right_.trange() );
+                    << "\n    left  = " << left_trange \
+                    << "\n    right = " << right_trange );
 
                 TA_EXCEPTION("The contracted dimensions of the left- and " \
                     "right-hand expressions are not coformal.");
@@ -491,7 +1065,7 @@ namespace TiledArray {
         const TiledArray::math::GemmHelper
         shape_gemm_helper(madness::cblas::NoTrans, madness::cblas::NoTrans,
             op_.gemm_helper().result_rank(), op_.gemm_helper().left_rank(),
-            op_.gemm_helper().right_rank());
+            op_.gemm_helper().right_rank(), batch_rank_);
         return left_.shape().gemm(right_.shape(), factor_, shape_gemm_helper);
       }
 
@@ -503,22 +1077,194 @@ namespace TiledArray {
         const TiledArray::math::GemmHelper
         shape_gemm_helper(madness::cblas::NoTrans, madness::cblas::NoTrans,
             op_.gemm_helper().result_rank(), op_.gemm_helper().left_rank(),
-            op_.gemm_helper().right_rank());
+            op_.gemm_helper().right_rank(), batch_rank_);
         return left_.shape().gemm(right_.shape(), factor_, shape_gemm_helper, perm);
       }
 
-      dist_eval_type make_dist_eval() const {
-        // Define the impl type
-        typedef TiledArray::detail::Summa<typename left_type::dist_eval_type,
-            typename right_type::dist_eval_type, op_type, typename Derived::policy> impl_type;
+      /// Batch slice of a tiled range
+
+      /// \tparam TR The tiled range type
+      /// \param trange The tiled range, where the batch dimensions lead
+      /// \param batch_index The tile index of the batch dimensions
+      /// \return The tiled range of the slice, where each batch dimension is
+      /// the batch tile of \c trange
+      template <typename TR>
+      static TR make_batch_trange(const TR& trange,
+          const std::vector<size_type>& batch_index)
+      {
+        typename TR::Ranges ranges(trange.data());
+        for(unsigned int i = 0u; i < batch_index.size(); ++i) {
+          const auto& tile = trange.data()[i].tile(batch_index[i]);
+          const size_type bounds[2] = { tile.first, tile.second };
+          ranges[i] = TiledRange1(bounds, bounds + 2);
+        }
+        return TR(ranges.begin(), ranges.end());
+      }
 
-        typename left_type::dist_eval_type left = left_.make_dist_eval();
-        typename right_type::dist_eval_type right = right_.make_dist_eval();
+      /// Batch slice of a shape
+
+      /// \tparam S The shape type
+      /// \tparam TR The tiled range type
+      /// \param shape The shape, where the batch dimensions lead
+      /// \param trange The tiled range of \c shape
+      /// \param batch_index The tile index of the batch dimensions
+      /// \return The shape of the slice
+      template <typename S, typename TR>
+      static S make_batch_shape(const S& shape, const TR& trange,
+          const std::vector<size_type>& batch_index)
+      {
+        const unsigned int rank = trange.tiles().rank();
+        std::vector<size_type> lower(trange.tiles().lobound_data(),
+            trange.tiles().lobound_data() + rank);
+        std::vector<size_type> upper(trange.tiles().upbound_data(),
+            trange.tiles().upbound_data() + rank);
+        for(unsigned int i = 0u; i < batch_index.size(); ++i) {
+          lower[i] = batch_index[i];
+          upper[i] = batch_index[i] + 1ul;
+        }
+        return shape.block(lower, upper);
+      }
 
-        std::shared_ptr<impl_type> pimpl(
-            new impl_type(left, right, *world_, trange_, shape_, pmap_, perm_,
-            op_, K_, proc_grid_));
+      /// Construct the distributed evaluator for a batched contraction
+
+      /// Each batch slice of the result (i.e. each tile of the batch
+      /// dimensions) is evaluated by a separate SUMMA evaluator, which
+      /// contracts the corresponding slices of the arguments. The slices use
+      /// copies of the process grid that are shifted by the slice index (see
+      /// \c TiledArray::detail::BatchPmap ), and they are evaluated
+      /// concurrently.
+      /// \return The distributed evaluator that will evaluate this expression
+      dist_eval_type make_batch_dist_eval() const {
+        typedef typename left_type::dist_eval_type left_dist_eval_type;
+        typedef typename right_type::dist_eval_type right_dist_eval_type;
+        typedef TiledArray::detail::BatchSliceEvalImpl<left_dist_eval_type> left_slice_type;
+        typedef TiledArray::detail::BatchSliceEvalImpl<right_dist_eval_type> right_slice_type;
+        typedef TiledArray::detail::Summa<left_dist_eval_type,
+            right_dist_eval_type, op_type, policy> summa_type;
+        typedef TiledArray::detail::BatchEvalImpl<left_dist_eval_type,
+            right_dist_eval_type, dist_eval_type, policy> impl_type;
+
+        left_dist_eval_type left = left_.make_dist_eval();
+        right_dist_eval_type right = right_.make_dist_eval();
+
+        // Compute the number of batch tiles
+        const trange_type result_trange = ContEngine_::make_trange();
+        const size_type* restrict const batch_lower = result_trange.tiles().lobound_data();
+        const size_type* restrict const batch_extent = result_trange.tiles().extent_data();
+        size_type batches = 1ul;
+        for(unsigned int i = 0u; i < batch_rank_; ++i)
+          batches *= batch_extent[i];
+
+        // Construct the SUMMA evaluator of each batch slice
+        std::vector<dist_eval_type> slices;
+        slices.reserve(batches);
+        std::vector<size_type> batch_index(batch_rank_);
+        for(size_type b = 0ul; b < batches; ++b) {
+          // Compute the tile index of the batch dimensions
+          size_type x = b;
+          for(unsigned int i = batch_rank_; i > 0u; --i) {
+            batch_index[i - 1u] = batch_lower[i - 1u] + (x % batch_extent[i - 1u]);
+            x /= batch_extent[i - 1u];
+          }
+
+          // Construct the process grid and process maps of the slice, which
+          // match the distribution of the arguments and the result (see
+          // init_distribution() )
+          const TiledArray::detail::ProcGrid proc_grid =
+              proc_grid_.shift(b * proc_grid_.proc_span());
+          const std::shared_ptr<pmap_interface> left_pmap =
+              proc_grid.make_row_phase_pmap(K_);
+          const std::shared_ptr<pmap_interface> right_pmap =
+              proc_grid.make_col_phase_pmap(K_);
+
+          left_dist_eval_type left_slice(std::make_shared<left_slice_type>(left,
+              *world_, make_batch_trange(left_.trange(), batch_index),
+              make_batch_shape(left_.shape(), left_.trange(), batch_index),
+              left_pmap, b * left_pmap->size()));
+          right_dist_eval_type right_slice(std::make_shared<right_slice_type>(right,
+              *world_, make_batch_trange(right_.trange(), batch_index),
+              make_batch_shape(right_.shape(), right_.trange(), batch_index),
+              right_pmap, b * right_pmap->size()));
+
+          slices.push_back(dist_eval_type(std::make_shared<summa_type>(left_slice,
+              right_slice, *world_, make_batch_trange(result_trange, batch_index),
+              make_batch_shape(batch_shape_, result_trange, batch_index),
+              proc_grid.make_pmap(), Permutation(), op_, K_, proc_grid)));
+        }
+
+        return dist_eval_type(std::make_shared<impl_type>(left, right, slices,
+            *world_, trange_, shape_, pmap_, perm_));
+      }
+
+      /// Tile fusion is not supported for these tile types
+      dist_eval_type make_fused_dist_eval(std::false_type) const {
+        return dist_eval_type(make_summa(shape_));
+      }
+
+      /// Construct the distributed evaluator for a contraction with fused tiles
+
+      /// The tiles of the arguments are fused, the fused tiles are contracted
+      /// with SUMMA, and the fused result tiles are split to the tiles of the
+      /// result.
+      /// \return The distributed evaluator that will evaluate this expression
+      dist_eval_type make_fused_dist_eval(std::true_type) const {
+        typedef TiledArray::detail::FuseEvalImpl<typename left_type::dist_eval_type,
+            policy> left_fuse_type;
+        typedef TiledArray::detail::FuseEvalImpl<typename right_type::dist_eval_type,
+            policy> right_fuse_type;
+        typedef TiledArray::detail::DistEval<typename left_fuse_type::value_type,
+            policy> left_dist_eval_type;
+        typedef TiledArray::detail::DistEval<typename right_fuse_type::value_type,
+            policy> right_dist_eval_type;
+        typedef TiledArray::detail::Summa<left_dist_eval_type,
+            right_dist_eval_type, op_type, policy> summa_type;
+        typedef TiledArray::detail::SplitEvalImpl<dist_eval_type, policy> impl_type;
+
+        // The fused tiles are distributed with the process grid, which
+        // matches the distribution of the arguments (see init_distribution() )
+        left_dist_eval_type left(std::make_shared<left_fuse_type>(
+            left_.make_dist_eval(), *world_, fused_left_trange_, fused_left_shape_,
+            proc_grid_.make_row_phase_pmap(K_), left_fused_index_));
+        right_dist_eval_type right(std::make_shared<right_fuse_type>(
+            right_.make_dist_eval(), *world_, fused_right_trange_, fused_right_shape_,
+            proc_grid_.make_col_phase_pmap(K_), right_fused_index_));
+        dist_eval_type fused(std::make_shared<summa_type>(left, right, *world_,
+            fused_trange_, fused_shape_, proc_grid_.make_pmap(), perm_, op_, K_,
+            proc_grid_));
+
+        TileFusion::fused();
+        return dist_eval_type(std::make_shared<impl_type>(fused, *world_,
+            trange_, shape_, pmap_, fused_index_));
+      }
+
+      /// Construct the distributed evaluator for this expression
+
+      /// \return The distributed evaluator that will evaluate this expression
+      dist_eval_type make_dist_eval() const {
+        if(batch_rank_)
+          return make_batch_dist_eval();
+        if(fuse_)
+          return make_fused_dist_eval(is_fusable());
+        return dist_eval_type(make_summa(shape_));
+      }
 
+      /// Construct a distributed evaluator that adds this expression to an array
+
+      /// The tiles of \c target are the initial values of the result tile
+      /// reductions, and they are updated in place. The result of this
+      /// expression must not be permuted or evaluated with fused tiles, and
+      /// its tiled range must be equal to that of \c target.
+      /// \tparam A The array type
+      /// \param target The array that the result of this expression is added to
+      /// \return The distributed evaluator that will evaluate the sum of
+      /// \c target and this expression
+      template <typename A>
+      dist_eval_type make_dist_eval(const A& target) const {
+        TA_ASSERT(! perm_);
+        TA_ASSERT(! batch_rank_);
+        TA_ASSERT(! fuse_);
+        auto pimpl = make_summa(shape_.add(target.get_shape()));
+        pimpl->accumulate_to(target);
         return dist_eval_type(pimpl);
       }
 
@@ -0,0 +1,271 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_CONT_PATH_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_CONT_PATH_H__INCLUDED
+
+#include <TiledArray/expressions/variable_list.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace TiledArray {
+  namespace expressions {
+
+    /// Contraction operand summary
+
+    /// The data of an expression that is used to estimate the cost of
+    /// contracting it with other expressions.
+    struct ContPathArg {
+      std::vector<std::string> vars; ///< The variables of the expression
+      std::vector<double> extents; ///< The number of elements of each variable
+      std::vector<double> tiles; ///< The number of tiles of each variable
+      double density; ///< The fraction of non-zero tiles
+
+      /// Find a variable
+
+      /// \param var The variable to find
+      /// \return The position of \c var, or the rank if it is not present
+      std::size_t find(const std::string& var) const {
+        return std::find(vars.begin(), vars.end(), var) - vars.begin();
+      }
+
+      /// Check for a variable
+
+      /// \param var The variable to find
+      /// \return \c true if \c var is a variable of this expression
+      bool has(const std::string& var) const { return find(var) < vars.size(); }
+    }; // struct ContPathArg
+
+    /// Contraction path optimizer
+
+    /// When the optimizer is enabled, a product of three expressions, such as
+    /// <tt>A("i,k") * B("k,l") * C("l,j")</tt>, is evaluated in the order
+    /// with the smallest estimated cost, instead of the order in which the
+    /// products are written. The cost of each order is the number of
+    /// floating point operations of its two contractions, where the
+    /// contraction of sparse arguments is scaled by the fraction of non-zero
+    /// tiles of both arguments. The shape of the intermediate result is
+    /// computed from the argument shapes as it is for the evaluation. The
+    /// intermediate result is not stored; it is evaluated as the argument of
+    /// the outer contraction, as it is for products that are written in that
+    /// order.
+    /// \note The products are reordered only when all products of either
+    /// order are contractions, and each variable appears in exactly two of
+    /// the three arguments and the result. Only the outermost product of an
+    /// assigned expression is considered: in a product of four or more
+    /// expressions, e.g. <tt>A * B * C * D</tt> , the outermost product is
+    /// reordered only when one of its arguments is not a product, and the
+    /// nested products are evaluated in the order in which they are
+    /// written. Reordering may change the rounding of floating point
+    /// results.
+    class ContPathOptimizer {
+    private:
+
+      static std::atomic<bool>& enabled_() {
+        static std::atomic<bool> enabled(false);
+        return enabled;
+      }
+
+      static std::mutex& mutex_() {
+        static std::mutex mutex;
+        return mutex;
+      }
+
+      static std::size_t& reorders_() {
+        static std::size_t reorders = 0ul;
+        return reorders;
+      }
+
+      /// Count the variables that two expressions share
+
+      /// \param left The left-hand expression
+      /// \param right The right-hand expression
+      /// \return The number of variables of \c left that are in \c right
+      static std::size_t count_common(const ContPathArg& left, const ContPathArg& right) {
+        std::size_t count = 0ul;
+        for(const std::string& var : left.vars)
+          if(right.has(var))
+            ++count;
+        return count;
+      }
+
+    public:
+
+      /// Check that the optimizer is enabled
+
+      /// \return \c true if products of three expressions are reordered
+      static bool enabled() { return enabled_().load(std::memory_order_relaxed); }
+
+      /// Enable or disable the optimizer
+
+      /// \param enable If \c true, products of three expressions are evaluated
+      /// in the order with the smallest estimated cost [ default = true ]
+      static void enable(const bool enable = true) { enabled_() = enable; }
+
+      /// Number of reordered products
+
+      /// \return The number of products that were evaluated in a different
+      /// order than they were written on this process
+      static std::size_t reorders() {
+        std::lock_guard<std::mutex> lock(mutex_());
+        return reorders_();
+      }
+
+      /// Reset the reordered product counter
+      static void clear() {
+        std::lock_guard<std::mutex> lock(mutex_());
+        reorders_() = 0ul;
+      }
+
+      /// Record a reordered product
+      static void reordered() {
+        std::lock_guard<std::mutex> lock(mutex_());
+        ++reorders_();
+      }
+
+      /// Construct the summary of an expression
+
+      /// The variable list and the structure of the expression are
+      /// initialized, but the expression is not evaluated.
+      /// \tparam Engine The expression engine type
+      /// \tparam E The expression type
+      /// \param expr The expression
+      /// \return The summary of \c expr
+      template <typename Engine, typename E>
+      static ContPathArg make_arg(const E& expr) {
+        Engine engine(expr);
+        engine.init_vars();
+        engine.init_struct(engine.vars());
+
+        const unsigned int rank = engine.vars().dim();
+        ContPathArg arg;
+        arg.vars = engine.vars().data();
+        arg.extents.assign(engine.trange().elements().extent_data(),
+            engine.trange().elements().extent_data() + rank);
+        arg.tiles.assign(engine.trange().tiles().extent_data(),
+            engine.trange().tiles().extent_data() + rank);
+        arg.density = 1.0 - double(engine.shape().sparsity());
+        return arg;
+      }
+
+      /// Check that the product of two expressions is a contraction
+
+      /// \param left The left-hand expression
+      /// \param right The right-hand expression
+      /// \return \c true if \c left and \c right share some, but not all,
+      /// variables
+      static bool is_contraction(const ContPathArg& left, const ContPathArg& right) {
+        const std::size_t common = count_common(left, right);
+        return (common > 0ul) && ((common < left.vars.size()) ||
+            (common < right.vars.size()));
+      }
+
+      /// Check that a product of three expressions may be reordered
+
+      /// \param a The first expression
+      /// \param b The second expression
+      /// \param c The third expression
+      /// \param target_vars The variable list of the result
+      /// \return \c true if <tt>(a * b) * c</tt> and <tt>a * (b * c)</tt> are
+      /// both products of contractions with the same result
+      static bool is_reorderable(const ContPathArg& a, const ContPathArg& b,
+          const ContPathArg& c, const VariableList& target_vars)
+      {
+        // Each variable must appear in exactly two of the arguments and result
+        std::vector<std::string> vars(a.vars);
+        vars.insert(vars.end(), b.vars.begin(), b.vars.end());
+        vars.insert(vars.end(), c.vars.begin(), c.vars.end());
+        vars.insert(vars.end(), target_vars.begin(), target_vars.end());
+        for(const std::string& var : vars)
+          if(std::count(vars.begin(), vars.end(), var) != 2)
+            return false;
+
+        return is_contraction(a, b) && is_contraction(contract(a, b), c) &&
+            is_contraction(b, c) && is_contraction(a, contract(b, c));
+      }
+
+      /// Summary of the contraction of two expressions
+
+      /// The density of the result is estimated from the argument densities,
+      /// assuming the non-zero tiles of the arguments are independent.
+      /// \param left The left-hand expression
+      /// \param right The right-hand expression
+      /// \return The summary of the contraction of \c left and \c right
+      static ContPathArg contract(const ContPathArg& left, const ContPathArg& right) {
+        ContPathArg result;
+        double inner_tiles = 1.0;
+        for(std::size_t i = 0ul; i < left.vars.size(); ++i) {
+          if(right.has(left.vars[i])) {
+            inner_tiles *= left.tiles[i];
+          } else {
+            result.vars.push_back(left.vars[i]);
+            result.extents.push_back(left.extents[i]);
+            result.tiles.push_back(left.tiles[i]);
+          }
+        }
+        for(std::size_t i = 0ul; i < right.vars.size(); ++i) {
+          if(! left.has(right.vars[i])) {
+            result.vars.push_back(right.vars[i]);
+            result.extents.push_back(right.extents[i]);
+            result.tiles.push_back(right.tiles[i]);
+          }
+        }
+        result.density = 1.0 - std::pow(1.0 - left.density * right.density, inner_tiles);
+        return result;
+      }
+
+      /// Estimate the cost of a contraction
+
+      /// \param left The left-hand expression
+      /// \param right The right-hand expression
+      /// \return The expected number of floating point operations of the
+      /// contraction of \c left and \c right
+      static double cost(const ContPathArg& left, const ContPathArg& right) {
+        double flops = 2.0 * left.density * right.density;
+        for(const double extent : left.extents)
+          flops *= extent;
+        for(std::size_t i = 0ul; i < right.vars.size(); ++i)
+          if(! left.has(right.vars[i]))
+            flops *= right.extents[i];
+        return flops;
+      }
+
+      /// Estimate the cost of a product of three expressions
+
+      /// \param a The first expression
+      /// \param b The second expression
+      /// \param ab The intermediate result of \c a and \c b
+      /// \param c The third expression
+      /// \return The estimated cost of <tt>(a * b) * c</tt>
+      static double cost(const ContPathArg& a, const ContPathArg& b,
+          const ContPathArg& ab, const ContPathArg& c)
+      {
+        return cost(a, b) + cost(ab, c);
+      }
+
+    }; // class ContPathOptimizer
+
+  }  // namespace expressions
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_CONT_PATH_H__INCLUDED
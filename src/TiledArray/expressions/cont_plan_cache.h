@@ -0,0 +1,232 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_CONT_PLAN_CACHE_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_CONT_PLAN_CACHE_H__INCLUDED
+
+#include <TiledArray/proc_grid.h>
+#include <TiledArray/dense_shape.h>
+#include <TiledArray/sparse_shape.h>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace TiledArray {
+  namespace expressions {
+
+    template <typename> class ContEngine;
+
+    /// Contraction plan
+
+    /// The decisions of a contraction expression engine that depend on the
+    /// argument shapes.
+    /// \tparam LeftShape The left-hand argument shape type
+    /// \tparam RightShape The right-hand argument shape type
+    /// \tparam Shape The result shape type
+    template <typename LeftShape, typename RightShape, typename Shape>
+    struct ContPlan {
+      std::vector<bool> left_zero; ///< Zero tile flags of the left-hand argument
+      std::vector<bool> right_zero; ///< Zero tile flags of the right-hand argument
+      LeftShape left_shape; ///< The left-hand argument shape used to compute \c shape
+      RightShape right_shape; ///< The right-hand argument shape used to compute \c shape
+      Shape shape; ///< The result shape
+      World* world; ///< The world of \c proc_grid
+      TiledArray::detail::ProcGrid proc_grid; ///< Process grid of the contraction
+    }; // struct ContPlan
+
+    /// Compare dense shapes
+
+    /// \return \c true
+    inline bool is_same_shape(const DenseShape&, const DenseShape&) { return true; }
+
+    /// Compare sparse shapes
+
+    /// \tparam T The shape value type
+    /// \param left The first shape
+    /// \param right The second shape
+    /// \return \c true if the tile norms of \c left and \c right are equal,
+    /// otherwise \c false
+    template <typename T>
+    inline bool is_same_shape(const SparseShape<T>& left, const SparseShape<T>& right) {
+      const Tensor<T>& left_norms = left.data();
+      const Tensor<T>& right_norms = right.data();
+      if(left_norms.data() == right_norms.data())
+        return true;
+      if(left_norms.empty() || right_norms.empty() ||
+          (left_norms.range() != right_norms.range()))
+        return false;
+      return std::equal(left_norms.data(), left_norms.data() + left_norms.size(),
+          right_norms.data());
+    }
+
+    /// Cache of contraction plans
+
+    /// When the cache is enabled, contraction expressions store the process
+    /// grid and the result shape that are selected during initialization, and
+    /// they reuse them when the same contraction is evaluated again. Plans
+    /// are keyed on the expression type, variable lists, scaling factor, and
+    /// the tiled ranges of the arguments. A cached process grid is reused when
+    /// the zero tiles of the argument shapes are unchanged, and a cached
+    /// result shape is reused when the argument shapes are unchanged. This is
+    /// intended for iterative algorithms that evaluate the same expressions
+    /// many times.
+    /// \note The cache is process-local. The cached decisions are identical
+    /// to the decisions they replace, so processes may hit or miss the cache
+    /// independently. Changing the zero threshold of \c SparseShape
+    /// requires the cache to be cleared.
+    class ContPlanCache {
+    private:
+      template <typename>
+      friend class ContEngine;
+
+      /// Cache entry
+      struct Entry {
+        std::string key; ///< The plan key
+        std::shared_ptr<const void> plan; ///< The cached plan
+      }; // struct Entry
+
+      static std::atomic<bool>& enabled_() {
+        static std::atomic<bool> enabled(false);
+        return enabled;
+      }
+
+      static std::mutex& mutex_() {
+        static std::mutex mutex;
+        return mutex;
+      }
+
+      static std::deque<Entry>& entries_() {
+        static std::deque<Entry> entries;
+        return entries;
+      }
+
+      static std::size_t& capacity_() {
+        static std::size_t capacity = 64ul;
+        return capacity;
+      }
+
+      static std::size_t& hits_() {
+        static std::size_t hits = 0ul;
+        return hits;
+      }
+
+      /// Find a cached plan
+
+      /// \tparam Plan The plan type, which must be encoded in \c key
+      /// \param key The plan key
+      /// \return The plan for \c key, or an empty pointer if it is not cached
+      template <typename Plan>
+      static std::shared_ptr<const Plan> find(const std::string& key) {
+        std::lock_guard<std::mutex> lock(mutex_());
+        for(const Entry& entry : entries_())
+          if(entry.key == key)
+            return std::static_pointer_cast<const Plan>(entry.plan);
+        return std::shared_ptr<const Plan>();
+      }
+
+      /// Record a cache hit
+      static void hit() {
+        std::lock_guard<std::mutex> lock(mutex_());
+        ++hits_();
+      }
+
+      /// Add a plan to the cache
+
+      /// The plan replaces the plan with the same key, if any. When the cache
+      /// is full, the oldest plan is discarded.
+      /// \param key The plan key
+      /// \param plan The plan for \c key
+      static void insert(const std::string& key, const std::shared_ptr<const void>& plan) {
+        std::lock_guard<std::mutex> lock(mutex_());
+        std::deque<Entry>& entries = entries_();
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+            [&] (const Entry& entry) { return entry.key == key; }), entries.end());
+        if(capacity_() == 0ul)
+          return;
+        while(entries.size() >= capacity_())
+          entries.pop_front();
+        entries.push_back(Entry{ key, plan });
+      }
+
+    public:
+
+      /// Check that the cache is enabled
+
+      /// \return \c true if contraction plans are cached on this process
+      static bool enabled() { return enabled_().load(std::memory_order_relaxed); }
+
+      /// Enable or disable the cache
+
+      /// Disabling the cache does not discard cached plans.
+      /// \param enable If \c true, contraction plans are cached [ default = true ]
+      static void enable(const bool enable = true) { enabled_() = enable; }
+
+      /// Cache capacity accessor
+
+      /// \return The maximum number of cached plans
+      static std::size_t capacity() {
+        std::lock_guard<std::mutex> lock(mutex_());
+        return capacity_();
+      }
+
+      /// Set the cache capacity
+
+      /// \param capacity The maximum number of cached plans [ default = 64 ]
+      static void set_capacity(const std::size_t capacity) {
+        std::lock_guard<std::mutex> lock(mutex_());
+        capacity_() = capacity;
+        std::deque<Entry>& entries = entries_();
+        while(entries.size() > capacity)
+          entries.pop_front();
+      }
+
+      /// Number of cached plans
+
+      /// \return The number of plans in the cache
+      static std::size_t size() {
+        std::lock_guard<std::mutex> lock(mutex_());
+        return entries_().size();
+      }
+
+      /// Number of cache hits
+
+      /// \return The number of contractions that reused a cached process grid
+      /// on this process
+      static std::size_t hits() {
+        std::lock_guard<std::mutex> lock(mutex_());
+        return hits_();
+      }
+
+      /// Discard all cached plans and reset the hit counter
+      static void clear() {
+        std::lock_guard<std::mutex> lock(mutex_());
+        entries_().clear();
+        hits_() = 0ul;
+      }
+
+    }; // class ContPlanCache
+
+  }  // namespace expressions
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_CONT_PLAN_CACHE_H__INCLUDED
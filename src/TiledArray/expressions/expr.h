@@ -31,6 +31,7 @@
 #include <TiledArray/tile_op/unary_reduction.h>
 #include <TiledArray/tile_op/binary_reduction.h>
 #include <TiledArray/tile_op/reduce_wrapper.h>
+#include <type_traits>
 
 namespace TiledArray {
 
@@ -118,6 +119,18 @@ namespace TiledArray {
         typename engine_type::dist_eval_type dist_eval = engine.make_dist_eval();
         dist_eval.eval();
 
+        return make_array<A>(dist_eval);
+      }
+
+      /// Array factor function
+
+      /// Construct an array that will hold the result of an evaluated
+      /// distributed evaluator
+      /// \tparam A The output array type
+      /// \tparam D The distributed evaluator type
+      /// \param dist_eval The distributed evaluator, which has been evaluated
+      template <typename A, typename D>
+      A make_array(D& dist_eval) const {
         // Create the result array
         A result(dist_eval.get_world(), dist_eval.trange(),
             dist_eval.shape(), dist_eval.pmap());
@@ -172,6 +185,67 @@ namespace TiledArray {
         make_array<A>(world, pmap, target_vars).swap(tsr.array());
       }
 
+      /// Evaluate this contraction and add it to \c tsr in place
+
+      /// The tiles of \c tsr are used as the initial values of the tile
+      /// reductions of the contraction, so the result is accumulated without
+      /// a temporary array, and the process map of \c tsr is reused. This is
+      /// only done when this expression is a contraction that does not
+      /// depend on \c tsr, its result has the same variable list and tiled
+      /// range as \c tsr, and it is not evaluated with fused tiles (see
+      /// \c TileFusion ); otherwise nothing is done.
+      /// \tparam A The array type
+      /// \param tsr The tensor that the result of this expression is added to
+      /// \return \c true if the result was added to \c tsr, otherwise \c false
+      /// \note Each reduction is seeded with a deep copy of the target tile,
+      /// so shallow copies of the array or its tiles keep their values.
+      template <typename A>
+      bool eval_add_to(TsrExpr<A>& tsr) const {
+        return eval_add_to(tsr, std::integral_constant<bool,
+            std::is_same<typename A::value_type, typename engine_type::value_type>::value &&
+            std::is_same<typename A::shape_type, typename engine_type::shape_type>::value>());
+      }
+
+    private:
+
+      template <typename A>
+      bool eval_add_to(TsrExpr<A>&, std::false_type) const { return false; }
+
+      template <typename A>
+      bool eval_add_to(TsrExpr<A>& tsr, std::true_type) const {
+        A& array = tsr.array();
+        if(! array.is_initialized())
+          return false;
+
+        // Check that the result does not need to be permuted, and that
+        // the array is not an argument of this expression.
+        const VariableList target_vars(tsr.vars());
+        {
+          engine_type engine(derived());
+          engine.init_vars(target_vars);
+          if(! engine.is_contraction() || (engine.vars() != target_vars) ||
+              engine.depends_on(array.id()))
+            return false;
+        }
+
+        // Construct the expression engine
+        engine_type engine(derived());
+        engine.init(array.get_world(), array.get_pmap(), target_vars);
+        if((engine.trange() != array.trange()) || (engine.pmap() != array.get_pmap()) ||
+            engine.is_fused())
+          return false;
+
+        // Create the distributed evaluator that adds this expression to array
+        typename engine_type::dist_eval_type dist_eval = engine.make_dist_eval(array);
+        dist_eval.eval();
+
+        // Swap the new array with the result array object.
+        make_array<A>(dist_eval).swap(array);
+        return true;
+      }
+
+    public:
+
       /// Array conversion operator
 
       /// \tparam T The array element type
@@ -151,6 +151,12 @@ namespace TiledArray {
       make_shape(const Permutation& perm) { return array_.get_shape().perm(perm); }
 
 
+      /// Check that this expression depends on an array
+
+      /// \param id The id of the array
+      /// \return \c true if the array of this expression has the id \c id
+      bool depends_on(const madness::uniqueidT& id) const { return array_.id() == id; }
+
       /// Construct the distributed evaluator for array
       dist_eval_type make_dist_eval() const {
         // Define the distributed evaluator implementation type
@@ -39,6 +39,8 @@ namespace TiledArray {
     template <typename, typename> class ScalMultExpr;
     template <typename, typename> class MultEngine;
     template <typename, typename> class ScalMultEngine;
+    template <typename, typename, typename> class MixedMultExpr;
+    template <typename, typename, typename> class MixedMultEngine;
 
     template <typename Left, typename Right>
     struct EngineTrait<MultEngine<Left, Right> > :
@@ -50,6 +52,37 @@ namespace TiledArray {
       public BinaryEngineTrait<Left, Right, TiledArray::math::ScalMult>
     { };
 
+    template <typename Left, typename Right, typename Result>
+    struct EngineTrait<MixedMultEngine<Left, Right, Result> > {
+      static_assert(std::is_same<typename EngineTrait<Left>::policy,
+          typename EngineTrait<Right>::policy>::value,
+          "The left- and right-hand expressions must use the same policy class");
+
+      // Argument typedefs
+      typedef Left left_type; ///< The left-hand expression type
+      typedef Right right_type; ///< The right-hand expression type
+
+      // Operational typedefs
+      typedef Result value_type; ///< The result tile type
+      typedef typename eval_trait<value_type>::type eval_type;  ///< Evaluation tile type
+      typedef TiledArray::math::ContractReduce<value_type,
+          typename EngineTrait<Left>::eval_type,
+          typename EngineTrait<Right>::eval_type> op_type; ///< The tile operation type
+      typedef typename TiledArray::detail::scalar_type<value_type>::type scalar_type; ///< Tile scalar type
+      typedef typename Left::policy policy; ///< The result policy type
+      typedef TiledArray::detail::DistEval<value_type, policy> dist_eval_type; ///< The distributed evaluator type
+
+      // Meta data typedefs
+      typedef typename policy::size_type size_type; ///< Size type
+      typedef typename policy::trange_type trange_type; ///< Tiled range type
+      typedef typename policy::shape_type shape_type; ///< Shape type
+      typedef typename policy::pmap_interface pmap_interface; ///< Process map interface type
+
+      static const bool consumable = true;
+      static const unsigned int leaves =
+          EngineTrait<Left>::leaves + EngineTrait<Right>::leaves;
+    };
+
 
     /// Multiplication expression engine
 
@@ -135,8 +168,7 @@ namespace TiledArray {
           BinaryEngine_::perm_vars(target_vars);
         } else {
           contract_ = true;
-          ContEngine_::init_vars();
-          ContEngine_::perm_vars(target_vars);
+          ContEngine_::init_vars(target_vars);
         }
       }
 
@@ -235,6 +267,27 @@ namespace TiledArray {
           return BinaryEngine_::make_dist_eval();
       }
 
+      /// Construct a distributed evaluator that adds this contraction to an array
+
+      /// \tparam A The array type
+      /// \param target The array that the result of this contraction is added to
+      /// \return The distributed evaluator that will evaluate the sum of
+      /// \c target and this contraction
+      template <typename A>
+      dist_eval_type make_dist_eval(const A& target) const {
+        TA_ASSERT(contract_);
+        return ContEngine_::make_dist_eval(target);
+      }
+
+      /// Contraction flag accessor
+
+      /// \return \c true if this expression is a contraction without batch
+      /// variables, or \c false if it is a coefficient-wise multiplication or
+      /// a batched contraction
+      bool is_contraction() const {
+        return contract_ && (ContEngine_::batch_rank() == 0u);
+      }
+
       /// Expression identification tag
 
       /// \return An expression tag used to identify this expression
@@ -337,8 +390,7 @@ namespace TiledArray {
           BinaryEngine_::perm_vars(target_vars);
         } else {
           contract_ = true;
-          ContEngine_::init_vars();
-          ContEngine_::perm_vars(target_vars);
+          ContEngine_::init_vars(target_vars);
         }
       }
 
@@ -393,6 +445,27 @@ namespace TiledArray {
           return BinaryEngine_::make_dist_eval();
       }
 
+      /// Construct a distributed evaluator that adds this contraction to an array
+
+      /// \tparam A The array type
+      /// \param target The array that the result of this contraction is added to
+      /// \return The distributed evaluator that will evaluate the sum of
+      /// \c target and this contraction
+      template <typename A>
+      dist_eval_type make_dist_eval(const A& target) const {
+        TA_ASSERT(contract_);
+        return ContEngine_::make_dist_eval(target);
+      }
+
+      /// Contraction flag accessor
+
+      /// \return \c true if this expression is a contraction without batch
+      /// variables, or \c false if it is a coefficient-wise multiplication or
+      /// a batched contraction
+      bool is_contraction() const {
+        return contract_ && (ContEngine_::batch_rank() == 0u);
+      }
+
       /// Non-permuting tiled range factory function
 
       /// \return The result tiled range object
@@ -468,6 +541,97 @@ namespace TiledArray {
 
     }; // class ScalMultEngine
 
+
+    /// Mixed-precision contraction expression engine
+
+    /// The argument tiles are evaluated, stored, and broadcast in their own
+    /// precision (e.g. \c Tensor<float> ), and the contraction is evaluated
+    /// and accumulated in the precision of the result tile type (e.g.
+    /// \c Tensor<double> ).
+    /// \tparam Left The left-hand engine type
+    /// \tparam Right The Right-hand engine type
+    /// \tparam Result The result tile type
+    template <typename Left, typename Right, typename Result>
+    class MixedMultEngine : public ContEngine<MixedMultEngine<Left, Right, Result> > {
+    public:
+      // Class hierarchy typedefs
+      typedef MixedMultEngine<Left, Right, Result> MixedMultEngine_; ///< This class type
+      typedef ContEngine<MixedMultEngine_> ContEngine_; ///< Contraction engine base class
+      typedef BinaryEngine<MixedMultEngine_> BinaryEngine_; ///< Binary base class type
+      typedef BinaryEngine<MixedMultEngine_> ExprEngine_; ///< Expression engine base class type
+
+      // Argument typedefs
+      typedef typename EngineTrait<MixedMultEngine_>::left_type left_type; ///< The left-hand expression type
+      typedef typename EngineTrait<MixedMultEngine_>::right_type right_type; ///< The right-hand expression type
+
+      // Operational typedefs
+      typedef typename EngineTrait<MixedMultEngine_>::value_type value_type; ///< The result tile type
+      typedef typename EngineTrait<MixedMultEngine_>::scalar_type scalar_type; ///< Tile scalar type
+      typedef typename EngineTrait<MixedMultEngine_>::op_type op_type; ///< The tile operation type
+      typedef typename EngineTrait<MixedMultEngine_>::policy policy; ///< The result policy type
+      typedef typename EngineTrait<MixedMultEngine_>::dist_eval_type dist_eval_type; ///< The distributed evaluator type
+
+      // Meta data typedefs
+      typedef typename EngineTrait<MixedMultEngine_>::size_type size_type; ///< Size type
+      typedef typename EngineTrait<MixedMultEngine_>::trange_type trange_type; ///< Tiled range type
+      typedef typename EngineTrait<MixedMultEngine_>::shape_type shape_type; ///< Shape type
+      typedef typename EngineTrait<MixedMultEngine_>::pmap_interface pmap_interface; ///< Process map interface type
+
+    private:
+
+      /// Initialize the variable lists of the arguments
+
+      /// \throw TiledArray::Exception When the product is not a contraction.
+      void init_arg_vars() {
+        BinaryEngine_::left_.init_vars();
+        BinaryEngine_::right_.init_vars();
+
+        TA_USER_ASSERT(! BinaryEngine_::left_.vars().is_permutation(
+            BinaryEngine_::right_.vars()),
+            "Mixed-precision products must be contractions.");
+      }
+
+    public:
+
+      /// Constructor
+
+      /// \tparam L The left-hand argument expression type
+      /// \tparam R The right-hand argument expression type
+      /// \param expr The parent expression
+      template <typename L, typename R>
+      MixedMultEngine(const MixedMultExpr<L, R, Result>& expr) : ContEngine_(expr) { }
+
+      /// Initialize the variable list of this expression
+
+      /// \param target_vars The target variable list for this expression
+      void init_vars(const VariableList& target_vars) {
+        init_arg_vars();
+        ContEngine_::init_vars(target_vars);
+      }
+
+      /// Initialize the variable list of this expression
+      void init_vars() {
+        init_arg_vars();
+        ContEngine_::init_vars();
+      }
+
+      /// Contraction flag accessor
+
+      /// \return \c true if this expression is a contraction without batch
+      /// variables, or \c false if it is a batched contraction
+      bool is_contraction() const { return ContEngine_::batch_rank() == 0u; }
+
+      /// Expression identification tag
+
+      /// \return An expression tag used to identify this expression
+      std::string make_tag() const {
+        std::stringstream ss;
+        ss << "[*] [" << ContEngine_::factor_ << "] [mixed] ";
+        return ss.str();
+      }
+
+    }; // class MixedMultEngine
+
   }  // namespace expressions
 } // namespace TiledArray
 
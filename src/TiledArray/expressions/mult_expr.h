@@ -28,6 +28,7 @@
 
 #include <TiledArray/expressions/binary_expr.h>
 #include <TiledArray/expressions/mult_engine.h>
+#include <TiledArray/expressions/cont_path.h>
 
 namespace TiledArray {
   namespace expressions {
@@ -42,6 +43,15 @@ namespace TiledArray {
         public BinaryExprTrait<Left, Right, ScalMultEngine>
     { };
 
+    template <typename Left, typename Right, typename Result>
+    struct ExprTrait<MixedMultExpr<Left, Right, Result> > {
+      typedef Left left_type; ///< The left-hand expression type
+      typedef Right right_type; ///< The right-hand expression type
+      typedef MixedMultEngine<typename ExprTrait<Left>::engine_type,
+          typename ExprTrait<Right>::engine_type, Result> engine_type; ///< Expression engine type
+      typedef typename TiledArray::detail::scalar_type<Result>::type scalar_type;  ///< Tile scalar type
+    };
+
 
     /// Multiplication expression
 
@@ -74,6 +84,105 @@ namespace TiledArray {
       /// \param other The expression to be copied
       MultExpr(const MultExpr_& other) : BinaryExpr_(other) { }
 
+      /// Evaluate this object and assign it to \c tsr
+
+      /// When \c ContPathOptimizer is enabled and this expression is a
+      /// product of three expressions, the products are evaluated in the
+      /// order with the smallest estimated cost. Only the two products of
+      /// this expression are reordered; a product that is an argument of
+      /// either of them is evaluated as it is written, and a product of two
+      /// products is never reordered.
+      /// \tparam A The array type
+      /// \param tsr The tensor to be assigned
+      template <typename A>
+      void eval_to(TsrExpr<A>& tsr) const {
+        if(! (ContPathOptimizer::enabled() &&
+            reorder_to(tsr, BinaryExpr_::left(), BinaryExpr_::right())))
+          BinaryExpr_::eval_to(tsr);
+      }
+
+    private:
+
+      /// Construct the summary of an expression
+
+      /// \tparam E The expression type
+      /// \param expr The expression
+      /// \return The contraction path summary of \c expr
+      template <typename E>
+      static ContPathArg make_arg(const E& expr) {
+        return ContPathOptimizer::make_arg<typename ExprTrait<E>::engine_type>(expr);
+      }
+
+      /// Products that are not reordered
+
+      /// \return \c false
+      template <typename A, typename L, typename R>
+      static bool reorder_to(TsrExpr<A>&, const L&, const R&) { return false; }
+
+      /// Products of four expressions are not reordered
+
+      /// \return \c false
+      template <typename A, typename L1, typename R1, typename L2, typename R2>
+      static bool reorder_to(TsrExpr<A>&, const MultExpr<L1, R1>&,
+          const MultExpr<L2, R2>&)
+      { return false; }
+
+      /// Evaluate <tt>(a * b) * c</tt> as <tt>a * (b * c)</tt> when it is cheaper
+
+      /// \param tsr The tensor to be assigned
+      /// \param left The product <tt>a * b</tt>
+      /// \param right The expression \c c
+      /// \return \c true if the product was reordered and evaluated
+      template <typename A, typename L, typename M, typename R>
+      static bool reorder_to(TsrExpr<A>& tsr, const MultExpr<L, M>& left,
+          const R& right)
+      {
+        const ContPathArg a = make_arg(left.left());
+        const ContPathArg b = make_arg(left.right());
+        const ContPathArg c = make_arg(right);
+        if(! ContPathOptimizer::is_reorderable(a, b, c, VariableList(tsr.vars())))
+          return false;
+
+        const MultExpr<M, R> bc_expr(left.right(), right);
+        const ContPathArg ab = make_arg(left);
+        const ContPathArg bc = make_arg(bc_expr);
+        if(ContPathOptimizer::cost(b, c, bc, a) >= ContPathOptimizer::cost(a, b, ab, c))
+          return false;
+
+        ContPathOptimizer::reordered();
+        const MultExpr<L, MultExpr<M, R> > expr(left.left(), bc_expr);
+        static_cast<const Expr<MultExpr<L, MultExpr<M, R> > >&>(expr).eval_to(tsr);
+        return true;
+      }
+
+      /// Evaluate <tt>a * (b * c)</tt> as <tt>(a * b) * c</tt> when it is cheaper
+
+      /// \param tsr The tensor to be assigned
+      /// \param left The expression \c a
+      /// \param right The product <tt>b * c</tt>
+      /// \return \c true if the product was reordered and evaluated
+      template <typename A, typename L, typename M, typename R>
+      static bool reorder_to(TsrExpr<A>& tsr, const L& left,
+          const MultExpr<M, R>& right)
+      {
+        const ContPathArg a = make_arg(left);
+        const ContPathArg b = make_arg(right.left());
+        const ContPathArg c = make_arg(right.right());
+        if(! ContPathOptimizer::is_reorderable(a, b, c, VariableList(tsr.vars())))
+          return false;
+
+        const MultExpr<L, M> ab_expr(left, right.left());
+        const ContPathArg ab = make_arg(ab_expr);
+        const ContPathArg bc = make_arg(right);
+        if(ContPathOptimizer::cost(a, b, ab, c) >= ContPathOptimizer::cost(b, c, bc, a))
+          return false;
+
+        ContPathOptimizer::reordered();
+        const MultExpr<MultExpr<L, M>, R> expr(ab_expr, right.right());
+        static_cast<const Expr<MultExpr<MultExpr<L, M>, R> >&>(expr).eval_to(tsr);
+        return true;
+      }
+
     }; // class MultExpr
 
 
@@ -131,6 +240,70 @@ namespace TiledArray {
     }; // class ScalMultExpr
 
 
+    /// Mixed-precision contraction expression
+
+    /// The arguments are evaluated and distributed with their own tile type,
+    /// and the contraction is evaluated and accumulated with the \c Result
+    /// tile type. For example, the contraction of arrays with
+    /// \c Tensor<float> tiles into a \c Tensor<double> result halves the
+    /// memory and communication volume of the arguments, compared to
+    /// contracting \c Tensor<double> arguments, while the sums are
+    /// accumulated in double precision.
+    /// \tparam Left The left-hand expression type
+    /// \tparam Right The right-hand expression type
+    /// \tparam Result The result tile type
+    template <typename Left, typename Right, typename Result>
+    class MixedMultExpr : public BinaryExpr<MixedMultExpr<Left, Right, Result> > {
+    public:
+      typedef MixedMultExpr<Left, Right, Result> MixedMultExpr_; ///< This class type
+      typedef BinaryExpr<MixedMultExpr_> BinaryExpr_; ///< Binary expression base type
+      typedef typename ExprTrait<MixedMultExpr_>::left_type left_type; ///< The left-hand expression type
+      typedef typename ExprTrait<MixedMultExpr_>::right_type right_type; ///< The right-hand expression type
+      typedef typename ExprTrait<MixedMultExpr_>::engine_type engine_type; ///< Expression engine type
+      typedef typename ExprTrait<MixedMultExpr_>::scalar_type scalar_type; ///< Tile scalar type
+
+    private:
+
+      scalar_type factor_; ///< The scaling factor
+
+      // Not allowed
+      MixedMultExpr_& operator=(const MixedMultExpr_&);
+
+    public:
+
+      /// Expression constructor
+
+      /// \param left The left-hand expression
+      /// \param right The right-hand expression
+      /// \param factor The scaling factor
+      MixedMultExpr(const left_type& left, const right_type& right,
+          const scalar_type factor = scalar_type(1)) :
+        BinaryExpr_(left, right), factor_(factor)
+      { }
+
+      /// Expression constructor
+
+      /// \param arg The scaled expression
+      /// \param factor The scaling factor
+      MixedMultExpr(const MixedMultExpr_& arg, const scalar_type factor) :
+        BinaryExpr_(arg), factor_(factor * arg.factor_)
+      { }
+
+      /// Copy constructor
+
+      /// \param other The expression to be copied
+      MixedMultExpr(const MixedMultExpr_& other) :
+        BinaryExpr_(other), factor_(other.factor_)
+      { }
+
+      /// Scaling factor accessor
+
+      /// \return The scaling factor
+      scalar_type factor() const { return factor_; }
+
+    }; // class MixedMultExpr
+
+
     /// Multiplication expression factor
 
     /// \tparam Left The left-hand expression type
@@ -225,6 +398,70 @@ namespace TiledArray {
       return ScalMultExpr<Left, Right>(expr, -1);
     }
 
+    /// Mixed-precision contraction expression factor
+
+    /// \code
+    /// c("i,j") = mixed_mult<TiledArray::Tensor<double> >(a("i,k"), b("k,j"));
+    /// \endcode
+    /// where \c a and \c b are arrays with \c Tensor<float> tiles, and
+    /// \c c is an array with \c Tensor<double> tiles.
+    /// \tparam Result The result tile type
+    /// \tparam Left The left-hand expression type
+    /// \tparam Right The right-hand expression type
+    /// \param left The left-hand expression object
+    /// \param right The right-hand expression object
+    /// \return A mixed-precision contraction expression object
+    template <typename Result, typename Left, typename Right>
+    inline MixedMultExpr<Left, Right, Result>
+    mixed_mult(const Expr<Left>& left, const Expr<Right>& right) {
+      return MixedMultExpr<Left, Right, Result>(left.derived(), right.derived());
+    }
+
+    /// Scaled mixed-precision contraction expression factor
+
+    /// \tparam Left The left-hand expression type
+    /// \tparam Right The right-hand expression type
+    /// \tparam Result The result tile type
+    /// \tparam Scalar A scalar type
+    /// \param expr The mixed-precision contraction expression object
+    /// \param factor The scaling factor
+    /// \return A scaled mixed-precision contraction expression object
+    template <typename Left, typename Right, typename Result, typename Scalar>
+    inline typename std::enable_if<TiledArray::detail::is_numeric<Scalar>::value,
+        MixedMultExpr<Left, Right, Result> >::type
+    operator*(const MixedMultExpr<Left, Right, Result>& expr, const Scalar& factor) {
+      return MixedMultExpr<Left, Right, Result>(expr, factor);
+    }
+
+    /// Scaled mixed-precision contraction expression factor
+
+    /// \tparam Left The left-hand expression type
+    /// \tparam Right The right-hand expression type
+    /// \tparam Result The result tile type
+    /// \tparam Scalar A scalar type
+    /// \param factor The scaling factor
+    /// \param expr The mixed-precision contraction expression object
+    /// \return A scaled mixed-precision contraction expression object
+    template <typename Left, typename Right, typename Result, typename Scalar>
+    inline typename std::enable_if<TiledArray::detail::is_numeric<Scalar>::value,
+        MixedMultExpr<Left, Right, Result> >::type
+    operator*(const Scalar& factor, const MixedMultExpr<Left, Right, Result>& expr) {
+      return MixedMultExpr<Left, Right, Result>(expr, factor);
+    }
+
+    /// Negated mixed-precision contraction expression factor
+
+    /// \tparam Left The left-hand expression type
+    /// \tparam Right The right-hand expression type
+    /// \tparam Result The result tile type
+    /// \param expr The mixed-precision contraction expression object
+    /// \return A scaled mixed-precision contraction expression object
+    template <typename Left, typename Right, typename Result>
+    inline MixedMultExpr<Left, Right, Result>
+    operator-(const MixedMultExpr<Left, Right, Result>& expr) {
+      return MixedMultExpr<Left, Right, Result>(expr, -1);
+    }
+
   }  // namespace expressions
 } // namespace TiledArray
 
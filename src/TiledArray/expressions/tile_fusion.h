@@ -0,0 +1,129 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_TILE_FUSION_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_TILE_FUSION_H__INCLUDED
+
+#include <TiledArray/tiled_range1.h>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace TiledArray {
+  namespace expressions {
+
+    /// Tile fusion for contractions
+
+    /// The tiling of an array reflects the structure of the problem, which
+    /// may produce tiles that are too small for efficient tile contractions.
+    /// When tile fusion is enabled, adjacent tiles of the arguments of a
+    /// contraction are fused into tiles with at least \c extent() elements
+    /// in each dimension, the contraction is evaluated with the fused tiles,
+    /// and the result is split to the tiling of the result. The tiles are
+    /// fused in each dimension separately, and slabs of zero tiles (i.e.
+    /// all tiles with the same coordinate in that dimension are zero) are
+    /// not fused with non-zero slabs, so fusion does not fill the sparsity of
+    /// the arguments. This setting is process-local; it should be the same
+    /// on all processes.
+    /// \note Tile fusion is only used for contractions of tensor tiles that
+    /// are not batched, where both arguments are in matrix form or are
+    /// permuted to matrix form, and the result is not accumulated to an
+    /// existing array.
+    class TileFusion {
+    private:
+
+      static std::atomic<std::size_t>& extent_() {
+        static std::atomic<std::size_t> extent(0ul);
+        return extent;
+      }
+
+      static std::atomic<std::size_t>& fusions_() {
+        static std::atomic<std::size_t> fusions(0ul);
+        return fusions;
+      }
+
+    public:
+
+      /// Check that tile fusion is enabled
+
+      /// \return \c true if the tiles of contraction arguments are fused
+      static bool enabled() { return extent() != 0ul; }
+
+      /// Fused tile extent accessor
+
+      /// \return The minimum number of elements of each dimension of a fused
+      /// tile, or zero if tile fusion is disabled
+      static std::size_t extent() { return extent_().load(std::memory_order_relaxed); }
+
+      /// Enable tile fusion
+
+      /// \param extent The minimum number of elements of each dimension of a
+      /// fused tile [ default = 64 ]
+      static void enable(const std::size_t extent = 64ul) { extent_() = extent; }
+
+      /// Disable tile fusion
+      static void disable() { extent_() = 0ul; }
+
+      /// Number of fused contractions
+
+      /// \return The number of contractions that were evaluated with fused
+      /// tiles on this process
+      static std::size_t fusions() { return fusions_(); }
+
+      /// Reset the fused contraction counter
+      static void clear() { fusions_() = 0ul; }
+
+      /// Record a fused contraction
+      static void fused() { ++fusions_(); }
+
+      /// Fuse the tiles of a tiled range
+
+      /// Adjacent tiles are fused until the fused tile has at least
+      /// \c extent elements. Zero tiles are only fused with zero tiles, and
+      /// non-zero tiles with non-zero tiles.
+      /// \param range The tiled range to be fused
+      /// \param zero Flags that are \c true for the zero tiles of \c range
+      /// \param extent The minimum number of elements of a fused tile
+      /// \return The fused tiled range
+      static TiledRange1 fuse(const TiledRange1& range,
+          const std::vector<bool>& zero, const std::size_t extent)
+      {
+        TA_ASSERT(zero.size() == (range.tiles().second - range.tiles().first));
+
+        std::vector<std::size_t> boundaries(1, range.elements().first);
+        std::size_t i = 0ul;
+        for(const TiledRange1::range_type& tile : range) {
+          // Start a new fused tile when the last one is large enough, or
+          // when the zero flag of the tile differs from that of the last one.
+          if((i != 0ul) && (((tile.first - boundaries.back()) >= extent) ||
+              (zero[i] != zero[i - 1ul])))
+            boundaries.push_back(tile.first);
+          ++i;
+        }
+        boundaries.push_back(range.elements().second);
+
+        return TiledRange1(boundaries.begin(), boundaries.end());
+      }
+
+    }; // class TileFusion
+
+  }  // namespace expressions
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_TILE_FUSION_H__INCLUDED
@@ -129,6 +129,38 @@ namespace TiledArray {
         return operator=(AddExpr<TsrExpr_, D>(*this, other.derived()));
       }
 
+      /// Contraction plus-assignment operator
+
+      /// When possible, the contraction is accumulated into the tiles of this
+      /// array in place, without a temporary array (see
+      /// \c Expr::eval_add_to() ).
+      /// \tparam L The left-hand expression type
+      /// \tparam R The right-hand expression type
+      /// \param other The contraction expression that will be added to this
+      /// array
+      template <typename L, typename R>
+      TsrExpr_& operator+=(const MultExpr<L, R>& other) {
+        if(other.eval_add_to(*this))
+          return *this;
+        return operator=(AddExpr<TsrExpr_, MultExpr<L, R> >(*this, other));
+      }
+
+      /// Scaled contraction plus-assignment operator
+
+      /// When possible, the contraction is accumulated into the tiles of this
+      /// array in place, without a temporary array (see
+      /// \c Expr::eval_add_to() ).
+      /// \tparam L The left-hand expression type
+      /// \tparam R The right-hand expression type
+      /// \param other The scaled contraction expression that will be added to
+      /// this array
+      template <typename L, typename R>
+      TsrExpr_& operator+=(const ScalMultExpr<L, R>& other) {
+        if(other.eval_add_to(*this))
+          return *this;
+        return operator=(AddExpr<TsrExpr_, ScalMultExpr<L, R> >(*this, other));
+      }
+
       /// Expression minus-assignment operator
 
       /// \tparam D The derived expression type
@@ -181,6 +181,13 @@ namespace TiledArray {
         return perm ^ arg_.trange();
       }
 
+      /// Check that this expression depends on an array
+
+      /// \param id The id of the array
+      /// \return \c true if the argument of this expression depends on the
+      /// array with the id \c id
+      bool depends_on(const madness::uniqueidT& id) const { return arg_.depends_on(id); }
+
       /// Construct the distributed evaluator for this expression
 
       /// \return The distributed evaluator that will evaluate this expression
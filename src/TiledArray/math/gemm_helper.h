@@ -28,6 +28,7 @@
 
 #include <TiledArray/error.h>
 #include <TiledArray/madness.h>
+#include <TiledArray/math/vector_op.h>
 
 namespace TiledArray {
   namespace math {
@@ -35,7 +36,10 @@ namespace TiledArray {
     /// Contraction to *GEMM helper
 
     /// This object is used to convert tensor contraction to *GEMM operations by
-    /// providing information on how to fuse dimensions
+    /// providing information on how to fuse dimensions. The arguments and the
+    /// result may also share leading batch dimensions, which are neither
+    /// contracted nor fused; each batch element is an independent *GEMM
+    /// operation.
     class GemmHelper {
     private:
 
@@ -44,12 +48,14 @@ namespace TiledArray {
       madness::cblas::CBLAS_TRANSPOSE right_op_;
               ///< Transpose operation that is applied to the right-hand argument
       unsigned int result_rank_; ///< The rank of the result tensor
+      unsigned int batch_rank_; ///< The number of leading batch dimensions
 
       /// Contraction argument range data
 
       /// The range data held by this object is the range of the inner and outer
       /// dimensions of the argument tensor. It is assumed that the inner and
-      /// outer dimensions are contiguous.
+      /// outer dimensions are contiguous, and that they follow the batch
+      /// dimensions.
       struct ContractArg {
         unsigned int inner[2]; ///< The inner dimension range
         unsigned int outer[2]; ///< The outer dimension range
@@ -61,15 +67,25 @@ namespace TiledArray {
 
     public:
 
+      /// Construct a contraction helper
+
+      /// \param left_op The left-hand matrix operation
+      /// \param right_op The right-hand matrix operation
+      /// \param result_rank The rank of the result tensor
+      /// \param left_rank The rank of the left-hand tensor
+      /// \param right_rank The rank of the right-hand tensor
+      /// \param batch_rank The number of leading dimensions that are shared
+      /// by the arguments and the result (default = 0)
       GemmHelper(const madness::cblas::CBLAS_TRANSPOSE left_op,
           const madness::cblas::CBLAS_TRANSPOSE right_op,
           const unsigned int result_rank, const unsigned int left_rank,
-          const unsigned int right_rank) :
+          const unsigned int right_rank, const unsigned int batch_rank = 0u) :
         left_op_(left_op), right_op_(right_op),
-        result_rank_(result_rank), left_(), right_()
+        result_rank_(result_rank), batch_rank_(batch_rank), left_(), right_()
       {
         // Compute the number of contracted dimensions in left and right.
-        TA_ASSERT(((left_rank + right_rank - result_rank) % 2u) == 0u);
+        TA_ASSERT(batch_rank <= std::min(result_rank, std::min(left_rank, right_rank)));
+        TA_ASSERT(((left_rank + right_rank - result_rank - batch_rank) % 2u) == 0u);
 
         left_.rank = left_rank;
         right_.rank = right_rank;
@@ -77,22 +93,22 @@ namespace TiledArray {
 
         // Store the inner and outer dimension ranges for the left-hand argument.
         if(left_op == madness::cblas::NoTrans) {
-          left_.outer[0] = 0u;
+          left_.outer[0] = batch_rank;
           left_.outer[1] = left_.inner[0] = left_rank - contract_size;
           left_.inner[1] = left_rank;
         } else {
-          left_.inner[0] = 0ul;
-          left_.inner[1] = left_.outer[0] = contract_size;
+          left_.inner[0] = batch_rank;
+          left_.inner[1] = left_.outer[0] = batch_rank + contract_size;
           left_.outer[1] = left_rank;
         }
 
         // Store the inner and outer dimension ranges for the right-hand argument.
         if(right_op == madness::cblas::NoTrans) {
-          right_.inner[0] = 0u;
-          right_.inner[1] = right_.outer[0] = contract_size;
+          right_.inner[0] = batch_rank;
+          right_.inner[1] = right_.outer[0] = batch_rank + contract_size;
           right_.outer[1] = right_rank;
         } else {
-          right_.outer[0] = 0u;
+          right_.outer[0] = batch_rank;
           right_.outer[1] = right_.inner[0] = right_rank - contract_size;
           right_.inner[1] = right_rank;
         }
@@ -104,7 +120,7 @@ namespace TiledArray {
       /// \param other The functor to be copied
       GemmHelper(const GemmHelper& other) :
         left_op_(other.left_op_), right_op_(other.right_op_),
-        result_rank_(other.result_rank_),
+        result_rank_(other.result_rank_), batch_rank_(other.batch_rank_),
         left_(other.left_), right_(other.right_)
       { }
 
@@ -115,6 +131,7 @@ namespace TiledArray {
         left_op_ = other.left_op_;
         right_op_ = other.right_op_;
         result_rank_ = other.result_rank_;
+        batch_rank_ = other.batch_rank_;
         left_ = other.left_;
         right_ = other.right_;
 
@@ -125,9 +142,15 @@ namespace TiledArray {
 
       /// \return The number of ranks that are summed by this operation
       unsigned int num_contract_ranks() const {
-        return (left_.rank + right_.rank - result_rank_) >> 1;
+        return (left_.rank + right_.rank - result_rank_ - batch_rank_) >> 1;
       }
 
+      /// Batch rank accessor
+
+      /// \return The number of leading dimensions that are shared by the
+      /// arguments and the result
+      unsigned int batch_rank() const { return batch_rank_; }
+
       /// Result rank accessor
 
       /// \return The rank of the result tile
@@ -175,6 +198,12 @@ namespace TiledArray {
         lower.reserve(result_rank_);
         upper.reserve(result_rank_);
 
+        // Copy the batch dimensions to start and finish
+        for(unsigned int i = 0u; i < batch_rank_; ++i) {
+          lower.push_back(left_lower[i]);
+          upper.push_back(left_upper[i]);
+        }
+
         // Copy left-hand argument outer dimensions to start and finish
         for(unsigned int i = left_.outer[0]; i < left_.outer[1]; ++i) {
           lower.push_back(left_lower[i]);
@@ -203,7 +232,9 @@ namespace TiledArray {
       /// of result
       template <typename Left, typename Result>
       bool left_result_coformal(const Left& left, const Result& result) const {
-        return std::equal(left + left_.outer[0], left + left_.outer[1], result);
+        return std::equal(left, left + batch_rank_, result) &&
+            std::equal(left + left_.outer[0], left + left_.outer[1],
+            result + batch_rank_);
       }
 
       /// Test that the outer dimensions of right are coformal with that of the result tensor
@@ -218,8 +249,9 @@ namespace TiledArray {
       /// of result
       template <typename Right, typename Result>
       bool right_result_coformal(const Right& right, const Result& result) const {
-        return std::equal(right + right_.outer[0], right + right_.outer[1],
-            result + (left_.outer[1] - left_.outer[0]));
+        return std::equal(right, right + batch_rank_, result) &&
+            std::equal(right + right_.outer[0], right + right_.outer[1],
+            result + batch_rank_ + (left_.outer[1] - left_.outer[0]));
       }
 
       /// Test that the inner dimensions of left are coformal with that of right
@@ -234,7 +266,8 @@ namespace TiledArray {
       /// that of \c right, other \c false.
       template <typename Left, typename Right>
       bool left_right_coformal(const Left& left, const Right& right) const {
-        return std::equal(left + left_.inner[0], left + left_.inner[1],
+        return std::equal(left, left + batch_rank_, right) &&
+            std::equal(left + left_.inner[0], left + left_.inner[1],
             right + right_.inner[0]);
       }
 
@@ -270,10 +303,64 @@ namespace TiledArray {
           n *= right_extent[i];
       }
 
+      /// Compute the number of *GEMM operations
+
+      /// \tparam Left The left-hand range type
+      /// \param left The left-hand range object
+      /// \return The number of elements in the batch dimensions of \c left
+      template <typename Left>
+      integer compute_batch_size(const Left& left) const {
+        TA_ASSERT(left.rank() == left_.rank);
+        const auto* restrict const left_extent = left.extent_data();
+
+        integer batch = 1;
+        for(unsigned int i = 0u; i < batch_rank_; ++i)
+          batch *= left_extent[i];
+        return batch;
+      }
+
       madness::cblas::CBLAS_TRANSPOSE left_op() const { return left_op_; }
       madness::cblas::CBLAS_TRANSPOSE right_op() const { return right_op_; }
     }; // class ContractReduce
 
+    /// Pack two *GEMM arguments into a single panel along the inner dimension
+
+    /// The matrices \c a1 and \c a2 share the outer (i.e. non-contracted)
+    /// dimension and have \c k1 and \c k2 inner elements, respectively. The
+    /// panel holds the \c outer by <tt>k1 + k2</tt> matrix with the same
+    /// storage order as the arguments, so that the contraction of two packed
+    /// panels is equal to the sum of the contractions of the argument pairs.
+    /// \tparam T The matrix element type
+    /// \param inner_fast \c true if the inner dimension is the fastest
+    /// running dimension of the arguments (i.e. \c NoTrans for a left-hand
+    /// argument and \c Trans for a right-hand argument)
+    /// \param outer The size of the outer dimension
+    /// \param k1 The size of the inner dimension of \c a1
+    /// \param a1 The first matrix
+    /// \param k2 The size of the inner dimension of \c a2
+    /// \param a2 The second matrix
+    /// \param[out] panel The packed matrix with <tt>outer * (k1 + k2)</tt>
+    /// elements
+    template <typename T>
+    inline void pack_inner(const bool inner_fast, const integer outer,
+        const integer k1, const T* a1, const integer k2, const T* a2,
+        T* panel)
+    {
+      if(inner_fast) {
+        // Interleave the rows of the two matrices
+        for(integer i = 0; i < outer; ++i, a1 += k1, a2 += k2) {
+          copy_vector(k1, a1, panel);
+          panel += k1;
+          copy_vector(k2, a2, panel);
+          panel += k2;
+        }
+      } else {
+        // Stack the two matrices
+        copy_vector(outer * k1, a1, panel);
+        copy_vector(outer * k2, a2, panel + outer * k1);
+      }
+    }
+
   }  // namespace math
 } // namespace TiledArray
 
@@ -27,143 +27,214 @@
 #define TILEDARRAY_PARALLEL_GEMM_H__INCLUDED
 
 #include <TiledArray/madness.h>
-#include <TiledArray/vector_op.h>
-#include <TiledArray/blas.h>
-
-#define TILEDARRAY_DYNAMIC_BLOCK_SIZE std::numeric_limits<std::size_t>::max();
+#include <TiledArray/math/blas.h>
+#include <TiledArray/math/vector_op.h>
+#include <TiledArray/tensor/parallel_config.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
 
 namespace TiledArray {
   namespace math {
 
-//#ifdef HAVE_INTEL_TBB
-
-
-    template <typename T, integer Size>
-    class MatrixBlockTask : public tbb::task {
-
-      const integer rows_;
-      const integer cols_;
-      T* data_;
-      const integer ld_;
-      std::shared_ptr<T> result_;
-
-      /// Copy a \c Size^2 block from \c data to \c result
-
-      /// \param[out] result A pointer to the first element of the result block
-      /// \param[in] data A pointer to the first element of the block to be copied
-      /// \param[in] ld The leading dimension stride for the \c data block
-      void copy_block(T* result, const T* data, const integer ld) {
-        const T* const block_end = result + (TILEDARRAY_LOOP_UNWIND * Size);
-        for(; result < block_end; result += Size, data += ld)
-          TiledArray::math::copy_block(result, data);
+    /// Runtime parameters for task-parallel *GEMM
+
+    /// A *GEMM with at least \c threshold() multiply-adds (i.e. \c m*n*k ) is
+    /// split into blocks of the result matrix that are evaluated by the
+    /// MADNESS task threads, instead of one *GEMM call on the thread that
+    /// evaluates the tile. The rows of the left-hand matrix and the columns
+    /// of the right-hand matrix that contribute to each result block are
+    /// first packed into contiguous panels, so the block *GEMM calls read
+    /// unit stride memory that is shared by all blocks in the same block row
+    /// or column. This helps when there are only a few large tiles per
+    /// process and the BLAS library is single-threaded inside tasks. This
+    /// setting is process-local.
+    class GemmParallelConfig {
+    private:
+
+      static std::atomic<std::size_t>& threshold_() {
+        static std::atomic<std::size_t> threshold(0ul);
+        return threshold;
       }
 
-      /// Copy a rectangular \c m*n block from \c data to \c result
+      static std::atomic<integer>& block_size_() {
+        static std::atomic<integer> block_size(256);
+        return block_size;
+      }
 
-      /// \param[in] m The number of rows to copy
-      /// \param[in] n The number of columns to copy
-      /// \param[out] result A pointer to the first element of the result block
-      /// \param[in] data A pointer to the first element of the block to be copied
-      /// \param[in] ld The leading dimension stride for the \c data block
-      void copy_block(const integer m, const integer n, T* result,
-          const T* data, const integer ld)
-      {
-        const T* const block_end = result + (m * Size);
-        for(; result < block_end; result += Size, data += ld)
-          TiledArray::math::copy_block(n, result, data);
+      static std::atomic<std::size_t>& parallel_gemms_() {
+        static std::atomic<std::size_t> parallel_gemms(0ul);
+        return parallel_gemms;
       }
 
     public:
-      MatrixBlockTask(const integer rows, const integer cols,
-          const T* const data, const integer ld) :
-        rows_(rows), cols_(cols), data_(data), ld_(ld)
-      { }
-
-      /// Task body
-      virtual tbb::task* execut() {
-
-        // Compute block iteration limit
-        constexpr integer index_mask = ~integer(TILEDARRAY_LOOP_UNWIND - 1ul);
-        const integer mx = rows_ & index_mask; // = rows - rows % TILEDARRAY_LOOP_UNWIND
-        const integer nx = cols_ & index_mask; // = cols - cols % TILEDARRAY_LOOP_UNWIND
-        const integer m_tail = rows_ - mx;
-        const integer n_tail = cols_ - nx;
-
-        // Copy data into block_
-        integer i = 0ul;
-        T* result_i = result_.get();
-        const T* data_i = data_;
-        for(; i < mx; i += TILEDARRAY_LOOP_UNWIND, result_i += Size, data_i += ld_) {
-
-          integer j = 0ul;
-          for(; j < nx; j += TILEDARRAY_LOOP_UNWIND)
-            copy_block(result_i + j, data_i + j);
-
-          if(n_tail)
-            copy_block(TILEDARRAY_LOOP_UNWIND, n_tail, result_i + j, data_i + j);
-        }
-
-        if(m_tail) {
-
-          integer j = 0ul;
-          for(; j < nx; j += TILEDARRAY_LOOP_UNWIND)
-            copy_block(m_tail, TILEDARRAY_LOOP_UNWIND, result_i + j, data_i + j);
 
-          if(n_tail)
-            copy_block(m_tail, n_tail, result_i + j, data_i + j);
+      /// The smallest result block size
+      static constexpr integer min_block_size = 4 * TILEDARRAY_LOOP_UNWIND;
 
-        }
-
-        return nullptr;
-      }
+      /// Check that task-parallel *GEMM is enabled
 
-      std::shared_ptr<T> result() {
-        constexpr integer size = Size * Size;
-        constexpr integer bytes = size * sizeof(T);
+      /// \return \c true if large *GEMM calls are split across threads
+      static bool enabled() { return threshold() != 0ul; }
 
-        T* result_ptr = nullptr;
-        if(! posix_memalign(result_ptr, TILEARRAY_ALIGNMENT, bytes))
-          throw std::bad_alloc();
+      /// Size threshold accessor
 
-        result_.reset(result_ptr);
+      /// \return The minimum number of multiply-adds of a task-parallel
+      /// *GEMM, or zero if task-parallel *GEMM is disabled
+      static std::size_t threshold() { return threshold_().load(std::memory_order_relaxed); }
 
-        return result_;
-      }
-
-    }; // class MatrixBlockTask
+      /// Set the size threshold of task-parallel *GEMM
 
+      /// \param size The minimum value of \c m*n*k of a *GEMM that is split
+      /// across threads; zero disables task-parallel *GEMM (default)
+      static void set_threshold(const std::size_t size) { threshold_() = size; }
 
-    template <integer Size, typename C, typename A = C, typename B = C, typename Alpha = C, typename Beta = C>
-    class GemmTask : public tbb::task {
-      const madness::cblas::CBLAS_TRANSPOSE op_a_, op_b_;
-      const integer m_, n_, k_;
-      const Alpha alpha_;
-      std::shared_ptr<A> a_;
-      constexpr integer lda_ = Size;
-      std::shared_ptr<B> b_;
-      const Beta beta_;
-      std::shared_ptr<C> c_;
-      const integer ldc_;
+      /// Result block size accessor
 
-    public:
+      /// \return The number of rows and columns of the result blocks
+      static integer block_size() { return block_size_().load(std::memory_order_relaxed); }
 
+      /// Set the result block size
 
-      GemmTask(madness::cblas::CBLAS_TRANSPOSE op_a,
-          madness::cblas::CBLAS_TRANSPOSE op_b, const integer m, const integer n,
-          const integer k, const Alpha alpha, const std::shared_ptr<A>& a,
-          const std::shared_ptr<B>& b, const Beta beta,
-          const std::shared_ptr<C>& c, const integer ldc) :
-            op_a_(op_a), op_b_(op_b), m_(m), n_(n), k_(k), alpha_(alpha), a_(a),
-            b_(b), beta_(beta), c_(c), ldc_(c)
-      { }
+      /// The block size is reduced for matrices that have fewer blocks than
+      /// threads, but not below \c min_block_size .
+      /// \param size The number of rows and columns of the result blocks
+      /// [ default = 256 ]
+      static void set_block_size(const integer size) {
+        TA_ASSERT(size >= min_block_size);
+        block_size_() = size;
+      }
 
-      virtual tbb::task execute() {
-        gemm(op_a_, op_b_, m_, n_, k_, alpha_, a_.get(), Size, b_.get(), Size, c_, ldc_);
+      /// Task-parallel *GEMM counter accessor
+
+      /// \return The number of *GEMM calls that were split across threads on
+      /// this process
+      static std::size_t parallel_gemms() { return parallel_gemms_(); }
+
+      /// Reset the task-parallel *GEMM counter
+      static void reset_parallel_gemms() { parallel_gemms_() = 0ul; }
+
+      /// Record a task-parallel *GEMM
+      static void parallel_gemm() { ++parallel_gemms_(); }
+
+    }; // class GemmParallelConfig
+
+    /// Copy a sub-matrix into a contiguous panel
+
+    /// \tparam T The element type
+    /// \param rows The number of rows to copy
+    /// \param cols The number of columns to copy
+    /// \param data A pointer to the first element of the sub-matrix
+    /// \param ld The leading dimension of \c data
+    /// \param[out] panel A pointer to the first element of the panel, which
+    /// has \c cols columns
+    template <typename T>
+    inline void pack_panel(const integer rows, const integer cols,
+        const T* data, const integer ld, T* panel)
+    {
+      for(integer i = 0; i < rows; ++i, data += ld, panel += cols)
+        std::copy(data, data + cols, panel);
+    }
+
+    /// Task-parallel *GEMM
+
+    /// Evaluates <tt>c = alpha * op_a(a) * op_b(b) + beta * c</tt> like
+    /// \c gemm . When <tt>m*n*k</tt> is at least
+    /// \c GemmParallelConfig::threshold() , the result is split into blocks
+    /// of \c GemmParallelConfig::block_size() rows and columns. The row
+    /// panels of \c a and the column panels of \c b are packed into
+    /// contiguous buffers by tasks, then the *GEMM of each result block is
+    /// evaluated by a task. The calling thread works on the first panel and
+    /// block, and runs other tasks while it waits for the remaining ones.
+    /// Otherwise, or if there is only one result block, \c gemm is called.
+    /// \param op_a The operation applied to \c a
+    /// \param op_b The operation applied to \c b
+    /// \param m The number of rows of \c c
+    /// \param n The number of columns of \c c
+    /// \param k The number of columns of \c op_a(a) and rows of \c op_b(b)
+    /// \param alpha The scaling factor of the product
+    /// \param a The left-hand matrix
+    /// \param lda The leading dimension of \c a
+    /// \param b The right-hand matrix
+    /// \param ldb The leading dimension of \c b
+    /// \param beta The scaling factor of \c c
+    /// \param c The result matrix
+    /// \param ldc The leading dimension of \c c
+    template <typename S1, typename T1, typename T2, typename S2, typename T3>
+    inline void parallel_gemm(madness::cblas::CBLAS_TRANSPOSE op_a,
+        madness::cblas::CBLAS_TRANSPOSE op_b, const integer m, const integer n,
+        const integer k, const S1 alpha, const T1* a, const integer lda,
+        const T2* b, const integer ldb, const S2 beta, T3* c, const integer ldc)
+    {
+      const std::size_t min_size = GemmParallelConfig::threshold();
+      const std::size_t threads = madness::ThreadPool::size() + 1ul;
+      if((min_size == 0ul) || (threads == 1ul) || (k == 0) ||
+          ((std::size_t(m) * std::size_t(n) * std::size_t(k)) < min_size))
+      {
+        math::gemm(op_a, op_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        return;
       }
 
-    }; // class GemmTask
+      // Reduce the block size until there is a block for each thread
+      const integer min_block_size = GemmParallelConfig::min_block_size;
+      integer block_size = GemmParallelConfig::block_size();
+      integer mb = (m + block_size - 1) / block_size;
+      integer nb = (n + block_size - 1) / block_size;
+      while((std::size_t(mb * nb) < threads) && (block_size > min_block_size)) {
+        block_size = std::max(min_block_size,
+            (block_size >> 1) & ~integer(TILEDARRAY_LOOP_UNWIND - 1));
+        mb = (m + block_size - 1) / block_size;
+        nb = (n + block_size - 1) / block_size;
+      }
+      if((mb * nb) == 1) {
+        math::gemm(op_a, op_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        return;
+      }
 
-//#endif // HAVE_INTEL_TBB
+      GemmParallelConfig::parallel_gemm();
+
+      // The panel of row block i of op_a(a) starts at element i*block_size*k
+      // of packed_a. It holds the block rows of a, or the block columns of a
+      // when a is transposed; the panels of b are stored the same way.
+      const bool a_notrans = (op_a == madness::cblas::NoTrans);
+      const bool b_notrans = (op_b == madness::cblas::NoTrans);
+      std::unique_ptr<T1[]> packed_a(new T1[std::size_t(m) * std::size_t(k)]);
+      std::unique_ptr<T2[]> packed_b(new T2[std::size_t(k) * std::size_t(n)]);
+
+      // Pack the panels
+      detail::parallel_blocks(mb + nb, mb + nb, 1ul,
+          [&] (const std::size_t panel, const std::size_t, const std::size_t) {
+        if(integer(panel) < mb) {
+          const integer i = panel * block_size;
+          const integer rows = std::min(block_size, m - i);
+          if(a_notrans)
+            pack_panel(rows, k, a + i * lda, lda, packed_a.get() + i * k);
+          else
+            pack_panel(k, rows, a + i, lda, packed_a.get() + i * k);
+        } else {
+          const integer j = (panel - mb) * block_size;
+          const integer cols = std::min(block_size, n - j);
+          if(b_notrans)
+            pack_panel(k, cols, b + j, ldb, packed_b.get() + j * k);
+          else
+            pack_panel(cols, k, b + j * ldb, ldb, packed_b.get() + j * k);
+        }
+      });
+
+      // Evaluate the result blocks, where consecutive blocks share a row
+      // panel of op_a(a)
+      detail::parallel_blocks(mb * nb, mb * nb, 1ul,
+          [&] (const std::size_t block, const std::size_t, const std::size_t) {
+        const integer i = (block / nb) * block_size;
+        const integer j = (block % nb) * block_size;
+        const integer rows = std::min(block_size, m - i);
+        const integer cols = std::min(block_size, n - j);
+        math::gemm(op_a, op_b, rows, cols, k, alpha,
+            packed_a.get() + i * k, (a_notrans ? k : rows),
+            packed_b.get() + j * k, (b_notrans ? cols : k),
+            beta, c + i * ldc + j, ldc);
+      });
+    }
 
   }  // namespace math
 } // namespace TiledArray
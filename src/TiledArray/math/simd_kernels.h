@@ -0,0 +1,553 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_MATH_SIMD_KERNELS_H__INCLUDED
+#define TILEDARRAY_MATH_SIMD_KERNELS_H__INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+// SIMD kernels are compiled with per-function target attributes, so a binary
+// that is built for the baseline instruction set contains kernels for all
+// supported instruction sets, and selects one at runtime.
+#if ! defined(TILEDARRAY_DISABLE_SIMD_KERNELS) && \
+    (defined(__x86_64__) || defined(__i386__)) && ! defined(__INTEL_COMPILER) && \
+    (defined(__clang__) || (defined(__GNUC__) && \
+        ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))))
+#define TILEDARRAY_HAS_SIMD_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace TiledArray {
+  namespace math {
+
+    /// SIMD kernel configuration
+
+    /// The element-wise vector operations on \c float and \c double elements
+    /// are evaluated with hand-written kernels for the SSE2, AVX2, or
+    /// AVX-512 instruction sets. The kernels for the best instruction set
+    /// supported by the CPU are selected the first time they are used. This
+    /// setting is process-local.
+    class SimdConfig {
+    public:
+
+      /// Instruction sets with vector kernels
+      typedef enum {
+        generic = 0, ///< Portable C++ loops
+        sse2 = 1, ///< 128-bit SSE2 kernels
+        avx2 = 2, ///< 256-bit AVX2 and FMA kernels
+        avx512 = 3 ///< 512-bit AVX-512 kernels
+      } Isa;
+
+    private:
+
+      static std::atomic<int>& isa_() {
+        static std::atomic<int> isa(supported());
+        return isa;
+      }
+
+    public:
+
+      /// Best instruction set that is supported by the CPU
+
+      /// \return The best instruction set with kernels that can be executed
+      /// by this process
+      static Isa supported() {
+#ifdef TILEDARRAY_HAS_SIMD_KERNELS
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx512f"))
+          return avx512;
+        if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+          return avx2;
+        if(__builtin_cpu_supports("sse2"))
+          return sse2;
+#endif // TILEDARRAY_HAS_SIMD_KERNELS
+        return generic;
+      }
+
+      /// Instruction set accessor
+
+      /// \return The instruction set of the kernels that are used
+      static Isa isa() { return Isa(isa_().load(std::memory_order_relaxed)); }
+
+      /// Select the instruction set of the kernels
+
+      /// \param isa The instruction set; it is limited to the instruction
+      /// sets that are supported by the CPU
+      static void set_isa(const Isa isa) {
+        const Isa max_isa = supported();
+        isa_() = (isa < max_isa ? isa : max_isa);
+      }
+
+    }; // class SimdConfig
+
+  } // namespace math
+
+  namespace detail {
+
+    /// Vector kernels for one element type
+
+    /// Each member points to the kernel of one element-wise operation.
+    /// Arguments may alias the result, but must not overlap it otherwise.
+    /// \tparam T The element type
+    template <typename T>
+    struct VectorKernels {
+      /// <tt>result[i] = left[i] + right[i]</tt>
+      void (*add)(std::size_t, const T*, const T*, T*);
+      /// <tt>result[i] = left[i] - right[i]</tt>
+      void (*subt)(std::size_t, const T*, const T*, T*);
+      /// <tt>result[i] = left[i] * right[i]</tt>
+      void (*mult)(std::size_t, const T*, const T*, T*);
+      /// <tt>result[i] = (left[i] + right[i]) * factor</tt>
+      void (*add_scale)(std::size_t, const T*, const T*, T, T*);
+      /// <tt>result[i] = arg[i] * factor</tt>
+      void (*scale)(std::size_t, const T*, T, T*);
+      /// <tt>result[i] += arg[i]</tt>
+      void (*add_to)(std::size_t, const T*, T*);
+      /// <tt>result[i] -= arg[i]</tt>
+      void (*subt_to)(std::size_t, const T*, T*);
+      /// <tt>result[i] *= arg[i]</tt>
+      void (*mult_to)(std::size_t, const T*, T*);
+      /// <tt>result[i] = (result[i] + arg[i]) * factor</tt>
+      void (*add_to_scale)(std::size_t, const T*, T, T*);
+      /// <tt>result[i] *= factor</tt>
+      void (*scale_to)(std::size_t, T, T*);
+      /// Sum of <tt>arg[i]</tt>
+      T (*sum)(std::size_t, const T*);
+      /// Sum of <tt>left[i] * right[i]</tt>
+      T (*dot)(std::size_t, const T*, const T*);
+      /// <tt>result[i] = arg[i * stride]</tt>
+      void (*gather)(std::size_t, const T*, std::size_t, T*);
+      /// <tt>result[i * stride] = arg[i]</tt>
+      void (*scatter)(std::size_t, const T*, T*, std::size_t);
+    }; // struct VectorKernels
+
+    // Element-wise kernel definitions ---------------------------------------
+
+    // The kernel bodies are the same for all instruction sets; only the
+    // vector type V and the target attribute differ. The vector types use
+    // the GCC vector extensions, and elements that do not fill a vector
+    // are handled by a scalar loop with the same expression.
+
+#define TILEDARRAY_SIMD_BINARY_KERNEL( TARGET , T , V , NAME , EXPR ) \
+    TARGET inline void NAME(const std::size_t n, const T* const left, \
+        const T* const right, T* const result) \
+    { \
+      std::size_t i = 0ul; \
+      for(; (i + (sizeof(V) / sizeof(T))) <= n; i += sizeof(V) / sizeof(T)) { \
+        V l, r; \
+        std::memcpy(&l, left + i, sizeof(V)); \
+        std::memcpy(&r, right + i, sizeof(V)); \
+        const V x = EXPR; \
+        std::memcpy(result + i, &x, sizeof(V)); \
+      } \
+      for(; i < n; ++i) { \
+        const T l = left[i], r = right[i]; \
+        result[i] = EXPR; \
+      } \
+    }
+
+#define TILEDARRAY_SIMD_BINARY_SCALE_KERNEL( TARGET , T , V , NAME , EXPR ) \
+    TARGET inline void NAME(const std::size_t n, const T* const left, \
+        const T* const right, const T factor, T* const result) \
+    { \
+      std::size_t i = 0ul; \
+      for(; (i + (sizeof(V) / sizeof(T))) <= n; i += sizeof(V) / sizeof(T)) { \
+        V l, r; \
+        std::memcpy(&l, left + i, sizeof(V)); \
+        std::memcpy(&r, right + i, sizeof(V)); \
+        const V x = EXPR; \
+        std::memcpy(result + i, &x, sizeof(V)); \
+      } \
+      for(; i < n; ++i) { \
+        const T l = left[i], r = right[i]; \
+        result[i] = EXPR; \
+      } \
+    }
+
+#define TILEDARRAY_SIMD_UNARY_SCALE_KERNEL( TARGET , T , V , NAME , EXPR ) \
+    TARGET inline void NAME(const std::size_t n, const T* const arg, \
+        const T factor, T* const result) \
+    { \
+      std::size_t i = 0ul; \
+      for(; (i + (sizeof(V) / sizeof(T))) <= n; i += sizeof(V) / sizeof(T)) { \
+        V a; \
+        std::memcpy(&a, arg + i, sizeof(V)); \
+        const V x = EXPR; \
+        std::memcpy(result + i, &x, sizeof(V)); \
+      } \
+      for(; i < n; ++i) { \
+        const T a = arg[i]; \
+        result[i] = EXPR; \
+      } \
+    }
+
+#define TILEDARRAY_SIMD_KERNELS( TARGET , T , V ) \
+    TILEDARRAY_SIMD_BINARY_KERNEL(TARGET, T, V, add, l + r) \
+    TILEDARRAY_SIMD_BINARY_KERNEL(TARGET, T, V, subt, l - r) \
+    TILEDARRAY_SIMD_BINARY_KERNEL(TARGET, T, V, mult, l * r) \
+    TILEDARRAY_SIMD_BINARY_SCALE_KERNEL(TARGET, T, V, add_scale, (l + r) * factor) \
+    TILEDARRAY_SIMD_UNARY_SCALE_KERNEL(TARGET, T, V, scale, a * factor) \
+    \
+    TARGET inline void add_to(const std::size_t n, const T* const arg, T* const result) \
+    { add(n, result, arg, result); } \
+    \
+    TARGET inline void subt_to(const std::size_t n, const T* const arg, T* const result) \
+    { subt(n, result, arg, result); } \
+    \
+    TARGET inline void mult_to(const std::size_t n, const T* const arg, T* const result) \
+    { mult(n, result, arg, result); } \
+    \
+    TARGET inline void add_to_scale(const std::size_t n, const T* const arg, \
+        const T factor, T* const result) \
+    { add_scale(n, result, arg, factor, result); } \
+    \
+    TARGET inline void scale_to(const std::size_t n, const T factor, T* const result) \
+    { scale(n, result, factor, result); } \
+    \
+    TARGET inline T sum(const std::size_t n, const T* const arg) { \
+      constexpr std::size_t w = sizeof(V) / sizeof(T); \
+      V s0 = {}, s1 = {}; \
+      std::size_t i = 0ul; \
+      for(; (i + 2ul * w) <= n; i += 2ul * w) { \
+        V a0, a1; \
+        std::memcpy(&a0, arg + i, sizeof(V)); \
+        std::memcpy(&a1, arg + i + w, sizeof(V)); \
+        s0 += a0; \
+        s1 += a1; \
+      } \
+      s0 += s1; \
+      T result = 0; \
+      for(std::size_t j = 0ul; j < w; ++j) \
+        result += s0[j]; \
+      for(; i < n; ++i) \
+        result += arg[i]; \
+      return result; \
+    } \
+    \
+    TARGET inline T dot(const std::size_t n, const T* const left, \
+        const T* const right) \
+    { \
+      constexpr std::size_t w = sizeof(V) / sizeof(T); \
+      V s0 = {}, s1 = {}; \
+      std::size_t i = 0ul; \
+      for(; (i + 2ul * w) <= n; i += 2ul * w) { \
+        V l0, l1, r0, r1; \
+        std::memcpy(&l0, left + i, sizeof(V)); \
+        std::memcpy(&l1, left + i + w, sizeof(V)); \
+        std::memcpy(&r0, right + i, sizeof(V)); \
+        std::memcpy(&r1, right + i + w, sizeof(V)); \
+        s0 += l0 * r0; \
+        s1 += l1 * r1; \
+      } \
+      s0 += s1; \
+      T result = 0; \
+      for(std::size_t j = 0ul; j < w; ++j) \
+        result += s0[j]; \
+      for(; i < n; ++i) \
+        result += left[i] * right[i]; \
+      return result; \
+    }
+
+    namespace simd {
+
+      /// Portable kernels
+      namespace generic {
+
+        template <typename T>
+        inline void add(const std::size_t n, const T* const left,
+            const T* const right, T* const result)
+        { for(std::size_t i = 0ul; i < n; ++i) result[i] = left[i] + right[i]; }
+
+        template <typename T>
+        inline void subt(const std::size_t n, const T* const left,
+            const T* const right, T* const result)
+        { for(std::size_t i = 0ul; i < n; ++i) result[i] = left[i] - right[i]; }
+
+        template <typename T>
+        inline void mult(const std::size_t n, const T* const left,
+            const T* const right, T* const result)
+        { for(std::size_t i = 0ul; i < n; ++i) result[i] = left[i] * right[i]; }
+
+        template <typename T>
+        inline void add_scale(const std::size_t n, const T* const left,
+            const T* const right, const T factor, T* const result)
+        { for(std::size_t i = 0ul; i < n; ++i) result[i] = (left[i] + right[i]) * factor; }
+
+        template <typename T>
+        inline void scale(const std::size_t n, const T* const arg,
+            const T factor, T* const result)
+        { for(std::size_t i = 0ul; i < n; ++i) result[i] = arg[i] * factor; }
+
+        template <typename T>
+        inline void add_to(const std::size_t n, const T* const arg, T* const result)
+        { add(n, result, arg, result); }
+
+        template <typename T>
+        inline void subt_to(const std::size_t n, const T* const arg, T* const result)
+        { subt(n, result, arg, result); }
+
+        template <typename T>
+        inline void mult_to(const std::size_t n, const T* const arg, T* const result)
+        { mult(n, result, arg, result); }
+
+        template <typename T>
+        inline void add_to_scale(const std::size_t n, const T* const arg,
+            const T factor, T* const result)
+        { add_scale(n, result, arg, factor, result); }
+
+        template <typename T>
+        inline void scale_to(const std::size_t n, const T factor, T* const result)
+        { scale(n, result, factor, result); }
+
+        template <typename T>
+        inline T sum(const std::size_t n, const T* const arg) {
+          T result = 0;
+          for(std::size_t i = 0ul; i < n; ++i) result += arg[i];
+          return result;
+        }
+
+        template <typename T>
+        inline T dot(const std::size_t n, const T* const left, const T* const right) {
+          T result = 0;
+          for(std::size_t i = 0ul; i < n; ++i) result += left[i] * right[i];
+          return result;
+        }
+
+        template <typename T>
+        inline void gather(const std::size_t n, const T* const arg,
+            const std::size_t stride, T* const result)
+        { for(std::size_t i = 0ul; i < n; ++i) result[i] = arg[i * stride]; }
+
+        template <typename T>
+        inline void scatter(const std::size_t n, const T* const arg,
+            T* const result, const std::size_t stride)
+        { for(std::size_t i = 0ul; i < n; ++i) result[i * stride] = arg[i]; }
+
+        template <typename T>
+        inline VectorKernels<T> kernels() {
+          return VectorKernels<T>{ & add<T>, & subt<T>, & mult<T>,
+              & add_scale<T>, & scale<T>, & add_to<T>, & subt_to<T>,
+              & mult_to<T>, & add_to_scale<T>, & scale_to<T>, & sum<T>,
+              & dot<T>, & gather<T>, & scatter<T> };
+        }
+
+      } // namespace generic
+
+#ifdef TILEDARRAY_HAS_SIMD_KERNELS
+
+      /// SSE2 kernels
+      namespace sse2 {
+
+        typedef double double_vector __attribute__((vector_size(16)));
+        typedef float float_vector __attribute__((vector_size(16)));
+
+        TILEDARRAY_SIMD_KERNELS(__attribute__((target("sse2"))), double, double_vector)
+        TILEDARRAY_SIMD_KERNELS(__attribute__((target("sse2"))), float, float_vector)
+
+        template <typename T>
+        inline VectorKernels<T> kernels() {
+          return VectorKernels<T>{ & add, & subt, & mult, & add_scale, & scale,
+              & add_to, & subt_to, & mult_to, & add_to_scale, & scale_to,
+              & sum, & dot, & generic::gather<T>, & generic::scatter<T> };
+        }
+
+      } // namespace sse2
+
+      /// AVX2 kernels
+      namespace avx2 {
+
+        typedef double double_vector __attribute__((vector_size(32)));
+        typedef float float_vector __attribute__((vector_size(32)));
+
+        TILEDARRAY_SIMD_KERNELS(__attribute__((target("avx2,fma"))), double, double_vector)
+        TILEDARRAY_SIMD_KERNELS(__attribute__((target("avx2,fma"))), float, float_vector)
+
+        __attribute__((target("avx2,fma")))
+        inline void gather(const std::size_t n, const double* const arg,
+            const std::size_t stride, double* const result)
+        {
+          const long long s = stride;
+          const __m256i index = _mm256_set_epi64x(3ll * s, 2ll * s, s, 0ll);
+          std::size_t i = 0ul;
+          for(; (i + 4ul) <= n; i += 4ul)
+            _mm256_storeu_pd(result + i,
+                _mm256_i64gather_pd(arg + i * stride, index, 8));
+          for(; i < n; ++i)
+            result[i] = arg[i * stride];
+        }
+
+        __attribute__((target("avx2,fma")))
+        inline void gather(const std::size_t n, const float* const arg,
+            const std::size_t stride, float* const result)
+        {
+          const long long s = stride;
+          const __m256i index = _mm256_set_epi64x(3ll * s, 2ll * s, s, 0ll);
+          std::size_t i = 0ul;
+          for(; (i + 4ul) <= n; i += 4ul)
+            _mm_storeu_ps(result + i,
+                _mm256_i64gather_ps(arg + i * stride, index, 4));
+          for(; i < n; ++i)
+            result[i] = arg[i * stride];
+        }
+
+        template <typename T>
+        inline VectorKernels<T> kernels() {
+          return VectorKernels<T>{ & add, & subt, & mult, & add_scale, & scale,
+              & add_to, & subt_to, & mult_to, & add_to_scale, & scale_to,
+              & sum, & dot, & gather, & generic::scatter<T> };
+        }
+
+      } // namespace avx2
+
+      /// AVX-512 kernels
+      namespace avx512 {
+
+        typedef double double_vector __attribute__((vector_size(64)));
+        typedef float float_vector __attribute__((vector_size(64)));
+
+        TILEDARRAY_SIMD_KERNELS(__attribute__((target("avx512f"))), double, double_vector)
+        TILEDARRAY_SIMD_KERNELS(__attribute__((target("avx512f"))), float, float_vector)
+
+        __attribute__((target("avx512f")))
+        inline void gather(const std::size_t n, const double* const arg,
+            const std::size_t stride, double* const result)
+        {
+          const long long s = stride;
+          const __m512i index = _mm512_set_epi64(7ll * s, 6ll * s, 5ll * s,
+              4ll * s, 3ll * s, 2ll * s, s, 0ll);
+          std::size_t i = 0ul;
+          for(; (i + 8ul) <= n; i += 8ul)
+            _mm512_storeu_pd(result + i,
+                _mm512_mask_i64gather_pd(_mm512_setzero_pd(), 0xff, index,
+                    arg + i * stride, 8));
+          for(; i < n; ++i)
+            result[i] = arg[i * stride];
+        }
+
+        __attribute__((target("avx512f")))
+        inline void gather(const std::size_t n, const float* const arg,
+            const std::size_t stride, float* const result)
+        {
+          const long long s = stride;
+          const __m512i index = _mm512_set_epi64(7ll * s, 6ll * s, 5ll * s,
+              4ll * s, 3ll * s, 2ll * s, s, 0ll);
+          std::size_t i = 0ul;
+          for(; (i + 8ul) <= n; i += 8ul)
+            _mm256_storeu_ps(result + i,
+                _mm512_mask_i64gather_ps(_mm256_setzero_ps(), 0xff, index,
+                    arg + i * stride, 4));
+          for(; i < n; ++i)
+            result[i] = arg[i * stride];
+        }
+
+        __attribute__((target("avx512f")))
+        inline void scatter(const std::size_t n, const double* const arg,
+            double* const result, const std::size_t stride)
+        {
+          const long long s = stride;
+          const __m512i index = _mm512_set_epi64(7ll * s, 6ll * s, 5ll * s,
+              4ll * s, 3ll * s, 2ll * s, s, 0ll);
+          std::size_t i = 0ul;
+          for(; (i + 8ul) <= n; i += 8ul)
+            _mm512_i64scatter_pd(result + i * stride, index,
+                _mm512_loadu_pd(arg + i), 8);
+          for(; i < n; ++i)
+            result[i * stride] = arg[i];
+        }
+
+        __attribute__((target("avx512f")))
+        inline void scatter(const std::size_t n, const float* const arg,
+            float* const result, const std::size_t stride)
+        {
+          const long long s = stride;
+          const __m512i index = _mm512_set_epi64(7ll * s, 6ll * s, 5ll * s,
+              4ll * s, 3ll * s, 2ll * s, s, 0ll);
+          std::size_t i = 0ul;
+          for(; (i + 8ul) <= n; i += 8ul)
+            _mm512_i64scatter_ps(result + i * stride, index,
+                _mm256_loadu_ps(arg + i), 4);
+          for(; i < n; ++i)
+            result[i * stride] = arg[i];
+        }
+
+        template <typename T>
+        inline VectorKernels<T> kernels() {
+          return VectorKernels<T>{ & add, & subt, & mult, & add_scale, & scale,
+              & add_to, & subt_to, & mult_to, & add_to_scale, & scale_to,
+              & sum, & dot, & gather, & scatter };
+        }
+
+      } // namespace avx512
+
+#endif // TILEDARRAY_HAS_SIMD_KERNELS
+
+    } // namespace simd
+
+#undef TILEDARRAY_SIMD_KERNELS
+#undef TILEDARRAY_SIMD_UNARY_SCALE_KERNEL
+#undef TILEDARRAY_SIMD_BINARY_SCALE_KERNEL
+#undef TILEDARRAY_SIMD_BINARY_KERNEL
+
+    /// Check for element types with vector kernels
+
+    /// \tparam T The element type
+    template <typename T>
+    struct is_simd_type :
+        public std::integral_constant<bool, std::is_same<T, double>::value
+            || std::is_same<T, float>::value>
+    { };
+
+    /// Check for a vector kernel scaling factor
+
+    /// Integral factors are converted to the element type by the scalar
+    /// operations, so the kernels give the same result for them.
+    /// \tparam N The scaling factor type
+    /// \tparam T The element type
+    template <typename N, typename T>
+    struct is_simd_factor :
+        public std::integral_constant<bool, is_simd_type<T>::value &&
+            (std::is_same<N, T>::value || std::is_integral<N>::value)>
+    { };
+
+    /// Vector kernels for the selected instruction set
+
+    /// \tparam T The element type, which is \c float or \c double
+    /// \return The kernels for \c SimdConfig::isa()
+    template <typename T>
+    inline const VectorKernels<T>& vector_kernels() {
+      static_assert(is_simd_type<T>::value,
+          "Vector kernels are only available for float and double.");
+#ifdef TILEDARRAY_HAS_SIMD_KERNELS
+      static const VectorKernels<T> kernels[4] = {
+          simd::generic::kernels<T>(), simd::sse2::kernels<T>(),
+          simd::avx2::kernels<T>(), simd::avx512::kernels<T>() };
+      return kernels[math::SimdConfig::isa()];
+#else
+      static const VectorKernels<T> kernels = simd::generic::kernels<T>();
+      return kernels;
+#endif // TILEDARRAY_HAS_SIMD_KERNELS
+    }
+
+  } // namespace detail
+} // namespace TiledArray
+
+#endif // TILEDARRAY_MATH_SIMD_KERNELS_H__INCLUDED
@@ -0,0 +1,353 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_MATH_STRIDED_GEMM_H__INCLUDED
+#define TILEDARRAY_MATH_STRIDED_GEMM_H__INCLUDED
+
+#include <TiledArray/math/gemm_helper.h>
+#include <TiledArray/math/blas.h>
+#include <TiledArray/permutation.h>
+#include <algorithm>
+#include <vector>
+
+namespace TiledArray {
+  namespace math {
+
+    /// *GEMM evaluation of contractions with arguments in their native layout
+
+    /// A \c GemmHelper defines a contraction of arguments in matrix form,
+    /// where the inner and outer dimensions of each argument are two
+    /// contiguous groups. This object evaluates the same contraction for
+    /// arguments that are stored with their dimensions in a different order,
+    /// without permuting the arguments. The trailing outer and inner
+    /// dimensions that can be fused in the argument layouts form the matrices
+    /// of a *GEMM call, and the remaining dimensions are iterated over, where
+    /// the sub-blocks of the arguments and the result are addressed with
+    /// their strides. The result is always stored in matrix form.
+    /// \note Not all layouts can be evaluated this way, since each *GEMM
+    /// argument must have unit stride along its rows or columns; use
+    /// \c is_valid() to check that the contraction is supported.
+    class StridedGemm {
+    private:
+
+      /// Dimension data
+      struct Dim {
+        integer extent; ///< The dimension size
+        integer left; ///< The left-hand argument stride (zero if not present)
+        integer right; ///< The right-hand argument stride (zero if not present)
+        integer result; ///< The result stride (zero if not present)
+      }; // struct Dim
+
+      std::vector<Dim> loops_; ///< Dimensions that are iterated outside of *GEMM, inner dimensions first
+      integer k_loops_; ///< The number of iterations over inner dimensions
+      integer m_; ///< The number of rows of the left-hand and result matrices
+      integer n_; ///< The number of columns of the right-hand and result matrices
+      integer k_; ///< The number of contracted elements of a *GEMM call
+      madness::cblas::CBLAS_TRANSPOSE left_op_; ///< The left-hand matrix operation
+      madness::cblas::CBLAS_TRANSPOSE right_op_; ///< The right-hand matrix operation
+      integer lda_; ///< The leading dimension of the left-hand matrices
+      integer ldb_; ///< The leading dimension of the right-hand matrices
+      integer ldc_; ///< The leading dimension of the result matrices
+      bool valid_; ///< \c true if the contraction can be evaluated
+
+      /// Compute the dimensions of an argument in matrix form
+
+      /// \tparam Index The extent and stride array type
+      /// \param perm The permutation from the native layout to matrix form
+      /// \param rank The rank of the argument
+      /// \param native_extent The extents of the native layout
+      /// \param native_stride The strides of the native layout
+      /// \param[out] extent The extents in matrix form
+      /// \param[out] stride The strides in matrix form
+      template <typename Index>
+      static void matrix_form(const Permutation& perm, const unsigned int rank,
+          const Index* native_extent, const Index* native_stride,
+          std::vector<integer>& extent, std::vector<integer>& stride)
+      {
+        TA_ASSERT(! perm || (perm.dim() == rank));
+        extent.resize(rank);
+        stride.resize(rank);
+        for(unsigned int i = 0u; i < rank; ++i) {
+          const unsigned int pi = (perm ? perm[i] : i);
+          extent[pi] = native_extent[i];
+          stride[pi] = native_stride[i];
+        }
+      }
+
+      /// Find the trailing dimensions that can be fused
+
+      /// \param dims The dimensions
+      /// \param[out] size The size of the fused dimension
+      /// \return The index of the first fused dimension
+      static std::size_t fuse(const std::vector<Dim>& dims, integer& size) {
+        size = 1;
+        std::size_t first = dims.size();
+        while(first > 0ul) {
+          const Dim& outer = dims[first - 1ul];
+          if(first < dims.size()) {
+            const Dim& inner = dims[first];
+            if((outer.left != (inner.left * inner.extent)) ||
+                (outer.right != (inner.right * inner.extent)) ||
+                (outer.result != (inner.result * inner.extent)))
+              break;
+          }
+          size *= outer.extent;
+          --first;
+        }
+        return first;
+      }
+
+      /// Stride of the fused dimension
+
+      /// \param dims The dimensions
+      /// \param member The stride member
+      /// \return The stride of the last dimension in \c dims, or zero if
+      /// \c dims is empty
+      static integer fused_stride(const std::vector<Dim>& dims, integer Dim::* member) {
+        return (dims.empty() ? 0 : dims.back().*member);
+      }
+
+      void init(const GemmHelper& gemm_helper,
+          const std::vector<integer>& left_extent, const std::vector<integer>& left_stride,
+          const std::vector<integer>& right_extent, const std::vector<integer>& right_stride)
+      {
+        // Batched contractions are not supported
+        if(gemm_helper.batch_rank() != 0u) {
+          valid_ = false;
+          return;
+        }
+
+        const unsigned int m_rank = gemm_helper.left_outer_end() - gemm_helper.left_outer_begin();
+        const unsigned int n_rank = gemm_helper.right_outer_end() - gemm_helper.right_outer_begin();
+        const unsigned int k_rank = gemm_helper.num_contract_ranks();
+
+        // Collect the outer and inner dimensions
+        std::vector<Dim> m_dims, n_dims, k_dims;
+        m_dims.reserve(m_rank);
+        n_dims.reserve(n_rank);
+        k_dims.reserve(k_rank);
+        for(unsigned int i = gemm_helper.left_outer_begin(); i < gemm_helper.left_outer_end(); ++i)
+          m_dims.push_back(Dim{ left_extent[i], left_stride[i], 0, 0 });
+        for(unsigned int i = gemm_helper.right_outer_begin(); i < gemm_helper.right_outer_end(); ++i)
+          n_dims.push_back(Dim{ right_extent[i], 0, right_stride[i], 0 });
+        for(unsigned int i = gemm_helper.left_inner_begin(), j = gemm_helper.right_inner_begin();
+            i < gemm_helper.left_inner_end(); ++i, ++j)
+        {
+          TA_ASSERT(left_extent[i] == right_extent[j]);
+          k_dims.push_back(Dim{ left_extent[i], left_stride[i], right_stride[j], 0 });
+        }
+
+        // The inner dimensions are summed over, so their order is free. Order
+        // them by the left-hand stride, so dimensions that are swapped in both
+        // arguments can still be fused.
+        std::stable_sort(k_dims.begin(), k_dims.end(),
+            [] (const Dim& l, const Dim& r) { return l.left > r.left; });
+
+        // The result is stored in matrix form
+        integer volume = 1;
+        for(auto it = n_dims.rbegin(); it != n_dims.rend(); ++it) {
+          it->result = volume;
+          volume *= it->extent;
+        }
+        for(auto it = m_dims.rbegin(); it != m_dims.rend(); ++it) {
+          it->result = volume;
+          volume *= it->extent;
+        }
+
+        // Fuse the trailing dimensions of each group into the *GEMM dimensions
+        const std::size_t m_first = fuse(m_dims, m_);
+        const std::size_t n_first = fuse(n_dims, n_);
+        const std::size_t k_first = fuse(k_dims, k_);
+        const integer a_m = fused_stride(m_dims, &Dim::left);
+        const integer a_k = fused_stride(k_dims, &Dim::left);
+        const integer b_n = fused_stride(n_dims, &Dim::right);
+        const integer b_k = fused_stride(k_dims, &Dim::right);
+        const integer c_m = fused_stride(m_dims, &Dim::result);
+
+        // Select the matrix operations, which require unit stride along the
+        // rows or columns of each matrix.
+        valid_ = true;
+        if((k_ == 1) || (a_k == 1)) {
+          left_op_ = madness::cblas::NoTrans;
+          lda_ = (m_ == 1 ? std::max<integer>(k_, 1) : a_m);
+        } else if((m_ == 1) || (a_m == 1)) {
+          left_op_ = madness::cblas::Trans;
+          lda_ = (k_ == 1 ? std::max<integer>(m_, 1) : a_k);
+        } else {
+          valid_ = false;
+        }
+        if((n_ == 1) || (b_n == 1)) {
+          right_op_ = madness::cblas::NoTrans;
+          ldb_ = (k_ == 1 ? std::max<integer>(n_, 1) : b_k);
+        } else if((k_ == 1) || (b_k == 1)) {
+          right_op_ = madness::cblas::Trans;
+          ldb_ = (n_ == 1 ? std::max<integer>(k_, 1) : b_n);
+        } else {
+          valid_ = false;
+        }
+        ldc_ = (m_ == 1 ? std::max<integer>(n_, 1) : c_m);
+
+        // Collect the remaining dimensions, where the inner dimensions are
+        // iterated over last so the first pass over the result may overwrite
+        // it.
+        loops_.assign(k_dims.begin(), k_dims.begin() + k_first);
+        k_loops_ = 1;
+        for(const Dim& dim : loops_)
+          k_loops_ *= dim.extent;
+        loops_.insert(loops_.end(), m_dims.begin(), m_dims.begin() + m_first);
+        loops_.insert(loops_.end(), n_dims.begin(), n_dims.begin() + n_first);
+      }
+
+    public:
+
+      /// Construct a contraction of native layout arguments
+
+      /// \tparam LeftRange The left-hand range type
+      /// \tparam RightRange The right-hand range type
+      /// \param gemm_helper The contraction of the arguments in matrix form
+      /// \param left_range The range of the left-hand argument
+      /// \param left_perm The permutation that takes the left-hand argument to
+      /// matrix form, or an empty permutation if it is in matrix form
+      /// \param right_range The range of the right-hand argument
+      /// \param right_perm The permutation that takes the right-hand argument
+      /// to matrix form, or an empty permutation if it is in matrix form
+      template <typename LeftRange, typename RightRange>
+      StridedGemm(const GemmHelper& gemm_helper, const LeftRange& left_range,
+          const Permutation& left_perm, const RightRange& right_range,
+          const Permutation& right_perm)
+      {
+        TA_ASSERT(left_range.rank() == gemm_helper.left_rank());
+        TA_ASSERT(right_range.rank() == gemm_helper.right_rank());
+
+        std::vector<integer> left_extent, left_stride, right_extent, right_stride;
+        matrix_form(left_perm, left_range.rank(), left_range.extent_data(),
+            left_range.stride_data(), left_extent, left_stride);
+        matrix_form(right_perm, right_range.rank(), right_range.extent_data(),
+            right_range.stride_data(), right_extent, right_stride);
+        init(gemm_helper, left_extent, left_stride, right_extent, right_stride);
+      }
+
+      /// Check that a contraction of native layout arguments is supported
+
+      /// Whether a contraction can be evaluated depends only on the order of
+      /// the argument dimensions, not on their sizes.
+      /// \param gemm_helper The contraction of the arguments in matrix form
+      /// \param left_perm The permutation that takes the left-hand argument to
+      /// matrix form, or an empty permutation if it is in matrix form
+      /// \param right_perm The permutation that takes the right-hand argument
+      /// to matrix form, or an empty permutation if it is in matrix form
+      /// \return \c true if the contraction can be evaluated with this object
+      static bool is_supported(const GemmHelper& gemm_helper,
+          const Permutation& left_perm, const Permutation& right_perm)
+      {
+        // Use arguments where all dimensions have two elements
+        const unsigned int rank = std::max(gemm_helper.left_rank(), gemm_helper.right_rank());
+        std::vector<integer> extent(rank, 2), stride(rank);
+        integer volume = 1;
+        std::vector<integer> left_extent, left_stride, right_extent, right_stride;
+
+        for(unsigned int i = gemm_helper.left_rank(); i > 0u; --i, volume *= 2)
+          stride[i - 1u] = volume;
+        matrix_form(left_perm, gemm_helper.left_rank(), extent.data(),
+            stride.data(), left_extent, left_stride);
+
+        volume = 1;
+        for(unsigned int i = gemm_helper.right_rank(); i > 0u; --i, volume *= 2)
+          stride[i - 1u] = volume;
+        matrix_form(right_perm, gemm_helper.right_rank(), extent.data(),
+            stride.data(), right_extent, right_stride);
+
+        StridedGemm strided_gemm;
+        strided_gemm.init(gemm_helper, left_extent, left_stride, right_extent, right_stride);
+        return strided_gemm.valid_;
+      }
+
+      /// Check that the contraction can be evaluated
+
+      /// \return \c true if the contraction can be evaluated
+      bool is_valid() const { return valid_; }
+
+      /// The number of *GEMM calls
+
+      /// \return The number of *GEMM calls used to evaluate the contraction
+      integer gemm_count() const {
+        integer count = 1;
+        for(const Dim& dim : loops_)
+          count *= dim.extent;
+        return count;
+      }
+
+      /// Evaluate the contraction
+
+      /// Compute <tt>c = alpha * a * b + beta * c</tt>, where \c a and \c b
+      /// are stored in their native layouts and \c c is in matrix form.
+      /// \tparam S1 The \c alpha type
+      /// \tparam T1 The left-hand argument element type
+      /// \tparam T2 The right-hand argument element type
+      /// \tparam S2 The \c beta type
+      /// \tparam T3 The result element type
+      /// \param alpha The scaling factor of the contraction
+      /// \param a The left-hand argument data
+      /// \param b The right-hand argument data
+      /// \param beta The scaling factor of the result
+      /// \param c The result data
+      template <typename S1, typename T1, typename T2, typename S2, typename T3>
+      void operator()(const S1 alpha, const T1* a, const T2* b, const S2 beta,
+          T3* c) const
+      {
+        TA_ASSERT(valid_);
+
+        const std::size_t rank = loops_.size();
+        std::vector<integer> index(rank, 0);
+        const integer count = gemm_count();
+        const integer mn_count = count / k_loops_;
+        integer a_offset = 0, b_offset = 0, c_offset = 0;
+
+        for(integer i = 0; i < count; ++i) {
+          math::gemm(left_op_, right_op_, m_, n_, k_, alpha, a + a_offset, lda_,
+              b + b_offset, ldb_, (i < mn_count ? beta : S2(1)), c + c_offset, ldc_);
+
+          // Increment the loop index, where the last loop is the fastest
+          // running loop.
+          for(std::size_t d = rank; d > 0ul; --d) {
+            const Dim& dim = loops_[d - 1ul];
+            if(++index[d - 1ul] < dim.extent) {
+              a_offset += dim.left;
+              b_offset += dim.right;
+              c_offset += dim.result;
+              break;
+            }
+            index[d - 1ul] = 0;
+            a_offset -= dim.left * (dim.extent - 1);
+            b_offset -= dim.right * (dim.extent - 1);
+            c_offset -= dim.result * (dim.extent - 1);
+          }
+        }
+      }
+
+    private:
+
+      StridedGemm() = default;
+
+    }; // class StridedGemm
+
+  }  // namespace math
+} // namespace TiledArray
+
+#endif // TILEDARRAY_MATH_STRIDED_GEMM_H__INCLUDED
@@ -28,6 +28,7 @@
 
 #include <TiledArray/type_traits.h>
 #include <TiledArray/madness.h>
+#include <TiledArray/math/simd_kernels.h>
 
 #ifndef TILEARRAY_ALIGNMENT
 #define TILEARRAY_ALIGNMENT 16
@@ -299,7 +300,7 @@ namespace TiledArray {
 
     template <typename Arg, typename Result>
     TILEDARRAY_FORCE_INLINE void
-    gather_block_n(const std::size_t n, Result* const result, const Arg* const arg,
+    gather_block_n(const std::size_t n, Result* const result, const Arg* arg,
         const std::size_t stride)
     {
       for(std::size_t i = 0; i < n; ++i, arg += stride)
@@ -332,6 +333,262 @@ namespace TiledArray {
 
     }; // class Block
 
+    // Element-wise operations -------------------------------------------------
+
+    // The element-wise operations below have vector kernels for float and
+    // double elements (see simd_kernels.h). The vector operation functions
+    // evaluate these operations with the kernels of the instruction set
+    // selected by SimdConfig, and all other operations with the portable
+    // loops below.
+
+    /// Addition operation: <tt>l + r</tt>
+    struct AddOp {
+      template <typename L, typename R>
+      auto operator()(const L& l, const R& r) const -> decltype(l + r)
+      { return l + r; }
+    }; // struct AddOp
+
+    /// Subtraction operation: <tt>l - r</tt>
+    struct SubtOp {
+      template <typename L, typename R>
+      auto operator()(const L& l, const R& r) const -> decltype(l - r)
+      { return l - r; }
+    }; // struct SubtOp
+
+    /// Multiplication operation: <tt>l * r</tt>
+    struct MultOp {
+      template <typename L, typename R>
+      auto operator()(const L& l, const R& r) const -> decltype(l * r)
+      { return l * r; }
+    }; // struct MultOp
+
+    /// Scale operation: <tt>a * factor</tt>
+
+    /// \tparam N The scaling factor type
+    template <typename N>
+    class ScaleOp {
+      N factor_; ///< The scaling factor
+    public:
+      explicit ScaleOp(const N factor) : factor_(factor) { }
+      N factor() const { return factor_; }
+
+      template <typename A>
+      auto operator()(const A& a) const -> decltype(a * std::declval<const N&>())
+      { return a * factor_; }
+    }; // class ScaleOp
+
+    /// Scaled addition operation: <tt>(l + r) * factor</tt>
+
+    /// \tparam N The scaling factor type
+    template <typename N>
+    class AddScaleOp {
+      N factor_; ///< The scaling factor
+    public:
+      explicit AddScaleOp(const N factor) : factor_(factor) { }
+      N factor() const { return factor_; }
+
+      template <typename L, typename R>
+      auto operator()(const L& l, const R& r) const ->
+          decltype((l + r) * std::declval<const N&>())
+      { return (l + r) * factor_; }
+    }; // class AddScaleOp
+
+    /// In-place addition operation: <tt>res += a</tt>
+
+    /// This operation is also the summation reduction.
+    struct AddToOp {
+      template <typename R, typename A>
+      void operator()(R& restrict res, const A& a) const { res += a; }
+    }; // struct AddToOp
+
+    /// In-place subtraction operation: <tt>res -= a</tt>
+    struct SubtToOp {
+      template <typename R, typename A>
+      void operator()(R& restrict res, const A& a) const { res -= a; }
+    }; // struct SubtToOp
+
+    /// In-place multiplication operation: <tt>res *= a</tt>
+    struct MultToOp {
+      template <typename R, typename A>
+      void operator()(R& restrict res, const A& a) const { res *= a; }
+    }; // struct MultToOp
+
+    /// In-place scale operation: <tt>res *= factor</tt>
+
+    /// \tparam N The scaling factor type
+    template <typename N>
+    class ScaleToOp {
+      N factor_; ///< The scaling factor
+    public:
+      explicit ScaleToOp(const N factor) : factor_(factor) { }
+      N factor() const { return factor_; }
+
+      template <typename R>
+      void operator()(R& restrict res) const { res *= factor_; }
+    }; // class ScaleToOp
+
+    /// In-place scaled addition operation: <tt>(res += a) *= factor</tt>
+
+    /// \tparam N The scaling factor type
+    template <typename N>
+    class AddToScaleOp {
+      N factor_; ///< The scaling factor
+    public:
+      explicit AddToScaleOp(const N factor) : factor_(factor) { }
+      N factor() const { return factor_; }
+
+      template <typename R, typename A>
+      void operator()(R& restrict res, const A& a) const { (res += a) *= factor_; }
+    }; // class AddToScaleOp
+
+    /// Dot product reduction: <tt>res += l * r</tt>
+    struct DotOp {
+      template <typename R, typename L, typename Ri>
+      void operator()(R& res, const L& l, const Ri& r) const { res += l * r; }
+    }; // struct DotOp
+
+    /// Square reduction: <tt>res += a * a</tt>
+    struct SquareAddOp {
+      template <typename R, typename A>
+      void operator()(R& restrict res, const A& a) const { res += a * a; }
+    }; // struct SquareAddOp
+
+    /// Evaluate a vector operation with a vector kernel
+
+    /// This is the fallback for operations and element types without a
+    /// vector kernel.
+    /// \return \c false
+    template <typename Op, typename Result, typename... Args>
+    inline bool vector_kernel(const Op&, const std::size_t, Result* const,
+        const Args* const...)
+    { return false; }
+
+    /// Evaluate a reduction with a vector kernel
+
+    /// This is the fallback for operations and element types without a
+    /// vector kernel.
+    /// \return \c false
+    template <typename Op, typename Result, typename... Args>
+    inline bool reduce_kernel(const Op&, const std::size_t, Result&,
+        const Args* const...)
+    { return false; }
+
+    template <typename T>
+    inline typename std::enable_if<TiledArray::detail::is_simd_type<T>::value, bool>::type
+    vector_kernel(const AddOp&, const std::size_t n, T* const result,
+        const T* const left, const T* const right)
+    {
+      TiledArray::detail::vector_kernels<T>().add(n, left, right, result);
+      return true;
+    }
+
+    template <typename T>
+    inline typename std::enable_if<TiledArray::detail::is_simd_type<T>::value, bool>::type
+    vector_kernel(const SubtOp&, const std::size_t n, T* const result,
+        const T* const left, const T* const right)
+    {
+      TiledArray::detail::vector_kernels<T>().subt(n, left, right, result);
+      return true;
+    }
+
+    template <typename T>
+    inline typename std::enable_if<TiledArray::detail::is_simd_type<T>::value, bool>::type
+    vector_kernel(const MultOp&, const std::size_t n, T* const result,
+        const T* const left, const T* const right)
+    {
+      TiledArray::detail::vector_kernels<T>().mult(n, left, right, result);
+      return true;
+    }
+
+    template <typename N, typename T>
+    inline typename std::enable_if<TiledArray::detail::is_simd_factor<N, T>::value, bool>::type
+    vector_kernel(const ScaleOp<N>& op, const std::size_t n, T* const result,
+        const T* const arg)
+    {
+      TiledArray::detail::vector_kernels<T>().scale(n, arg, T(op.factor()), result);
+      return true;
+    }
+
+    template <typename N, typename T>
+    inline typename std::enable_if<TiledArray::detail::is_simd_factor<N, T>::value, bool>::type
+    vector_kernel(const AddScaleOp<N>& op, const std::size_t n, T* const result,
+        const T* const left, const T* const right)
+    {
+      TiledArray::detail::vector_kernels<T>().add_scale(n, left, right, T(op.factor()), result);
+      return true;
+    }
+
+    template <typename T>
+    inline typename std::enable_if<TiledArray::detail::is_simd_type<T>::value, bool>::type
+    vector_kernel(const AddToOp&, const std::size_t n, T* const result,
+        const T* const arg)
+    {
+      TiledArray::detail::vector_kernels<T>().add_to(n, arg, result);
+      return true;
+    }
+
+    template <typename T>
+    inline typename std::enable_if<TiledArray::detail::is_simd_type<T>::value, bool>::type
+    vector_kernel(const SubtToOp&, const std::size_t n, T* const result,
+        const T* const arg)
+    {
+      TiledArray::detail::vector_kernels<T>().subt_to(n, arg, result);
+      return true;
+    }
+
+    template <typename T>
+    inline typename std::enable_if<TiledArray::detail::is_simd_type<T>::value, bool>::type
+    vector_kernel(const MultToOp&, const std::size_t n, T* const result,
+        const T* const arg)
+    {
+      TiledArray::detail::vector_kernels<T>().mult_to(n, arg, result);
+      return true;
+    }
+
+    template <typename N, typename T>
+    inline typename std::enable_if<TiledArray::detail::is_simd_factor<N, T>::value, bool>::type
+    vector_kernel(const ScaleToOp<N>& op, const std::size_t n, T* const result)
+    {
+      TiledArray::detail::vector_kernels<T>().scale_to(n, T(op.factor()), result);
+      return true;
+    }
+
+    template <typename N, typename T>
+    inline typename std::enable_if<TiledArray::detail::is_simd_factor<N, T>::value, bool>::type
+    vector_kernel(const AddToScaleOp<N>& op, const std::size_t n, T* const result,
+        const T* const arg)
+    {
+      TiledArray::detail::vector_kernels<T>().add_to_scale(n, arg, T(op.factor()), result);
+      return true;
+    }
+
+    template <typename T>
+    inline typename std::enable_if<TiledArray::detail::is_simd_type<T>::value, bool>::type
+    reduce_kernel(const AddToOp&, const std::size_t n, T& result,
+        const T* const arg)
+    {
+      result += TiledArray::detail::vector_kernels<T>().sum(n, arg);
+      return true;
+    }
+
+    template <typename T>
+    inline typename std::enable_if<TiledArray::detail::is_simd_type<T>::value, bool>::type
+    reduce_kernel(const SquareAddOp&, const std::size_t n, T& result,
+        const T* const arg)
+    {
+      result += TiledArray::detail::vector_kernels<T>().dot(n, arg, arg);
+      return true;
+    }
+
+    template <typename T>
+    inline typename std::enable_if<TiledArray::detail::is_simd_type<T>::value, bool>::type
+    reduce_kernel(const DotOp&, const std::size_t n, T& result,
+        const T* const left, const T* const right)
+    {
+      result += TiledArray::detail::vector_kernels<T>().dot(n, left, right);
+      return true;
+    }
+
 
     template <typename Op, typename Result, typename... Args,
         typename std::enable_if<std::is_void<typename std::result_of<Op(Result&,
@@ -339,6 +596,9 @@ namespace TiledArray {
     void inplace_vector_op(Op&& op, const std::size_t n, Result* const result,
         const Args* const... args)
     {
+      if(vector_kernel(op, n, result, args...))
+        return;
+
       std::size_t i = 0ul;
 
       // Compute block iteration limit
@@ -360,6 +620,9 @@ namespace TiledArray {
     void vector_op(Op&& op, const std::size_t n, Result* const result,
         const Args* const... args)
     {
+      if(vector_kernel(op, n, result, args...))
+        return;
+
       auto wrapper_op = [&op] (Result& res, param_type<Args>... a)
           { res = op(a...); };
 
@@ -397,6 +660,9 @@ namespace TiledArray {
     void reduce_op(Op&& op, const std::size_t n, Result& result,
         const Args* const... args)
     {
+      if(reduce_kernel(op, n, result, args...))
+        return;
+
       std::size_t i = 0ul;
 
       // Compute block iteration limit
@@ -434,10 +700,48 @@ namespace TiledArray {
       std::memcpy(result, arg, n * sizeof(T));
     }
 
+    /// Copy strided elements to a vector
+
+    /// <tt>result[i] = arg[i * stride]</tt>
+    /// \param n The number of elements
+    /// \param arg The strided argument
+    /// \param stride The argument stride
+    /// \param result The result vector
+    template <typename T>
+    inline typename std::enable_if<! TiledArray::detail::is_simd_type<T>::value>::type
+    gather_vector(const std::size_t n, const T* const arg,
+        const std::size_t stride, T* const result)
+    { gather_block_n(n, result, arg, stride); }
+
+    template <typename T>
+    inline typename std::enable_if<TiledArray::detail::is_simd_type<T>::value>::type
+    gather_vector(const std::size_t n, const T* const arg,
+        const std::size_t stride, T* const result)
+    { TiledArray::detail::vector_kernels<T>().gather(n, arg, stride, result); }
+
+    /// Copy a vector to strided elements
+
+    /// <tt>result[i * stride] = arg[i]</tt>
+    /// \param n The number of elements
+    /// \param arg The argument vector
+    /// \param result The strided result
+    /// \param stride The result stride
+    template <typename T>
+    inline typename std::enable_if<! TiledArray::detail::is_simd_type<T>::value>::type
+    scatter_vector(const std::size_t n, const T* const arg, T* const result,
+        const std::size_t stride)
+    { scatter_block_n(n, result, stride, arg); }
+
+    template <typename T>
+    inline typename std::enable_if<TiledArray::detail::is_simd_type<T>::value>::type
+    scatter_vector(const std::size_t n, const T* const arg, T* const result,
+        const std::size_t stride)
+    { TiledArray::detail::vector_kernels<T>().scatter(n, arg, result, stride); }
+
     template <typename Arg, typename Result>
     void fill_vector(const std::size_t n, const Arg& arg, Result* const result) {
       auto fill_op = [arg] (Result& res) { res = arg; };
-      vector_op(fill_op, n, result);
+      inplace_vector_op(fill_op, n, result);
     }
 
 
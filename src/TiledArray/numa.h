@@ -0,0 +1,244 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_NUMA_H__INCLUDED
+#define TILEDARRAY_NUMA_H__INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif // defined(__linux__)
+
+namespace TiledArray {
+
+  namespace detail {
+
+    /// Parse a Linux cpu or node list
+
+    /// \param list A list of ranges, e.g. \c "0-3,8,10-11"
+    /// \return The list members
+    inline std::vector<std::size_t> parse_id_list(const std::string& list) {
+      std::vector<std::size_t> result;
+      std::istringstream stream(list);
+      std::string range;
+      while(std::getline(stream, range, ',')) {
+        if(range.find_first_of("0123456789") == std::string::npos)
+          continue;
+        const std::size_t dash = range.find('-');
+        const std::size_t first = std::stoul(range.substr(0ul, dash));
+        const std::size_t last =
+            (dash == std::string::npos ? first : std::stoul(range.substr(dash + 1ul)));
+        for(std::size_t i = first; i <= last; ++i)
+          result.push_back(i);
+      }
+      return result;
+    }
+
+    /// Read the first line of a file
+
+    /// \param path The file path
+    /// \return The first line of the file, or an empty string if the file
+    /// cannot be read
+    inline std::string read_line(const std::string& path) {
+      std::ifstream file(path.c_str());
+      std::string line;
+      std::getline(file, line);
+      return line;
+    }
+
+  } // namespace detail
+
+  /// NUMA node memory counters
+
+  /// The counters of a node are read from
+  /// <tt>/sys/devices/system/node/node<N>/numastat</tt> , and count pages.
+  /// The counters are zero when they are not available.
+  struct NumaCounters {
+    std::size_t numa_hit = 0ul; ///< Pages allocated on the intended node
+    std::size_t numa_miss = 0ul; ///< Pages allocated here that were intended for another node
+    std::size_t numa_foreign = 0ul; ///< Pages intended for this node that were allocated elsewhere
+    std::size_t interleave_hit = 0ul; ///< Interleaved pages allocated on the intended node
+    std::size_t local_node = 0ul; ///< Pages allocated here by a thread on this node
+    std::size_t other_node = 0ul; ///< Pages allocated here by a thread on another node
+
+    /// Read the counters of a node
+
+    /// \param node The node id
+    /// \return The current counters of \c node
+    static NumaCounters read(const std::size_t node) {
+      NumaCounters result;
+      std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/numastat");
+      std::string name;
+      std::size_t value = 0ul;
+      while(file >> name >> value) {
+        if(name == "numa_hit") result.numa_hit = value;
+        else if(name == "numa_miss") result.numa_miss = value;
+        else if(name == "numa_foreign") result.numa_foreign = value;
+        else if(name == "interleave_hit") result.interleave_hit = value;
+        else if(name == "local_node") result.local_node = value;
+        else if(name == "other_node") result.other_node = value;
+      }
+      return result;
+    }
+
+    /// Counter difference
+
+    /// \param other The earlier counters
+    /// \return The counter increments since \c other
+    NumaCounters operator-(const NumaCounters& other) const {
+      NumaCounters result;
+      result.numa_hit = numa_hit - other.numa_hit;
+      result.numa_miss = numa_miss - other.numa_miss;
+      result.numa_foreign = numa_foreign - other.numa_foreign;
+      result.interleave_hit = interleave_hit - other.interleave_hit;
+      result.local_node = local_node - other.local_node;
+      result.other_node = other_node - other.other_node;
+      return result;
+    }
+  }; // struct NumaCounters
+
+  /// NUMA topology and memory placement
+
+  /// Memory pages are placed on the NUMA node of the thread that first
+  /// touches them. When NUMA placement is enabled, \c TilePool keeps freed
+  /// tile blocks in a cache of the node of the thread that freed them, and
+  /// only reuses them for tiles that are allocated on the same node, so tile
+  /// data stays on the node of the task that produced it. Tiles that are
+  /// initialized by multithreaded tensor operations (see
+  /// \c TensorParallelConfig ) are spread over the nodes of those threads.
+  /// Only tiles that are allocated with \c PoolAllocator are affected;
+  /// tiles with the default allocator are placed by the system alone. On
+  /// systems without NUMA support, there is a single node.
+  class NumaConfig {
+  private:
+
+    /// NUMA topology
+    struct Topology {
+      std::size_t nodes_ = 1ul; ///< The number of node ids
+      std::vector<std::size_t> cpu_nodes_; ///< The node of each cpu
+
+      Topology() {
+#if defined(__linux__)
+        const std::vector<std::size_t> online =
+            detail::parse_id_list(detail::read_line("/sys/devices/system/node/online"));
+        for(const std::size_t node : online) {
+          nodes_ = std::max(nodes_, node + 1ul);
+          const std::vector<std::size_t> cpus = detail::parse_id_list(detail::read_line(
+              "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+          for(const std::size_t cpu : cpus) {
+            if(cpu >= cpu_nodes_.size())
+              cpu_nodes_.resize(cpu + 1ul, 0ul);
+            cpu_nodes_[cpu] = node;
+          }
+        }
+#endif // defined(__linux__)
+      }
+    }; // struct Topology
+
+    // The topology is never destroyed, so tiles may be freed during static
+    // destruction.
+    static const Topology& topology_() {
+      static const Topology* topology = new Topology;
+      return *topology;
+    }
+
+    static std::atomic<bool>& enabled_() {
+      static std::atomic<bool> enabled(false);
+      return enabled;
+    }
+
+  public:
+
+    /// Check that NUMA placement is enabled
+
+    /// \return \c true if tile memory is kept on the node where it was
+    /// allocated
+    static bool enabled() { return enabled_().load(std::memory_order_relaxed); }
+
+    /// Enable or disable NUMA placement
+
+    /// On multi-node systems, each pooled free of a block of at least
+    /// \c TilePool::numa_block_size bytes queries the node of the block
+    /// with a system call, so placement should only be enabled when tile
+    /// data is produced and consumed by threads that are bound to nodes.
+    /// \param enabled If \c true , tile memory is kept on the node where it
+    /// was allocated [ default = false ]
+    static void set_enabled(const bool enabled) { enabled_() = enabled; }
+
+    /// NUMA node count accessor
+
+    /// \return The number of NUMA node ids, i.e. one more than the largest
+    /// node id
+    static std::size_t nodes() { return topology_().nodes_; }
+
+    /// Current NUMA node accessor
+
+    /// \return The node of the cpu that runs the calling thread
+    static std::size_t node() {
+#if defined(__linux__)
+      const std::vector<std::size_t>& cpu_nodes = topology_().cpu_nodes_;
+      const int cpu = sched_getcpu();
+      if((cpu >= 0) && (std::size_t(cpu) < cpu_nodes.size()))
+        return cpu_nodes[cpu];
+#endif // defined(__linux__)
+      return 0ul;
+    }
+
+    /// Memory location accessor
+
+    /// \param p A pointer to memory that has been touched
+    /// \return The node of the page that holds \c p , or \c nodes() if the
+    /// page has not been placed yet or the node is not known on a multi-node
+    /// system
+    static std::size_t node_of(const void* const p) {
+#if defined(__linux__) && defined(SYS_move_pages)
+      void* page = const_cast<void*>(p);
+      int status = -1;
+      // With a null node list, move_pages only queries the page locations
+      if((syscall(SYS_move_pages, 0, 1ul, & page, nullptr, & status, 0) == 0l) && (status >= 0))
+        return status;
+#endif // defined(__linux__) && defined(SYS_move_pages)
+      return (nodes() == 1ul ? 0ul : nodes());
+    }
+
+    /// Read the memory counters of all nodes
+
+    /// \return The counters of each node id
+    static std::vector<NumaCounters> counters() {
+      std::vector<NumaCounters> result;
+      result.reserve(nodes());
+      for(std::size_t node = 0ul; node < nodes(); ++node)
+        result.push_back(NumaCounters::read(node));
+      return result;
+    }
+
+  }; // class NumaConfig
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_NUMA_H__INCLUDED
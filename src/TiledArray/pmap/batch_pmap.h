@@ -0,0 +1,127 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_BATCH_PMAP_H__INCLUDED
+#define TILEDARRAY_PMAP_BATCH_PMAP_H__INCLUDED
+
+#include <TiledArray/pmap/pmap.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Map processes for a batch of tensors
+
+    /// The tiles are divided into \c batches contiguous slices of equal size,
+    /// and the tiles of each slice are distributed with the slice process map,
+    /// where the processes of slice \c b are shifted cyclically by
+    /// <tt>b * stride</tt> . That is, tile \c t is owned by process
+    /// <tt>(pmap->owner(t % n) + (t / n) * stride) % procs</tt>, where \c n
+    /// is the size of the slice process map. This is the distribution of
+    /// tensors where the batch dimensions lead. When the slice process map
+    /// includes only part of world, the stride places consecutive slices on
+    /// different processes.
+    class BatchPmap : public Pmap {
+    protected:
+
+      // Import Pmap protected variables
+      using Pmap::rank_; ///< The rank of this process
+      using Pmap::procs_; ///< The number of processes
+      using Pmap::size_; ///< The number of tiles mapped among all processes
+      using Pmap::local_; ///< A list of local tiles
+
+    private:
+
+      const std::shared_ptr<Pmap> pmap_; ///< The slice process map
+      const size_type stride_; ///< The process shift between slices
+
+    public:
+      typedef Pmap::size_type size_type; ///< Size type
+
+      /// Construct process map
+
+      /// \param world The world where the tiles will be mapped
+      /// \param batches The number of slices
+      /// \param pmap The process map of each slice
+      /// \param stride The number of processes that each slice is shifted by,
+      /// relative to the previous slice [ default = 0 ]
+      BatchPmap(World& world, const size_type batches,
+          const std::shared_ptr<Pmap>& pmap, const size_type stride = 0ul) :
+        Pmap(world, batches * pmap->size()), pmap_(pmap), stride_(stride % procs_)
+      {
+        TA_ASSERT(batches >= 1ul);
+        TA_ASSERT(pmap_->procs() == procs_);
+
+        // Initialize local tile list
+        const size_type n = pmap_->size();
+        for(size_type b = 0ul, offset = 0ul; b < batches; ++b, offset += n) {
+          if(stride_ == 0ul) {
+            for(const size_type tile : *pmap_)
+              local_.push_back(offset + tile);
+          } else {
+            // The local tiles of this slice are those owned by the process
+            // that is shifted onto this process
+            const size_type slice_rank = (rank_ + procs_ - shift(b)) % procs_;
+            for(size_type tile = 0ul; tile < n; ++tile)
+              if(pmap_->owner(tile) == slice_rank)
+                local_.push_back(offset + tile);
+          }
+        }
+      }
+
+      virtual ~BatchPmap() { }
+
+      /// Slice process map accessor
+
+      /// \return The process map of each slice
+      const std::shared_ptr<Pmap>& slice_pmap() const { return pmap_; }
+
+      /// Process shift of a slice
+
+      /// \param batch The slice index
+      /// \return The number of processes that the slice process map is
+      /// shifted by for slice \c batch
+      size_type shift(const size_type batch) const {
+        return (batch % procs_) * stride_ % procs_;
+      }
+
+      /// Maps \c tile to the processor that owns it
+
+      /// \param tile The tile to be queried
+      /// \return Processor that logically owns \c tile
+      virtual size_type owner(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        const size_type n = pmap_->size();
+        return (pmap_->owner(tile % n) + shift(tile / n)) % procs_;
+      }
+
+      /// Check that the tile is owned by this process
+
+      /// \param tile The tile to be checked
+      /// \return \c true if \c tile is owned by this process, otherwise \c false .
+      virtual bool is_local(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        return BatchPmap::owner(tile) == rank_;
+      }
+
+    }; // class BatchPmap
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_PMAP_BATCH_PMAP_H__INCLUDED
@@ -34,7 +34,9 @@ namespace TiledArray {
     /// Map processes using a 2D cyclic decomposition
 
     /// This map cyclicly distributes a two-dimensional grid of tiles among a
-    /// two-dimensional grid of processes.
+    /// two-dimensional grid of processes. The processes of the grid may be
+    /// shifted cyclically by an offset, so that process \c p of the grid is
+    /// process <tt>(p + offset) % procs</tt> of world.
     class CyclicPmap : public Pmap {
     protected:
 
@@ -50,6 +52,7 @@ namespace TiledArray {
       const size_type cols_; ///< Number of tile columns to be mapped
       const size_type proc_cols_; ///< Number of process columns
       const size_type proc_rows_; ///< Number of process rows
+      const size_type offset_; ///< The process offset of the grid
 
     public:
       typedef Pmap::size_type size_type; ///< Size type
@@ -61,13 +64,14 @@ namespace TiledArray {
       /// \param cols The number of tile columns to be mapped
       /// \param proc_rows The number of process rows in the map
       /// \param proc_cols The number of process columns in the map
+      /// \param offset The process offset of the grid [ default = 0 ]
       /// \throw TiledArray::Exception When <tt>proc_rows > rows</tt>
       /// \throw TiledArray::Exception When <tt>proc_cols > cols</tt>
       /// \throw TiledArray::Exception When <tt>proc_rows * proc_cols > world.size()</tt>
       CyclicPmap(World& world, size_type rows, size_type cols,
-          size_type proc_rows, size_type proc_cols) :
+          size_type proc_rows, size_type proc_cols, size_type offset = 0ul) :
         Pmap(world, rows * cols), rows_(rows), cols_(cols),
-        proc_cols_(proc_cols), proc_rows_(proc_rows)
+        proc_cols_(proc_cols), proc_rows_(proc_rows), offset_(offset)
       {
         // Check that the size is non-zero
         TA_ASSERT(rows_ >= 1ul);
@@ -77,12 +81,14 @@ namespace TiledArray {
         TA_ASSERT(proc_rows_ >= 1ul);
         TA_ASSERT(proc_cols_ >= 1ul);
         TA_ASSERT((proc_rows_ * proc_cols_) <= procs_);
+        TA_ASSERT(offset_ < procs_);
 
         // Initialize local tile list
-        if(rank_ < (proc_rows_ * proc_cols_)) {
+        const size_type grid_rank = (rank_ + procs_ - offset_) % procs_;
+        if(grid_rank < (proc_rows_ * proc_cols_)) {
           // Compute rank coordinates
-          const size_type rank_row = rank_ / proc_cols_;
-          const size_type rank_col = rank_ % proc_cols_;
+          const size_type rank_row = grid_rank / proc_cols_;
+          const size_type rank_col = grid_rank % proc_cols_;
 
           const size_type local_rows =
               (rows_ / proc_rows_) + ((rows_ % proc_rows_) < rank_row ? 1ul : 0ul);
@@ -118,7 +124,7 @@ namespace TiledArray {
         const size_type proc_row = tile_row % proc_rows_;
         const size_type proc_col = tile_col % proc_cols_;
         // Compute the process that owns tile
-        const size_type proc = proc_row * proc_cols_ + proc_col;
+        const size_type proc = (proc_row * proc_cols_ + proc_col + offset_) % procs_;
 
         TA_ASSERT(proc < procs_);
 
@@ -0,0 +1,129 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_FUSED_PMAP_H__INCLUDED
+#define TILEDARRAY_PMAP_FUSED_PMAP_H__INCLUDED
+
+#include <TiledArray/pmap/pmap.h>
+#include <TiledArray/tiled_range.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Compute the fused tile index of each tile
+
+    /// \param trange The tiled range
+    /// \param fused_trange The tiled range of the fused tiles, where each tile
+    /// boundary is also a tile boundary of \c trange
+    /// \return A vector where element \c t is the ordinal index of the fused
+    /// tile that contains tile \c t of \c trange
+    inline std::vector<std::size_t>
+    fused_tile_index(const TiledRange& trange, const TiledRange& fused_trange) {
+      TA_ASSERT(trange.elements() == fused_trange.elements());
+
+      const std::size_t n = trange.tiles().volume();
+      std::vector<std::size_t> fused_index;
+      fused_index.reserve(n);
+      for(std::size_t t = 0ul; t < n; ++t)
+        fused_index.push_back(fused_trange.tiles().ordinal(
+            fused_trange.element_to_tile(trange.make_tile_range(t).lobound())));
+
+      return fused_index;
+    }
+
+    /// Map processes for tiles that are fused
+
+    /// Each tile is owned by the process that owns the fused tile that
+    /// contains it. That is, tile \c t is owned by the process that owns tile
+    /// <tt>fused_index[t]</tt> in the fused process map, so the tiles of a
+    /// fused tile can be assembled without communication.
+    class FusedPmap : public Pmap {
+    protected:
+
+      // Import Pmap protected variables
+      using Pmap::rank_; ///< The rank of this process
+      using Pmap::procs_; ///< The number of processes
+      using Pmap::size_; ///< The number of tiles mapped among all processes
+      using Pmap::local_; ///< A list of local tiles
+
+    public:
+      typedef Pmap::size_type size_type; ///< Size type
+
+    private:
+
+      const std::shared_ptr<Pmap> pmap_; ///< The fused process map
+      const std::shared_ptr<const std::vector<size_type> > fused_index_; ///< The fused tile of each tile
+
+    public:
+
+      /// Construct process map
+
+      /// \param world The world where the tiles will be mapped
+      /// \param pmap The process map of the fused tiles
+      /// \param fused_index The fused tile index of each tile (see
+      /// \c fused_tile_index() )
+      FusedPmap(World& world, const std::shared_ptr<Pmap>& pmap,
+          const std::shared_ptr<const std::vector<size_type> >& fused_index) :
+        Pmap(world, fused_index->size()), pmap_(pmap), fused_index_(fused_index)
+      {
+        TA_ASSERT(pmap_->procs() == procs_);
+
+        // Initialize local tile list
+        for(size_type tile = 0ul; tile < size_; ++tile)
+          if(pmap_->is_local((*fused_index_)[tile]))
+            local_.push_back(tile);
+      }
+
+      virtual ~FusedPmap() { }
+
+      /// Fused process map accessor
+
+      /// \return The process map of the fused tiles
+      const std::shared_ptr<Pmap>& fused_pmap() const { return pmap_; }
+
+      /// Fused tile index accessor
+
+      /// \return The fused tile index of each tile
+      const std::shared_ptr<const std::vector<size_type> >& fused_index() const
+      { return fused_index_; }
+
+      /// Maps \c tile to the processor that owns it
+
+      /// \param tile The tile to be queried
+      /// \return Processor that logically owns \c tile
+      virtual size_type owner(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        return pmap_->owner((*fused_index_)[tile]);
+      }
+
+      /// Check that the tile is owned by this process
+
+      /// \param tile The tile to be checked
+      /// \return \c true if \c tile is owned by this process, otherwise \c false .
+      virtual bool is_local(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        return pmap_->is_local((*fused_index_)[tile]);
+      }
+
+    }; // class FusedPmap
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_PMAP_FUSED_PMAP_H__INCLUDED
@@ -0,0 +1,168 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_LAYERED_CYCLIC_PMAP_H__INCLUDED
+#define TILEDARRAY_PMAP_LAYERED_CYCLIC_PMAP_H__INCLUDED
+
+#include <TiledArray/pmap/pmap.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Map processes using a layered, 2D cyclic decomposition
+
+    /// This map divides the tile rows (or tile columns) into contiguous
+    /// slices, one for each layer of a three-dimensional process grid. The
+    /// tiles of each slice are cyclicly distributed among the two-dimensional
+    /// grid of processes in the corresponding layer. Layer \c l includes
+    /// processes <tt>[l * layer_stride, l * layer_stride + proc_rows * proc_cols)</tt>,
+    /// where <tt>layer_stride = procs / proc_layers</tt>, and it holds the
+    /// rows (or columns) <tt>[l * n / proc_layers, (l + 1) * n / proc_layers)</tt>.
+    /// The processes of the grid may be shifted cyclically by an offset, as
+    /// in \c CyclicPmap .
+    class LayeredCyclicPmap : public Pmap {
+    protected:
+
+      // Import Pmap protected variables
+      using Pmap::rank_; ///< The rank of this process
+      using Pmap::procs_; ///< The number of processes
+      using Pmap::size_; ///< The number of tiles mapped among all processes
+      using Pmap::local_; ///< A list of local tiles
+
+    private:
+
+      const size_type rows_; ///< Number of tile rows to be mapped
+      const size_type cols_; ///< Number of tile columns to be mapped
+      const size_type proc_cols_; ///< Number of process columns
+      const size_type proc_rows_; ///< Number of process rows
+      const size_type proc_layers_; ///< Number of process layers
+      const size_type layer_stride_; ///< Process offset between layers
+      const bool row_layers_; ///< Rows are divided among layers if true, otherwise columns
+      const size_type offset_; ///< The process offset of the grid
+
+      /// Compute the layer that holds a row or column
+
+      /// \param x The row or column index
+      /// \param n The number of rows or columns
+      /// \return The layer that holds row or column \c x
+      size_type layer(const size_type x, const size_type n) const {
+        return ((x + 1ul) * proc_layers_ - 1ul) / n;
+      }
+
+    public:
+      typedef Pmap::size_type size_type; ///< Size type
+
+      /// Construct process map
+
+      /// \param world The world where the tiles will be mapped
+      /// \param rows The number of tile rows to be mapped
+      /// \param cols The number of tile columns to be mapped
+      /// \param proc_rows The number of process rows in each layer
+      /// \param proc_cols The number of process columns in each layer
+      /// \param proc_layers The number of process layers
+      /// \param row_layers If \c true, the tile rows are divided among the
+      /// layers, otherwise the tile columns are divided among the layers
+      /// \param offset The process offset of the grid [ default = 0 ]
+      /// \throw TiledArray::Exception When <tt>proc_layers</tt> is greater
+      /// than the number of rows (or columns) that are divided among layers
+      /// \throw TiledArray::Exception When <tt>proc_rows * proc_cols * proc_layers > world.size()</tt>
+      LayeredCyclicPmap(World& world, size_type rows, size_type cols,
+          size_type proc_rows, size_type proc_cols, size_type proc_layers,
+          bool row_layers, size_type offset = 0ul) :
+        Pmap(world, rows * cols), rows_(rows), cols_(cols),
+        proc_cols_(proc_cols), proc_rows_(proc_rows), proc_layers_(proc_layers),
+        layer_stride_(procs_ / std::max<size_type>(proc_layers, 1ul)),
+        row_layers_(row_layers), offset_(offset)
+      {
+        // Check that the size is non-zero
+        TA_ASSERT(rows_ >= 1ul);
+        TA_ASSERT(cols_ >= 1ul);
+
+        // Check limits of process rows, columns, and layers
+        TA_ASSERT(proc_rows_ >= 1ul);
+        TA_ASSERT(proc_cols_ >= 1ul);
+        TA_ASSERT(proc_layers_ >= 1ul);
+        TA_ASSERT(proc_layers_ <= (row_layers_ ? rows_ : cols_));
+        TA_ASSERT((proc_rows_ * proc_cols_) <= layer_stride_);
+        TA_ASSERT(offset_ < procs_);
+
+        // Initialize local tile list
+        const size_type grid_rank = (rank_ + procs_ - offset_) % procs_;
+        const size_type rank_layer = grid_rank / layer_stride_;
+        const size_type layer_rank = grid_rank % layer_stride_;
+        if((rank_layer < proc_layers_) && (layer_rank < (proc_rows_ * proc_cols_))) {
+          // Compute rank coordinates
+          const size_type rank_row = layer_rank / proc_cols_;
+          const size_type rank_col = layer_rank % proc_cols_;
+
+          // Iterate over local tiles
+          for(size_type i = rank_row; i < rows_; i += proc_rows_) {
+            if(row_layers_ && (layer(i, rows_) != rank_layer)) continue;
+            const size_type row_end = (i + 1) * cols_;
+            for(size_type tile = i * cols_ + rank_col; tile < row_end; tile += proc_cols_) {
+              if(! row_layers_ && (layer(tile - i * cols_, cols_) != rank_layer))
+                continue;
+              TA_ASSERT(LayeredCyclicPmap::owner(tile) == rank_);
+              local_.push_back(tile);
+            }
+          }
+        }
+      }
+
+      virtual ~LayeredCyclicPmap() { }
+
+      /// Maps \c tile to the processor that owns it
+
+      /// \param tile The tile to be queried
+      /// \return Processor that logically owns \c tile
+      virtual size_type owner(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        // Compute tile coordinate in tile grid
+        const size_type tile_row = tile / cols_;
+        const size_type tile_col = tile % cols_;
+        // Compute process coordinate of tile in the process grid
+        const size_type proc_row = tile_row % proc_rows_;
+        const size_type proc_col = tile_col % proc_cols_;
+        const size_type proc_layer =
+            (row_layers_ ? layer(tile_row, rows_) : layer(tile_col, cols_));
+        // Compute the process that owns tile
+        const size_type proc = (proc_layer * layer_stride_
+            + proc_row * proc_cols_ + proc_col + offset_) % procs_;
+
+        TA_ASSERT(proc < procs_);
+
+        return proc;
+      }
+
+
+      /// Check that the tile is owned by this process
+
+      /// \param tile The tile to be checked
+      /// \return \c true if \c tile is owned by this process, otherwise \c false .
+      virtual bool is_local(const size_type tile) const {
+        return (LayeredCyclicPmap::owner(tile) == rank_);
+      }
+
+    }; // class LayeredCyclicPmap
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+
+#endif // TILEDARRAY_PMAP_LAYERED_CYCLIC_PMAP_H__INCLUDED
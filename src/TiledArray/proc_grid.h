@@ -27,7 +27,9 @@
 #define TILEDARRAY_GRID_H__INCLUDED
 
 #include <TiledArray/pmap/cyclic_pmap.h>
+#include <TiledArray/pmap/layered_cyclic_pmap.h>
 #include <TiledArray/math/eigen.h>
+#include <limits>
 
 namespace TiledArray {
   namespace detail {
@@ -56,6 +58,25 @@ namespace TiledArray {
     /// \f]
     /// where the positive, real root of \f$P_{\rm{row}}\f$ give the optimal
     /// optimal communication time.
+    ///
+    /// The process grid may also be divided into layers, where each layer is
+    /// a 2D process grid that includes <tt>P / layers</tt> processes. Layer
+    /// \c l includes the processes
+    /// <tt>[l * layer_stride, l * layer_stride + proc_size)</tt>, where
+    /// \c layer_stride is equal to <tt>P / layers</tt>. Each layer evaluates
+    /// a contiguous slice of the inner dimension of a contraction.
+    ///
+    /// The processes of the grid may be shifted cyclically by an offset (see
+    /// \c shift() ), so that process \c p of the grid is process
+    /// <tt>(p + offset) % P</tt> of world. This is used to place independent
+    /// contractions that use only part of world on different processes.
+    ///
+    /// For block-sparse arguments, the process grid may instead be selected
+    /// with a cost model that uses the argument shapes (see
+    /// \c SummaConfig::set_sparse_grid() ). The model estimates
+    /// the GEMM work and the broadcast data of each process for candidate
+    /// grids, and the grid with the smallest predicted makespan (i.e. the
+    /// cost of the busiest process) is used.
     class ProcGrid {
     public:
       typedef uint_fast32_t size_type;
@@ -74,6 +95,12 @@ namespace TiledArray {
       size_type local_rows_; ///< The number of local element rows
       size_type local_cols_; ///< The number of local element columns
       size_type local_size_; ///< Number of local elements
+      size_type proc_layers_; ///< Number of layers in the process grid
+      size_type layer_stride_; ///< Process offset between layers
+      size_type rank_layer_; ///< This process's layer in the process grid
+      size_type rank_; ///< The rank of this process
+      size_type procs_; ///< The number of processes
+      size_type proc_offset_; ///< The process offset of the grid
 
 
       /// Compute the number of process rows that minimizes communication
@@ -170,6 +197,94 @@ namespace TiledArray {
 
       /// Member variable initialization
 
+      /// This function initializes the member variables with with the optimal
+      /// sizes for a layered process grid.
+      /// \tparam Init The 2D process grid initialization function type
+      /// \param rank The rank of this process
+      /// \param nprocs The number of processes
+      /// \param layers The number of layers
+      /// \param init_2d The function that initializes the 2D process grid of
+      /// a layer, given the rank in the layer and the number of processes in
+      /// the layer
+      template <typename Init>
+      void init_layers(const size_type rank, const size_type nprocs,
+          const size_type layers, const Init& init_2d)
+      {
+        TA_ASSERT(layers >= 1u);
+        TA_ASSERT(layers <= nprocs);
+
+        rank_ = rank;
+        procs_ = nprocs;
+        proc_layers_ = layers;
+        layer_stride_ = nprocs / layers;
+        rank_layer_ = rank / layer_stride_;
+
+        // Processes that are not included in any layer have no local elements
+        if(rank_layer_ < proc_layers_) {
+          init_2d(rank % layer_stride_, layer_stride_);
+        } else {
+          init_2d(layer_stride_, layer_stride_);
+          rank_row_ = -1;
+          rank_col_ = -1;
+          local_rows_ = 0u;
+          local_cols_ = 0u;
+          local_size_ = 0u;
+        }
+      }
+
+      /// Initialize the coordinates and local counts of a shifted grid
+
+      /// The process grid size and layers must be set before calling this
+      /// function.
+      /// \param grid_rank The rank of this process in the grid, i.e. its rank
+      /// in world minus the process offset
+      void init_shifted_rank(const size_type grid_rank) {
+        rank_layer_ = grid_rank / layer_stride_;
+        const size_type layer_rank = grid_rank % layer_stride_;
+        if((rank_layer_ < proc_layers_) && (layer_rank < proc_size_)) {
+          rank_row_ = layer_rank / proc_cols_;
+          rank_col_ = layer_rank % proc_cols_;
+          local_rows_ = (rows_ / proc_rows_) + (size_type(rank_row_) < (rows_ % proc_rows_) ? 1u : 0u);
+          local_cols_ = (cols_ / proc_cols_) + (size_type(rank_col_) < (cols_ % proc_cols_) ? 1u : 0u);
+          local_size_ = local_rows_ * local_cols_;
+        } else {
+          rank_row_ = -1;
+          rank_col_ = -1;
+          local_rows_ = 0u;
+          local_cols_ = 0u;
+          local_size_ = 0u;
+        }
+      }
+
+      /// Map a process of the grid to a process of world
+
+      /// \param p The process in the grid
+      /// \return The process in world
+      ProcessID world_rank(const size_type p) const {
+        return (p + proc_offset_) % procs_;
+      }
+
+      /// Initialize the coordinates and local counts of this process
+
+      /// The process grid size must be set before calling this function.
+      /// \param rank The rank of this process
+      void init_rank(const size_type rank) {
+        proc_size_ = proc_rows_ * proc_cols_;
+
+        if(rank < proc_size_) {
+          // Set this process rank
+          rank_row_ = rank / proc_cols_;
+          rank_col_ = rank % proc_cols_;
+
+          // Set local counts
+          local_rows_ = (rows_ / proc_rows_) + (size_type(rank_row_) < (rows_ % proc_rows_) ? 1u : 0u);
+          local_cols_ = (cols_ / proc_cols_) + (size_type(rank_col_) < (cols_ % proc_cols_) ? 1u : 0u);
+          local_size_ = local_rows_ * local_cols_;
+        }
+      }
+
+      /// Member variable initialization
+
       /// This function initializes the member variables with with the optimal
       /// sizes.
       void init(const size_type rank, const size_type nprocs,
@@ -231,19 +346,152 @@ namespace TiledArray {
                 min_proc_rows, max_proc_rows);
           }
 
-          proc_size_ = proc_rows_ * proc_cols_;
+          init_rank(rank);
+        }
+      }
 
-          if(rank < proc_size_) {
-            // Set this process rank
-            rank_row_ = rank / proc_cols_;
-            rank_col_ = rank % proc_cols_;
+      /// Estimate the makespan of a sparse SUMMA for a process grid
+
+      /// The cost of each process is the sum of the time spent in tile GEMMs
+      /// and in receiving broadcast tiles, in units of the time required to
+      /// receive one element. A left-hand tile is only sent to the processes
+      /// of its process row that hold a non-zero right-hand tile in the
+      /// same SUMMA iteration, and vice versa.
+      /// \param proc_rows The number of process rows
+      /// \param proc_cols The number of process columns
+      /// \param left_nz The rows of the non-zero left-hand tiles of each
+      /// inner dimension tile
+      /// \param right_nz The columns of the non-zero right-hand tiles of each
+      /// inner dimension tile
+      /// \param m The average number of element rows in a tile
+      /// \param n The average number of element columns in a tile
+      /// \param k The average number of inner elements in a tile
+      /// \param flops_per_element The number of flops per element received
+      /// \param latency The message latency, in units of the time required to
+      /// receive one element
+      /// \return The cost of the busiest process
+      static double sparse_cost(const size_type proc_rows,
+          const size_type proc_cols,
+          const std::vector<std::vector<size_type> >& left_nz,
+          const std::vector<std::vector<size_type> >& right_nz,
+          const double m, const double n, const double k,
+          const double flops_per_element, const double latency)
+      {
+        const size_type nprocs = proc_rows * proc_cols;
+        std::vector<double> pairs(nprocs, 0.0), left_recv(nprocs, 0.0),
+            right_recv(nprocs, 0.0);
+        std::vector<size_type> a(proc_rows), b(proc_cols);
+
+        const size_type K = left_nz.size();
+        for(size_type kk = 0ul; kk < K; ++kk) {
+          // Count the non-zero tiles of this iteration in each process row
+          // and column
+          std::fill(a.begin(), a.end(), 0ul);
+          std::fill(b.begin(), b.end(), 0ul);
+          for(const size_type i : left_nz[kk])
+            ++a[i % proc_rows];
+          for(const size_type j : right_nz[kk])
+            ++b[j % proc_cols];
+
+          // The owners of the left- and right-hand tiles of this iteration
+          const size_type left_owner_col = kk % proc_cols;
+          const size_type right_owner_row = kk % proc_rows;
+
+          for(size_type r = 0ul; r < proc_rows; ++r) {
+            for(size_type c = 0ul; c < proc_cols; ++c) {
+              const size_type proc = r * proc_cols + c;
+              pairs[proc] += double(a[r] * b[c]);
+              if(b[c] && (c != left_owner_col))
+                left_recv[proc] += a[r];
+              if(a[r] && (r != right_owner_row))
+                right_recv[proc] += b[c];
+            }
+          }
+        }
 
-            // Set local counts
-            local_rows_ = (rows_ / proc_rows_) + (size_type(rank_row_) < (rows_ % proc_rows_) ? 1u : 0u);
-            local_cols_ = (cols_ / proc_cols_) + (size_type(rank_col_) < (cols_ % proc_cols_) ? 1u : 0u);
-            local_size_ = local_rows_ * local_cols_;
+        // Compute the cost of the busiest process
+        const double gemm_cost = 2.0 * m * n * k / flops_per_element;
+        const double left_cost = latency + m * k;
+        const double right_cost = latency + k * n;
+        double makespan = 0.0;
+        for(size_type proc = 0ul; proc < nprocs; ++proc)
+          makespan = std::max(makespan, pairs[proc] * gemm_cost
+              + left_recv[proc] * left_cost + right_recv[proc] * right_cost);
+
+        return makespan;
+      }
+
+      /// Member variable initialization for sparse arguments
+
+      /// This function initializes the member variables with the process grid
+      /// that minimizes the predicted makespan of a sparse SUMMA, as given by
+      /// \c sparse_cost(). All grids that use the largest number of process
+      /// rows for a given number of process columns are tested.
+      /// \tparam LeftShape The left-hand shape type
+      /// \tparam RightShape The right-hand shape type
+      /// \param rank The rank of this process
+      /// \param nprocs The number of processes
+      /// \param row_size The number of element rows
+      /// \param col_size The number of element columns
+      /// \param inner_size The number of inner elements
+      /// \param inner The number of inner tiles
+      /// \param left The shape of the left-hand argument, which has
+      /// <tt>rows * inner</tt> tiles
+      /// \param right The shape of the right-hand argument, which has
+      /// <tt>inner * cols</tt> tiles
+      /// \param flops_per_element The number of flops per element received
+      /// \param latency The message latency, in units of the time required to
+      /// receive one element
+      template <typename LeftShape, typename RightShape>
+      void init(const size_type rank, const size_type nprocs,
+          const std::size_t row_size, const std::size_t col_size,
+          const std::size_t inner_size, const size_type inner,
+          const LeftShape& left, const RightShape& right,
+          const double flops_per_element, const double latency)
+      {
+        // Use the simple distributions when there is no choice to be made
+        if((nprocs == 1u) || (size_ <= nprocs)) {
+          init(rank, nprocs, row_size, col_size);
+          return;
+        }
+
+        // Collect the non-zero tiles of each SUMMA iteration
+        std::vector<std::vector<size_type> > left_nz(inner), right_nz(inner);
+        for(size_type i = 0ul; i < rows_; ++i)
+          for(size_type k = 0ul; k < inner; ++k)
+            if(! left.is_zero(i * inner + k))
+              left_nz[k].push_back(i);
+        for(size_type k = 0ul; k < inner; ++k)
+          for(size_type j = 0ul; j < cols_; ++j)
+            if(! right.is_zero(k * cols_ + j))
+              right_nz[k].push_back(j);
+
+        // Compute average tile sizes
+        const double m = double(row_size) / double(rows_);
+        const double n = double(col_size) / double(cols_);
+        const double k = double(inner_size) / double(inner);
+
+        // Search for the process grid with the smallest makespan
+        const size_type max_proc_rows = std::min<size_type>(nprocs, rows_);
+        double min_cost = std::numeric_limits<double>::max();
+        for(size_type test_rows = 1ul; test_rows <= max_proc_rows; ++test_rows) {
+          const size_type test_cols = std::min<size_type>(nprocs / test_rows, cols_);
+
+          // Skip grids that use fewer processes for the same number of columns
+          if((test_rows < max_proc_rows) &&
+              (std::min<size_type>(nprocs / (test_rows + 1ul), cols_) == test_cols))
+            continue;
+
+          const double cost = sparse_cost(test_rows, test_cols, left_nz,
+              right_nz, m, n, k, flops_per_element, latency);
+          if(cost < min_cost) {
+            min_cost = cost;
+            proc_rows_ = test_rows;
+            proc_cols_ = test_cols;
           }
         }
+
+        init_rank(rank);
       }
 
     public:
@@ -253,7 +501,9 @@ namespace TiledArray {
       ProcGrid() :
         world_(NULL), rows_(0u), cols_(0u), size_(0u), proc_rows_(0u),
         proc_cols_(0u), proc_size_(0u), rank_row_(0), rank_col_(0),
-        local_rows_(0u), local_cols_(0u), local_size_(0u)
+        local_rows_(0u), local_cols_(0u), local_size_(0u), proc_layers_(0u),
+        layer_stride_(0u), rank_layer_(0u), rank_(0u), procs_(0u),
+        proc_offset_(0u)
       { }
 
       /// Construct a process grid
@@ -266,20 +516,77 @@ namespace TiledArray {
       /// \param cols The number of tile columns
       /// \param row_size The number of element rows
       /// \param col_size The number of element columns
+      /// \param layers The number of layers in the process grid [ default = 1 ]
+      ProcGrid(World& world, const size_type rows, const size_type cols,
+          const std::size_t row_size, const std::size_t col_size,
+          const size_type layers = 1u) :
+        world_(&world), rows_(rows), cols_(cols), size_(rows_ * cols_),
+        proc_rows_(0ul), proc_cols_(0ul), proc_size_(0ul),
+        rank_row_(-1), rank_col_(-1),
+        local_rows_(0ul), local_cols_(0ul), local_size_(0ul),
+        proc_layers_(0ul), layer_stride_(0ul), rank_layer_(0ul), rank_(0ul),
+        procs_(0ul), proc_offset_(0ul)
+      {
+        // Check for non-zero sizes
+        TA_ASSERT(rows_ >= 1u);
+        TA_ASSERT(cols_ >= 1u);
+        TA_ASSERT(row_size >= 1ul);
+        TA_ASSERT(col_size >= 1ul);
+
+        init_layers(world_->rank(), world_->size(), layers,
+            [=] (const size_type rank, const size_type nprocs)
+            { this->init(rank, nprocs, row_size, col_size); });
+      }
+
+      /// Construct a process grid for sparse arguments
+
+      /// The process grid is selected with a cost model that uses the shapes
+      /// of the contraction arguments, such that the predicted makespan of
+      /// SUMMA is minimized.
+      /// \tparam LeftShape The left-hand shape type
+      /// \tparam RightShape The right-hand shape type
+      /// \param world The world where the process grid will live
+      /// \param rows The number of tile rows
+      /// \param cols The number of tile columns
+      /// \param row_size The number of element rows
+      /// \param col_size The number of element columns
+      /// \param inner The number of inner tiles
+      /// \param inner_size The number of inner elements
+      /// \param left The shape of the left-hand argument, with
+      /// <tt>rows * inner</tt> tiles
+      /// \param right The shape of the right-hand argument, with
+      /// <tt>inner * cols</tt> tiles
+      /// \param layers The number of layers in the process grid [ default = 1 ]
+      /// \param flops_per_element The number of flops per element received
+      /// [ default = 64 ]
+      /// \param latency The message latency, in units of the time required to
+      /// receive one element [ default = 1024 ]
+      template <typename LeftShape, typename RightShape>
       ProcGrid(World& world, const size_type rows, const size_type cols,
-          const std::size_t row_size, const std::size_t col_size) :
+          const std::size_t row_size, const std::size_t col_size,
+          const size_type inner, const std::size_t inner_size,
+          const LeftShape& left, const RightShape& right,
+          const size_type layers = 1u, const double flops_per_element = 64.0,
+          const double latency = 1024.0) :
         world_(&world), rows_(rows), cols_(cols), size_(rows_ * cols_),
         proc_rows_(0ul), proc_cols_(0ul), proc_size_(0ul),
         rank_row_(-1), rank_col_(-1),
-        local_rows_(0ul), local_cols_(0ul), local_size_(0ul)
+        local_rows_(0ul), local_cols_(0ul), local_size_(0ul),
+        proc_layers_(0ul), layer_stride_(0ul), rank_layer_(0ul), rank_(0ul),
+        procs_(0ul), proc_offset_(0ul)
       {
         // Check for non-zero sizes
         TA_ASSERT(rows_ >= 1u);
         TA_ASSERT(cols_ >= 1u);
+        TA_ASSERT(inner >= 1u);
         TA_ASSERT(row_size >= 1ul);
         TA_ASSERT(col_size >= 1ul);
+        TA_ASSERT(inner_size >= 1ul);
 
-        init(world_->rank(), world_->size(), row_size, col_size);
+        init_layers(world_->rank(), world_->size(), layers,
+            [&] (const size_type rank, const size_type nprocs)
+            { this->init(rank, nprocs, row_size, col_size, inner_size, inner,
+                left, right, flops_per_element, latency); });
       }
 
 #ifdef TILEDARRAY_ENABLE_TEST_PROC_GRID
@@ -300,12 +607,16 @@ namespace TiledArray {
       /// \param cols The number of tile columns
       /// \param row_size The number of element rows
       /// \param col_size The number of element columns
+      /// \param layers The number of layers in the process grid [ default = 1 ]
       ProcGrid(World& world, const size_type test_rank, size_type test_nprocs,
           const size_type rows, const size_type cols,
-          const std::size_t row_size, const std::size_t col_size) :
+          const std::size_t row_size, const std::size_t col_size,
+          const size_type layers = 1u) :
         world_(&world), rows_(rows), cols_(cols), size_(rows_ * cols_),
         proc_rows_(0u), proc_cols_(0u), proc_size_(0u), rank_row_(-1),
-        rank_col_(-1), local_rows_(0u), local_cols_(0u), local_size_(0u)
+        rank_col_(-1), local_rows_(0u), local_cols_(0u), local_size_(0u),
+        proc_layers_(0u), layer_stride_(0u), rank_layer_(0u), rank_(0u),
+        procs_(0u), proc_offset_(0u)
       {
         // Check for non-zero sizes
         TA_ASSERT(rows >= 1u);
@@ -314,7 +625,56 @@ namespace TiledArray {
         TA_ASSERT(col_size >= 1u);
         TA_ASSERT(test_rank < test_nprocs);
 
-        init(test_rank, test_nprocs, row_size, col_size);
+        init_layers(test_rank, test_nprocs, layers,
+            [=] (const size_type rank, const size_type nprocs)
+            { this->init(rank, nprocs, row_size, col_size); });
+      }
+
+      /// Construct a process grid for sparse arguments
+
+      /// \param world The world where the process grid will live
+      /// \param test_rank Test rank
+      /// \param test_nprocs Test number of procs
+      /// \param rows The number of tile rows
+      /// \param cols The number of tile columns
+      /// \param row_size The number of element rows
+      /// \param col_size The number of element columns
+      /// \param inner The number of inner tiles
+      /// \param inner_size The number of inner elements
+      /// \param left The shape of the left-hand argument
+      /// \param right The shape of the right-hand argument
+      /// \param layers The number of layers in the process grid [ default = 1 ]
+      /// \param flops_per_element The number of flops per element received
+      /// [ default = 64 ]
+      /// \param latency The message latency, in units of the time required to
+      /// receive one element [ default = 1024 ]
+      template <typename LeftShape, typename RightShape>
+      ProcGrid(World& world, const size_type test_rank, size_type test_nprocs,
+          const size_type rows, const size_type cols,
+          const std::size_t row_size, const std::size_t col_size,
+          const size_type inner, const std::size_t inner_size,
+          const LeftShape& left, const RightShape& right,
+          const size_type layers = 1u, const double flops_per_element = 64.0,
+          const double latency = 1024.0) :
+        world_(&world), rows_(rows), cols_(cols), size_(rows_ * cols_),
+        proc_rows_(0u), proc_cols_(0u), proc_size_(0u), rank_row_(-1),
+        rank_col_(-1), local_rows_(0u), local_cols_(0u), local_size_(0u),
+        proc_layers_(0u), layer_stride_(0u), rank_layer_(0u), rank_(0u),
+        procs_(0u), proc_offset_(0u)
+      {
+        // Check for non-zero sizes
+        TA_ASSERT(rows >= 1u);
+        TA_ASSERT(cols >= 1u);
+        TA_ASSERT(inner >= 1u);
+        TA_ASSERT(row_size >= 1u);
+        TA_ASSERT(col_size >= 1u);
+        TA_ASSERT(inner_size >= 1u);
+        TA_ASSERT(test_rank < test_nprocs);
+
+        init_layers(test_rank, test_nprocs, layers,
+            [&] (const size_type rank, const size_type nprocs)
+            { this->init(rank, nprocs, row_size, col_size, inner_size, inner,
+                left, right, flops_per_element, latency); });
       }
 #endif // TILEDARRAY_ENABLE_TEST_PROC_GRID
 
@@ -330,7 +690,10 @@ namespace TiledArray {
         proc_cols_(other.proc_cols_), proc_size_(other.proc_size_),
         rank_row_(other.rank_row_), rank_col_(other.rank_col_),
         local_rows_(other.local_rows_), local_cols_(other.local_cols_),
-        local_size_(other.local_size_)
+        local_size_(other.local_size_), proc_layers_(other.proc_layers_),
+        layer_stride_(other.layer_stride_), rank_layer_(other.rank_layer_),
+        rank_(other.rank_), procs_(other.procs_),
+        proc_offset_(other.proc_offset_)
       { }
 
       /// Copy assignment operator
@@ -349,6 +712,12 @@ namespace TiledArray {
         local_rows_ = other.local_rows_;
         local_cols_ = other.local_cols_;
         local_size_ = other.local_size_;
+        proc_layers_ = other.proc_layers_;
+        layer_stride_ = other.layer_stride_;
+        rank_layer_ = other.rank_layer_;
+        rank_ = other.rank_;
+        procs_ = other.procs_;
+        proc_offset_ = other.proc_offset_;
 
         return *this;
       }
@@ -409,6 +778,53 @@ namespace TiledArray {
       /// less than the number of process in world).
       size_type proc_size() const { return proc_size_; }
 
+      /// Process layer count accessor
+
+      /// \return The number of layers in the process grid
+      size_type proc_layers() const { return proc_layers_; }
+
+      /// Rank layer accessor
+
+      /// \return The layer of this process in the process grid
+      size_type rank_layer() const { return rank_layer_; }
+
+      /// Compute the first row or column of a layer slice
+
+      /// The \c n rows or columns of the inner dimension are divided into
+      /// contiguous slices, one for each layer.
+      /// \param n The number of rows or columns to be divided among layers
+      /// \param layer The layer
+      /// \return The first row or column of the slice held by \c layer
+      size_type layer_begin(const size_type n, const size_type layer) const {
+        TA_ASSERT(layer <= proc_layers_);
+        return (layer * n) / proc_layers_;
+      }
+
+      /// Process offset accessor
+
+      /// \return The offset of the processes of the grid in world
+      size_type proc_offset() const { return proc_offset_; }
+
+      /// Process span accessor
+
+      /// \return The number of consecutive processes, starting at the
+      /// process offset, that include all processes of the grid
+      size_type proc_span() const {
+        return (proc_layers_ - 1u) * layer_stride_ + proc_size_;
+      }
+
+      /// Construct a shifted process grid
+
+      /// \param offset The number of processes the grid is shifted by
+      /// \return A copy of this process grid, where process \c p of the
+      /// grid is process <tt>(p + offset) % P</tt> of this grid
+      ProcGrid shift(const size_type offset) const {
+        ProcGrid result(*this);
+        result.proc_offset_ = (proc_offset_ + (offset % procs_)) % procs_;
+        result.init_shifted_rank((rank_ + procs_ - result.proc_offset_) % procs_);
+        return result;
+      }
+
 
       /// Construct a row group
 
@@ -425,10 +841,10 @@ namespace TiledArray {
           proc_list.reserve(proc_cols_);
 
           // Populate the row process list
-          size_type p = rank_row_ * proc_cols_;
+          size_type p = rank_layer_ * layer_stride_ + rank_row_ * proc_cols_;
           const size_type row_end = p + proc_cols_;
           for(; p < row_end; ++p)
-            proc_list.push_back(p);
+            proc_list.push_back(world_rank(p));
 
           // Construct the group
           group = madness::Group(*world_, proc_list, did);
@@ -452,8 +868,9 @@ namespace TiledArray {
           proc_list.reserve(proc_rows_);
 
           // Populate the column process list
+          const size_type layer_offset = rank_layer_ * layer_stride_;
           for(size_type p = rank_col_; p < proc_size_; p += proc_cols_)
-            proc_list.push_back(p);
+            proc_list.push_back(world_rank(layer_offset + p));
 
           // Construct the group
           if(proc_list.size() != 0)
@@ -469,7 +886,7 @@ namespace TiledArray {
       /// \return The process the corresponds to the process coordinate \c (row,rank_col)
       ProcessID map_row(const size_type row) const {
         TA_ASSERT(row < proc_rows_);
-        return rank_col_ + row * proc_cols_;
+        return world_rank(rank_layer_ * layer_stride_ + rank_col_ + row * proc_cols_);
       }
 
       /// Map a column to the process in this process's row
@@ -478,41 +895,64 @@ namespace TiledArray {
       /// \return The process the corresponds to the process coordinate \c (rank_row,col)
       ProcessID map_col(const size_type col) const {
         TA_ASSERT(col < proc_cols_);
-        return rank_row_ * proc_cols_ + col;
+        return world_rank(rank_layer_ * layer_stride_ + rank_row_ * proc_cols_ + col);
+      }
+
+      /// Map a layer to the process at this process's row and column
+
+      /// \param layer The layer to be mapped
+      /// \return The process the corresponds to the process coordinate \c (rank_row,rank_col,layer)
+      ProcessID map_layer(const size_type layer) const {
+        TA_ASSERT(layer < proc_layers_);
+        return world_rank(layer * layer_stride_ + rank_row_ * proc_cols_ + rank_col_);
       }
 
       /// Construct a cyclic process
 
-      /// Construct a cyclic process map with the same phase as the process grid.
+      /// Construct a cyclic process map with the same phase as the process
+      /// grid. Tiles are only mapped to the processes in the first layer.
       /// \return Cyclic process map
       std::shared_ptr<Pmap> make_pmap() const {
         TA_ASSERT(world_);
 
-        return std::shared_ptr<Pmap>(new CyclicPmap(*world_, rows_, cols_, proc_rows_, proc_cols_));
+        return std::shared_ptr<Pmap>(new CyclicPmap(*world_, rows_, cols_,
+            proc_rows_, proc_cols_, proc_offset_));
       }
 
       /// Construct column phased a cyclic process
 
       /// Construct a cyclic process map where the column phase of the process
-      /// matches that of this process grid.
+      /// matches that of this process grid. When the process grid has more
+      /// than one layer, the rows are divided among the layers.
       /// \param rows The number of rows in the process map
       /// \return Cyclic process map with matching column phase
       std::shared_ptr<Pmap> make_col_phase_pmap(const size_type rows) const {
         TA_ASSERT(world_);
 
-        return std::shared_ptr<Pmap>(new CyclicPmap(*world_, rows, cols_, proc_rows_, proc_cols_));
+        if(proc_layers_ > 1u)
+          return std::shared_ptr<Pmap>(new LayeredCyclicPmap(*world_, rows,
+              cols_, proc_rows_, proc_cols_, proc_layers_, true, proc_offset_));
+
+        return std::shared_ptr<Pmap>(new CyclicPmap(*world_, rows, cols_,
+            proc_rows_, proc_cols_, proc_offset_));
       }
 
       /// Construct row phased a cyclic process
 
       /// Construct a cyclic process map where the column phase of the process
-      /// matches that of this process grid.
+      /// matches that of this process grid. When the process grid has more
+      /// than one layer, the columns are divided among the layers.
       /// \param cols The number of columns in the process map
       /// \return Cyclic process map with matching column phase
       std::shared_ptr<Pmap> make_row_phase_pmap(const size_type cols) const {
         TA_ASSERT(world_);
 
-        return std::shared_ptr<Pmap>(new CyclicPmap(*world_, rows_, cols, proc_rows_, proc_cols_));
+        if(proc_layers_ > 1u)
+          return std::shared_ptr<Pmap>(new LayeredCyclicPmap(*world_, rows_,
+              cols, proc_rows_, proc_cols_, proc_layers_, false, proc_offset_));
+
+        return std::shared_ptr<Pmap>(new CyclicPmap(*world_, rows_, cols,
+            proc_rows_, proc_cols_, proc_offset_));
       }
     }; // class Grid
 
@@ -46,6 +46,8 @@ namespace TiledArray {
     typedef detail::RangeIterator<size_type, Range_> const_iterator; ///< Coordinate iterator
     friend class detail::RangeIterator<size_type, Range_>;
 
+    static constexpr unsigned int inline_rank = 6u; ///< The largest rank that is stored without heap allocation
+
   protected:
 
     size_type* data_ = nullptr;
@@ -60,6 +62,64 @@ namespace TiledArray {
     size_type offset_ = 0ul; ///< Ordinal index offset correction
     size_type volume_ = 0ul; ///< Total number of elements
     unsigned int rank_ = 0u; ///< The rank (or number of dimensions) in the range
+    size_type inline_data_[inline_rank << 2]; ///< Storage of \c data_ for ranks up to \c inline_rank
+
+    /// Allocate range data
+
+    /// Ranges with a rank of at most \c inline_rank use the storage of this
+    /// object, so they are constructed without heap allocation.
+    /// \pre \c data_ is not allocated
+    /// \param n The rank of the range
+    /// \post \c data_ holds 4*n elements and \c rank_ is equal to \c n
+    /// \throw std::bad_alloc When memory allocation fails.
+    void alloc_data(const unsigned int n) {
+      data_ = (n == 0u ? nullptr : (n <= inline_rank ? inline_data_ : new size_type[n << 2]));
+      rank_ = n;
+    }
+
+    /// Free range data
+
+    /// \post \c data_ is \c nullptr and \c rank_ is zero
+    void free_data() {
+      if(data_ != inline_data_)
+        delete [] data_;
+      data_ = nullptr;
+      rank_ = 0u;
+    }
+
+    /// Reallocate range data
+
+    /// \param n The rank of the range
+    /// \post \c data_ holds 4*n elements and \c rank_ is equal to \c n
+    /// \throw std::bad_alloc When memory allocation fails.
+    void realloc_data(const unsigned int n) {
+      if(rank_ != n) {
+        free_data();
+        alloc_data(n);
+      }
+    }
+
+    /// Move range data from another range
+
+    /// \pre \c data_ is not allocated
+    /// \param other The range that is moved to this range
+    /// \post \c other is empty
+    void move_data(Range_& other) {
+      if(other.data_ == other.inline_data_) {
+        data_ = inline_data_;
+        memcpy(inline_data_, other.inline_data_, (sizeof(size_type) << 2) * other.rank_);
+      } else {
+        data_ = other.data_;
+      }
+      offset_ = other.offset_;
+      volume_ = other.volume_;
+      rank_ = other.rank_;
+
+      other.data_ = nullptr;
+      other.offset_ = 0ul;
+      other.volume_ = 0ul;
+      other.rank_ = 0u;
+    }
 
   private:
 
@@ -213,8 +273,7 @@ namespace TiledArray {
       TA_ASSERT(n == detail::size(upper_bound));
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
-        rank_ = n;
+        alloc_data(n);
         init_range_data(lower_bound, upper_bound);
       }
     }
@@ -235,8 +294,7 @@ namespace TiledArray {
       TA_ASSERT(n == detail::size(upper_bound));
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
-        rank_ = n;
+        alloc_data(n);
         init_range_data(lower_bound, upper_bound);
       }
     }
@@ -254,8 +312,7 @@ namespace TiledArray {
       const size_type n = detail::size(extent);
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
-        rank_ = n;
+        alloc_data(n);
         init_range_data(extent);
       }
     }
@@ -270,8 +327,7 @@ namespace TiledArray {
       const size_type n = detail::size(extent);
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
-        rank_ = n;
+        alloc_data(n);
         init_range_data(extent);
       }
     }
@@ -294,27 +350,18 @@ namespace TiledArray {
     /// \throw std::bad_alloc When memory allocation fails.
     Range(const Range_& other) {
       if(other.rank_ > 0ul) {
-        data_ = new size_type[other.rank_ << 2];
+        alloc_data(other.rank_);
         offset_ = other.offset_;
         volume_ = other.volume_;
-        rank_ = other.rank_;
         memcpy(data_, other.data_, (sizeof(size_type) << 2) * other.rank_);
       }
     }
 
-    /// Copy Constructor
+    /// Move Constructor
 
-    /// \param other The range to be copied
-    /// \throw std::bad_alloc When memory allocation fails.
-    Range(Range_&& other) :
-      data_(other.data_), offset_(other.offset_), volume_(other.volume_),
-      rank_(other.rank_)
-    {
-      other.data_ = nullptr;
-      other.offset_ = 0ul;
-      other.volume_ = 0ul;
-      other.rank_ = 0u;
-    }
+    /// \param other The range to be moved
+    /// \throw nothing
+    Range(Range_&& other) { move_data(other); }
 
     /// Permuting copy constructor
 
@@ -325,8 +372,7 @@ namespace TiledArray {
       TA_ASSERT(perm.dim() == other.rank_);
 
       if(other.rank_ > 0ul) {
-        data_ = new size_type[other.rank_ << 2];
-        rank_ = other.rank_;
+        alloc_data(other.rank_);
 
         if(perm) {
           init_range_data(perm, other.data_, other.data_ + rank_);
@@ -340,7 +386,7 @@ namespace TiledArray {
     }
 
     /// Destructor
-    ~Range() { delete [] data_; }
+    ~Range() { free_data(); }
 
     /// Copy assignment operator
 
@@ -348,12 +394,9 @@ namespace TiledArray {
     /// \return A reference to this object
     /// \throw std::bad_alloc When memory allocation fails.
     Range_& operator=(const Range_& other) {
-      if(rank_ != other.rank_) {
-        delete [] data_;
-        data_ = (other.rank_ > 0ul ? new size_type[other.rank_ << 2] : nullptr);
-        rank_ = other.rank_;
-      }
-      memcpy(data_, other.data_, (sizeof(size_type) << 2) * rank_);
+      realloc_data(other.rank_);
+      if(rank_ > 0u)
+        memcpy(data_, other.data_, (sizeof(size_type) << 2) * rank_);
       offset_ = other.offset_;
       volume_ = other.volume_;
 
@@ -366,15 +409,10 @@ namespace TiledArray {
     /// \return A reference to this object
     /// \throw nothing
     Range_& operator=(Range_&& other) {
-      data_ = other.data_;
-      offset_ = other.offset_;
-      volume_ = other.volume_;
-      rank_ = other.rank_;
-
-      other.data_ = nullptr;
-      other.offset_ = 0ul;
-      other.volume_ = 0ul;
-      other.rank_ = 0u;
+      if(this != & other) {
+        free_data();
+        move_data(other);
+      }
 
       return *this;
     }
@@ -548,11 +586,7 @@ namespace TiledArray {
       TA_ASSERT(n == detail::size(upper_bound));
 
       // Reallocate memory for range arrays
-      if(rank_ != n) {
-        delete [] data_;
-        data_ = (n > 0ul ? new size_type[n << 2] : nullptr);
-        rank_ = n;
-      }
+      realloc_data(n);
       if(n > 0ul)
         init_range_data(lower_bound, upper_bound);
       else
@@ -717,11 +751,7 @@ namespace TiledArray {
 
       // Reallocate the array
       const unsigned int four_x_rank = rank << 2;
-      if(rank_ != rank) {
-        delete [] data_;
-        data_ = (rank > 0u ? new size_type[four_x_rank] : nullptr);
-        rank_ = rank;
-      }
+      realloc_data(rank);
 
       // Get range data
       ar & madness::archive::wrap(data_, four_x_rank) & offset_ & volume_;
@@ -734,11 +764,10 @@ namespace TiledArray {
     }
 
     void swap(Range_& other) {
-      // Get temp data
-      std::swap(data_, other.data_);
-      std::swap(offset_, other.offset_);
-      std::swap(volume_, other.volume_);
-      std::swap(rank_, other.rank_);
+      // Inline range data is exchanged by moving it
+      Range_ temp(std::move(other));
+      other.move_data(*this);
+      move_data(temp);
     }
 
   private:
@@ -825,14 +854,17 @@ namespace TiledArray {
     TA_ASSERT(perm.dim() == rank_);
     if(rank_ > 1ul) {
       // Copy the lower and upper bound data into a temporary array
-      size_type* restrict const temp_lower = new size_type[rank_ << 1];
+      size_type inline_temp[inline_rank << 1];
+      size_type* restrict const temp_lower =
+          (rank_ <= inline_rank ? inline_temp : new size_type[rank_ << 1]);
       const size_type* restrict const temp_upper = temp_lower + rank_;
       std::memcpy(temp_lower, data_, (sizeof(size_type) << 1) * rank_);
 
       init_range_data(perm, temp_lower, temp_upper);
 
       // Cleanup old memory.
-      delete[] temp_lower;
+      if(temp_lower != inline_temp)
+        delete[] temp_lower;
     }
     return *this;
   }
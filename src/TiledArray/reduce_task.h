@@ -22,6 +22,7 @@
 
 #include <TiledArray/error.h>
 #include <TiledArray/madness.h>
+#include <atomic>
 
 namespace TiledArray {
   namespace detail {
@@ -41,6 +42,83 @@ namespace TiledArray {
       typedef std::pair<Future<T>, Future<U> > type;
     }; // struct ArgumentHelper
 
+    /// Thread-local free list of fixed-size memory blocks
+
+    /// Blocks that are deallocated by a thread are kept in a free list of
+    /// that thread, and reused by later allocations on the same thread. The
+    /// free list of each thread holds at most \c max_blocks blocks; the
+    /// remaining blocks are returned to the global allocator. Blocks may be
+    /// allocated and deallocated by different threads.
+    /// \tparam Size The size of the memory blocks in bytes
+    template <std::size_t Size>
+    class FreeList {
+    private:
+
+      /// Free memory block
+      struct Node {
+        Node* next; ///< The next free block
+      }; // struct Node
+
+      static constexpr std::size_t block_size =
+          (Size > sizeof(Node) ? Size : sizeof(Node)); ///< Block size
+
+      /// Free list of a single thread
+      struct Cache {
+        Node* head; ///< The first free block
+        std::size_t size; ///< The number of free blocks
+
+        Cache() : head(nullptr), size(0ul) { }
+
+        ~Cache() {
+          while(head) {
+            Node* const node = head;
+            head = node->next;
+            ::operator delete(node);
+          }
+        }
+      }; // struct Cache
+
+      /// Free list of the calling thread
+      static Cache& cache() {
+        static thread_local Cache cache;
+        return cache;
+      }
+
+    public:
+
+      static constexpr std::size_t max_blocks = 1024ul; ///< The maximum number of free blocks per thread
+
+      /// Allocate a memory block
+
+      /// \return A pointer to an uninitialized block of \c Size bytes
+      static void* allocate() {
+        Cache& c = cache();
+        if(c.head) {
+          Node* const node = c.head;
+          c.head = node->next;
+          --c.size;
+          return node;
+        }
+        return ::operator new(block_size);
+      }
+
+      /// Deallocate a memory block
+
+      /// \param p A pointer to a block that was allocated by \c allocate()
+      static void deallocate(void* p) {
+        Cache& c = cache();
+        if(c.size < max_blocks) {
+          Node* const node = static_cast<Node*>(p);
+          node->next = c.head;
+          c.head = node;
+          ++c.size;
+        } else {
+          ::operator delete(p);
+        }
+      }
+
+    }; // class FreeList
+
     /// Wrapper that to convert a pair-wise reduction into a standard reduction
 
     /// \tparam opT The pair-wise reduction operation to be reduced
@@ -93,6 +171,16 @@ namespace TiledArray {
       /// Create an default reduction object
       result_type operator()() const { return op_(); }
 
+      /// Reset a result object for reuse
+
+      /// This function is only available when \c opT can reset a result
+      /// object.
+      /// \param[in,out] result The result object that will be reset
+      template <typename Op = opT>
+      auto reset(result_type& result) const ->
+          decltype(std::declval<const Op&>().reset(result), void())
+      { op_.reset(result); }
+
       result_type operator()(const result_type temp) const { return op_(temp); }
 
       /// Reduce two result objects
@@ -111,6 +199,25 @@ namespace TiledArray {
         op_(result, arg.first, arg.second);
       }
 
+      /// Reduce two argument pairs
+
+      /// This overload is only available when \c opT can reduce two argument
+      /// pairs at once (e.g. by fusing the two pairs into one operation).
+      /// \param[out] result The object that will hold the result of this reduction
+      /// \param[in] arg1 The first argument pair to be reduced
+      /// \param[in] arg2 The second argument pair to be reduced
+      template <typename Op = opT>
+      auto operator()(result_type& result, const argument_type& arg1,
+          const argument_type& arg2) const ->
+          decltype(std::declval<const Op&>()(result,
+              std::declval<const first_argument_type&>(),
+              std::declval<const second_argument_type&>(),
+              std::declval<const first_argument_type&>(),
+              std::declval<const second_argument_type&>()), void())
+      {
+        op_(result, arg1.first, arg1.second, arg2.first, arg2.second);
+      }
+
     }; // class ReducePairOpWrapper
 
 
@@ -153,6 +260,14 @@ namespace TiledArray {
     ///     // Reduce an argument
     ///     void operator()(result_type&, const argument_type&) const;
     ///
+    ///     // Reduce two arguments (optional)
+    ///     void operator()(result_type&, const argument_type&,
+    ///         const argument_type&) const;
+    ///
+    ///     // Reset a result object to the empty result, keeping its storage
+    ///     // (optional)
+    ///     void reset(result_type&) const;
+    ///
     /// }; // struct ReductionOp
     /// \endcode
     ///
@@ -209,7 +324,9 @@ namespace TiledArray {
         /// Reduction argument container
 
         /// This object holds the reduction argument. When the arguments to
-        /// this object are ready, it will invoke the parent callback.
+        /// this object are ready, it will invoke the parent callback. One
+        /// object is allocated for each argument, so they are allocated from
+        /// a thread-local free list.
         class ReduceObject : public madness::CallbackInterface {
         private:
 
@@ -266,6 +383,22 @@ namespace TiledArray {
 
           virtual ~ReduceObject() { }
 
+          /// Allocate memory for a reduce object
+
+          /// \param size The size of the object
+          /// \return A pointer to the allocated memory
+          static void* operator new(std::size_t size) {
+            MADNESS_ASSERT(size == sizeof(ReduceObject));
+            return FreeList<sizeof(ReduceObject)>::allocate();
+          }
+
+          /// Deallocate the memory of a reduce object
+
+          /// \param p A pointer to the memory of a reduce object
+          static void operator delete(void* p) {
+            FreeList<sizeof(ReduceObject)>::deallocate(p);
+          }
+
           /// Callback function that is invoked when the argument is ready
           virtual void notify() { if((--count_) == 0) parent_->ready(this); }
 
@@ -298,7 +431,7 @@ namespace TiledArray {
         /// state.
         /// \param result The result object that will be used to reduce
         /// other data
-        void reduce(std::shared_ptr<result_type>& result) {
+        void reduce(result_type* result) {
           while(result) {
             lock_.lock(); // <<< Begin critical section
             if(ready_object_) {
@@ -315,19 +448,19 @@ namespace TiledArray {
               this->dec();
             } else if(ready_result_) {
               // Get the ready result
-              std::shared_ptr<result_type> ready_result = ready_result_;
-              ready_result_.reset();
+              result_type* ready_result = ready_result_;
+              ready_result_ = nullptr;
               lock_.unlock(); // <<< End critical section
 
               // Reduce the result that was held by ready_result_
               op_(*result, *ready_result);
 
               // cleanup the result
-              ready_result.reset();
+              recycle(ready_result);
             } else {
               // Nothing is ready, so place result in the ready state.
               ready_result_ = result;
-              result.reset();
+              result = nullptr;
               lock_.unlock(); // <<< End critical section
             }
           }
@@ -337,7 +470,7 @@ namespace TiledArray {
 
         /// \param result The target of the reduction
         /// \param object The reduction argument to be reduced
-        void reduce_result_object(std::shared_ptr<result_type> result, const ReduceObject* object) {
+        void reduce_result_object(result_type* result, const ReduceObject* object) {
           // Reduce the argument
           op_(*result, object->arg());
 
@@ -352,14 +485,93 @@ namespace TiledArray {
           this->dec();
         }
 
+        /// Reduce two arguments with a single reduction operation
+
+        /// This overload is selected when the reduction operation can reduce
+        /// two arguments at once, which allows it to fuse the work for
+        /// arguments that become ready at the same time.
+        template <typename Op>
+        static auto reduce_arguments(Op& op, result_type& result,
+            const argument_type& arg1, const argument_type& arg2, int) ->
+            decltype(op(result, arg1, arg2), void())
+        { op(result, arg1, arg2); }
+
+        /// Reduce two arguments, one at a time
+        template <typename Op>
+        static void reduce_arguments(Op& op, result_type& result,
+            const argument_type& arg1, const argument_type& arg2, long)
+        {
+          op(result, arg1);
+          op(result, arg2);
+        }
+
+        // Result recycling ----------------------------------------------------
+
+        // Each pair of arguments that are reduced together needs a new result
+        // object, and each pair of results that are reduced together releases
+        // one. When the reduction operation can reset a result object, one
+        // released result is kept as a spare, so its storage (e.g. the
+        // buffer of a result tile) is reused instead of being reallocated.
+        // The seed result shares its storage with the caller, so it is never
+        // kept as the spare; only result objects that are owned by this task
+        // are reset.
+
+        /// Reset a result object with the reduction operation
+        template <typename Op>
+        static auto reset(const Op& op, result_type& result, int) ->
+            decltype(op.reset(result), void())
+        { op.reset(result); }
+
+        /// Reset a result object by replacing it with an empty result
+        template <typename Op>
+        static void reset(const Op& op, result_type& result, long) { result = op(); }
+
+        /// Keep a result object that was released as the spare result
+        template <typename Op>
+        auto recycle(const Op& op, result_type* result, int) ->
+            decltype(op.reset(*result), void())
+        {
+          if(result == seed_.load(std::memory_order_relaxed)) {
+            delete result;
+            return;
+          }
+          result_type* empty = nullptr;
+          if(! spare_.compare_exchange_strong(empty, result,
+              std::memory_order_acq_rel, std::memory_order_relaxed))
+            delete result;
+        }
+
+        /// Delete a result object that was released
+        template <typename Op>
+        void recycle(const Op&, result_type* result, long) { delete result; }
+
+        /// Release a result object
+
+        /// \param result The result object that is no longer used
+        void recycle(result_type* result) { recycle(op_, result, 0); }
+
+        /// Make an empty result object
+
+        /// \return The spare result after it is reset, or a new empty result
+        /// if there is no spare result
+        result_type* make_result() {
+          if(spare_.load(std::memory_order_relaxed)) {
+            result_type* const result = spare_.exchange(nullptr, std::memory_order_acq_rel);
+            if(result) {
+              reset(op_, *result, 0);
+              return result;
+            }
+          }
+          return new result_type(op_());
+        }
+
         /// Reduce two reduction arguments
         void reduce_object_object(const ReduceObject* object1, const ReduceObject* object2) {
           // Construct an empty result object
-          std::shared_ptr<result_type> result(new result_type(op_()));
+          result_type* const result = make_result();
 
           // Reduce the two arguments
-          op_(*result, object1->arg());
-          op_(*result, object2->arg());
+          reduce_arguments(op_, *result, object1->arg(), object2->arg(), 0);
 
           // Cleanup arguments
           ReduceObject::destroy(object1);
@@ -374,10 +586,28 @@ namespace TiledArray {
           this->dec();
         }
 
+        /// Reduce the seed result
+
+        /// \param seed The initial value of the reduction
+        void reduce_seed(const result_type& seed) {
+          // Record the seed result object, so it is not recycled
+          result_type* const result = new result_type(seed);
+          seed_.store(result, std::memory_order_relaxed);
+
+          // Check for more reductions
+          reduce(result);
+
+          // Decrement the dependency counter for the seed. This must be done
+          // after the reduce call to avoid a race condition.
+          this->dec();
+        }
+
         World& world_; ///< The world that owns this task
         opT op_; ///< The reduction operation
-        std::shared_ptr<result_type> ready_result_; ///< Result object that is ready to be reduced
+        result_type* ready_result_; ///< Result object that is ready to be reduced
         volatile ReduceObject* ready_object_; ///< Reduction argument that is ready to be reduced
+        std::atomic<result_type*> spare_; ///< Released result object that may be reused
+        std::atomic<const result_type*> seed_; ///< The seed result object, which is not reused
         Future<result_type> result_; ///< The result of the reduction task
         madness::Spinlock lock_; ///< Task lock
         madness::CallbackInterface* callback_; ///< The completion callback
@@ -393,15 +623,22 @@ namespace TiledArray {
         ReduceTaskImpl(World& world, opT op, madness::CallbackInterface* callback) :
           madness::TaskInterface(1, TaskAttributes::hipri()),
           world_(world), op_(op), ready_result_(new result_type(op())),
-          ready_object_(nullptr), result_(), lock_(), callback_(callback)
+          ready_object_(nullptr), spare_(nullptr), seed_(nullptr), result_(),
+          lock_(), callback_(callback)
         { }
 
-        virtual ~ReduceTaskImpl() { }
+        virtual ~ReduceTaskImpl() {
+          delete ready_result_;
+          delete spare_.load(std::memory_order_acquire);
+        }
 
         /// Task function
         virtual void run(const madness::TaskThreadEnv&) {
           MADNESS_ASSERT(ready_result_);
           result_.set(op_(*ready_result_));
+          delete ready_result_;
+          ready_result_ = nullptr;
+          delete spare_.exchange(nullptr, std::memory_order_acquire);
           if(callback_)
             callback_->notify();
         }
@@ -416,10 +653,9 @@ namespace TiledArray {
           MADNESS_ASSERT(object);
           lock_.lock(); // <<< Begin critical section
           if(ready_result_) {
-            std::shared_ptr<result_type> ready_result = ready_result_;
-            ready_result_.reset();
+            result_type* ready_result = ready_result_;
+            ready_result_ = nullptr;
             lock_.unlock(); // <<< End critical section
-            MADNESS_ASSERT(ready_result);
             world_.taskq.add(this, & ReduceTaskImpl::reduce_result_object,
                 ready_result, object, TaskAttributes::hipri());
           } else if(ready_object_) {
@@ -435,6 +671,22 @@ namespace TiledArray {
           }
         }
 
+        /// Set the initial value of the reduction
+
+        /// The empty result object is replaced by \c seed, so the reduction
+        /// arguments are reduced directly into \c seed once it is ready.
+        /// \param seed The initial value of the reduction
+        void seed(const Future<result_type>& seed) {
+          lock_.lock(); // <<< Begin critical section
+          result_type* const ready_result = ready_result_;
+          ready_result_ = nullptr;
+          lock_.unlock(); // <<< End critical section
+          delete ready_result;
+          this->inc();
+          world_.taskq.add(this, & ReduceTaskImpl::reduce_seed, seed,
+              TaskAttributes::hipri());
+        }
+
         /// Task result accessor
 
         /// \return A future that will hold the result of the reduction task
@@ -449,7 +701,8 @@ namespace TiledArray {
 
 
       ReduceTaskImpl* pimpl_; ///< The reduction task object.
-      std::size_t count_; ///< Reduction argument counter
+      // Screened SUMMA steps read the count while other steps add arguments
+      std::atomic<std::size_t> count_; ///< Reduction argument counter
 
     public:
 
@@ -472,7 +725,7 @@ namespace TiledArray {
 
       /// \param other The object to be moved
       ReduceTask(ReduceTask<opT>&& other) noexcept :
-        pimpl_(other.pimpl_), count_(other.count_)
+        pimpl_(other.pimpl_), count_(other.count_.load())
       {
         other.pimpl_ = nullptr;
         other.count_ = 0ul;
@@ -489,9 +742,9 @@ namespace TiledArray {
       /// \param other The object to be moved
       ReduceTask<opT>& operator=(ReduceTask<opT>&& other) noexcept {
         pimpl_ = other.pimpl_;
-        count_ = other.count_;
+        count_ = other.count_.load();
         other.pimpl_ = nullptr;
-        other.count_ = 0;
+        other.count_ = 0ul;
         return *this;
       }
 
@@ -516,6 +769,22 @@ namespace TiledArray {
         return ++count_;
       }
 
+      /// Set the initial value of the reduction
+
+      /// The reduction arguments are reduced into \c seed instead of an empty
+      /// result object, so the result of the reduction is the sum of \c seed
+      /// and the arguments. The seed counts as an argument. This must be
+      /// called at most once, before any arguments have been added.
+      /// \param seed The initial value of the reduction
+      /// \note \c seed is reduced in place, so it should not be shared with
+      /// other objects that expect it to be unchanged.
+      void seed(const Future<result_type>& seed) {
+        MADNESS_ASSERT(pimpl_);
+        MADNESS_ASSERT(count_ == 0);
+        pimpl_->seed(seed);
+        ++count_;
+      }
+
       /// Argument count
 
       /// \return The total number of arguments added to this task
@@ -541,6 +810,22 @@ namespace TiledArray {
         return result;
       }
 
+      /// Destroy the reduction task without running it
+
+      /// This may only be called before any arguments have been added to the
+      /// reduction.
+      /// \note Arguments can no longer be added to the reduction after
+      /// calling \c destroy().
+      void destroy() {
+        MADNESS_ASSERT(pimpl_);
+        MADNESS_ASSERT(count_ == 0);
+
+        // Release the dependency held by this object before deleting the task
+        pimpl_->dec();
+        delete pimpl_;
+        pimpl_ = nullptr;
+      }
+
       /// Type conversion operator
 
       /// \return \c true if the task object is initialized.
@@ -590,6 +875,15 @@ namespace TiledArray {
     ///     void operator()(result_type&, const first_argument_type&,
     ///         const second_argument_type&) const;
     ///
+    ///     // Reduce two argument pairs (optional)
+    ///     void operator()(result_type&, const first_argument_type&,
+    ///         const second_argument_type&, const first_argument_type&,
+    ///         const second_argument_type&) const;
+    ///
+    ///     // Reset a result object to the empty result, keeping its storage
+    ///     // (optional)
+    ///     void reset(result_type&) const;
+    ///
     /// }; // struct ReductionOp
     /// \endcode
     ///
@@ -0,0 +1,383 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_RUNTIME_CONFIG_H__INCLUDED
+#define TILEDARRAY_RUNTIME_CONFIG_H__INCLUDED
+
+#include <TiledArray/dist_eval/summa_config.h>
+#include <TiledArray/dist_eval/summa_group_cache.h>
+#include <TiledArray/dist_eval/summa_trace.h>
+#include <TiledArray/expressions/cont_path.h>
+#include <TiledArray/expressions/cont_plan_cache.h>
+#include <TiledArray/expressions/tile_fusion.h>
+#include <TiledArray/math/parallel_gemm.h>
+#include <TiledArray/math/simd_kernels.h>
+#include <TiledArray/tensor/parallel_config.h>
+#include <TiledArray/tensor/pool_allocator.h>
+#include <TiledArray/numa.h>
+
+namespace TiledArray {
+
+  /// Runtime parameters
+
+  /// This class collects the tuning parameters of TiledArray in one place.
+  /// Each parameter is still held by the class that uses it (e.g.
+  /// \c SummaConfig or \c math::GemmParallelConfig ), and the functions of
+  /// this class only forward to those classes, so both interfaces may be
+  /// used. The parameters are shared by all threads of a process and are
+  /// read when an operation is evaluated, so they should be set before the
+  /// expression is evaluated. Parameters that change the communication of an
+  /// evaluation (the SUMMA parameters, the broadcast group cache, the
+  /// contraction path optimizer, and tile fusion) must be the same on all
+  /// processes.
+  ///
+  /// The counters of each subsystem can be read here, but they are only
+  /// reset through the class that owns them.
+  class RuntimeConfig {
+  public:
+
+    // SUMMA parameters ------------------------------------------------------
+
+    /// SUMMA memory limit accessor
+
+    /// \return The maximum number of bytes that a SUMMA contraction may use
+    /// on this process, or zero if the memory usage is not bounded
+    static std::size_t memory_limit() { return SummaConfig::memory_limit(); }
+
+    /// Set the SUMMA memory limit (see \c SummaConfig::set_memory_limit() )
+
+    /// \param limit The memory limit in bytes; zero disables the memory
+    /// bound [ default = 0 ]
+    static void set_memory_limit(const std::size_t limit)
+    { SummaConfig::set_memory_limit(limit); }
+
+    /// Tile-pair screening accessor
+
+    /// \return \c true if negligible tile pairs of sparse contractions are
+    /// skipped
+    static bool screening() { return SummaConfig::screening(); }
+
+    /// Enable or disable tile-pair screening (see \c SummaConfig::set_screening() )
+
+    /// \param screening If \c true, tile pairs are screened [ default = false ]
+    static void set_screening(const bool screening)
+    { SummaConfig::set_screening(screening); }
+
+    /// Broadcast compression accessor
+
+    /// \return The compression mode of the tiles that are broadcast by SUMMA
+    static SummaConfig::BcastCompression bcast_compression()
+    { return SummaConfig::bcast_compression(); }
+
+    /// Set the broadcast compression mode (see \c SummaConfig::set_bcast_compression() )
+
+    /// \param compression The compression mode
+    /// [ default = SummaConfig::uncompressed ]
+    static void set_bcast_compression(const SummaConfig::BcastCompression compression)
+    { SummaConfig::set_bcast_compression(compression); }
+
+    /// Lossy broadcast tolerance accessor
+
+    /// \return The maximum absolute error of the elements of tiles that are
+    /// broadcast with lossy compression
+    static double bcast_tolerance() { return SummaConfig::bcast_tolerance(); }
+
+    /// Set the lossy broadcast tolerance (see \c SummaConfig::set_bcast_tolerance() )
+
+    /// \param tolerance The maximum absolute error of broadcast tile
+    /// elements; zero disables truncation [ default = 0 ]
+    static void set_bcast_tolerance(const double tolerance)
+    { SummaConfig::set_bcast_tolerance(tolerance); }
+
+    /// Sparse process grid selection accessor
+
+    /// \return \c true if the process grid of a sparse contraction is
+    /// selected with the sparse cost model
+    static bool sparse_grid() { return SummaConfig::sparse_grid(); }
+
+    /// Enable or disable sparse process grid selection (see \c SummaConfig::set_sparse_grid() )
+
+    /// \param sparse_grid If \c true, sparse process grids are selected with
+    /// the cost model [ default = false ]
+    static void set_sparse_grid(const bool sparse_grid)
+    { SummaConfig::set_sparse_grid(sparse_grid); }
+
+    /// Sparse grid flop rate accessor
+
+    /// \return The number of flops per element received that is used by the
+    /// sparse process grid cost model
+    static double grid_flops_per_element() { return SummaConfig::grid_flops_per_element(); }
+
+    /// Sparse grid latency accessor
+
+    /// \return The message latency that is used by the sparse process grid
+    /// cost model
+    static double grid_latency() { return SummaConfig::grid_latency(); }
+
+    /// Set the machine balance of the sparse process grid cost model
+
+    /// \param flops_per_element The number of flops that a process performs
+    /// in the time required to receive one element [ default = 64 ]
+    /// \param latency The message latency, in units of the time required to
+    /// receive one element [ default = 1024 ]
+    static void set_grid_cost(const double flops_per_element, const double latency)
+    { SummaConfig::set_grid_cost(flops_per_element, latency); }
+
+    /// Broadcast group cache accessor
+
+    /// \return \c true if sparse SUMMA schedules are cached (see
+    /// \c SummaGroupCache )
+    static bool group_cache() { return SummaGroupCache::enabled(); }
+
+    /// Enable or disable the broadcast group cache
+
+    /// \param enable If \c true, sparse SUMMA schedules are cached
+    /// [ default = false ]
+    static void set_group_cache(const bool enable) { SummaGroupCache::enable(enable); }
+
+    /// Broadcast group cache capacity accessor
+
+    /// \return The maximum number of cached sparse SUMMA schedules
+    static std::size_t group_cache_capacity() { return SummaGroupCache::capacity(); }
+
+    /// Set the broadcast group cache capacity
+
+    /// \param capacity The maximum number of cached schedules [ default = 16 ]
+    static void set_group_cache_capacity(const std::size_t capacity)
+    { SummaGroupCache::set_capacity(capacity); }
+
+    /// SUMMA event recording accessor
+
+    /// \return \c true if SUMMA events are recorded (see \c SummaTrace )
+    static bool summa_trace() { return SummaTrace::enabled(); }
+
+    /// Enable or disable SUMMA event recording
+
+    /// \param enable If \c true, SUMMA events are recorded [ default = false ]
+    static void set_summa_trace(const bool enable) { SummaTrace::enable(enable); }
+
+    // Expression parameters -------------------------------------------------
+
+    /// Contraction path optimizer accessor
+
+    /// \return \c true if products of three expressions are reordered (see
+    /// \c expressions::ContPathOptimizer )
+    static bool cont_path() { return expressions::ContPathOptimizer::enabled(); }
+
+    /// Enable or disable the contraction path optimizer
+
+    /// \param enable If \c true, products of three expressions are evaluated
+    /// in the order with the smallest estimated cost [ default = false ]
+    static void set_cont_path(const bool enable)
+    { expressions::ContPathOptimizer::enable(enable); }
+
+    /// Contraction plan cache accessor
+
+    /// \return \c true if contraction plans are cached (see
+    /// \c expressions::ContPlanCache )
+    static bool plan_cache() { return expressions::ContPlanCache::enabled(); }
+
+    /// Enable or disable the contraction plan cache
+
+    /// \param enable If \c true, contraction plans are cached
+    /// [ default = false ]
+    static void set_plan_cache(const bool enable)
+    { expressions::ContPlanCache::enable(enable); }
+
+    /// Contraction plan cache capacity accessor
+
+    /// \return The maximum number of cached contraction plans
+    static std::size_t plan_cache_capacity()
+    { return expressions::ContPlanCache::capacity(); }
+
+    /// Set the contraction plan cache capacity
+
+    /// \param capacity The maximum number of cached plans [ default = 64 ]
+    static void set_plan_cache_capacity(const std::size_t capacity)
+    { expressions::ContPlanCache::set_capacity(capacity); }
+
+    /// Fused tile extent accessor
+
+    /// \return The minimum number of elements of each dimension of a fused
+    /// tile, or zero if tile fusion is disabled (see
+    /// \c expressions::TileFusion )
+    static std::size_t fusion_extent() { return expressions::TileFusion::extent(); }
+
+    /// Set the fused tile extent
+
+    /// \param extent The minimum number of elements of each dimension of a
+    /// fused tile, e.g. 64; zero disables tile fusion [ default = 0 ]
+    static void set_fusion_extent(const std::size_t extent) {
+      if(extent)
+        expressions::TileFusion::enable(extent);
+      else
+        expressions::TileFusion::disable();
+    }
+
+    // Tile operation parameters ---------------------------------------------
+
+    /// Task-parallel *GEMM threshold accessor
+
+    /// \return The minimum number of multiply-adds of a task-parallel
+    /// *GEMM, or zero if it is disabled (see \c math::GemmParallelConfig )
+    static std::size_t gemm_threshold() { return math::GemmParallelConfig::threshold(); }
+
+    /// Set the size threshold of task-parallel *GEMM
+
+    /// \param size The minimum value of \c m*n*k of a *GEMM that is split
+    /// across threads; zero disables task-parallel *GEMM [ default = 0 ]
+    static void set_gemm_threshold(const std::size_t size)
+    { math::GemmParallelConfig::set_threshold(size); }
+
+    /// Task-parallel *GEMM block size accessor
+
+    /// \return The number of rows and columns of the result blocks of a
+    /// task-parallel *GEMM
+    static integer gemm_block_size() { return math::GemmParallelConfig::block_size(); }
+
+    /// Set the task-parallel *GEMM block size
+
+    /// \param size The number of rows and columns of the result blocks,
+    /// which is at least \c math::GemmParallelConfig::min_block_size
+    /// [ default = 256 ]
+    static void set_gemm_block_size(const integer size)
+    { math::GemmParallelConfig::set_block_size(size); }
+
+    /// Multithreaded tensor operation threshold accessor
+
+    /// \return The minimum volume of multithreaded tensor operations, or
+    /// zero if they are disabled (see \c TensorParallelConfig )
+    static std::size_t tensor_threshold() { return TensorParallelConfig::threshold(); }
+
+    /// Set the volume threshold of multithreaded tensor operations
+
+    /// \param volume The minimum number of elements of a tensor operation
+    /// that is split across threads; zero disables multithreaded tensor
+    /// operations [ default = 0 ]
+    static void set_tensor_threshold(const std::size_t volume)
+    { TensorParallelConfig::set_threshold(volume); }
+
+    /// SIMD instruction set accessor
+
+    /// \return The instruction set of the vector kernels that are used (see
+    /// \c math::SimdConfig )
+    static math::SimdConfig::Isa simd_isa() { return math::SimdConfig::isa(); }
+
+    /// Select the instruction set of the vector kernels
+
+    /// \param isa The instruction set; it is limited to the instruction
+    /// sets that are supported by the CPU [ default = the best supported ]
+    static void set_simd_isa(const math::SimdConfig::Isa isa)
+    { math::SimdConfig::set_isa(isa); }
+
+    // Tile memory parameters ------------------------------------------------
+
+    /// Tile pool thread cache limit accessor
+
+    /// \return The maximum number of bytes held by the free lists of each
+    /// thread (see \c TilePool )
+    static std::size_t pool_thread_cache_limit() { return TilePool::thread_cache_limit(); }
+
+    /// Set the tile pool thread cache limit
+
+    /// \param bytes The maximum number of bytes held by the free lists of
+    /// each thread
+    static void set_pool_thread_cache_limit(const std::size_t bytes)
+    { TilePool::set_thread_cache_limit(bytes); }
+
+    /// Tile pool shared cache limit accessor
+
+    /// \return The maximum number of bytes held by the shared free lists of
+    /// each NUMA node
+    static std::size_t pool_cache_limit() { return TilePool::cache_limit(); }
+
+    /// Set the tile pool shared cache limit
+
+    /// \param bytes The maximum number of bytes held by the shared free lists
+    /// of each NUMA node
+    static void set_pool_cache_limit(const std::size_t bytes)
+    { TilePool::set_cache_limit(bytes); }
+
+    /// Tile pool huge page accessor
+
+    /// \return \c true if large tile pool blocks are backed by huge pages
+    static bool pool_huge_pages() { return TilePool::huge_pages(); }
+
+    /// Enable or disable huge pages for large tile pool blocks
+
+    /// \param huge_pages If \c true, huge pages are requested
+    /// [ default = false ]
+    static void set_pool_huge_pages(const bool huge_pages)
+    { TilePool::set_huge_pages(huge_pages); }
+
+    /// NUMA placement accessor
+
+    /// \return \c true if tiles are placed on the NUMA node of the thread
+    /// that allocates them (see \c NumaConfig )
+    static bool numa_placement() { return NumaConfig::enabled(); }
+
+    /// Enable or disable NUMA placement
+
+    /// \param enable If \c true, tiles are placed on the NUMA node of the
+    /// allocating thread [ default = false ]
+    static void set_numa_placement(const bool enable) { NumaConfig::set_enabled(enable); }
+
+    // Counters --------------------------------------------------------------
+
+    /// \return The number of tile contractions that were skipped by
+    /// tile-pair screening on this process
+    static std::size_t skipped_contractions() { return SummaConfig::skipped_contractions(); }
+
+    /// \return The number of bytes of the tiles that were compressed for
+    /// SUMMA broadcasts on this process
+    static std::size_t bcast_bytes() { return SummaConfig::bcast_bytes(); }
+
+    /// \return The number of compressed bytes of the tiles that were
+    /// compressed for SUMMA broadcasts on this process
+    static std::size_t bcast_compressed_bytes() { return SummaConfig::bcast_compressed_bytes(); }
+
+    /// \return The number of evaluations that reused a cached sparse SUMMA
+    /// schedule on this process
+    static std::size_t group_cache_hits() { return SummaGroupCache::hits(); }
+
+    /// \return The number of contractions that reused a cached process grid
+    /// on this process
+    static std::size_t plan_cache_hits() { return expressions::ContPlanCache::hits(); }
+
+    /// \return The number of products that were reordered by the
+    /// contraction path optimizer on this process
+    static std::size_t cont_path_reorders() { return expressions::ContPathOptimizer::reorders(); }
+
+    /// \return The number of contractions that were evaluated with fused
+    /// tiles on this process
+    static std::size_t fusions() { return expressions::TileFusion::fusions(); }
+
+    /// \return The number of *GEMM calls that were split across threads on
+    /// this process
+    static std::size_t parallel_gemms() { return math::GemmParallelConfig::parallel_gemms(); }
+
+    /// \return The number of tensor operations that were split across
+    /// threads on this process
+    static std::size_t parallel_ops() { return TensorParallelConfig::parallel_ops(); }
+
+  }; // class RuntimeConfig
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_RUNTIME_CONFIG_H__INCLUDED
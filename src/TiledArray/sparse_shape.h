@@ -31,6 +31,9 @@
 #include <TiledArray/val_array.h>
 #include <TiledArray/tensor/shift_wrapper.h>
 #include <TiledArray/tensor/tensor_interface.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 
 namespace TiledArray {
 
@@ -63,9 +66,18 @@ namespace TiledArray {
     // Internal typedefs
     typedef detail::ValArray<value_type> vector_type;
 
+    /// Zero tile pattern fingerprint, which is shared by shallow copies
+    struct Fingerprint {
+      std::mutex mutex; ///< Fingerprint lock
+      bool valid = false; ///< \c true when \c value has been computed
+      value_type threshold = value_type(0); ///< The threshold of \c value
+      std::size_t value = 0ul; ///< The fingerprint
+    }; // struct Fingerprint
+
     Tensor<value_type> tile_norms_; ///< Tile magnitude data
     std::shared_ptr<vector_type> size_vectors_; ///< Tile volume data
     size_type zero_tile_count_; ///< Number of zero tiles
+    std::shared_ptr<Fingerprint> fingerprint_; ///< Zero tile pattern fingerprint
     static value_type threshold_; ///< The zero threshold
 
     template <typename Op>
@@ -192,7 +204,7 @@ namespace TiledArray {
     SparseShape(const Tensor<T>& tile_norms, const std::shared_ptr<vector_type>& size_vectors,
         const size_type zero_tile_count) :
       tile_norms_(tile_norms), size_vectors_(size_vectors),
-      zero_tile_count_(zero_tile_count)
+      zero_tile_count_(zero_tile_count), fingerprint_(std::make_shared<Fingerprint>())
     { }
 
   public:
@@ -200,7 +212,10 @@ namespace TiledArray {
     /// Default constructor
 
     /// Construct a shape with no data.
-    SparseShape() : tile_norms_(), size_vectors_(), zero_tile_count_(0ul) { }
+    SparseShape() :
+      tile_norms_(), size_vectors_(), zero_tile_count_(0ul),
+      fingerprint_(std::make_shared<Fingerprint>())
+    { }
 
     /// Constructor
 
@@ -211,7 +226,7 @@ namespace TiledArray {
     /// \param trange The tiled range of the tensor
     SparseShape(const Tensor<value_type>& tile_norms, const TiledRange& trange) :
       tile_norms_(tile_norms.clone()), size_vectors_(initialize_size_vectors(trange)),
-      zero_tile_count_(0ul)
+      zero_tile_count_(0ul), fingerprint_(std::make_shared<Fingerprint>())
     {
       TA_ASSERT(! tile_norms_.empty());
       TA_ASSERT(tile_norms_.range() == trange.tiles());
@@ -231,7 +246,7 @@ namespace TiledArray {
     SparseShape(World& world, const Tensor<value_type>& tile_norms,
         const TiledRange& trange) :
       tile_norms_(tile_norms.clone()), size_vectors_(initialize_size_vectors(trange)),
-      zero_tile_count_(0ul)
+      zero_tile_count_(0ul), fingerprint_(std::make_shared<Fingerprint>())
     {
       TA_ASSERT(! tile_norms_.empty());
       TA_ASSERT(tile_norms_.range() == trange.tiles());
@@ -248,7 +263,7 @@ namespace TiledArray {
     /// \param other The other shape object to be copied
     SparseShape(const SparseShape<T>& other) :
       tile_norms_(other.tile_norms_), size_vectors_(other.size_vectors_),
-      zero_tile_count_(other.zero_tile_count_)
+      zero_tile_count_(other.zero_tile_count_), fingerprint_(other.fingerprint_)
     { }
 
     /// Copy assignment operator
@@ -260,6 +275,7 @@ namespace TiledArray {
       tile_norms_ = other.tile_norms_;
       size_vectors_ = other.size_vectors_;
       zero_tile_count_ = other.zero_tile_count_;
+      fingerprint_ = other.fingerprint_;
       return *this;
     }
 
@@ -321,6 +337,40 @@ namespace TiledArray {
     /// \return A reference to the \c Tensor object that stores shape data
     const Tensor<value_type>& data() const { return tile_norms_; }
 
+    /// Fingerprint of the zero tile pattern
+
+    /// The fingerprint is a hash of the zero tile flags at the current
+    /// threshold. It is computed once and shared by shallow copies of this
+    /// shape, so repeated evaluations with the same shape can identify its
+    /// sparsity pattern without scanning the tiles. It is recomputed when the
+    /// threshold changes.
+    /// \return The fingerprint of the zero tile pattern
+    std::size_t fingerprint() const {
+      TA_ASSERT(! tile_norms_.empty());
+      const value_type threshold = threshold_;
+      std::lock_guard<std::mutex> lock(fingerprint_->mutex);
+      if(! fingerprint_->valid || (fingerprint_->threshold != threshold)) {
+        std::size_t seed = tile_norms_.size();
+        std::uint64_t word = 0ul;
+        unsigned int bit = 0u;
+        for(size_type i = 0ul; i < tile_norms_.size(); ++i) {
+          if(tile_norms_[i] < threshold)
+            word |= std::uint64_t(1) << bit;
+          if(++bit == 64u) {
+            madness::hash_combine(seed, word);
+            word = 0ul;
+            bit = 0u;
+          }
+        }
+        madness::hash_combine(seed, word);
+
+        fingerprint_->valid = true;
+        fingerprint_->threshold = threshold;
+        fingerprint_->value = seed;
+      }
+      return fingerprint_->value;
+    }
+
     /// Initialization check
 
     /// \return \c true when this shape has been initialized.
@@ -465,6 +515,55 @@ namespace TiledArray {
           zero_tile_count_);
     }
 
+    /// Create a shape of fused tiles
+
+    /// Each tile of \c fused_trange is the union of a block of adjacent
+    /// tiles of \c trange. The norm of a fused tile is the norm of its
+    /// constituent tiles, normalized by the fused tile volume. A fused tile
+    /// that contains a non-zero tile is non-zero, even when its normalized
+    /// norm is below the zero threshold.
+    /// \param trange The tiled range of this shape
+    /// \param fused_trange The tiled range of the fused tiles, where each
+    /// tile boundary is also a tile boundary of \c trange
+    /// \return The shape of the fused tiles
+    SparseShape_ fuse(const TiledRange& trange, const TiledRange& fused_trange) const {
+      TA_ASSERT(! tile_norms_.empty());
+      TA_ASSERT(tile_norms_.range() == trange.tiles());
+      TA_ASSERT(trange.elements() == fused_trange.elements());
+
+      const value_type threshold = threshold_;
+      Tensor<value_type> result_norms(fused_trange.tiles(), value_type(0));
+      std::vector<bool> non_zero(result_norms.size(), false);
+
+      // Accumulate the squared norms of the non-zero tiles of each fused tile
+      for(size_type t = 0ul; t < tile_norms_.size(); ++t) {
+        if(tile_norms_[t] < threshold)
+          continue;
+
+        const Range range = trange.make_tile_range(t);
+        const size_type f = fused_trange.tiles().ordinal(
+            fused_trange.element_to_tile(range.lobound()));
+        const value_type norm = tile_norms_[t] * value_type(range.volume());
+        result_norms[f] += norm * norm;
+        non_zero[f] = true;
+      }
+
+      // Normalize the fused tile norms
+      size_type zero_tile_count = 0ul;
+      for(size_type f = 0ul; f < result_norms.size(); ++f) {
+        if(non_zero[f]) {
+          const value_type norm = std::sqrt(result_norms[f]) /
+              value_type(fused_trange.make_tile_range(f).volume());
+          result_norms[f] = std::max(norm, threshold);
+        } else {
+          ++zero_tile_count;
+        }
+      }
+
+      return SparseShape_(result_norms, initialize_size_vectors(fused_trange),
+          zero_tile_count);
+    }
+
     /// Scale shape
 
     /// Construct a new scaled shape as:
@@ -854,6 +953,7 @@ namespace TiledArray {
       size_type zero_tile_count = 0ul;
       integer M = 0, N = 0, K = 0;
       gemm_helper.compute_matrix_sizes(M, N, K, tile_norms_.range(), other.tile_norms_.range());
+      const integer B = gemm_helper.compute_batch_size(tile_norms_.range());
 
       // Allocate memory for the contracted size vectors
       std::shared_ptr<vector_type> result_size_vectors(new vector_type[gemm_helper.result_rank()],
@@ -861,6 +961,8 @@ namespace TiledArray {
 
       // Initialize the result size vectors
       unsigned int x = 0ul;
+      for(unsigned int i = 0u; i < gemm_helper.batch_rank(); ++i, ++x)
+        result_size_vectors.get()[x] = size_vectors_.get()[i];
       for(unsigned int i = gemm_helper.left_outer_begin(); i < gemm_helper.left_outer_end(); ++i, ++x)
         result_size_vectors.get()[x] = size_vectors_.get()[i];
       for(unsigned int i = gemm_helper.right_outer_begin(); i < gemm_helper.right_outer_end(); ++i, ++x)
@@ -873,6 +975,15 @@ namespace TiledArray {
       Tensor<value_type> result_norms(gemm_helper.make_result_range<typename Tensor<T>::range_type>(
           tile_norms_.range(), other.tile_norms_.range()), 0);
 
+      // Compute the volume of each batch tile. The result norms are scaled by
+      // these volumes, since the elements of a batch tile are contracted
+      // separately.
+      const vector_type batch_sizes = (gemm_helper.batch_rank() > 0u ?
+          recursive_outer_product(size_vectors_.get(), gemm_helper.batch_rank(),
+              [] (const vector_type& size_vector) -> const vector_type&
+              { return size_vector; }) :
+          vector_type(1ul, value_type(1)));
+
       if(k_rank > 0u) {
 
         // Compute size vector
@@ -885,7 +996,7 @@ namespace TiledArray {
         // for the arguments, but requires a custom matrix multiply.
 
         Tensor<value_type> left(tile_norms_.range());
-        const size_type mk = M * K;
+        const size_type mk = B * M * K;
         auto left_op = [] (const value_type left, const value_type right)
             { return left * right; };
         for(size_type i = 0ul; i < mk; i += K)
@@ -893,37 +1004,47 @@ namespace TiledArray {
               tile_norms_.data() + i, k_sizes.data());
 
         Tensor<value_type> right(other.tile_norms_.range());
-        for(integer i = 0ul, k = 0; k < K; i += N, ++k) {
-          const value_type factor = k_sizes[k];
+        for(integer i = 0ul, k = 0; k < B * K; i += N, ++k) {
+          const value_type factor = k_sizes[k % K];
           auto right_op = [=] (const value_type arg) { return arg * factor; };
           math::vector_op(right_op, N, right.data() + i, other.tile_norms_.data() + i);
         }
 
         result_norms = left.gemm(right, factor, gemm_helper);
 
-        // Hard zero tiles that are below the zero threshold.
-        result_norms.inplace_unary(
-            [threshold, &zero_tile_count] (value_type& value) {
-              if(value < threshold) {
-                value = value_type(0);
-                ++zero_tile_count;
-              }
-            });
+        // Scale the norms of each batch by the batch tile volume, and hard
+        // zero tiles that are below the zero threshold.
+        const size_type mn = M * N;
+        for(integer b = 0; b < B; ++b) {
+          const value_type batch_size = batch_sizes[b];
+          math::inplace_vector_op(
+              [threshold, &zero_tile_count, batch_size] (value_type& value) {
+                value *= batch_size;
+                if(value < threshold) {
+                  value = value_type(0);
+                  ++zero_tile_count;
+                }
+              }, mn, result_norms.data() + b * mn);
+        }
 
       } else {
 
         // This is an outer product, so the inputs can be used directly
-        math::outer_fill(M, N, tile_norms_.data(), other.tile_norms_.data(), result_norms.data(),
-            [threshold, &zero_tile_count, factor] (const value_type left,
-                const value_type right)
-            {
-              value_type norm = left * right * factor;
-              if(norm < threshold) {
-                norm = value_type(0);
-                ++zero_tile_count;
-              }
-              return norm;
-            });
+        for(integer b = 0; b < B; ++b) {
+          const value_type batch_factor = factor * batch_sizes[b];
+          math::outer_fill(M, N, tile_norms_.data() + b * M, other.tile_norms_.data() + b * N,
+              result_norms.data() + b * M * N,
+              [threshold, &zero_tile_count, batch_factor] (const value_type left,
+                  const value_type right)
+              {
+                value_type norm = left * right * batch_factor;
+                if(norm < threshold) {
+                  norm = value_type(0);
+                  ++zero_tile_count;
+                }
+                return norm;
+              });
+        }
       }
 
       return SparseShape_(result_norms, result_size_vectors, zero_tile_count);
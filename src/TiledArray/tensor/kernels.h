@@ -26,6 +26,7 @@
 #ifndef TILEDARRAY_TENSOR_KENERLS_H__INCLUDED
 #define TILEDARRAY_TENSOR_KENERLS_H__INCLUDED
 
+#include <TiledArray/tensor/parallel_config.h>
 #include <TiledArray/tensor/utility.h>
 #include <TiledArray/tensor/permute.h>
 #include <TiledArray/math/eigen.h>
@@ -104,8 +105,11 @@ namespace TiledArray {
 
       const auto volume = result.range().volume();
 
-      math::inplace_vector_op(op, volume, result.data(),
-          tensors.data()...);
+      parallel_vector_op(volume,
+          [&] (const std::size_t first, const std::size_t n) {
+            math::inplace_vector_op(op, n, result.data() + first,
+                (tensors.data() + first)...);
+          });
     }
 
     /// In-place tensor of tensors operations with contiguous data
@@ -311,7 +315,13 @@ namespace TiledArray {
               typename Ts::const_reference restrict... ts)
           { new(result) typename TR::value_type(op(ts...)); };
 
-      math::vector_ptr_op(wrapper_op, volume, result.data(), tensors.data()...);
+      parallel_vector_op(volume,
+          [&] (const std::size_t first, const std::size_t n) {
+            if(! math::vector_kernel(op, n, result.data() + first,
+                (tensors.data() + first)...))
+              math::vector_ptr_op(wrapper_op, n, result.data() + first,
+                  (tensors.data() + first)...);
+          });
     }
 
     /// Initialize tensor of tensors with contiguous tensor arguments
@@ -501,6 +511,8 @@ namespace TiledArray {
     /// \tparam T1 The first argument tensor type
     /// \tparam Ts The argument tensor types
     /// \param reduce_op The element-wise reduction operation
+    /// \param join_op The operation that combines the partial results of
+    /// multithreaded reductions
     /// \param identity The initial value for the reduction and the result
     /// \param tensor1 The first tensor to be reduced
     /// \param tensors The other tensors to be reduced
@@ -508,7 +520,7 @@ namespace TiledArray {
     template <typename ReduceOp, typename JoinOp, typename Scalar, typename T1, typename... Ts,
     typename std::enable_if<is_numeric<Scalar>::value && is_tensor<T1, Ts...>::value
              && is_contiguous_tensor<T1, Ts...>::value>::type* = nullptr>
-    Scalar tensor_reduce(ReduceOp&& reduce_op, JoinOp&&,
+    Scalar tensor_reduce(ReduceOp&& reduce_op, JoinOp&& join_op,
         Scalar identity, const T1& tensor1, const Ts&... tensors)
     {
       TA_ASSERT(! empty(tensor1, tensors...));
@@ -516,10 +528,11 @@ namespace TiledArray {
 
       const auto volume = tensor1.range().volume();
 
-      math::reduce_op(reduce_op, volume, identity,
-          tensor1.data(), tensors.data()...);
-
-      return identity;
+      return parallel_reduce_op(volume, identity,
+          [&] (Scalar& result, const std::size_t first, const std::size_t n) {
+            math::reduce_op(reduce_op, n, result, tensor1.data() + first,
+                (tensors.data() + first)...);
+          }, join_op);
     }
 
     /// Tensor of tensor reduction operation for contiguous tensors
@@ -0,0 +1,224 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_TENSOR_PARALLEL_CONFIG_H__INCLUDED
+#define TILEDARRAY_TENSOR_PARALLEL_CONFIG_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/madness.h>
+#include <TiledArray/math/vector_op.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace TiledArray {
+
+  /// Runtime parameters for multithreaded tensor operations
+
+  /// Element-wise operations and reductions of tensors with contiguous
+  /// elements are split across the MADNESS task threads when the tensor
+  /// volume is at least \c threshold(). This helps when there are only a
+  /// few large tiles per process, so the tile tasks alone cannot keep all
+  /// threads busy. The element operations of multithreaded tensor
+  /// operations must be thread-safe. This setting is process-local.
+  class TensorParallelConfig {
+  private:
+
+    static std::atomic<std::size_t>& threshold_() {
+      static std::atomic<std::size_t> threshold(0ul);
+      return threshold;
+    }
+
+    static std::atomic<std::size_t>& parallel_ops_() {
+      static std::atomic<std::size_t> parallel_ops(0ul);
+      return parallel_ops;
+    }
+
+  public:
+
+    /// Check that multithreaded tensor operations are enabled
+
+    /// \return \c true if large tensor operations are multithreaded
+    static bool enabled() { return threshold() != 0ul; }
+
+    /// Volume threshold accessor
+
+    /// \return The minimum volume of multithreaded tensor operations, or
+    /// zero if they are disabled
+    static std::size_t threshold() { return threshold_().load(std::memory_order_relaxed); }
+
+    /// Set the volume threshold of multithreaded tensor operations
+
+    /// \param volume The minimum number of elements of a tensor operation
+    /// that is split across threads; zero disables multithreaded tensor
+    /// operations (default)
+    static void set_threshold(const std::size_t volume) { threshold_() = volume; }
+
+    /// Multithreaded tensor operation counter accessor
+
+    /// \return The number of tensor operations that were split across
+    /// threads on this process
+    static std::size_t parallel_ops() { return parallel_ops_(); }
+
+    /// Reset the multithreaded tensor operation counter
+    static void reset_parallel_ops() { parallel_ops_() = 0ul; }
+
+    /// Number of blocks of a tensor operation
+
+    /// \param volume The number of elements of the operation
+    /// \return The number of blocks that are evaluated concurrently, which
+    /// is one for operations below the threshold
+    static std::size_t blocks(const std::size_t volume) {
+      const std::size_t min_volume = threshold();
+      if((min_volume == 0ul) || (volume < min_volume))
+        return 1ul;
+
+      // The calling thread evaluates one block
+      const std::size_t threads = madness::ThreadPool::size() + 1ul;
+      const std::size_t max_blocks = volume / TILEDARRAY_LOOP_UNWIND;
+      return std::max<std::size_t>(1ul, std::min(threads, max_blocks));
+    }
+
+    /// Record a multithreaded tensor operation
+    static void parallel_op() { ++parallel_ops_(); }
+
+  }; // class TensorParallelConfig
+
+  namespace detail {
+
+    /// Evaluate a blocked operation
+
+    /// \c op(b,first,n) is called for each block \c b of contiguous
+    /// elements, where \c first is the offset of the block and \c n is the
+    /// number of elements in the block. All blocks, except the last, have
+    /// \c block_size elements, and empty blocks are skipped. Block 0 is
+    /// evaluated by the calling thread and the other blocks by tasks.
+    /// \tparam Op The block operation type
+    /// \param volume The number of elements
+    /// \param blocks The number of blocks
+    /// \param block_size The number of elements in each block
+    /// \param op The block operation
+    template <typename Op>
+    inline void parallel_blocks(const std::size_t volume,
+        const std::size_t blocks, std::size_t block_size, const Op& op)
+    {
+      TA_ASSERT(blocks > 1ul);
+      TensorParallelConfig::parallel_op();
+
+      block_size = std::min(volume, block_size);
+
+      std::atomic<std::size_t> pending(blocks - 1ul);
+      World& world = World::get_default();
+      for(std::size_t b = 1ul; b < blocks; ++b) {
+        const std::size_t first = std::min(volume, b * block_size);
+        const std::size_t last =
+            (b + 1ul < blocks ? std::min(volume, first + block_size) : volume);
+        world.taskq.add([&op, &pending, b, first, last] () {
+          if(first < last)
+            op(b, first, last - first);
+          --pending;
+        });
+      }
+
+      op(0ul, 0ul, block_size);
+      madness::ThreadPool::await([&] () { return (pending == 0ul); }, true);
+    }
+
+    /// Evaluate a blocked vector operation
+
+    /// \c op(b,first,n) is called for each block \c b of contiguous
+    /// elements, where \c first is the offset of the block and \c n is the
+    /// number of elements in the block. Block 0 is evaluated by the calling
+    /// thread and the other blocks by tasks. Block boundaries are aligned to
+    /// the vector loop unwind, so only the last block has a remainder loop.
+    /// \tparam Op The block operation type
+    /// \param volume The number of elements
+    /// \param blocks The number of blocks
+    /// \param op The block operation
+    template <typename Op>
+    inline void parallel_blocks(const std::size_t volume,
+        const std::size_t blocks, const Op& op)
+    {
+      parallel_blocks(volume, blocks,
+          ((volume / blocks) + TILEDARRAY_LOOP_UNWIND - 1ul) & math::index_mask::value,
+          op);
+    }
+
+    /// Evaluate a vector operation in blocks
+
+    /// \c op(first,n) is called for contiguous blocks of elements, where
+    /// \c first is the offset of the block and \c n is the number of
+    /// elements in the block. When \c volume is at least
+    /// \c TensorParallelConfig::threshold() , the blocks are evaluated
+    /// concurrently, otherwise \c op(0,volume) is called.
+    /// \tparam Op The block operation type
+    /// \param volume The number of elements
+    /// \param op The block operation
+    template <typename Op>
+    inline void parallel_vector_op(const std::size_t volume, const Op& op) {
+      const std::size_t blocks = TensorParallelConfig::blocks(volume);
+      if(blocks == 1ul)
+        op(0ul, volume);
+      else
+        parallel_blocks(volume, blocks,
+            [&op] (const std::size_t, const std::size_t first, const std::size_t n)
+            { op(first, n); });
+    }
+
+    /// Evaluate a vector reduction in blocks
+
+    /// \c reduce_op(result,first,n) reduces a contiguous block of elements
+    /// into \c result , where \c first is the offset of the block and \c n
+    /// is the number of elements in the block. The partial results of the
+    /// blocks are combined with \c join_op in block order, so the result
+    /// does not depend on the task schedule.
+    /// \tparam Scalar The result type
+    /// \tparam ReduceOp The block reduction operation type
+    /// \tparam JoinOp The partial result reduction operation type
+    /// \param volume The number of elements
+    /// \param identity The initial value of the reduction
+    /// \param reduce_op The block reduction operation
+    /// \param join_op The partial result reduction operation
+    /// \return The reduced value
+    template <typename Scalar, typename ReduceOp, typename JoinOp>
+    inline Scalar parallel_reduce_op(const std::size_t volume,
+        const Scalar identity, const ReduceOp& reduce_op, JoinOp&& join_op)
+    {
+      Scalar result = identity;
+      const std::size_t blocks = TensorParallelConfig::blocks(volume);
+      if(blocks == 1ul) {
+        reduce_op(result, 0ul, volume);
+      } else {
+        std::vector<Scalar> partials(blocks, identity);
+        parallel_blocks(volume, blocks,
+            [&] (const std::size_t b, const std::size_t first, const std::size_t n)
+            { reduce_op(partials[b], first, n); });
+
+        for(std::size_t b = 0ul; b < blocks; ++b)
+          join_op(result, partials[b]);
+      }
+
+      return result;
+    }
+
+  } // namespace detail
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TENSOR_PARALLEL_CONFIG_H__INCLUDED
@@ -28,6 +28,7 @@
 
 #include <TiledArray/perm_index.h>
 #include <TiledArray/math/transpose.h>
+#include <TiledArray/tensor/parallel_config.h>
 
 namespace TiledArray {
   namespace detail {
@@ -98,6 +99,12 @@ namespace TiledArray {
 
     /// Construct a permuted tensor copy
 
+    /// The permutation is evaluated as a series of cache-blocked matrix
+    /// transposes (or block copies when the last dimension is not permuted).
+    /// When the volume is at least \c TensorParallelConfig::threshold() , the
+    /// outer loops over the matrices (or the matrix rows when there are too
+    /// few matrices) are split across the task threads, so the operations
+    /// must be thread-safe.
     /// The expected signature of the input operations is:
     /// \code
     /// Result::value_type input_op(const Arg0::value_type, const Args::value_type...)
@@ -151,13 +158,26 @@ namespace TiledArray {
         { output_op(result, input_op(a0, as...)); };
 
         // Permute the data
-        for(typename Result::size_type index = 0ul; index < volume; index += block_size) {
-          const typename Result::size_type perm_index = perm_index_op(index);
-
-          // Copy the block
-          math::vector_ptr_op(op, block_size, result.data() + perm_index,
-              arg0.data() + index, (args.data() + index)...);
-        }
+        auto copy_blocks = [&] (const std::size_t first, const std::size_t n) {
+          const typename Result::size_type last = (first + n) * block_size;
+          for(typename Result::size_type index = first * block_size; index < last; index += block_size) {
+            const typename Result::size_type perm_index = perm_index_op(index);
+
+            // Copy the block
+            math::vector_ptr_op(op, block_size, result.data() + perm_index,
+                arg0.data() + index, (args.data() + index)...);
+          }
+        };
+
+        const std::size_t nblocks = volume / block_size;
+        const std::size_t tasks =
+            std::min(TensorParallelConfig::blocks(volume), nblocks);
+        if(tasks > 1ul)
+          parallel_blocks(nblocks, tasks, (nblocks + tasks - 1ul) / tasks,
+              [&] (const std::size_t, const std::size_t first, const std::size_t n)
+              { copy_blocks(first, n); });
+        else
+          copy_blocks(0ul, nblocks);
 
       } else {
         // This is the more complicated case. Here we permute in terms of matrix
@@ -187,18 +207,41 @@ namespace TiledArray {
           result_outer_stride *= result_extent[i];
 
         // Copy data from the input to the output matrix via a series of matrix
-        // transposes.
-        for(typename Result::size_type i = 0ul; i < other_fused_size[0]; ++i) {
-          typename Result::size_type index = i * other_fused_weight[0];
-          for(typename Result::size_type j = 0ul; j < other_fused_size[2]; ++j, index += other_fused_weight[2]) {
+        // transposes. Matrices [first, last) of the outer loops are
+        // transposed, or only their argument rows [row, row + rows).
+        auto transpose_matrices = [&] (const std::size_t first,
+            const std::size_t last, const std::size_t row, const std::size_t rows)
+        {
+          const typename Result::size_type row_offset = row * other_fused_weight[1];
+          for(std::size_t k = first; k < last; ++k) {
             // Compute the ordinal index of the input and output matrices.
-            typename Result::size_type perm_index = perm_index_op(index);
-
-            math::transpose(input_op, output_op,
-                other_fused_size[1], other_fused_size[3],
-                result_outer_stride, result.data() + perm_index,
-                other_fused_weight[1], arg0.data() + index, (args.data() + index)...);
+            const typename Result::size_type index =
+                (k / other_fused_size[2]) * other_fused_weight[0] +
+                (k % other_fused_size[2]) * other_fused_weight[2];
+            const typename Result::size_type perm_index = perm_index_op(index);
+
+            math::transpose(input_op, output_op, rows, other_fused_size[3],
+                result_outer_stride, result.data() + perm_index + row,
+                other_fused_weight[1], arg0.data() + index + row_offset,
+                (args.data() + index + row_offset)...);
           }
+        };
+
+        const std::size_t matrices = other_fused_size[0] * other_fused_size[2];
+        const std::size_t tasks = TensorParallelConfig::blocks(volume);
+        if(tasks > 1ul && matrices >= tasks) {
+          // Split the matrices across threads
+          parallel_blocks(matrices, tasks, (matrices + tasks - 1ul) / tasks,
+              [&] (const std::size_t, const std::size_t first, const std::size_t n)
+              { transpose_matrices(first, first + n, 0ul, other_fused_size[1]); });
+        } else if(tasks > 1ul && other_fused_size[1] >= (TILEDARRAY_LOOP_UNWIND << 1)) {
+          // Split the matrix rows across threads
+          parallel_blocks(other_fused_size[1],
+              std::min(tasks, other_fused_size[1] / TILEDARRAY_LOOP_UNWIND),
+              [&] (const std::size_t, const std::size_t first, const std::size_t n)
+              { transpose_matrices(0ul, matrices, first, n); });
+        } else {
+          transpose_matrices(0ul, matrices, 0ul, other_fused_size[1]);
         }
       }
     }
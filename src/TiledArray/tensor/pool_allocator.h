@@ -0,0 +1,481 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_TENSOR_POOL_ALLOCATOR_H__INCLUDED
+#define TILEDARRAY_TENSOR_POOL_ALLOCATOR_H__INCLUDED
+
+#include <tiledarray_fwd.h>
+#include <TiledArray/error.h>
+#include <TiledArray/numa.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif // defined(__linux__)
+
+namespace TiledArray {
+
+  /// Tile memory pool
+
+  /// Tile memory is allocated in size classes, where each power of two is
+  /// divided into four classes, so at most 25% of a block is unused. Freed
+  /// blocks are kept in a cache of the thread that freed them, and are
+  /// reused by the next allocation of the same size class on that thread.
+  /// When a thread cache exceeds \c thread_cache_limit() bytes, half of the
+  /// blocks of the size class are moved to a shared cache, which holds at
+  /// most \c cache_limit() bytes; other blocks are returned to the system.
+  /// When NUMA placement is enabled (see \c NumaConfig ; it is disabled by
+  /// default), there is a shared
+  /// cache for each NUMA node, and freed blocks of at least
+  /// \c numa_block_size bytes are returned to the cache of the node that
+  /// holds their pages. Since new blocks are first touched by the thread that
+  /// initializes the tile, tile data stays on the node of the task that
+  /// produced it. Blocks are aligned to cache lines, and blocks of at least
+  /// 2 MiB may be backed by transparent huge pages. These settings are
+  /// process-local.
+  class TilePool {
+  public:
+
+    static constexpr std::size_t min_block_size = 64ul; ///< Smallest block and block alignment
+    static constexpr std::size_t max_block_size = 1ul << 30; ///< Largest pooled block
+    static constexpr std::size_t huge_page_size = 1ul << 21; ///< Huge page size
+    static constexpr std::size_t classes = 4ul * 24ul + 1ul; ///< Number of size classes
+    static constexpr std::size_t numa_block_size = 1ul << 16; ///< Smallest block that is placed by NUMA node
+
+  private:
+
+    /// Shared block cache
+    struct SharedCache {
+      std::mutex mutex_; ///< Cache mutex
+      std::vector<void*> blocks_[classes]; ///< Free blocks of each class
+      std::size_t bytes_ = 0ul; ///< Bytes of the free blocks
+    }; // struct SharedCache
+
+    /// Thread block cache
+    struct ThreadCache {
+      std::vector<void*> blocks_[classes]; ///< Free blocks of each class
+      std::size_t bytes_ = 0ul; ///< Bytes of the free blocks
+
+      ThreadCache() { alive_() = true; }
+
+      ~ThreadCache() {
+        alive_() = false;
+        const std::size_t node = node_();
+        for(std::size_t c = 0ul; c < classes; ++c)
+          release(node, c, blocks_[c], blocks_[c].size());
+      }
+    }; // struct ThreadCache
+
+    struct Stats {
+      std::atomic<std::size_t> allocations_{0ul};
+      std::atomic<std::size_t> thread_hits_{0ul};
+      std::atomic<std::size_t> shared_hits_{0ul};
+      std::atomic<std::size_t> system_frees_{0ul};
+      std::atomic<std::size_t> remote_frees_{0ul};
+    }; // struct Stats
+
+    // The shared caches and statistics are never destroyed, so tiles may be
+    // freed during static destruction.
+    static SharedCache& shared_(const std::size_t node) {
+      static SharedCache* caches = new SharedCache[NumaConfig::nodes()];
+      return caches[node];
+    }
+
+    /// The NUMA node of the shared cache of the calling thread
+    static std::size_t node_() {
+      return (NumaConfig::enabled() ?
+          std::min(NumaConfig::node(), NumaConfig::nodes() - 1ul) : 0ul);
+    }
+
+    static Stats& stats_() {
+      static Stats* stats = new Stats;
+      return *stats;
+    }
+
+    static bool& alive_() {
+      static thread_local bool alive = false;
+      return alive;
+    }
+
+    static ThreadCache* thread_cache_() {
+      static thread_local ThreadCache cache;
+      // The cache is not used after it is destroyed at thread exit
+      return (alive_() ? & cache : nullptr);
+    }
+
+    static std::atomic<std::size_t>& thread_cache_limit_() {
+      static std::atomic<std::size_t> limit(64ul << 20);
+      return limit;
+    }
+
+    static std::atomic<std::size_t>& cache_limit_() {
+      static std::atomic<std::size_t> limit(1ul << 30);
+      return limit;
+    }
+
+    static std::atomic<bool>& huge_pages_() {
+      static std::atomic<bool> huge_pages(false);
+      return huge_pages;
+    }
+
+    /// Allocate a block from the system
+
+    /// \param size The block size
+    /// \return A pointer to the block
+    /// \throw std::bad_alloc When the allocation fails
+    static void* system_allocate(const std::size_t size) {
+      const bool huge = huge_pages() && (size >= huge_page_size);
+      void* block = nullptr;
+      if(posix_memalign(& block, (huge ? huge_page_size : min_block_size), size) != 0)
+        throw std::bad_alloc();
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+      if(huge)
+        madvise(block, size, MADV_HUGEPAGE);
+#endif // defined(__linux__) && defined(MADV_HUGEPAGE)
+      return block;
+    }
+
+    /// Return a block to the system
+    static void system_free(void* const block) {
+      ++stats_().system_frees_;
+      std::free(block);
+    }
+
+    /// Move blocks to a shared cache
+
+    /// Blocks that do not fit in the shared cache are returned to the system.
+    /// \param node The NUMA node of the shared cache
+    /// \param c The size class of the blocks
+    /// \param blocks The thread cache blocks of class \c c
+    /// \param n The number of blocks to be moved from the end of \c blocks
+    static void release(const std::size_t node, const std::size_t c,
+        std::vector<void*>& blocks, const std::size_t n)
+    {
+      TA_ASSERT(n <= blocks.size());
+      const std::size_t size = class_size(c);
+      std::size_t i = 0ul;
+      SharedCache& shared = shared_(node);
+      {
+        std::lock_guard<std::mutex> lock(shared.mutex_);
+        const std::size_t limit = cache_limit();
+        for(; (i < n) && (shared.bytes_ + size <= limit); ++i) {
+          shared.blocks_[c].push_back(blocks.back());
+          shared.bytes_ += size;
+          blocks.pop_back();
+        }
+      }
+      for(; i < n; ++i) {
+        system_free(blocks.back());
+        blocks.pop_back();
+      }
+    }
+
+  public:
+
+    /// Size class of a block
+
+    /// \param size The number of bytes
+    /// \return The smallest size class with blocks of at least \c size bytes
+    static std::size_t size_class(const std::size_t size) {
+      if(size <= min_block_size)
+        return 0ul;
+
+      // Find k such that 2^k < size <= 2^(k+1)
+      std::size_t k = 0ul;
+      for(std::size_t s = size - 1ul; s > 1ul; s >>= 1)
+        ++k;
+      const std::size_t step = std::size_t(1) << (k - 2ul);
+      const std::size_t m = (size - (std::size_t(1) << k) + step - 1ul) / step;
+      return (k - 6ul) * 4ul + m;
+    }
+
+    /// Block size of a size class
+
+    /// \param c The size class
+    /// \return The number of bytes of blocks in class \c c
+    static std::size_t class_size(const std::size_t c) {
+      const std::size_t k = 6ul + c / 4ul;
+      return (std::size_t(1) << k) + (c % 4ul) * (std::size_t(1) << (k - 2ul));
+    }
+
+    /// Allocate a block
+
+    /// \param size The number of bytes
+    /// \return A pointer to a block of at least \c size bytes
+    /// \throw std::bad_alloc When the allocation fails
+    static void* allocate(const std::size_t size) {
+      Stats& stats = stats_();
+      ++stats.allocations_;
+      if(size > max_block_size)
+        return system_allocate(size);
+
+      const std::size_t c = size_class(size);
+      const std::size_t block_size = class_size(c);
+
+      // Take a block from the thread cache
+      ThreadCache* const cache = thread_cache_();
+      if(cache && ! cache->blocks_[c].empty()) {
+        void* const block = cache->blocks_[c].back();
+        cache->blocks_[c].pop_back();
+        cache->bytes_ -= block_size;
+        ++stats.thread_hits_;
+        return block;
+      }
+
+      // Take a block from the shared cache of this NUMA node
+      SharedCache& shared = shared_(node_());
+      {
+        std::lock_guard<std::mutex> lock(shared.mutex_);
+        if(! shared.blocks_[c].empty()) {
+          void* const block = shared.blocks_[c].back();
+          shared.blocks_[c].pop_back();
+          shared.bytes_ -= block_size;
+          ++stats.shared_hits_;
+          return block;
+        }
+      }
+
+      return system_allocate(block_size);
+    }
+
+    /// Free a block
+
+    /// \param block The block pointer
+    /// \param size The number of bytes that were allocated
+    static void deallocate(void* const block, const std::size_t size) {
+      if(! block)
+        return;
+      if(size > max_block_size) {
+        system_free(block);
+        return;
+      }
+
+      const std::size_t c = size_class(size);
+      const std::size_t block_size = class_size(c);
+
+      const std::size_t node = node_();
+      ThreadCache* const cache = thread_cache_();
+      if(! cache) {
+        std::vector<void*> blocks(1, block);
+        release(node, c, blocks, 1ul);
+        return;
+      }
+
+      // Return large blocks that are held by another NUMA node to the
+      // shared cache of that node
+      if((block_size >= numa_block_size) && (NumaConfig::nodes() > 1ul) &&
+          NumaConfig::enabled())
+      {
+        const std::size_t block_node = NumaConfig::node_of(block);
+        if((block_node != node) && (block_node < NumaConfig::nodes())) {
+          ++stats_().remote_frees_;
+          std::vector<void*> blocks(1, block);
+          release(block_node, c, blocks, 1ul);
+          return;
+        }
+      }
+
+      cache->blocks_[c].push_back(block);
+      cache->bytes_ += block_size;
+
+      // Move half of the blocks of this class to the shared cache when the
+      // thread cache is full
+      if(cache->bytes_ > thread_cache_limit()) {
+        std::vector<void*>& blocks = cache->blocks_[c];
+        const std::size_t n = (blocks.size() + 1ul) / 2ul;
+        cache->bytes_ -= n * block_size;
+        release(node, c, blocks, n);
+      }
+    }
+
+    /// Return the blocks of the shared caches to the system
+    static void release() {
+      for(std::size_t node = 0ul; node < NumaConfig::nodes(); ++node) {
+        SharedCache& shared = shared_(node);
+        std::lock_guard<std::mutex> lock(shared.mutex_);
+        for(std::size_t c = 0ul; c < classes; ++c) {
+          for(void* const block : shared.blocks_[c])
+            system_free(block);
+          std::vector<void*>().swap(shared.blocks_[c]);
+        }
+        shared.bytes_ = 0ul;
+      }
+    }
+
+    /// Thread cache limit accessor
+
+    /// \return The maximum number of bytes of free blocks in each thread cache
+    static std::size_t thread_cache_limit() { return thread_cache_limit_().load(std::memory_order_relaxed); }
+
+    /// Set the thread cache limit
+
+    /// \param bytes The maximum number of bytes of free blocks in each thread
+    /// cache [ default = 64 MiB ]
+    static void set_thread_cache_limit(const std::size_t bytes) { thread_cache_limit_() = bytes; }
+
+    /// Shared cache limit accessor
+
+    /// \return The maximum number of bytes of free blocks in each shared cache
+    static std::size_t cache_limit() { return cache_limit_().load(std::memory_order_relaxed); }
+
+    /// Set the shared cache limit
+
+    /// \param bytes The maximum number of bytes of free blocks in each shared
+    /// cache [ default = 1 GiB ]
+    static void set_cache_limit(const std::size_t bytes) { cache_limit_() = bytes; }
+
+    /// Huge page accessor
+
+    /// \return \c true if blocks of at least 2 MiB are backed by huge pages
+    static bool huge_pages() { return huge_pages_().load(std::memory_order_relaxed); }
+
+    /// Enable or disable huge pages
+
+    /// When enabled, new blocks of at least 2 MiB are aligned to huge pages
+    /// and transparent huge pages are requested for them (Linux only).
+    /// \param huge_pages If \c true, large blocks are backed by huge pages
+    /// [ default = false ]
+    static void set_huge_pages(const bool huge_pages) { huge_pages_() = huge_pages; }
+
+    /// Allocation counter accessor
+
+    /// \return The number of allocations since the last \c reset_stats()
+    static std::size_t allocations() { return stats_().allocations_; }
+
+    /// Pool hit counter accessor
+
+    /// \return The number of allocations that reused a cached block
+    static std::size_t hits() { return thread_hits() + shared_hits(); }
+
+    /// Thread cache hit counter accessor
+
+    /// \return The number of allocations that reused a block of the thread
+    /// cache
+    static std::size_t thread_hits() { return stats_().thread_hits_; }
+
+    /// Shared cache hit counter accessor
+
+    /// \return The number of allocations that reused a block of the shared
+    /// cache
+    static std::size_t shared_hits() { return stats_().shared_hits_; }
+
+    /// Pool hit rate accessor
+
+    /// \return The fraction of allocations that reused a cached block
+    static double hit_rate() {
+      const std::size_t n = allocations();
+      return (n ? double(hits()) / double(n) : 0.0);
+    }
+
+    /// System free counter accessor
+
+    /// \return The number of blocks that were returned to the system
+    static std::size_t system_frees() { return stats_().system_frees_; }
+
+    /// Remote free counter accessor
+
+    /// \return The number of freed blocks that were returned to the shared
+    /// cache of another NUMA node
+    static std::size_t remote_frees() { return stats_().remote_frees_; }
+
+    /// Reset the statistics counters
+    static void reset_stats() {
+      Stats& stats = stats_();
+      stats.allocations_ = 0ul;
+      stats.thread_hits_ = 0ul;
+      stats.shared_hits_ = 0ul;
+      stats.system_frees_ = 0ul;
+      stats.remote_frees_ = 0ul;
+    }
+
+  }; // class TilePool
+
+  /// Pool allocator for tensor elements
+
+  /// This allocator gets memory from \c TilePool. It can be used as the
+  /// allocator of \c Tensor , e.g. <tt>Tensor<double, PoolAllocator<double> ></tt>.
+  /// All instances are interchangeable.
+  /// \tparam T The element type
+  template <typename T>
+  class PoolAllocator {
+  public:
+    typedef T value_type; ///< Element type
+    typedef T* pointer; ///< Element pointer type
+    typedef const T* const_pointer; ///< Element const pointer type
+    typedef T& reference; ///< Element reference type
+    typedef const T& const_reference; ///< Element const reference type
+    typedef std::size_t size_type; ///< Size type
+    typedef std::ptrdiff_t difference_type; ///< Difference type
+
+    template <typename U>
+    struct rebind { typedef PoolAllocator<U> other; };
+
+    PoolAllocator() { }
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) { }
+
+    /// Allocate elements
+
+    /// \param n The number of elements
+    /// \return A pointer to uninitialized memory for \c n elements
+    pointer allocate(const size_type n, const void* = nullptr) {
+      if(n == 0ul)
+        return nullptr;
+      if(n > max_size())
+        throw std::bad_alloc();
+      return static_cast<pointer>(TilePool::allocate(n * sizeof(T)));
+    }
+
+    /// Free elements
+
+    /// \param p The pointer returned by \c allocate(n)
+    /// \param n The number of elements
+    void deallocate(const pointer p, const size_type n) {
+      TilePool::deallocate(p, n * sizeof(T));
+    }
+
+    size_type max_size() const { return std::numeric_limits<size_type>::max() / sizeof(T); }
+
+    pointer address(reference x) const { return & x; }
+    const_pointer address(const_reference x) const { return & x; }
+
+    template <typename U, typename... Args>
+    void construct(U* const p, Args&&... args) { new(p) U(std::forward<Args>(args)...); }
+
+    template <typename U>
+    void destroy(U* const p) { p->~U(); }
+
+  }; // class PoolAllocator
+
+  template <typename T, typename U>
+  inline bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&) { return true; }
+
+  template <typename T, typename U>
+  inline bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&) { return false; }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TENSOR_POOL_ALLOCATOR_H__INCLUDED
@@ -21,8 +21,10 @@
 #define TILEDARRAY_TENSOR_TENSOR_H__INCLUDED
 
 #include <TiledArray/math/gemm_helper.h>
-#include <TiledArray/math/blas.h>
+#include <TiledArray/math/parallel_gemm.h>
+#include <TiledArray/math/strided_gemm.h>
 #include <TiledArray/tensor/kernels.h>
+#include <TiledArray/tensor/pool_allocator.h>
 
 namespace TiledArray {
 
@@ -30,7 +32,7 @@ namespace TiledArray {
 
   /// \tparam T the value type of this tensor
   /// \tparam A The allocator type for the data
-  template <typename T, typename A = Eigen::aligned_allocator<T> >
+  template <typename T, typename A = typename detail::default_allocator<T>::type>
   class Tensor {
   public:
     typedef Tensor<T, A> Tensor_; ///< This class type
@@ -94,6 +96,62 @@ namespace TiledArray {
       math::uninitialized_fill_vector(n, U(), u);
     }
 
+    /// Contract two argument pairs with a single *GEMM
+
+    /// The inner dimensions of the two pairs are packed into contiguous
+    /// left- and right-hand panels, so that both contractions are evaluated
+    /// by one *GEMM call. The outer dimensions of all arguments must match.
+    /// \param left1 The first left-hand argument
+    /// \param right1 The first right-hand argument
+    /// \param left2 The second left-hand argument
+    /// \param right2 The second right-hand argument
+    /// \param factor The scaling factor
+    /// \param beta The scaling factor applied to the data of this tensor
+    /// \param gemm_helper The *GEMM operation meta data
+    template <typename U, typename AU, typename V, typename AV>
+    void gemm_packed(const Tensor<U, AU>& left1, const Tensor<V, AV>& right1,
+        const Tensor<U, AU>& left2, const Tensor<V, AV>& right2,
+        const numeric_type factor, const numeric_type beta,
+        const math::GemmHelper& gemm_helper)
+    {
+      typedef typename Tensor<U, AU>::value_type left_value_type;
+      typedef typename Tensor<V, AV>::value_type right_value_type;
+
+      // Batched arguments are not packed
+      TA_ASSERT(gemm_helper.batch_rank() == 0u);
+
+      // Check that the inner dimensions of each pair match
+      TA_ASSERT(gemm_helper.left_right_coformal(left1.range().extent_data(),
+          right1.range().extent_data()));
+      TA_ASSERT(gemm_helper.left_right_coformal(left2.range().extent_data(),
+          right2.range().extent_data()));
+
+      // Compute gemm dimensions
+      integer m1, n1, k1, m2, n2, k2;
+      gemm_helper.compute_matrix_sizes(m1, n1, k1, left1.range(), right1.range());
+      gemm_helper.compute_matrix_sizes(m2, n2, k2, left2.range(), right2.range());
+      TA_ASSERT(m1 == m2);
+      TA_ASSERT(n1 == n2);
+      const integer k = k1 + k2;
+
+      // Pack the arguments along the inner dimension
+      const bool left_notrans = (gemm_helper.left_op() == madness::cblas::NoTrans);
+      const bool right_notrans = (gemm_helper.right_op() == madness::cblas::NoTrans);
+      std::unique_ptr<left_value_type[]> left(new left_value_type[m1 * k]);
+      std::unique_ptr<right_value_type[]> right(new right_value_type[k * n1]);
+      math::pack_inner(left_notrans, m1, k1, left1.data(), k2, left2.data(),
+          left.get());
+      math::pack_inner(! right_notrans, n1, k1, right1.data(), k2, right2.data(),
+          right.get());
+
+      // Get the leading dimension for left and right matrices.
+      const integer lda = (left_notrans ? k : m1);
+      const integer ldb = (right_notrans ? n1 : k);
+
+      math::parallel_gemm(gemm_helper.left_op(), gemm_helper.right_op(), m1, n1, k,
+          factor, left.get(), lda, right.get(), ldb, beta, pimpl_->data_, n1);
+    }
+
     std::shared_ptr<Impl> pimpl_; ///< Shared pointer to implementation object
     static const range_type empty_range_; ///< Empty range
 
@@ -622,7 +680,7 @@ namespace TiledArray {
     /// \return A new tensor where the elements are the sum of the elements of
     /// \c this are scaled by \c factor
     Tensor_ scale(numeric_type factor) const {
-      return unary([=] (const numeric_type a) { return a * factor; });
+      return unary(math::ScaleOp<numeric_type>(factor));
     }
 
     /// Construct a scaled and permuted copy of this tensor
@@ -640,7 +698,7 @@ namespace TiledArray {
     /// \param factor The scaling factor
     /// \return A reference to this tensor
     Tensor_& scale_to(numeric_type factor) {
-      return inplace_unary([=] (numeric_type& restrict res) { res *= factor; });
+      return inplace_unary(math::ScaleToOp<numeric_type>(factor));
     }
 
     // Addition operations
@@ -654,8 +712,7 @@ namespace TiledArray {
     template <typename Right,
         typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
     Tensor_ add(const Right& right) const {
-      return binary(right, [] (const numeric_type l,
-          const typename TiledArray::detail::scalar_type<Right>::type r) { return l + r; });
+      return binary(right, math::AddOp());
     }
 
     /// Add this and \c other to construct a new, permuted tensor
@@ -684,9 +741,7 @@ namespace TiledArray {
     template <typename Right,
         typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
     Tensor_ add(const Right& right, const numeric_type factor) const {
-      return binary(right, [=] (const numeric_type l,
-          const typename TiledArray::detail::scalar_type<Right>::type r)
-          { return (l + r) * factor; });
+      return binary(right, math::AddScaleOp<numeric_type>(factor));
     }
 
     /// Scale and add this and \c other to construct a new, permuted tensor
@@ -734,9 +789,7 @@ namespace TiledArray {
     template <typename Right,
         typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
     Tensor_& add_to(const Right& right) {
-      return inplace_binary(right, [] (numeric_type& restrict l,
-          const typename TiledArray::detail::scalar_type<Right>::type r)
-          { l += r; });
+      return inplace_binary(right, math::AddToOp());
     }
 
     /// Add \c other to this tensor, and scale the result
@@ -748,9 +801,7 @@ namespace TiledArray {
     template <typename Right,
         typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
     Tensor_& add_to(const Right& right, const numeric_type factor) {
-      return inplace_binary(right, [=] (numeric_type& restrict l,
-          const typename TiledArray::detail::scalar_type<Right>::type r)
-          { (l += r) *= factor; });
+      return inplace_binary(right, math::AddToScaleOp<numeric_type>(factor));
     }
 
     /// Add a constant to this tensor
@@ -772,9 +823,7 @@ namespace TiledArray {
     template <typename Right,
         typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
     Tensor_ subt(const Right& right) const {
-      return binary(right, [] (const numeric_type l,
-          const typename TiledArray::detail::scalar_type<Right>::type r)
-          { return l - r; });
+      return binary(right, math::SubtOp());
     }
 
     /// Subtract this and \c right to construct a new, permuted tensor
@@ -851,9 +900,7 @@ namespace TiledArray {
     template <typename Right,
         typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
     Tensor_& subt_to(const Right& right) {
-      return inplace_binary(right, [] (numeric_type& restrict l,
-          const typename TiledArray::detail::scalar_type<Right>::type r)
-          { l -= r; });
+      return inplace_binary(right, math::SubtToOp());
     }
 
     /// Subtract \c right from and scale this tensor
@@ -888,9 +935,7 @@ namespace TiledArray {
     template <typename Right,
         typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
     Tensor_ mult(const Right& right) const {
-      return binary(right, [] (const numeric_type l,
-          const typename TiledArray::detail::scalar_type<Right>::type r)
-          { return l * r; });
+      return binary(right, math::MultOp());
     }
 
     /// Multiply this by \c right to create a new, permuted tensor
@@ -949,9 +994,7 @@ namespace TiledArray {
     template <typename Right,
         typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
     Tensor_& mult_to(const Right& right) {
-      return inplace_binary(right, [] (numeric_type& restrict l,
-          const typename TiledArray::detail::scalar_type<Right>::type r)
-          { l *= r; });
+      return inplace_binary(right, math::MultToOp());
     }
 
     /// Scale and multiply this tensor by \c right
@@ -1029,13 +1072,17 @@ namespace TiledArray {
       // Compute gemm dimensions
       integer m = 1, n = 1, k = 1;
       gemm_helper.compute_matrix_sizes(m, n, k, pimpl_->range_, other.range());
+      const integer batch = gemm_helper.compute_batch_size(pimpl_->range_);
 
       // Get the leading dimension for left and right matrices.
       const integer lda = (gemm_helper.left_op() == madness::cblas::NoTrans ? k : m);
       const integer ldb = (gemm_helper.right_op() == madness::cblas::NoTrans ? n : k);
 
-      math::gemm(gemm_helper.left_op(), gemm_helper.right_op(), m, n, k, factor,
-          pimpl_->data_, lda, other.data(), ldb, numeric_type(0), result.data(), n);
+      // Evaluate one *GEMM for each element of the batch dimensions
+      for(integer b = 0; b < batch; ++b)
+        math::parallel_gemm(gemm_helper.left_op(), gemm_helper.right_op(), m, n, k, factor,
+            pimpl_->data_ + b * m * k, lda, other.data() + b * k * n, ldb,
+            numeric_type(0), result.data() + b * m * n, n);
 
       return result;
     }
@@ -1123,6 +1170,7 @@ namespace TiledArray {
       // Compute gemm dimensions
       integer m, n, k;
       gemm_helper.compute_matrix_sizes(m, n, k, left.range(), right.range());
+      const integer batch = gemm_helper.compute_batch_size(left.range());
 
       // Get the leading dimension for left and right matrices.
       const integer lda =
@@ -1130,8 +1178,190 @@ namespace TiledArray {
       const integer ldb =
           (gemm_helper.right_op() == madness::cblas::NoTrans ? n : k);
 
-      math::gemm(gemm_helper.left_op(), gemm_helper.right_op(), m, n, k, factor,
-          left.data(), lda, right.data(), ldb, numeric_type(1), pimpl_->data_, n);
+      // Evaluate one *GEMM for each element of the batch dimensions
+      for(integer b = 0; b < batch; ++b)
+        math::parallel_gemm(gemm_helper.left_op(), gemm_helper.right_op(), m, n, k, factor,
+            left.data() + b * m * k, lda, right.data() + b * k * n, ldb,
+            numeric_type(1), pimpl_->data_ + b * m * n, n);
+
+      return *this;
+    }
+
+    /// Contract this tensor with \c right1 and \c left2 with \c right2
+
+    /// The two contractions share the outer dimensions but may differ in the
+    /// size of the inner dimensions. The arguments are packed along the inner
+    /// dimension, and the sum of the two contractions is evaluated with a
+    /// single *GEMM call.
+    /// \tparam U The right-hand tensor element type
+    /// \tparam AU The right-hand tensor allocator type
+    /// \param right1 The right-hand tensor that will be contracted with this
+    /// tensor
+    /// \param left2 The second left-hand tensor that will be contracted
+    /// \param right2 The second right-hand tensor that will be contracted
+    /// \param factor The scaling factor
+    /// \param gemm_helper The *GEMM operation meta data
+    /// \return A new tensor that is equal to
+    /// <tt>(this * right1 + left2 * right2) * factor</tt>
+    /// \throw TiledArray::Exception When this tensor is empty.
+    /// \throw TiledArray::Exception When any argument is empty.
+    template <typename U, typename AU>
+    Tensor_ gemm(const Tensor<U, AU>& right1, const Tensor_& left2,
+        const Tensor<U, AU>& right2, const numeric_type factor,
+        const math::GemmHelper& gemm_helper) const
+    {
+      // Check that the arguments are not empty and have the correct ranks
+      TA_ASSERT(pimpl_);
+      TA_ASSERT(pimpl_->range_.rank() == gemm_helper.left_rank());
+      TA_ASSERT(!right1.empty());
+      TA_ASSERT(right1.range().rank() == gemm_helper.right_rank());
+      TA_ASSERT(!left2.empty());
+      TA_ASSERT(left2.range().rank() == gemm_helper.left_rank());
+      TA_ASSERT(!right2.empty());
+      TA_ASSERT(right2.range().rank() == gemm_helper.right_rank());
+
+      // Construct the result Tensor
+      Tensor_ result(gemm_helper.make_result_range<range_type>(pimpl_->range_, right1.range()));
+
+      result.gemm_packed(*this, right1, left2, right2, factor, numeric_type(0),
+          gemm_helper);
+
+      return result;
+    }
+
+    /// Contract two pairs of tensors and add the result to this tensor
+
+    /// The two contractions share the outer dimensions but may differ in the
+    /// size of the inner dimensions. The arguments are packed along the inner
+    /// dimension, and the sum of the two contractions is evaluated with a
+    /// single *GEMM call.
+    /// \tparam U The left-hand tensor element type
+    /// \tparam AU The left-hand tensor allocator type
+    /// \tparam V The right-hand tensor element type
+    /// \tparam AV The right-hand tensor allocator type
+    /// \param left1 The first left-hand tensor that will be contracted
+    /// \param right1 The first right-hand tensor that will be contracted
+    /// \param left2 The second left-hand tensor that will be contracted
+    /// \param right2 The second right-hand tensor that will be contracted
+    /// \param factor The scaling factor
+    /// \param gemm_helper The *GEMM operation meta data
+    /// \return A reference to this tensor
+    /// \throw TiledArray::Exception When this tensor is empty.
+    /// \throw TiledArray::Exception When any argument is empty.
+    template <typename U, typename AU, typename V, typename AV>
+    Tensor_& gemm(const Tensor<U, AU>& left1, const Tensor<V, AV>& right1,
+        const Tensor<U, AU>& left2, const Tensor<V, AV>& right2,
+        const numeric_type factor, const math::GemmHelper& gemm_helper)
+    {
+      // Check that this tensor is not empty and has the correct rank
+      TA_ASSERT(pimpl_);
+      TA_ASSERT(pimpl_->range_.rank() == gemm_helper.result_rank());
+
+      // Check that the arguments are not empty and have the correct ranks
+      TA_ASSERT(!left1.empty());
+      TA_ASSERT(left1.range().rank() == gemm_helper.left_rank());
+      TA_ASSERT(!right1.empty());
+      TA_ASSERT(right1.range().rank() == gemm_helper.right_rank());
+      TA_ASSERT(!left2.empty());
+      TA_ASSERT(left2.range().rank() == gemm_helper.left_rank());
+      TA_ASSERT(!right2.empty());
+      TA_ASSERT(right2.range().rank() == gemm_helper.right_rank());
+
+      // Check that the outer dimensions of the arguments match the
+      // corresponding dimensions in result
+      TA_ASSERT(gemm_helper.left_result_coformal(left1.range().extent_data(),
+          pimpl_->range_.extent_data()));
+      TA_ASSERT(gemm_helper.left_result_coformal(left2.range().extent_data(),
+          pimpl_->range_.extent_data()));
+      TA_ASSERT(gemm_helper.right_result_coformal(right1.range().extent_data(),
+          pimpl_->range_.extent_data()));
+      TA_ASSERT(gemm_helper.right_result_coformal(right2.range().extent_data(),
+          pimpl_->range_.extent_data()));
+
+      gemm_packed(left1, right1, left2, right2, factor, numeric_type(1),
+          gemm_helper);
+
+      return *this;
+    }
+
+    /// Contract this tensor with \c other, where the arguments are not in matrix form
+
+    /// The arguments are contracted in their native layout, as if they were
+    /// permuted into matrix form first (see \c math::StridedGemm ).
+    /// \tparam U The other tensor element type
+    /// \tparam AU The other tensor allocator type
+    /// \param other The tensor that will be contracted with this tensor
+    /// \param factor The scaling factor
+    /// \param gemm_helper The *GEMM operation meta data of the arguments in
+    /// matrix form
+    /// \param left_perm The permutation that takes this tensor to matrix form
+    /// \param right_perm The permutation that takes \c other to matrix form
+    /// \return A new tensor which is the result of contracting this tensor with
+    /// \c other
+    /// \throw TiledArray::Exception When this tensor is empty.
+    /// \throw TiledArray::Exception When \c other is empty.
+    template <typename U, typename AU>
+    Tensor_ gemm(const Tensor<U, AU>& other, const numeric_type factor,
+        const math::GemmHelper& gemm_helper, const Permutation& left_perm,
+        const Permutation& right_perm) const
+    {
+      // Check that the tensors are not empty
+      TA_ASSERT(pimpl_);
+      TA_ASSERT(!other.empty());
+
+      const math::StridedGemm strided_gemm(gemm_helper, pimpl_->range_, left_perm,
+          other.range(), right_perm);
+      TA_ASSERT(strided_gemm.is_valid());
+
+      // Construct the result Tensor
+      Tensor_ result(gemm_helper.make_result_range<range_type>(
+          (left_perm ? left_perm * pimpl_->range_ : pimpl_->range_),
+          (right_perm ? right_perm * other.range() : other.range())));
+
+      strided_gemm(factor, pimpl_->data_, other.data(), numeric_type(0),
+          result.data());
+
+      return result;
+    }
+
+    /// Contract two tensors that are not in matrix form and add the result to this tensor
+
+    /// The arguments are contracted in their native layout, as if they were
+    /// permuted into matrix form first (see \c math::StridedGemm ).
+    /// \tparam U The left-hand tensor element type
+    /// \tparam AU The left-hand tensor allocator type
+    /// \tparam V The right-hand tensor element type
+    /// \tparam AV The right-hand tensor allocator type
+    /// \param left The left-hand tensor that will be contracted
+    /// \param right The right-hand tensor that will be contracted
+    /// \param factor The scaling factor
+    /// \param gemm_helper The *GEMM operation meta data of the arguments in
+    /// matrix form
+    /// \param left_perm The permutation that takes \c left to matrix form
+    /// \param right_perm The permutation that takes \c right to matrix form
+    /// \return A reference to this tensor
+    /// \throw TiledArray::Exception When this tensor is empty.
+    /// \throw TiledArray::Exception When any argument is empty.
+    template <typename U, typename AU, typename V, typename AV>
+    Tensor_& gemm(const Tensor<U, AU>& left, const Tensor<V, AV>& right,
+        const numeric_type factor, const math::GemmHelper& gemm_helper,
+        const Permutation& left_perm, const Permutation& right_perm)
+    {
+      // Check that the tensors are not empty and have the correct ranks
+      TA_ASSERT(pimpl_);
+      TA_ASSERT(pimpl_->range_.rank() == gemm_helper.result_rank());
+      TA_ASSERT(!left.empty());
+      TA_ASSERT(!right.empty());
+
+      const math::StridedGemm strided_gemm(gemm_helper, left.range(), left_perm,
+          right.range(), right_perm);
+      TA_ASSERT(strided_gemm.is_valid());
+      TA_ASSERT(pimpl_->range_ == gemm_helper.make_result_range<range_type>(
+          (left_perm ? left_perm * left.range() : left.range()),
+          (right_perm ? right_perm * right.range() : right.range())));
+
+      strided_gemm(factor, left.data(), right.data(), numeric_type(1),
+          pimpl_->data_);
 
       return *this;
     }
@@ -1226,9 +1456,7 @@ namespace TiledArray {
 
     /// \return The sum of all elements of this tensor
     numeric_type sum() const {
-      auto sum_op = [] (numeric_type& restrict res, const numeric_type arg)
-              { res += arg; };
-      return reduce(sum_op, sum_op, numeric_type(0));
+      return reduce(math::AddToOp(), math::AddToOp(), numeric_type(0));
     }
 
     /// Product of elements
@@ -1244,11 +1472,7 @@ namespace TiledArray {
 
     /// \return The vector norm of this tensor
     numeric_type squared_norm() const {
-      auto square_op = [] (numeric_type& restrict res, const numeric_type arg)
-              { res += arg * arg; };
-      auto sum_op = [] (numeric_type& restrict res, const numeric_type arg)
-              { res += arg; };
-      return reduce(square_op, sum_op, numeric_type(0));
+      return reduce(math::SquareAddOp(), math::AddToOp(), numeric_type(0));
     }
 
     /// Vector 2-norm
@@ -1306,12 +1530,7 @@ namespace TiledArray {
     template <typename Right,
         typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
     numeric_type dot(const Right& other) const {
-      auto mult_add_op = [] (numeric_type& res, const numeric_type l,
-                const typename TiledArray::detail::scalar_type<Right>::type r)
-                { res += l * r; };
-      auto add_op = [] (numeric_type& restrict res, const numeric_type value)
-            { res += value; };
-      return reduce(other, mult_add_op, add_op, numeric_type(0));
+      return reduce(other, math::DotOp(), math::AddToOp(), numeric_type(0));
     }
 
   }; // class Tensor
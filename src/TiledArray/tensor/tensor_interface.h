@@ -26,6 +26,7 @@
 #ifndef TILEDARRAY_TENSOR_TENSOR_VIEW_H__INCLUDED
 #define TILEDARRAY_TENSOR_TENSOR_VIEW_H__INCLUDED
 
+#include <tiledarray_fwd.h>
 #include <TiledArray/type_traits.h>
 #include <TiledArray/tensor/kernels.h>
 #include <initializer_list>
@@ -104,7 +105,7 @@ namespace detail {
         typedef typename detail::scalar_type<value_type>::type
             numeric_type;  ///< the numeric type that supports T
 
-        typedef Tensor<T, Eigen::aligned_allocator<T> > result_tensor;
+        typedef Tensor<T, typename detail::default_allocator<T>::type> result_tensor;
         ///< Tensor type used as the return type from arithmetic operations
 
        private:
@@ -804,6 +804,64 @@ namespace TiledArray {
     return result;
   }
 
+  /// Contract and scale two pairs of tile arguments
+
+  /// The two contractions are done via a single GEMM operation, where the
+  /// inner dimensions of the argument pairs are packed together, with fused
+  /// indices as defined by \c gemm_config.
+  /// \tparam Left The left-hand tile type
+  /// \tparam Right The right-hand tile type
+  /// \param left1 The first left-hand argument to be contracted
+  /// \param right1 The first right-hand argument to be contracted
+  /// \param left2 The second left-hand argument to be contracted
+  /// \param right2 The second right-hand argument to be contracted
+  /// \param factor The scaling factor
+  /// \param gemm_config A helper object used to simplify gemm operations
+  /// \return A tile that is equal to
+  /// <tt>(left1 * right1 + left2 * right2) * factor</tt>
+  template <typename Left, typename Right, typename Scalar,
+      typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+  inline auto gemm(const Tile<Left>& left1, const Tile<Right>& right1,
+      const Tile<Left>& left2, const Tile<Right>& right2,
+      const Scalar factor, const math::GemmHelper& gemm_config) ->
+      Tile<decltype(gemm(left1.tensor(), right1.tensor(), left2.tensor(),
+          right2.tensor(), factor, gemm_config))>
+  {
+    return detail::make_tile(gemm(left1.tensor(), right1.tensor(),
+        left2.tensor(), right2.tensor(), factor, gemm_config));
+  }
+
+  /// Contract and scale two pairs of tile arguments to the result tile
+
+  /// The two contractions are done via a single GEMM operation, where the
+  /// inner dimensions of the argument pairs are packed together, with fused
+  /// indices as defined by \c gemm_config.
+  /// \tparam Result The result tile type
+  /// \tparam Left The left-hand tile type
+  /// \tparam Right The right-hand tile type
+  /// \param result The contracted result
+  /// \param left1 The first left-hand argument to be contracted
+  /// \param right1 The first right-hand argument to be contracted
+  /// \param left2 The second left-hand argument to be contracted
+  /// \param right2 The second right-hand argument to be contracted
+  /// \param factor The scaling factor
+  /// \param gemm_config A helper object used to simplify gemm operations
+  /// \return A tile that is equal to
+  /// <tt>result += (left1 * right1 + left2 * right2) * factor</tt>
+  template <typename Result, typename Left, typename Right, typename Scalar,
+      typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+  inline auto gemm(Tile<Result>& result, const Tile<Left>& left1,
+      const Tile<Right>& right1, const Tile<Left>& left2,
+      const Tile<Right>& right2, const Scalar factor,
+      const math::GemmHelper& gemm_config) ->
+      decltype(gemm(result.tensor(), left1.tensor(), right1.tensor(),
+          left2.tensor(), right2.tensor(), factor, gemm_config), result)
+  {
+    gemm(result.tensor(), left1.tensor(), right1.tensor(), left2.tensor(),
+        right2.tensor(), factor, gemm_config);
+    return result;
+  }
+
 
   // Reduction operations ------------------------------------------------------
 
@@ -29,6 +29,8 @@
 #include <TiledArray/permutation.h>
 #include <TiledArray/math/gemm_helper.h>
 #include <TiledArray/tile_op/tile_interface.h>
+#include <TiledArray/dist_eval/summa_trace.h>
+#include <algorithm>
 
 namespace TiledArray {
   namespace math {
@@ -36,7 +38,11 @@ namespace TiledArray {
     /// Contract and reduce operation
 
     /// This object uses a tile contraction operation to form a pair reduction
-    /// operation.
+    /// operation. When the scalar type of the result differs from that of the
+    /// arguments (e.g. \c Tensor<float> arguments and a \c Tensor<double>
+    /// result), the argument tiles are converted to the result tile type
+    /// before they are contracted, so the products are evaluated and
+    /// accumulated in the precision of the result.
     template <typename Result, typename Left, typename Right>
     class ContractReduce {
     public:
@@ -48,22 +54,272 @@ namespace TiledArray {
 
     private:
 
+      /// Flag type that is \c std::true_type when the arguments are
+      /// contracted in the precision of the result
+      typedef std::integral_constant<bool,
+          ! (std::is_same<scalar_type,
+                typename TiledArray::detail::scalar_type<Left>::type>::value &&
+             std::is_same<scalar_type,
+                typename TiledArray::detail::scalar_type<Right>::type>::value)>
+          convert_args;
+
       struct Impl {
         Impl(const madness::cblas::CBLAS_TRANSPOSE left_op,
             const madness::cblas::CBLAS_TRANSPOSE right_op, const scalar_type alpha,
             const unsigned int result_rank, const unsigned int left_rank,
-            const unsigned int right_rank, const Permutation& perm = Permutation()) :
-          gemm_helper_(left_op, right_op, result_rank, left_rank, right_rank),
-          alpha_(alpha), perm_(perm)
+            const unsigned int right_rank, const Permutation& perm,
+            const Permutation& left_perm, const Permutation& right_perm,
+            const unsigned int batch_rank) :
+          gemm_helper_(left_op, right_op, result_rank, left_rank, right_rank,
+              batch_rank),
+          trans_gemm_helper_(transpose(right_op), transpose(left_op),
+              result_rank, right_rank, left_rank, batch_rank),
+          alpha_(alpha), perm_(perm),
+          trans_result_((batch_rank == 0u) && is_outer_swap(perm,
+              left_rank - gemm_helper_.num_contract_ranks())),
+          left_perm_(left_perm), right_perm_(right_perm)
         { }
 
+        /// Transpose a BLAS matrix operation
+
+        /// \param op The matrix operation
+        /// \return The matrix operation of the transposed matrix
+        static madness::cblas::CBLAS_TRANSPOSE
+        transpose(const madness::cblas::CBLAS_TRANSPOSE op) {
+          return (op == madness::cblas::NoTrans ? madness::cblas::Trans :
+              madness::cblas::NoTrans);
+        }
+
+        /// Check for a permutation that swaps the outer dimensions
+
+        /// \param perm The result permutation
+        /// \param left_outer_rank The number of left-hand outer dimensions
+        /// \return \c true if \c perm moves the left-hand outer dimensions of
+        /// the result after the right-hand outer dimensions, without changing
+        /// the order within each group, otherwise \c false
+        static bool is_outer_swap(const Permutation& perm,
+            const unsigned int left_outer_rank)
+        {
+          if(! perm)
+            return false;
+          const unsigned int right_outer_rank = perm.dim() - left_outer_rank;
+          for(unsigned int i = 0u; i < left_outer_rank; ++i)
+            if(perm[i] != (right_outer_rank + i))
+              return false;
+          for(unsigned int i = left_outer_rank; i < perm.dim(); ++i)
+            if(perm[i] != (i - left_outer_rank))
+              return false;
+          return true;
+        }
+
         GemmHelper gemm_helper_; ///< Gemm helper object
+        GemmHelper trans_gemm_helper_; ///< Gemm helper object for the transposed contraction
         scalar_type alpha_; ///< Scaling factor applied to the contraction of the left- and right-hand arguments
         Permutation perm_; ///< Permutation that is applied to the final result tensor
+        bool trans_result_; ///< If true, \c perm_ is applied by contracting the transposed arguments
+        Permutation left_perm_; ///< Permutation that takes left-hand tiles to matrix form
+        Permutation right_perm_; ///< Permutation that takes right-hand tiles to matrix form
       };
 
       std::shared_ptr<Impl> pimpl_;
 
+      /// Contract a pair of tiles in matrix form and add to a target tile
+
+      /// \param[in,out] result The result object that will be the reduction target
+      /// \param[in] left The left-hand tile to be contracted
+      /// \param[in] right The right-hand tile to be contracted
+      template <typename R, typename L, typename T>
+      void gemm_matrix(R& result, const L& left, const T& right) const {
+        using TiledArray::empty;
+        using TiledArray::gemm;
+        if(pimpl_->trans_result_) {
+          // Compute the permuted result directly, (A B)^T = B^T A^T
+          if(empty(result))
+            result = gemm(right, left, pimpl_->alpha_, pimpl_->trans_gemm_helper_);
+          else
+            gemm(result, right, left, pimpl_->alpha_, pimpl_->trans_gemm_helper_);
+        } else {
+          if(empty(result))
+            result = gemm(left, right, pimpl_->alpha_, pimpl_->gemm_helper_);
+          else
+            gemm(result, left, right, pimpl_->alpha_, pimpl_->gemm_helper_);
+        }
+      }
+
+      /// Contract a pair of tiles in their native layout
+
+      /// This overload is selected when the tile type supports contractions
+      /// of arguments that are not in matrix form.
+      template <typename R>
+      auto gemm_native(R& result, first_argument_type left,
+          second_argument_type right, int) const ->
+          decltype(gemm(result, left, right, pimpl_->alpha_,
+              pimpl_->gemm_helper_, pimpl_->left_perm_, pimpl_->right_perm_), void())
+      {
+        if(pimpl_->trans_result_) {
+          if(empty(result))
+            result = gemm(right, left, pimpl_->alpha_, pimpl_->trans_gemm_helper_,
+                pimpl_->right_perm_, pimpl_->left_perm_);
+          else
+            gemm(result, right, left, pimpl_->alpha_, pimpl_->trans_gemm_helper_,
+                pimpl_->right_perm_, pimpl_->left_perm_);
+        } else {
+          if(empty(result))
+            result = gemm(left, right, pimpl_->alpha_, pimpl_->gemm_helper_,
+                pimpl_->left_perm_, pimpl_->right_perm_);
+          else
+            gemm(result, left, right, pimpl_->alpha_, pimpl_->gemm_helper_,
+                pimpl_->left_perm_, pimpl_->right_perm_);
+        }
+      }
+
+      /// Permute a pair of tiles to matrix form and contract them
+
+      /// This overload is selected when the tile type does not support
+      /// contractions of arguments that are not in matrix form.
+      template <typename R>
+      void gemm_native(R& result, first_argument_type left,
+          second_argument_type right, long) const
+      {
+        using TiledArray::permute;
+        if(pimpl_->left_perm_ && pimpl_->right_perm_)
+          gemm_matrix(result, permute(left, pimpl_->left_perm_),
+              permute(right, pimpl_->right_perm_));
+        else if(pimpl_->left_perm_)
+          gemm_matrix(result, permute(left, pimpl_->left_perm_), right);
+        else
+          gemm_matrix(result, left, permute(right, pimpl_->right_perm_));
+      }
+
+      /// Contract two pairs of tiles with a single, K-fused contraction
+
+      /// This overload is selected when the tile type supports the packed
+      /// \c gemm interface.
+      template <typename R>
+      auto gemm_pairs(R& result, first_argument_type left1,
+          second_argument_type right1, first_argument_type left2,
+          second_argument_type right2, int) const ->
+          decltype(gemm(result, left1, right1, left2, right2,
+              pimpl_->alpha_, pimpl_->gemm_helper_), void())
+      {
+        if(pimpl_->left_perm_ || pimpl_->right_perm_) {
+          // Arguments in their native layout cannot be packed
+          gemm_native(result, left1, right1, 0);
+          gemm_native(result, left2, right2, 0);
+        } else if(pimpl_->gemm_helper_.batch_rank()) {
+          // Arguments with batch dimensions cannot be packed
+          gemm_matrix(result, left1, right1);
+          gemm_matrix(result, left2, right2);
+        } else if(pimpl_->trans_result_) {
+          if(empty(result))
+            result = gemm(right1, left1, right2, left2, pimpl_->alpha_,
+                pimpl_->trans_gemm_helper_);
+          else
+            gemm(result, right1, left1, right2, left2, pimpl_->alpha_,
+                pimpl_->trans_gemm_helper_);
+        } else {
+          if(empty(result))
+            result = gemm(left1, right1, left2, right2, pimpl_->alpha_,
+                pimpl_->gemm_helper_);
+          else
+            gemm(result, left1, right1, left2, right2, pimpl_->alpha_,
+                pimpl_->gemm_helper_);
+        }
+      }
+
+      /// Contract two pairs of tiles, one pair at a time
+
+      /// This overload is selected when the tile type does not support the
+      /// packed \c gemm interface.
+      template <typename R>
+      void gemm_pairs(R& result, first_argument_type left1,
+          second_argument_type right1, first_argument_type left2,
+          second_argument_type right2, long) const
+      {
+        ContractReduce_::operator()(result, left1, right1);
+        ContractReduce_::operator()(result, left2, right2);
+      }
+
+      /// Convert an argument tile to the result tile type
+
+      /// \tparam Arg The argument tile type
+      /// \param arg The argument tile
+      /// \param perm The permutation that takes \c arg to matrix form
+      /// \return A copy of \c arg in the precision of the result
+      template <typename Arg>
+      static result_type convert(const Arg& arg, const Permutation& perm) {
+        return (perm ? result_type(arg, perm) : result_type(arg));
+      }
+
+      /// Contract a pair of tiles in the precision of the arguments
+
+      /// \param[in,out] result The result object that will be the reduction target
+      /// \param[in] left The left-hand tile to be contracted
+      /// \param[in] right The right-hand tile to be contracted
+      void gemm_pair(result_type& result, first_argument_type left,
+          second_argument_type right, std::false_type) const
+      {
+        if(pimpl_->left_perm_ || pimpl_->right_perm_)
+          gemm_native(result, left, right, 0);
+        else
+          gemm_matrix(result, left, right);
+      }
+
+      /// Contract a pair of tiles in the precision of the result
+
+      /// The arguments are converted to the result tile type, which also
+      /// takes arguments in their native layout to matrix form.
+      /// \param[in,out] result The result object that will be the reduction target
+      /// \param[in] left The left-hand tile to be contracted
+      /// \param[in] right The right-hand tile to be contracted
+      void gemm_pair(result_type& result, first_argument_type left,
+          second_argument_type right, std::true_type) const
+      {
+        gemm_matrix(result, convert(left, pimpl_->left_perm_),
+            convert(right, pimpl_->right_perm_));
+      }
+
+      /// Set the elements of a result tile to zero
+
+      /// This overload is selected for tiles with a contiguous array of
+      /// numeric elements, where the storage of the tile is kept.
+      /// \param[in,out] result The result tile
+      template <typename R>
+      static auto reset_tile(R& result, int) ->
+          typename std::enable_if<TiledArray::detail::is_numeric<
+              typename std::remove_reference<decltype(* result.data())>::type>::value,
+              decltype(result.size(), void())>::type
+      {
+        typedef typename std::remove_reference<decltype(* result.data())>::type value_type;
+        std::fill_n(result.data(), result.size(), value_type(0));
+      }
+
+      /// Replace a result tile with an empty tile
+
+      /// \param[in,out] result The result tile
+      template <typename R>
+      static void reset_tile(R& result, long) { result = R(); }
+
+      /// Contract two pairs of tiles in the precision of the arguments
+      void gemm_pairs(result_type& result, first_argument_type left1,
+          second_argument_type right1, first_argument_type left2,
+          second_argument_type right2, std::false_type) const
+      {
+        gemm_pairs(result, left1, right1, left2, right2, 0);
+      }
+
+      /// Contract two pairs of tiles in the precision of the result
+
+      /// Converted arguments are not packed, since the packed copy would
+      /// need the same storage as the converted tiles.
+      void gemm_pairs(result_type& result, first_argument_type left1,
+          second_argument_type right1, first_argument_type left2,
+          second_argument_type right2, std::true_type) const
+      {
+        gemm_pair(result, left1, right1, std::true_type());
+        gemm_pair(result, left2, right2, std::true_type());
+      }
+
     public:
 
       /// Default constructor
@@ -79,11 +335,24 @@ namespace TiledArray {
       /// \param right_rank The rank of the right-hand tensor
       /// \param perm The permutation to be applied to the result tensor
       /// (default = no permute)
+      /// \param left_perm The permutation that takes left-hand tiles to the
+      /// layout defined by \c left_op, if the tiles are contracted in their
+      /// native layout (default = no permute)
+      /// \param right_perm The permutation that takes right-hand tiles to the
+      /// layout defined by \c right_op, if the tiles are contracted in their
+      /// native layout (default = no permute)
+      /// \param batch_rank The number of leading dimensions that are shared
+      /// by the arguments and the result, which are not contracted
+      /// (default = 0)
       ContractReduce(const madness::cblas::CBLAS_TRANSPOSE left_op,
           const madness::cblas::CBLAS_TRANSPOSE right_op, const scalar_type alpha,
           const unsigned int result_rank, const unsigned int left_rank,
-          const unsigned int right_rank, const Permutation& perm = Permutation()) :
-        pimpl_(new Impl(left_op, right_op, alpha, result_rank, left_rank, right_rank, perm))
+          const unsigned int right_rank, const Permutation& perm = Permutation(),
+          const Permutation& left_perm = Permutation(),
+          const Permutation& right_perm = Permutation(),
+          const unsigned int batch_rank = 0u) :
+        pimpl_(new Impl(left_op, right_op, alpha, result_rank, left_rank,
+            right_rank, perm, left_perm, right_perm, batch_rank))
       { }
 
       /// Functor copy constructor
@@ -158,13 +427,26 @@ namespace TiledArray {
         return result_type();
       }
 
+      /// Reset a result object for reuse
+
+      /// The elements of \c result are set to zero, so the storage of a
+      /// result tile that was already reduced can be reused as the target of
+      /// another reduction.
+      /// \param[in,out] result The result object that will be reset
+      void reset(result_type& result) const { reset_tile(result, 0); }
+
       /// Post processing step
+
+      /// The result permutation is applied to \c temp, unless the permutation
+      /// only swaps the left- and right-hand outer dimensions. In that case,
+      /// the transposed contraction is evaluated, so \c temp is already in
+      /// the permuted layout.
       result_type operator()(const result_type& temp) const {
         TA_ASSERT(pimpl_);
         using TiledArray::empty;
         TA_ASSERT(! empty(temp));
 
-        if(! pimpl_->perm_)
+        if(! pimpl_->perm_ || pimpl_->trans_result_)
           return temp;
 
         using TiledArray::permute;
@@ -191,13 +473,29 @@ namespace TiledArray {
           second_argument_type right) const
       {
         TA_ASSERT(pimpl_);
+        TiledArray::detail::SummaTraceScope trace("gemm", "pairs", 1);
 
-        using TiledArray::empty;
-        using TiledArray::gemm;
-        if(empty(result))
-          result = gemm(left, right, pimpl_->alpha_, pimpl_->gemm_helper_);
-        else
-          gemm(result, left, right, pimpl_->alpha_, pimpl_->gemm_helper_);
+        gemm_pair(result, left, right, convert_args());
+      }
+
+      /// Contract two pairs of tiles and add to a target tile
+
+      /// The pairs are packed along the contracted dimension so that both
+      /// contractions are evaluated with a single *GEMM, which reduces the
+      /// number of passes over \c result for fine-grained inner tilings.
+      /// \param[in,out] result The result object that will be the reduction target
+      /// \param[in] left1 The first left-hand tile to be contracted
+      /// \param[in] right1 The first right-hand tile to be contracted
+      /// \param[in] left2 The second left-hand tile to be contracted
+      /// \param[in] right2 The second right-hand tile to be contracted
+      void operator()(result_type& result, first_argument_type left1,
+          second_argument_type right1, first_argument_type left2,
+          second_argument_type right2) const
+      {
+        TA_ASSERT(pimpl_);
+        TiledArray::detail::SummaTraceScope trace("gemm", "pairs", 2);
+
+        gemm_pairs(result, left1, right1, left2, right2, convert_args());
       }
 
     }; // class ContractReduce
@@ -780,6 +780,104 @@ namespace TiledArray {
     return result.gemm(left, right, factor, gemm_config);
   }
 
+  /// Contract and scale two pairs of tile arguments
+
+  /// The two contractions are done via a single GEMM operation, where the
+  /// inner dimensions of the argument pairs are packed together, with fused
+  /// indices as defined by \c gemm_config.
+  /// \tparam Left The left-hand tile type
+  /// \tparam Right The right-hand tile type
+  /// \tparam Scalar A scalar type
+  /// \param left1 The first left-hand argument to be contracted
+  /// \param right1 The first right-hand argument to be contracted
+  /// \param left2 The second left-hand argument to be contracted
+  /// \param right2 The second right-hand argument to be contracted
+  /// \param factor The scaling factor
+  /// \param gemm_config A helper object used to simplify gemm operations
+  /// \return A tile that is equal to
+  /// <tt>(left1 * right1 + left2 * right2) * factor</tt>
+  template <typename Left, typename Right, typename Scalar,
+      typename std::enable_if<TiledArray::detail::is_numeric<Scalar>::value>::type* = nullptr>
+  inline auto gemm(const Left& left1, const Right& right1, const Left& left2,
+      const Right& right2, const Scalar factor,
+      const math::GemmHelper& gemm_config) ->
+      decltype(left1.gemm(right1, left2, right2, factor, gemm_config))
+  { return left1.gemm(right1, left2, right2, factor, gemm_config); }
+
+  /// Contract and scale two pairs of tile arguments to the result tile
+
+  /// The two contractions are done via a single GEMM operation, where the
+  /// inner dimensions of the argument pairs are packed together, with fused
+  /// indices as defined by \c gemm_config.
+  /// \tparam Result The result tile type
+  /// \tparam Left The left-hand tile type
+  /// \tparam Right The right-hand tile type
+  /// \tparam Scalar A scalar type
+  /// \param result The contracted result
+  /// \param left1 The first left-hand argument to be contracted
+  /// \param right1 The first right-hand argument to be contracted
+  /// \param left2 The second left-hand argument to be contracted
+  /// \param right2 The second right-hand argument to be contracted
+  /// \param factor The scaling factor
+  /// \param gemm_config A helper object used to simplify gemm operations
+  /// \return A tile that is equal to
+  /// <tt>result += (left1 * right1 + left2 * right2) * factor</tt>
+  template <typename Result, typename Left, typename Right, typename Scalar,
+      typename std::enable_if<TiledArray::detail::is_numeric<Scalar>::value>::type* = nullptr>
+  inline auto gemm(Result& result, const Left& left1, const Right& right1,
+      const Left& left2, const Right& right2, const Scalar factor,
+      const math::GemmHelper& gemm_config) ->
+      decltype(result.gemm(left1, right1, left2, right2, factor, gemm_config))
+  { return result.gemm(left1, right1, left2, right2, factor, gemm_config); }
+
+  /// Contract and scale tile arguments that are not in matrix form
+
+  /// The contraction is done as defined by \c gemm_config for the arguments
+  /// permuted to matrix form, but the arguments are not permuted.
+  /// \tparam Left The left-hand tile type
+  /// \tparam Right The right-hand tile type
+  /// \tparam Scalar A scalar type
+  /// \param left The left-hand argument to be contracted
+  /// \param right The right-hand argument to be contracted
+  /// \param factor The scaling factor
+  /// \param gemm_config A helper object used to simplify gemm operations
+  /// \param left_perm The permutation that takes \c left to matrix form
+  /// \param right_perm The permutation that takes \c right to matrix form
+  /// \return A tile that is equal to
+  /// <tt>(left_perm ^ left * right_perm ^ right) * factor</tt>
+  template <typename Left, typename Right, typename Scalar,
+      typename std::enable_if<TiledArray::detail::is_numeric<Scalar>::value>::type* = nullptr>
+  inline auto gemm(const Left& left, const Right& right, const Scalar factor,
+      const math::GemmHelper& gemm_config, const Permutation& left_perm,
+      const Permutation& right_perm) ->
+      decltype(left.gemm(right, factor, gemm_config, left_perm, right_perm))
+  { return left.gemm(right, factor, gemm_config, left_perm, right_perm); }
+
+  /// Contract and scale tile arguments that are not in matrix form to the result tile
+
+  /// The contraction is done as defined by \c gemm_config for the arguments
+  /// permuted to matrix form, but the arguments are not permuted.
+  /// \tparam Result The result tile type
+  /// \tparam Left The left-hand tile type
+  /// \tparam Right The right-hand tile type
+  /// \tparam Scalar A scalar type
+  /// \param result The contracted result
+  /// \param left The left-hand argument to be contracted
+  /// \param right The right-hand argument to be contracted
+  /// \param factor The scaling factor
+  /// \param gemm_config A helper object used to simplify gemm operations
+  /// \param left_perm The permutation that takes \c left to matrix form
+  /// \param right_perm The permutation that takes \c right to matrix form
+  /// \return A tile that is equal to
+  /// <tt>result += (left_perm ^ left * right_perm ^ right) * factor</tt>
+  template <typename Result, typename Left, typename Right, typename Scalar,
+      typename std::enable_if<TiledArray::detail::is_numeric<Scalar>::value>::type* = nullptr>
+  inline auto gemm(Result& result, const Left& left, const Right& right,
+      const Scalar factor, const math::GemmHelper& gemm_config,
+      const Permutation& left_perm, const Permutation& right_perm) ->
+      decltype(result.gemm(left, right, factor, gemm_config, left_perm, right_perm))
+  { return result.gemm(left, right, factor, gemm_config, left_perm, right_perm); }
+
 
   // Reduction operations ------------------------------------------------------
 
@@ -22,6 +22,9 @@
 
 #include <TiledArray/madness.h>
 
+// Runtime parameters
+#include <TiledArray/runtime_config.h>
+
 // Array class
 #include <TiledArray/array.h>
 
@@ -20,6 +20,8 @@
 #ifndef TILEDARRAY_FWD_H__INCLUDED
 #define TILEDARRAY_FWD_H__INCLUDED
 
+#include <TiledArray/config.h>
+
 namespace Eigen { // Eigen Alligned allocator for TA::Tensor
   template<class>
   class aligned_allocator;
@@ -31,14 +33,36 @@ namespace TiledArray {
   class DensePolicy;
   class SparsePolicy;
 
+  // TiledArray Allocators
+  template <typename>
+  class PoolAllocator;
+
+  namespace detail {
+
+    /// Default allocator of tensor elements
+
+    /// The default is \c PoolAllocator when TiledArray is configured with
+    /// \c ENABLE_POOL_ALLOCATOR , otherwise \c Eigen::aligned_allocator .
+    /// \tparam T The element type
+    template <typename T>
+    struct default_allocator {
+#ifdef TILEDARRAY_DEFAULT_POOL_ALLOCATOR
+      typedef PoolAllocator<T> type;
+#else
+      typedef Eigen::aligned_allocator<T> type;
+#endif // TILEDARRAY_DEFAULT_POOL_ALLOCATOR
+    }; // struct default_allocator
+
+  } // namespace detail
+
   // TiledArray Tensors
   template<typename, typename>
   class Tensor;
 
-  typedef Tensor<double, Eigen::aligned_allocator<double> > TensorD;
-  typedef Tensor<int, Eigen::aligned_allocator<int> > TensorI;
-  typedef Tensor<float, Eigen::aligned_allocator<float> > TensorF;
-  typedef Tensor<long, Eigen::aligned_allocator<long> > TensorL;
+  typedef Tensor<double, detail::default_allocator<double>::type> TensorD;
+  typedef Tensor<int, detail::default_allocator<int>::type> TensorI;
+  typedef Tensor<float, detail::default_allocator<float>::type> TensorF;
+  typedef Tensor<long, detail::default_allocator<long>::type> TensorL;
 
   // TiledArray Arrays
   template<typename, unsigned int, typename, typename>
@@ -0,0 +1,165 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/pmap/batch_pmap.h"
+#include "TiledArray/pmap/cyclic_pmap.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct BatchPmapFixture {
+
+  BatchPmapFixture() { }
+
+  // Construct a cyclic process map for a slice
+  static std::shared_ptr<Pmap> make_slice_pmap(const std::size_t x, const std::size_t y) {
+    const std::size_t nprocs = GlobalFixture::world->size();
+    const std::size_t p_rows = std::max<std::size_t>(1ul, std::min(nprocs, x));
+    const std::size_t p_cols = std::max<std::size_t>(1ul, std::min(nprocs / p_rows, y));
+    return std::make_shared<detail::CyclicPmap>(* GlobalFixture::world, x, y,
+        p_rows, p_cols);
+  }
+
+};
+
+
+// =============================================================================
+// BatchPmap Test Suite
+
+
+BOOST_FIXTURE_TEST_SUITE( batch_pmap_suite, BatchPmapFixture )
+
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  for(std::size_t batches = 1ul; batches < 5ul; ++batches) {
+    for(std::size_t x = 1ul; x < 6ul; ++x) {
+      for(std::size_t y = 1ul; y < 6ul; ++y) {
+        std::shared_ptr<Pmap> slice_pmap = make_slice_pmap(x, y);
+
+        BOOST_REQUIRE_NO_THROW(detail::BatchPmap pmap(* GlobalFixture::world,
+            batches, slice_pmap));
+        detail::BatchPmap pmap(* GlobalFixture::world, batches, slice_pmap);
+        BOOST_CHECK_EQUAL(pmap.rank(), GlobalFixture::world->rank());
+        BOOST_CHECK_EQUAL(pmap.procs(), GlobalFixture::world->size());
+        BOOST_CHECK_EQUAL(pmap.size(), batches * x * y);
+        BOOST_CHECK_EQUAL(pmap.local_size(), batches * slice_pmap->local_size());
+        BOOST_CHECK_EQUAL(pmap.slice_pmap(), slice_pmap);
+      }
+    }
+  }
+
+#ifdef TA_EXCEPTION_ERROR
+  BOOST_CHECK_THROW(detail::BatchPmap pmap(* GlobalFixture::world, 0ul,
+      make_slice_pmap(2ul, 2ul)), TiledArray::Exception);
+#endif // TA_EXCEPTION_ERROR
+}
+
+BOOST_AUTO_TEST_CASE( owner )
+{
+  for(std::size_t batches = 1ul; batches < 5ul; ++batches) {
+    for(std::size_t x = 1ul; x < 6ul; ++x) {
+      for(std::size_t y = 1ul; y < 6ul; ++y) {
+        std::shared_ptr<Pmap> slice_pmap = make_slice_pmap(x, y);
+        detail::BatchPmap pmap(* GlobalFixture::world, batches, slice_pmap);
+
+        // Check that each slice is distributed with the slice process map
+        for(std::size_t b = 0ul; b < batches; ++b) {
+          for(std::size_t tile = 0ul; tile < x * y; ++tile) {
+            BOOST_CHECK_EQUAL(pmap.owner(b * x * y + tile), slice_pmap->owner(tile));
+            BOOST_CHECK_EQUAL(pmap.is_local(b * x * y + tile), slice_pmap->is_local(tile));
+          }
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( local_group )
+{
+  ProcessID tile_owners[100];
+
+  for(std::size_t batches = 1ul; batches < 5ul; ++batches) {
+    for(std::size_t x = 1ul; x < 6ul; ++x) {
+      for(std::size_t y = 1ul; y < 6ul; ++y) {
+        const std::size_t tiles = batches * x * y;
+        detail::BatchPmap pmap(* GlobalFixture::world, batches, make_slice_pmap(x, y));
+
+        // Check that all local elements map to this rank
+        for(detail::BatchPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it) {
+          BOOST_CHECK_EQUAL(pmap.owner(*it), GlobalFixture::world->rank());
+        }
+
+        // Check that the local tiles of all processes cover all tiles
+        std::size_t total_size = pmap.local_size();
+        GlobalFixture::world->gop.sum(total_size);
+        BOOST_CHECK_EQUAL(total_size, tiles);
+
+        std::fill_n(tile_owners, tiles, 0);
+        for(detail::BatchPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it) {
+          tile_owners[*it] += GlobalFixture::world->rank();
+        }
+
+        GlobalFixture::world->gop.sum(tile_owners, tiles);
+        for(std::size_t tile = 0; tile < tiles; ++tile) {
+          BOOST_CHECK_EQUAL(tile_owners[tile], pmap.owner(tile));
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( stride )
+{
+  const std::size_t nprocs = GlobalFixture::world->size();
+  ProcessID tile_owners[100];
+
+  for(std::size_t stride = 1ul; stride < 4ul; ++stride) {
+    for(std::size_t batches = 1ul; batches < 5ul; ++batches) {
+      const std::size_t x = 2ul, y = 3ul;
+      const std::size_t tiles = batches * x * y;
+      std::shared_ptr<Pmap> slice_pmap = make_slice_pmap(x, y);
+      detail::BatchPmap pmap(* GlobalFixture::world, batches, slice_pmap, stride);
+
+      // Check that the processes of each slice are shifted by the stride
+      for(std::size_t b = 0ul; b < batches; ++b) {
+        for(std::size_t tile = 0ul; tile < x * y; ++tile) {
+          const std::size_t owner = (slice_pmap->owner(tile) + b * stride) % nprocs;
+          BOOST_CHECK_EQUAL(pmap.owner(b * x * y + tile), owner);
+          BOOST_CHECK_EQUAL(pmap.is_local(b * x * y + tile),
+              owner == std::size_t(GlobalFixture::world->rank()));
+        }
+      }
+
+      // Check that the local tiles of all processes cover all tiles
+      std::fill_n(tile_owners, tiles, 0);
+      for(detail::BatchPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it) {
+        BOOST_CHECK_EQUAL(pmap.owner(*it), GlobalFixture::world->rank());
+        tile_owners[*it] += GlobalFixture::world->rank() + 1;
+      }
+
+      GlobalFixture::world->gop.sum(tile_owners, tiles);
+      for(std::size_t tile = 0; tile < tiles; ++tile) {
+        BOOST_CHECK_EQUAL(tile_owners[tile], pmap.owner(tile) + 1);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,105 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/dist_eval/compressed_tile.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct CompressedTileFixture {
+
+  CompressedTileFixture() :
+    r(11ul, 13ul)
+  { }
+
+  // Construct a tile where element i is the value of op(i)
+  template <typename T, typename Op>
+  Tensor<T> make_tile(const Op& op) const {
+    Tensor<T> tile(r);
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      tile[i] = op(i);
+    return tile;
+  }
+
+  Range r;
+};
+
+BOOST_FIXTURE_TEST_SUITE( compressed_tile_suite, CompressedTileFixture )
+
+BOOST_AUTO_TEST_CASE( empty )
+{
+  detail::CompressedTile<Tensor<double> > compressed(Tensor<double>(), 0.0);
+  BOOST_CHECK_EQUAL(compressed.size(), 0ul);
+  BOOST_CHECK(compressed.decompress().empty());
+}
+
+BOOST_AUTO_TEST_CASE( lossless_int )
+{
+  // Small integers have three zero bytes, which are encoded as runs
+  const Tensor<int> tile = make_tile<int>([] (const std::size_t i) { return int(i % 7ul); });
+
+  detail::CompressedTile<Tensor<int> > compressed(tile, 0.0);
+  BOOST_CHECK_EQUAL(compressed.width(), sizeof(int));
+  BOOST_CHECK_LT(compressed.size(), tile.size() * sizeof(int));
+
+  const Tensor<int> result = compressed.decompress();
+  BOOST_CHECK_EQUAL(result.range(), tile.range());
+  for(std::size_t i = 0ul; i < tile.size(); ++i)
+    BOOST_CHECK_EQUAL(result[i], tile[i]);
+}
+
+BOOST_AUTO_TEST_CASE( lossless_double )
+{
+  const Tensor<double> tile = make_tile<double>(
+      [] (const std::size_t i) { return std::sin(double(i)) * 1.0e3; });
+
+  // A tolerance of zero must not truncate the elements
+  detail::CompressedTile<Tensor<double> > compressed(tile, 0.0);
+  BOOST_CHECK_EQUAL(compressed.width(), sizeof(double));
+  BOOST_CHECK_LE(compressed.size(), tile.size() * sizeof(double));
+
+  const Tensor<double> result = compressed.decompress();
+  BOOST_CHECK_EQUAL(result.range(), tile.range());
+  for(std::size_t i = 0ul; i < tile.size(); ++i)
+    BOOST_CHECK_EQUAL(result[i], tile[i]);
+}
+
+BOOST_AUTO_TEST_CASE( lossy_double )
+{
+  const Tensor<double> tile = make_tile<double>(
+      [] (const std::size_t i) { return std::sin(double(i)); });
+
+  for(const double tolerance : { 1.0e-2, 1.0e-6 }) {
+    detail::CompressedTile<Tensor<double> > compressed(tile, tolerance);
+    BOOST_CHECK_EQUAL(compressed.width(), (tolerance > 1.0e-3 ? 2u : 4u));
+    BOOST_CHECK_LT(compressed.size(), tile.size() * sizeof(double));
+
+    // Check that the truncation error is within the tolerance
+    const Tensor<double> result = compressed.decompress();
+    BOOST_CHECK_EQUAL(result.range(), tile.range());
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_LE(std::abs(result[i] - tile[i]), tolerance);
+  }
+
+  // Check that large elements are not truncated
+  detail::CompressedTile<Tensor<double> > compressed(tile * 1.0e10, 1.0e-6);
+  BOOST_CHECK_EQUAL(compressed.width(), sizeof(double));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -223,6 +223,53 @@ struct ContractionEvalFixture : public SparseShapeFixture {
         (perm ? perm * array.trange() : array.trange()), shape, pmap, perm, op)));
   }
 
+  /// Reference contraction
+
+  /// \param left The left-hand argument
+  /// \param right The right-hand argument
+  /// \return The contraction of \c left and \c right, computed with Eigen
+  template <typename A>
+  static matrix_type make_reference(const A& left, const A& right) {
+    const matrix_type l = copy_to_matrix(left, 1), r = copy_to_matrix(right, GlobalFixture::dim - 1);
+    return l * r;
+  }
+
+  /// Check the local tiles of a contraction against a reference
+
+  /// Zero tiles of \c contract are skipped.
+  /// \param contract The evaluated contraction
+  /// \param reference The reference contraction matrix
+  template <typename Tile, typename Policy>
+  static void check_contraction(const TiledArray::detail::DistEval<Tile, Policy>& contract,
+      const matrix_type& reference)
+  {
+    typedef TiledArray::detail::DistEval<Tile, Policy> dist_eval_type;
+
+    typename dist_eval_type::pmap_interface::const_iterator it = contract.pmap()->begin();
+    const typename dist_eval_type::pmap_interface::const_iterator end = contract.pmap()->end();
+
+    for(; it != end; ++it) {
+      if(contract.is_zero(*it))
+        continue;
+
+      // Get the array evaluator tile.
+      Future<typename dist_eval_type::value_type> tile;
+      BOOST_REQUIRE_NO_THROW(tile = contract.get(*it));
+
+      // Force the evaluation of the tile
+      typename dist_eval_type::eval_type eval_tile;
+      BOOST_REQUIRE_NO_THROW(eval_tile = tile.get());
+      BOOST_CHECK(! eval_tile.empty());
+
+      if(!eval_tile.empty()) {
+        // Check that the result tile is correctly modified.
+        BOOST_CHECK_EQUAL(eval_tile.range(), contract.trange().make_tile_range(*it));
+        BOOST_CHECK(eigen_map(eval_tile) == reference.block(eval_tile.range().lobound_data()[0],
+            eval_tile.range().lobound_data()[1], eval_tile.range().extent_data()[0], eval_tile.range().extent_data()[1]));
+      }
+    }
+  }
+
   ArrayN left;
   ArrayN right;
   detail::ProcGrid proc_grid;
@@ -301,6 +348,44 @@ BOOST_AUTO_TEST_CASE( eval )
 }
 
 
+BOOST_AUTO_TEST_CASE( trace_eval )
+{
+  typedef detail::DistEval<op_type::result_type, DensePolicy> dist_eval_type1;
+
+  SummaTrace::clear();
+  SummaTrace::enable();
+
+  dist_eval_type1 contract = make_contract_eval(left_arg, right_arg,
+      left_arg.get_world(), DenseShape(), pmap, Permutation(), op);
+
+  BOOST_REQUIRE_NO_THROW(contract.eval());
+  BOOST_REQUIRE_NO_THROW(contract.wait());
+
+  // Wait for the SUMMA tasks to finish
+  GlobalFixture::world->gop.fence();
+
+  SummaTrace::enable(false);
+
+  // Check that events were recorded for the local part of the contraction
+  if(contract.pmap()->local_size() > 0ul) {
+    BOOST_CHECK(SummaTrace::size() > 0ul);
+
+    std::stringstream ss;
+    BOOST_REQUIRE_NO_THROW(SummaTrace::write(ss, GlobalFixture::world->rank()));
+    const std::string trace = ss.str();
+    BOOST_CHECK_EQUAL(trace.find("{\"traceEvents\":["), 0ul);
+    BOOST_CHECK(trace.find("\"name\":\"step\"") != std::string::npos);
+    BOOST_CHECK(trace.find("\"name\":\"gemm\"") != std::string::npos);
+    BOOST_CHECK(trace.find("\"name\":\"finalize\"") != std::string::npos);
+  }
+
+  // Check that no events are recorded when disabled
+  SummaTrace::clear();
+  BOOST_CHECK_EQUAL(SummaTrace::size(), 0ul);
+  SummaTrace::instant("bcast_post", "tile", 0);
+  BOOST_CHECK_EQUAL(SummaTrace::size(), 0ul);
+}
+
 BOOST_AUTO_TEST_CASE( perm_eval )
 {
   typedef detail::DistEval<op_type::result_type, DensePolicy> dist_eval_type1;
@@ -344,6 +429,69 @@ BOOST_AUTO_TEST_CASE( perm_eval )
 
 }
 
+BOOST_AUTO_TEST_CASE( mem_bound_eval )
+{
+  typedef detail::DistEval<op_type::result_type, DensePolicy> dist_eval_type1;
+
+  // Find the largest number of argument elements used by a SUMMA iteration
+  const std::size_t M = tr.tiles().extent_data()[0];
+  const std::size_t N = tr.tiles().extent_data()[tr.tiles().rank() - 1u];
+  const std::size_t K = tr.tiles().volume() / M;
+  std::size_t max_step = 0ul;
+  for(std::size_t k = 0ul; k < K; ++k) {
+    std::size_t step = 0ul;
+    for(std::size_t i = 0ul; i < M; ++i)
+      step += tr.make_tile_range(i * K + k).volume();
+    for(std::size_t j = 0ul; j < N; ++j)
+      step += tr.make_tile_range(k * N + j).volume();
+    max_step = std::max(max_step, step);
+  }
+
+  // Limit the memory to the result plus two SUMMA iterations
+  const std::size_t memory_limit = sizeof(int) * (result_tr.elements().volume()
+      + 2ul * max_step);
+  SummaConfig::set_memory_limit(memory_limit);
+  BOOST_CHECK_EQUAL(SummaConfig::memory_limit(), memory_limit);
+
+  dist_eval_type1 contract = make_contract_eval(left_arg, right_arg,
+      left_arg.get_world(), DenseShape(), pmap, Permutation(), op);
+
+  // Check evaluation
+  BOOST_REQUIRE_NO_THROW(contract.eval());
+  BOOST_REQUIRE_NO_THROW(contract.wait());
+
+  SummaConfig::set_memory_limit(0ul);
+
+  check_contraction(contract, make_reference(left, right));
+
+}
+
+BOOST_AUTO_TEST_CASE( compressed_eval )
+{
+  typedef detail::DistEval<op_type::result_type, DensePolicy> dist_eval_type1;
+
+  SummaConfig::set_bcast_compression(SummaConfig::lossless);
+  BOOST_CHECK_EQUAL(SummaConfig::bcast_compression(), SummaConfig::lossless);
+  SummaConfig::reset_bcast_bytes();
+
+  dist_eval_type1 contract = make_contract_eval(left_arg, right_arg,
+      left_arg.get_world(), DenseShape(), pmap, Permutation(), op);
+
+  // Check evaluation
+  BOOST_REQUIRE_NO_THROW(contract.eval());
+  BOOST_REQUIRE_NO_THROW(contract.wait());
+
+  SummaConfig::set_bcast_compression(SummaConfig::uncompressed);
+
+  // Check that compression does not increase the broadcast size
+  BOOST_CHECK_LE(SummaConfig::bcast_compressed_bytes(), SummaConfig::bcast_bytes());
+
+  // Check that lossless compression gives the exact result
+  check_contraction(contract, make_reference(left, right));
+
+  SummaConfig::reset_bcast_bytes();
+}
+
 #ifndef TILEDARRAY_ENABLE_OLD_SUMMA
 
 BOOST_AUTO_TEST_CASE( sparse_eval )
@@ -416,6 +564,119 @@ BOOST_AUTO_TEST_CASE( sparse_eval )
 
 }
 
+BOOST_AUTO_TEST_CASE( screened_sparse_eval )
+{
+  typedef detail::DistEval<op_type::result_type, SparsePolicy> dist_eval_type1;
+  typedef Array<int, GlobalFixture::dim, Tensor<int>, SparsePolicy> array_type;
+  typedef detail::DistEval<detail::LazyArrayTile<array_type::value_type, array_op_type>,
+      SparsePolicy> array_eval_type;
+
+  array_type left(*GlobalFixture::world, tr, make_shape(tr, 0.4, 23));
+
+  array_type right(*GlobalFixture::world, tr, make_shape(tr, 0.4, 42));
+
+  // Fill arrays with random data, except every other tile of left is filled
+  // with zeros, which is not reflected in the shape.
+  for(array_type::iterator it = left.begin(); it != left.end(); ++it) {
+    array_type::value_type tile(left.trange().make_tile_range(it.index()), 0);
+    if(left.range().ordinal(it.index()) % 2ul)
+      for(array_type::value_type::iterator tile_it = tile.begin(); tile_it != tile.end(); ++tile_it)
+        *tile_it = GlobalFixture::world->rand() % 27;
+    *it = tile;
+  }
+  rand_fill_array(right);
+
+  array_eval_type left_arg(make_array_eval(left, left.get_world(), left.get_shape(),
+      proc_grid.make_row_phase_pmap(tr.tiles().volume() / tr.tiles().extent_data()[0]),
+      Permutation(), array_op_type()));
+  array_eval_type right_arg(make_array_eval(right, right.get_world(), right.get_shape(),
+      proc_grid.make_col_phase_pmap(tr.tiles().volume() / tr.tiles().extent_data()[tr.tiles().rank() - 1]),
+      Permutation(), array_op_type()));
+
+  const SparseShape<float> result_shape = left_arg.shape().gemm(right_arg.shape(), 1, op.gemm_helper());
+
+  dist_eval_type1 contract = make_contract_eval(left_arg, right_arg,
+      left_arg.get_world(), result_shape, pmap, Permutation(), op);
+
+  SummaConfig::set_screening(true);
+  SummaConfig::reset_skipped_contractions();
+  BOOST_CHECK(SummaConfig::screening());
+
+  // Check evaluation
+  BOOST_REQUIRE_NO_THROW(contract.eval());
+  BOOST_REQUIRE_NO_THROW(contract.wait());
+
+  SummaConfig::set_screening(false);
+
+  // Check that tile contractions with zero tiles were skipped
+  std::size_t skipped = SummaConfig::skipped_contractions();
+  GlobalFixture::world->gop.sum(skipped);
+  BOOST_CHECK_GT(skipped, 0ul);
+
+  // Check that the skipped tile contractions did not change the result
+  check_contraction(contract, make_reference(left, right));
+
+}
+
+BOOST_AUTO_TEST_CASE( cached_sparse_eval )
+{
+  typedef detail::DistEval<op_type::result_type, SparsePolicy> dist_eval_type1;
+  typedef Array<int, GlobalFixture::dim, Tensor<int>, SparsePolicy> array_type;
+  typedef detail::DistEval<detail::LazyArrayTile<array_type::value_type, array_op_type>,
+      SparsePolicy> array_eval_type;
+
+  array_type left(*GlobalFixture::world, tr, make_shape(tr, 0.4, 23));
+
+  array_type right(*GlobalFixture::world, tr, make_shape(tr, 0.4, 42));
+
+  // Fill arrays with random data
+  rand_fill_array(left);
+  left.truncate();
+  rand_fill_array(right);
+  right.truncate();
+
+  // Compute the reference contraction
+  const matrix_type reference = make_reference(left, right);
+
+  SummaGroupCache::clear();
+  SummaGroupCache::enable();
+  BOOST_CHECK(SummaGroupCache::enabled());
+
+  // Evaluate the same contraction twice; the second evaluation reuses the
+  // broadcast schedule of the first.
+  for(unsigned int iter = 0u; iter < 2u; ++iter) {
+    array_eval_type left_arg(make_array_eval(left, left.get_world(), left.get_shape(),
+        proc_grid.make_row_phase_pmap(tr.tiles().volume() / tr.tiles().extent_data()[0]),
+        Permutation(), array_op_type()));
+    array_eval_type right_arg(make_array_eval(right, right.get_world(), right.get_shape(),
+        proc_grid.make_col_phase_pmap(tr.tiles().volume() / tr.tiles().extent_data()[tr.tiles().rank() - 1]),
+        Permutation(), array_op_type()));
+
+    const SparseShape<float> result_shape = left_arg.shape().gemm(right_arg.shape(), 1, op.gemm_helper());
+
+    dist_eval_type1 contract = make_contract_eval(left_arg, right_arg,
+        left_arg.get_world(), result_shape, pmap, Permutation(), op);
+
+    // Check evaluation
+    BOOST_REQUIRE_NO_THROW(contract.eval());
+    BOOST_REQUIRE_NO_THROW(contract.wait());
+
+    if(proc_grid.local_size() > 0ul) {
+      BOOST_CHECK_EQUAL(SummaGroupCache::size(), 1ul);
+      BOOST_CHECK_EQUAL(SummaGroupCache::hits(), std::size_t(iter));
+    }
+
+    // Check that the result is not changed by the cached schedule
+    check_contraction(contract, reference);
+
+    GlobalFixture::world->gop.fence();
+  }
+
+  SummaGroupCache::enable(false);
+  SummaGroupCache::clear();
+  BOOST_CHECK_EQUAL(SummaGroupCache::size(), 0ul);
+}
+
 #endif // TILEDARRAY_ENABLE_OLD_SUMMA
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -742,6 +742,459 @@ BOOST_AUTO_TEST_CASE( cont )
   }
 }
 
+BOOST_AUTO_TEST_CASE( cont_permute )
+{
+  BOOST_REQUIRE_NO_THROW(w("i,j") = a("i,b,c") * b("j,b,c"));
+
+  Array2 result;
+  BOOST_REQUIRE_NO_THROW(result("j,i") = a("i,b,c") * b("j,b,c"));
+
+  for(Array2::const_iterator it = result.begin(); it != result.end(); ++it) {
+    const Array2::value_type tile = *it;
+    const Array2::value_type reference_tile =
+        w.find(std::array<std::size_t, 2>{{it.index()[1], it.index()[0]}}).get();
+
+    std::size_t i[2];
+    for(i[0] = tile.range().lobound_data()[0]; i[0] < tile.range().upbound_data()[0]; ++i[0])
+      for(i[1] = tile.range().lobound_data()[1]; i[1] < tile.range().upbound_data()[1]; ++i[1]) {
+        const std::size_t j[2] = { i[1], i[0] };
+        BOOST_CHECK_EQUAL(tile[i], reference_tile[j]);
+      }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( cont_native )
+{
+  BOOST_REQUIRE_NO_THROW(w("i,j") = a("i,b,c") * b("j,b,c"));
+
+  // Construct arguments that are not in matrix form
+  Array3 x, y;
+  BOOST_REQUIRE_NO_THROW(x("b,i,c") = a("i,b,c"));
+  BOOST_REQUIRE_NO_THROW(y("c,j,b") = b("j,b,c"));
+
+  Array2 result;
+  BOOST_REQUIRE_NO_THROW(result("i,j") = x("b,i,c") * b("j,b,c"));
+  for(Array2::const_iterator it = result.begin(); it != result.end(); ++it) {
+    const Array2::value_type tile = *it;
+    const Array2::value_type reference_tile = w.find(it.index()).get();
+
+    BOOST_CHECK_EQUAL(tile.range(), reference_tile.range());
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], reference_tile[i]);
+  }
+
+  BOOST_REQUIRE_NO_THROW(result("i,j") = x("b,i,c") * (2 * y("c,j,b")));
+  for(Array2::const_iterator it = result.begin(); it != result.end(); ++it) {
+    const Array2::value_type tile = *it;
+    const Array2::value_type reference_tile = w.find(it.index()).get();
+
+    BOOST_CHECK_EQUAL(tile.range(), reference_tile.range());
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], 2 * reference_tile[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( cont_batch )
+{
+  BOOST_REQUIRE_NO_THROW(c("i,j,p") = a("i,k,p") * b("k,j,p"));
+
+  // Check the result against the contraction of each batch element
+  const std::size_t K = a.trange().tiles().extent_data()[1];
+  for(Array3::const_iterator it = c.begin(); it != c.end(); ++it) {
+    const Array3::value_type tile = *it;
+    BOOST_CHECK_EQUAL(tile.range(), c.trange().make_tile_range(it.index()));
+
+    Array3::value_type reference_tile(tile.range(), 0);
+    for(std::size_t k = 0ul; k < K; ++k) {
+      const Array3::value_type left =
+          a.find(std::array<std::size_t, 3>{{it.index()[0], k, it.index()[2]}}).get();
+      const Array3::value_type right =
+          b.find(std::array<std::size_t, 3>{{k, it.index()[1], it.index()[2]}}).get();
+
+      std::size_t i[3], l[3], r[3];
+      for(i[0] = tile.range().lobound_data()[0]; i[0] < tile.range().upbound_data()[0]; ++i[0])
+        for(i[1] = tile.range().lobound_data()[1]; i[1] < tile.range().upbound_data()[1]; ++i[1])
+          for(i[2] = tile.range().lobound_data()[2]; i[2] < tile.range().upbound_data()[2]; ++i[2])
+            for(l[1] = left.range().lobound_data()[1]; l[1] < left.range().upbound_data()[1]; ++l[1]) {
+              l[0] = i[0]; l[2] = r[2] = i[2];
+              r[0] = l[1]; r[1] = i[1];
+              reference_tile[i] += left[l] * right[r];
+            }
+    }
+
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], reference_tile[i]);
+  }
+
+  // Check a result where the batch variable leads
+  Array3 result;
+  BOOST_REQUIRE_NO_THROW(result("p,i,j") = a("i,k,p") * b("k,j,p"));
+  for(Array3::const_iterator it = result.begin(); it != result.end(); ++it) {
+    const Array3::value_type tile = *it;
+    const Array3::value_type reference_tile =
+        c.find(std::array<std::size_t, 3>{{it.index()[1], it.index()[2], it.index()[0]}}).get();
+
+    std::size_t i[3];
+    for(i[0] = tile.range().lobound_data()[0]; i[0] < tile.range().upbound_data()[0]; ++i[0])
+      for(i[1] = tile.range().lobound_data()[1]; i[1] < tile.range().upbound_data()[1]; ++i[1])
+        for(i[2] = tile.range().lobound_data()[2]; i[2] < tile.range().upbound_data()[2]; ++i[2]) {
+          const std::size_t j[3] = { i[1], i[2], i[0] };
+          BOOST_CHECK_EQUAL(tile[i], reference_tile[j]);
+        }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( cont_mixed_precision )
+{
+  typedef Array<float, 3> ArrayF3;
+  typedef Array<double, 2> ArrayD2;
+
+  // Copy the arguments to single precision arrays
+  ArrayF3 af(*GlobalFixture::world, tr), bf(*GlobalFixture::world, tr);
+  for(ArrayF3::pmap_interface::const_iterator it = af.get_pmap()->begin();
+      it != af.get_pmap()->end(); ++it)
+  {
+    af.set(*it, ArrayF3::value_type(a.find(*it).get()));
+    bf.set(*it, ArrayF3::value_type(b.find(*it).get()));
+  }
+
+  Array2 reference;
+  BOOST_REQUIRE_NO_THROW(reference("i,j") = a("i,b,c") * b("j,b,c"));
+
+  // Contract the single precision arrays into a double precision result
+  ArrayD2 result;
+  BOOST_REQUIRE_NO_THROW(result("i,j") =
+      expressions::mixed_mult<ArrayD2::value_type>(af("i,b,c"), bf("j,b,c")));
+  for(ArrayD2::const_iterator it = result.begin(); it != result.end(); ++it) {
+    const ArrayD2::value_type tile = *it;
+    const Array2::value_type reference_tile = reference.find(it.index()).get();
+
+    BOOST_CHECK_EQUAL(tile.range(), reference_tile.range());
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], double(reference_tile[i]));
+  }
+
+  // Check a scaled and permuted result
+  BOOST_REQUIRE_NO_THROW(result("j,i") =
+      2 * expressions::mixed_mult<ArrayD2::value_type>(af("i,b,c"), bf("j,b,c")));
+  for(ArrayD2::const_iterator it = result.begin(); it != result.end(); ++it) {
+    const ArrayD2::value_type tile = *it;
+    const Array2::value_type reference_tile =
+        reference.find(std::array<std::size_t, 2>{{it.index()[1], it.index()[0]}}).get();
+
+    std::size_t i[2];
+    for(i[0] = tile.range().lobound_data()[0]; i[0] < tile.range().upbound_data()[0]; ++i[0])
+      for(i[1] = tile.range().lobound_data()[1]; i[1] < tile.range().upbound_data()[1]; ++i[1]) {
+        const std::size_t j[2] = { i[1], i[0] };
+        BOOST_CHECK_EQUAL(tile[i], 2.0 * reference_tile[j]);
+      }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( cont_layers )
+{
+  // With two or more processes, the inner dimension of this contraction is
+  // divided among process layers. It has a single result tile, so the keys
+  // of the partial result tiles of the layers would overlap the keys of the
+  // broadcast argument tiles if they were not offset.
+  const std::array<std::size_t, 2> outer = {{ 0ul, 5ul }};
+  const std::array<std::size_t, 5> inner = {{ 0ul, 3ul, 6ul, 9ul, 12ul }};
+  const std::array<TiledRange1, 2> left_ranges = {{
+      TiledRange1(outer.begin(), outer.end()), TiledRange1(inner.begin(), inner.end()) }};
+  const std::array<TiledRange1, 2> right_ranges = {{
+      TiledRange1(inner.begin(), inner.end()), TiledRange1(outer.begin(), outer.end()) }};
+  Array2 left(*GlobalFixture::world, TiledRange(left_ranges.begin(), left_ranges.end()));
+  Array2 right(*GlobalFixture::world, TiledRange(right_ranges.begin(), right_ranges.end()));
+  random_fill(left);
+  random_fill(right);
+  GlobalFixture::world->gop.fence();
+
+  // Process layers are only used when the memory limit allows them
+  const std::size_t memory_limit = SummaConfig::memory_limit();
+  SummaConfig::set_memory_limit(1ul << 30);
+
+  Array2 result;
+  BOOST_REQUIRE_NO_THROW(result("i,j") = left("i,k") * right("k,j"));
+  GlobalFixture::world->gop.fence();
+
+  SummaConfig::set_memory_limit(memory_limit);
+
+  EigenMatrixXi reference = make_matrix(left) * make_matrix(right);
+  EigenMatrixXi result_matrix = make_matrix(result);
+  BOOST_CHECK_EQUAL(result_matrix, reference);
+}
+
+BOOST_AUTO_TEST_CASE( cont_lossy_bcast )
+{
+  // Construct double precision arguments with elements that are not exactly
+  // representable in single precision
+  Array<double,3> ad(*GlobalFixture::world, a.trange());
+  Array<double,3> bd(*GlobalFixture::world, b.trange());
+  for(Array<double,3>::iterator it = ad.begin(); it != ad.end(); ++it) {
+    Array<double,3>::value_type tile(ad.trange().make_tile_range(it.index()));
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      tile[i] = 1.0 + 1.0 / double(3ul + (i % 7ul));
+    *it = tile;
+  }
+  for(Array<double,3>::iterator it = bd.begin(); it != bd.end(); ++it) {
+    Array<double,3>::value_type tile(bd.trange().make_tile_range(it.index()));
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      tile[i] = 1.0 - 1.0 / double(3ul + (i % 5ul));
+    *it = tile;
+  }
+
+  Array<double,2> reference(*GlobalFixture::world, trange2);
+  BOOST_REQUIRE_NO_THROW(reference("i,j") = ad("i,b,c") * bd("j,b,c"));
+
+  SummaConfig::set_bcast_compression(SummaConfig::lossy);
+  SummaConfig::reset_bcast_bytes();
+
+  // Check that lossy compression does not truncate elements without a
+  // tolerance
+  Array<double,2> result(*GlobalFixture::world, trange2);
+  BOOST_REQUIRE_NO_THROW(result("i,j") = ad("i,b,c") * bd("j,b,c"));
+  if(SummaConfig::bcast_bytes() != 0ul)
+    BOOST_CHECK_GT(2ul * SummaConfig::bcast_compressed_bytes(), SummaConfig::bcast_bytes());
+  for(Array<double,2>::const_iterator it = result.begin(); it != result.end(); ++it) {
+    const Array<double,2>::value_type tile = *it;
+    const Array<double,2>::value_type reference_tile = reference.find(it.index()).get();
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], reference_tile[i]);
+  }
+
+  // Check that elements are truncated to single precision, and the result
+  // error is within the bound of the tolerance
+  const double tolerance = 1.0e-4;
+  SummaConfig::set_bcast_tolerance(tolerance);
+  BOOST_CHECK_EQUAL(SummaConfig::bcast_tolerance(), tolerance);
+  SummaConfig::reset_bcast_bytes();
+  BOOST_REQUIRE_NO_THROW(result("i,j") = ad("i,b,c") * bd("j,b,c"));
+  if(SummaConfig::bcast_bytes() != 0ul)
+    BOOST_CHECK_LE(2ul * SummaConfig::bcast_compressed_bytes(), SummaConfig::bcast_bytes());
+
+  const double k = double(ad.trange().elements().volume())
+      / double(ad.trange().elements().extent_data()[0]);
+  const double max_error = tolerance * k * (2.0 + 1.0);
+  for(Array<double,2>::const_iterator it = result.begin(); it != result.end(); ++it) {
+    const Array<double,2>::value_type tile = *it;
+    const Array<double,2>::value_type reference_tile = reference.find(it.index()).get();
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_SMALL(tile[i] - reference_tile[i], max_error);
+  }
+
+  SummaConfig::set_bcast_tolerance(0.0);
+  SummaConfig::set_bcast_compression(SummaConfig::uncompressed);
+  SummaConfig::reset_bcast_bytes();
+}
+
+BOOST_AUTO_TEST_CASE( cont_tile_fusion )
+{
+  // Compute the reference result without tile fusion
+  Array2 reference;
+  BOOST_REQUIRE_NO_THROW(reference("i,j") = a("i,b,c") * b("b,c,j"));
+
+  expressions::TileFusion::clear();
+  expressions::TileFusion::enable(8ul);
+  BOOST_CHECK(expressions::TileFusion::enabled());
+
+  // Check that the result is split to the original tiling
+  BOOST_REQUIRE_NO_THROW(w("i,j") = a("i,b,c") * b("b,c,j"));
+  BOOST_CHECK_EQUAL(expressions::TileFusion::fusions(), 1ul);
+  BOOST_CHECK_EQUAL(w.trange(), reference.trange());
+  for(Array2::const_iterator it = w.begin(); it != w.end(); ++it) {
+    const Array2::value_type tile = *it;
+    const Array2::value_type reference_tile = reference.find(it.index()).get();
+
+    BOOST_CHECK_EQUAL(tile.range(), reference_tile.range());
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], reference_tile[i]);
+  }
+
+  // Check a permuted result
+  BOOST_REQUIRE_NO_THROW(w("j,i") = a("i,b,c") * b("b,c,j"));
+  BOOST_CHECK_EQUAL(expressions::TileFusion::fusions(), 2ul);
+  for(Array2::const_iterator it = w.begin(); it != w.end(); ++it) {
+    const Array2::value_type tile = *it;
+    const Array2::value_type reference_tile =
+        reference.find(std::array<std::size_t, 2>{{it.index()[1], it.index()[0]}}).get();
+
+    std::size_t i[2];
+    for(i[0] = tile.range().lobound_data()[0]; i[0] < tile.range().upbound_data()[0]; ++i[0])
+      for(i[1] = tile.range().lobound_data()[1]; i[1] < tile.range().upbound_data()[1]; ++i[1]) {
+        const std::size_t j[2] = { i[1], i[0] };
+        BOOST_CHECK_EQUAL(tile[i], reference_tile[j]);
+      }
+  }
+
+  // Arguments that are transposed are not fused
+  BOOST_REQUIRE_NO_THROW(w("i,j") = a("i,b,c") * b("j,b,c"));
+  BOOST_CHECK_EQUAL(expressions::TileFusion::fusions(), 2ul);
+
+  expressions::TileFusion::disable();
+  expressions::TileFusion::clear();
+  BOOST_CHECK(! expressions::TileFusion::enabled());
+}
+
+BOOST_AUTO_TEST_CASE( cont_plan_cache )
+{
+  // Compute the reference result without the plan cache
+  Array2 reference(*GlobalFixture::world, trange2);
+  BOOST_REQUIRE_NO_THROW(reference("i,j") = a("i,b,c") * b("j,b,c"));
+
+  expressions::ContPlanCache::clear();
+  expressions::ContPlanCache::enable();
+  BOOST_CHECK(expressions::ContPlanCache::enabled());
+
+  // Evaluate the same contraction twice; the second evaluation reuses the
+  // plan of the first.
+  for(unsigned int iter = 0u; iter < 2u; ++iter) {
+    BOOST_REQUIRE_NO_THROW(w("i,j") = a("i,b,c") * b("j,b,c"));
+
+    BOOST_CHECK_EQUAL(expressions::ContPlanCache::size(), 1ul);
+    BOOST_CHECK_EQUAL(expressions::ContPlanCache::hits(), std::size_t(iter));
+
+    for(Array2::const_iterator it = w.begin(); it != w.end(); ++it) {
+      const Array2::value_type tile = *it;
+      const Array2::value_type reference_tile = reference.find(it.index()).get();
+
+      BOOST_CHECK_EQUAL(tile.range(), reference_tile.range());
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        BOOST_CHECK_EQUAL(tile[i], reference_tile[i]);
+    }
+  }
+
+  // Check that a different contraction uses a different plan
+  BOOST_REQUIRE_NO_THROW(w("i,j") = (2 * a("i,b,c")) * b("j,b,c"));
+  BOOST_CHECK_EQUAL(expressions::ContPlanCache::size(), 2ul);
+  BOOST_CHECK_EQUAL(expressions::ContPlanCache::hits(), 1ul);
+
+  // Check that contraction scaling factors that differ beyond the default
+  // stream precision use different plans
+  Array<double,3> ad(*GlobalFixture::world, a.trange());
+  Array<double,3> bd(*GlobalFixture::world, b.trange());
+  Array<double,2> wd(*GlobalFixture::world, trange2);
+  ad.fill_local(1.0);
+  bd.fill_local(1.0);
+  BOOST_REQUIRE_NO_THROW(wd("i,j") = 1.0 * (ad("i,b,c") * bd("j,b,c")));
+  BOOST_REQUIRE_NO_THROW(wd("i,j") = 1.0000001 * (ad("i,b,c") * bd("j,b,c")));
+  BOOST_CHECK_EQUAL(expressions::ContPlanCache::size(), 4ul);
+  BOOST_CHECK_EQUAL(expressions::ContPlanCache::hits(), 1ul);
+
+  expressions::ContPlanCache::enable(false);
+  expressions::ContPlanCache::clear();
+  BOOST_CHECK_EQUAL(expressions::ContPlanCache::size(), 0ul);
+}
+
+BOOST_AUTO_TEST_CASE( cont_path )
+{
+  // Square matrix with the tiling of the vectors
+  const TiledRange trange = { trange1.data().front(), trange1.data().front() };
+  Array2 x(*GlobalFixture::world, trange);
+  random_fill(x);
+  GlobalFixture::world->gop.fence();
+
+  // Compute the reference result in the cheaper order
+  Array1 reference(*GlobalFixture::world, trange1);
+  BOOST_REQUIRE_NO_THROW(reference("i") = x("i,j") * (x("j,k") * u("k")));
+
+  expressions::ContPathOptimizer::clear();
+  expressions::ContPathOptimizer::enable();
+  BOOST_CHECK(expressions::ContPathOptimizer::enabled());
+
+  // The matrix-matrix product is replaced by two matrix-vector products
+  BOOST_REQUIRE_NO_THROW(v("i") = x("i,j") * x("j,k") * u("k"));
+  BOOST_CHECK_EQUAL(expressions::ContPathOptimizer::reorders(), 1ul);
+  for(Array1::const_iterator it = v.begin(); it != v.end(); ++it) {
+    const Array1::value_type tile = *it;
+    const Array1::value_type reference_tile = reference.find(it.index()).get();
+
+    BOOST_CHECK_EQUAL(tile.range(), reference_tile.range());
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], reference_tile[i]);
+  }
+
+  // Check that products in the cheaper order are not reordered
+  BOOST_REQUIRE_NO_THROW(v("i") = x("i,j") * (x("j,k") * u("k")));
+  BOOST_CHECK_EQUAL(expressions::ContPathOptimizer::reorders(), 1ul);
+
+  // Check that products that are not contractions are not reordered
+  Array2 y(*GlobalFixture::world, trange);
+  BOOST_REQUIRE_NO_THROW(y("i,j") = x("i,k") * x("k,j") * x("i,j"));
+  BOOST_CHECK_EQUAL(expressions::ContPathOptimizer::reorders(), 1ul);
+
+  expressions::ContPathOptimizer::enable(false);
+  expressions::ContPathOptimizer::clear();
+}
+
+BOOST_AUTO_TEST_CASE( add_to_cont )
+{
+  Array2 reference(*GlobalFixture::world, trange2);
+  BOOST_REQUIRE_NO_THROW(reference("i,j") = a("i,b,c") * b("j,b,c"));
+
+  // Accumulate the contraction into an initialized array
+  BOOST_REQUIRE_NO_THROW(w("i,j") = a("i,b,c") * b("j,b,c"));
+  BOOST_REQUIRE_NO_THROW(w("i,j") += a("i,b,c") * b("j,b,c"));
+  BOOST_REQUIRE_NO_THROW(w("i,j") += 5 * (a("i,b,c") * b("j,b,c")));
+
+  for(Array2::const_iterator it = w.begin(); it != w.end(); ++it) {
+    const Array2::value_type tile = *it;
+    const Array2::value_type reference_tile = reference.find(it.index()).get();
+
+    BOOST_CHECK_EQUAL(tile.range(), reference_tile.range());
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], 7 * reference_tile[i]);
+  }
+
+  // Check that a contraction that reads the result array is not evaluated
+  // in place
+  const TiledRange trange = { trange1.data().front(), trange1.data().front() };
+  Array2 x(*GlobalFixture::world, trange);
+  random_fill(x);
+  Array2 y(*GlobalFixture::world, trange);
+  BOOST_REQUIRE_NO_THROW(y("i,j") = x("i,j") + x("i,k") * x("k,j"));
+  BOOST_REQUIRE_NO_THROW(x("i,j") += x("i,k") * x("k,j"));
+
+  for(Array2::const_iterator it = x.begin(); it != x.end(); ++it) {
+    const Array2::value_type tile = *it;
+    const Array2::value_type reference_tile = y.find(it.index()).get();
+
+    BOOST_CHECK_EQUAL(tile.range(), reference_tile.range());
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], reference_tile[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( add_to_cont_copy )
+{
+  Array2 reference(*GlobalFixture::world, trange2);
+  BOOST_REQUIRE_NO_THROW(reference("i,j") = a("i,b,c") * b("j,b,c"));
+
+  // Keep a shallow copy of the result array before accumulating into it
+  BOOST_REQUIRE_NO_THROW(w("i,j") = a("i,b,c") * b("j,b,c"));
+  Array2 copy = w;
+  BOOST_REQUIRE_NO_THROW(w("i,j") += a("i,b,c") * b("j,b,c"));
+
+  // Check that the copy is unchanged
+  for(Array2::const_iterator it = copy.begin(); it != copy.end(); ++it) {
+    const Array2::value_type tile = *it;
+    const Array2::value_type reference_tile = reference.find(it.index()).get();
+
+    BOOST_CHECK_EQUAL(tile.range(), reference_tile.range());
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], reference_tile[i]);
+  }
+
+  // Check that the result holds the sum
+  for(Array2::const_iterator it = w.begin(); it != w.end(); ++it) {
+    const Array2::value_type tile = *it;
+    const Array2::value_type reference_tile = reference.find(it.index()).get();
+
+    BOOST_CHECK_EQUAL(tile.range(), reference_tile.range());
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], 2 * reference_tile[i]);
+  }
+}
+
 BOOST_AUTO_TEST_CASE( scale_cont )
 {
   const std::size_t m = a.trange().elements().extent_data()[0];
@@ -0,0 +1,180 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/pmap/fused_pmap.h"
+#include "TiledArray/pmap/cyclic_pmap.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct FusedPmapFixture {
+
+  FusedPmapFixture() { }
+
+  // Construct a tiled range with x by y tiles of size 1
+  static TiledRange make_trange(const std::size_t x, const std::size_t y) {
+    std::vector<std::size_t> rows, cols;
+    for(std::size_t i = 0ul; i <= x; ++i)
+      rows.push_back(i);
+    for(std::size_t i = 0ul; i <= y; ++i)
+      cols.push_back(i);
+    const std::array<TiledRange1, 2> ranges = {{
+        TiledRange1(rows.begin(), rows.end()), TiledRange1(cols.begin(), cols.end()) }};
+    return TiledRange(ranges.begin(), ranges.end());
+  }
+
+  // Construct a tiled range where pairs of adjacent tiles are fused
+  static TiledRange make_fused_trange(const std::size_t x, const std::size_t y) {
+    std::vector<std::size_t> rows, cols;
+    for(std::size_t i = 0ul; i < x; i += 2ul)
+      rows.push_back(i);
+    rows.push_back(x);
+    for(std::size_t i = 0ul; i < y; i += 2ul)
+      cols.push_back(i);
+    cols.push_back(y);
+    const std::array<TiledRange1, 2> ranges = {{
+        TiledRange1(rows.begin(), rows.end()), TiledRange1(cols.begin(), cols.end()) }};
+    return TiledRange(ranges.begin(), ranges.end());
+  }
+
+  // Construct a cyclic process map for the fused tiles
+  static std::shared_ptr<Pmap> make_fused_pmap(const TiledRange& fused_trange) {
+    const std::size_t x = fused_trange.tiles().extent_data()[0];
+    const std::size_t y = fused_trange.tiles().extent_data()[1];
+    const std::size_t nprocs = GlobalFixture::world->size();
+    const std::size_t p_rows = std::max<std::size_t>(1ul, std::min(nprocs, x));
+    const std::size_t p_cols = std::max<std::size_t>(1ul, std::min(nprocs / p_rows, y));
+    return std::make_shared<detail::CyclicPmap>(* GlobalFixture::world, x, y,
+        p_rows, p_cols);
+  }
+
+  static std::shared_ptr<const std::vector<std::size_t> >
+  make_fused_index(const TiledRange& trange, const TiledRange& fused_trange) {
+    return std::make_shared<const std::vector<std::size_t> >(
+        detail::fused_tile_index(trange, fused_trange));
+  }
+
+};
+
+
+// =============================================================================
+// FusedPmap Test Suite
+
+
+BOOST_FIXTURE_TEST_SUITE( fused_pmap_suite, FusedPmapFixture )
+
+BOOST_AUTO_TEST_CASE( fused_tile_index )
+{
+  for(std::size_t x = 1ul; x < 6ul; ++x) {
+    for(std::size_t y = 1ul; y < 6ul; ++y) {
+      const TiledRange trange = make_trange(x, y);
+      const TiledRange fused_trange = make_fused_trange(x, y);
+
+      std::vector<std::size_t> fused_index;
+      BOOST_REQUIRE_NO_THROW(fused_index = detail::fused_tile_index(trange, fused_trange));
+      BOOST_CHECK_EQUAL(fused_index.size(), x * y);
+
+      // Check that each tile maps to the fused tile that contains it
+      for(std::size_t i = 0ul; i < x; ++i)
+        for(std::size_t j = 0ul; j < y; ++j)
+          BOOST_CHECK_EQUAL(fused_index[i * y + j],
+              (i / 2ul) * ((y + 1ul) / 2ul) + (j / 2ul));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  for(std::size_t x = 1ul; x < 6ul; ++x) {
+    for(std::size_t y = 1ul; y < 6ul; ++y) {
+      const TiledRange trange = make_trange(x, y);
+      const TiledRange fused_trange = make_fused_trange(x, y);
+      std::shared_ptr<Pmap> fused_pmap = make_fused_pmap(fused_trange);
+      std::shared_ptr<const std::vector<std::size_t> > fused_index =
+          make_fused_index(trange, fused_trange);
+
+      BOOST_REQUIRE_NO_THROW(detail::FusedPmap pmap(* GlobalFixture::world,
+          fused_pmap, fused_index));
+      detail::FusedPmap pmap(* GlobalFixture::world, fused_pmap, fused_index);
+      BOOST_CHECK_EQUAL(pmap.rank(), GlobalFixture::world->rank());
+      BOOST_CHECK_EQUAL(pmap.procs(), GlobalFixture::world->size());
+      BOOST_CHECK_EQUAL(pmap.size(), x * y);
+      BOOST_CHECK_EQUAL(pmap.fused_pmap(), fused_pmap);
+      BOOST_CHECK_EQUAL(pmap.fused_index(), fused_index);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( owner )
+{
+  for(std::size_t x = 1ul; x < 6ul; ++x) {
+    for(std::size_t y = 1ul; y < 6ul; ++y) {
+      const TiledRange trange = make_trange(x, y);
+      const TiledRange fused_trange = make_fused_trange(x, y);
+      std::shared_ptr<Pmap> fused_pmap = make_fused_pmap(fused_trange);
+      std::shared_ptr<const std::vector<std::size_t> > fused_index =
+          make_fused_index(trange, fused_trange);
+      detail::FusedPmap pmap(* GlobalFixture::world, fused_pmap, fused_index);
+
+      // Check that each tile is owned by the owner of its fused tile
+      for(std::size_t tile = 0ul; tile < x * y; ++tile) {
+        BOOST_CHECK_EQUAL(pmap.owner(tile), fused_pmap->owner((*fused_index)[tile]));
+        BOOST_CHECK_EQUAL(pmap.is_local(tile), fused_pmap->is_local((*fused_index)[tile]));
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( local_group )
+{
+  ProcessID tile_owners[100];
+
+  for(std::size_t x = 1ul; x < 6ul; ++x) {
+    for(std::size_t y = 1ul; y < 6ul; ++y) {
+      const std::size_t tiles = x * y;
+      const TiledRange trange = make_trange(x, y);
+      const TiledRange fused_trange = make_fused_trange(x, y);
+      detail::FusedPmap pmap(* GlobalFixture::world, make_fused_pmap(fused_trange),
+          make_fused_index(trange, fused_trange));
+
+      // Check that all local elements map to this rank
+      for(detail::FusedPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it) {
+        BOOST_CHECK_EQUAL(pmap.owner(*it), GlobalFixture::world->rank());
+      }
+
+      // Check that the local tiles of all processes cover all tiles
+      std::size_t total_size = pmap.local_size();
+      GlobalFixture::world->gop.sum(total_size);
+      BOOST_CHECK_EQUAL(total_size, tiles);
+
+      std::fill_n(tile_owners, tiles, 0);
+      for(detail::FusedPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it) {
+        tile_owners[*it] += GlobalFixture::world->rank();
+      }
+
+      GlobalFixture::world->gop.sum(tile_owners, tiles);
+      for(std::size_t tile = 0; tile < tiles; ++tile) {
+        BOOST_CHECK_EQUAL(tile_owners[tile], pmap.owner(tile));
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
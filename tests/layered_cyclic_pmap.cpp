@@ -0,0 +1,158 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/pmap/layered_cyclic_pmap.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct LayeredCyclicPmapFixture {
+
+  LayeredCyclicPmapFixture() { }
+
+  // Compute the process grid dimensions for a layer
+  static void proc_dims(const std::size_t x, const std::size_t y,
+      const std::size_t layers, std::size_t& p_rows, std::size_t& p_cols)
+  {
+    const std::size_t nprocs = GlobalFixture::world->size() / layers;
+    p_rows = std::max<std::size_t>(1ul, std::min<std::size_t>(
+        std::sqrt(nprocs * x / y), std::min<std::size_t>(nprocs, x)));
+    p_cols = std::max<std::size_t>(1ul, std::min<std::size_t>(nprocs / p_rows, y));
+  }
+
+};
+
+
+// =============================================================================
+// LayeredCyclicPmap Test Suite
+
+
+BOOST_FIXTURE_TEST_SUITE( layered_cyclic_pmap_suite, LayeredCyclicPmapFixture )
+
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  const std::size_t size = GlobalFixture::world->size();
+
+  for(std::size_t layers = 1ul; layers <= size; ++layers) {
+    for(std::size_t x = layers; x < 10ul; ++x) {
+      for(std::size_t y = layers; y < 10ul; ++y) {
+        std::size_t p_rows = 0ul, p_cols = 0ul;
+        proc_dims(x, y, layers, p_rows, p_cols);
+
+        BOOST_REQUIRE_NO_THROW(detail::LayeredCyclicPmap pmap(* GlobalFixture::world,
+            x, y, p_rows, p_cols, layers, true));
+        detail::LayeredCyclicPmap pmap(* GlobalFixture::world, x, y, p_rows,
+            p_cols, layers, false);
+        BOOST_CHECK_EQUAL(pmap.rank(), GlobalFixture::world->rank());
+        BOOST_CHECK_EQUAL(pmap.procs(), GlobalFixture::world->size());
+        BOOST_CHECK_EQUAL(pmap.size(), x * y);
+      }
+    }
+  }
+
+#ifdef TA_EXCEPTION_ERROR
+  BOOST_CHECK_THROW(detail::LayeredCyclicPmap pmap(* GlobalFixture::world, 10ul, 10ul, 1, 1, 0, true), TiledArray::Exception);
+  BOOST_CHECK_THROW(detail::LayeredCyclicPmap pmap(* GlobalFixture::world, 10ul, 10ul, 1, 1, size * 2, true), TiledArray::Exception);
+  BOOST_CHECK_THROW(detail::LayeredCyclicPmap pmap(* GlobalFixture::world, 10ul, 10ul, size, 2, 1, false), TiledArray::Exception);
+  BOOST_CHECK_THROW(detail::LayeredCyclicPmap pmap(* GlobalFixture::world, 1ul, 10ul, 1, 1, 2, true), TiledArray::Exception);
+  BOOST_CHECK_THROW(detail::LayeredCyclicPmap pmap(* GlobalFixture::world, 10ul, 1ul, 1, 1, 2, false), TiledArray::Exception);
+#endif // TA_EXCEPTION_ERROR
+}
+
+BOOST_AUTO_TEST_CASE( owner )
+{
+  const std::size_t size = GlobalFixture::world->size();
+
+  for(std::size_t layers = 1ul; layers <= size; ++layers) {
+    const std::size_t layer_stride = size / layers;
+
+    for(std::size_t x = layers; x < 10ul; ++x) {
+      for(std::size_t y = layers; y < 10ul; ++y) {
+        std::size_t p_rows = 0ul, p_cols = 0ul;
+        proc_dims(x, y, layers, p_rows, p_cols);
+
+        detail::LayeredCyclicPmap row_pmap(* GlobalFixture::world, x, y,
+            p_rows, p_cols, layers, true);
+        detail::LayeredCyclicPmap col_pmap(* GlobalFixture::world, x, y,
+            p_rows, p_cols, layers, false);
+
+        for(std::size_t i = 0ul; i < x; ++i) {
+          for(std::size_t j = 0ul; j < y; ++j) {
+            const std::size_t tile = i * y + j;
+            const std::size_t layer_rank = (i % p_rows) * p_cols + j % p_cols;
+
+            // Check that the tile is owned by the layer that holds row i
+            const std::size_t row_layer = row_pmap.owner(tile) / layer_stride;
+            BOOST_CHECK_LE(row_layer * x / layers, i);
+            BOOST_CHECK_LT(i, (row_layer + 1ul) * x / layers);
+            BOOST_CHECK_EQUAL(row_pmap.owner(tile), row_layer * layer_stride + layer_rank);
+
+            // Check that the tile is owned by the layer that holds column j
+            const std::size_t col_layer = col_pmap.owner(tile) / layer_stride;
+            BOOST_CHECK_LE(col_layer * y / layers, j);
+            BOOST_CHECK_LT(j, (col_layer + 1ul) * y / layers);
+            BOOST_CHECK_EQUAL(col_pmap.owner(tile), col_layer * layer_stride + layer_rank);
+          }
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( local_group )
+{
+  ProcessID tile_owners[100];
+  const std::size_t size = GlobalFixture::world->size();
+
+  for(std::size_t layers = 1ul; layers <= size; ++layers) {
+    for(std::size_t x = layers; x < 10ul; ++x) {
+      for(std::size_t y = layers; y < 10ul; ++y) {
+        std::size_t p_rows = 0ul, p_cols = 0ul;
+        proc_dims(x, y, layers, p_rows, p_cols);
+
+        const std::size_t tiles = x * y;
+        detail::LayeredCyclicPmap pmap(* GlobalFixture::world, x, y, p_rows,
+            p_cols, layers, (x + y) % 2ul);
+
+        // Check that all local elements map to this rank
+        for(detail::LayeredCyclicPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it) {
+          BOOST_CHECK_EQUAL(pmap.owner(*it), GlobalFixture::world->rank());
+        }
+
+        // Check that the local tiles of all processes cover all tiles
+        std::size_t total_size = pmap.local_size();
+        GlobalFixture::world->gop.sum(total_size);
+        BOOST_CHECK_EQUAL(total_size, tiles);
+
+        std::fill_n(tile_owners, tiles, 0);
+        for(detail::LayeredCyclicPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it) {
+          tile_owners[*it] += GlobalFixture::world->rank();
+        }
+
+        GlobalFixture::world->gop.sum(tile_owners, tiles);
+        for(std::size_t tile = 0; tile < tiles; ++tile) {
+          BOOST_CHECK_EQUAL(tile_owners[tile], pmap.owner(tile));
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,122 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/math/parallel_gemm.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct ParallelGemmFixture {
+
+  ParallelGemmFixture() :
+    threshold(math::GemmParallelConfig::threshold()),
+    block_size(math::GemmParallelConfig::block_size())
+  { }
+
+  ~ParallelGemmFixture() {
+    math::GemmParallelConfig::set_threshold(threshold);
+    math::GemmParallelConfig::set_block_size(block_size);
+  }
+
+  static std::vector<double> make_matrix(const std::size_t size) {
+    std::vector<double> result(size);
+    for(std::size_t i = 0ul; i < size; ++i)
+      result[i] = GlobalFixture::world->rand() % 11;
+    return result;
+  }
+
+  std::size_t threshold;
+  integer block_size;
+}; // ParallelGemmFixture
+
+BOOST_FIXTURE_TEST_SUITE( parallel_gemm_suite, ParallelGemmFixture )
+
+BOOST_AUTO_TEST_CASE( gemm )
+{
+  math::GemmParallelConfig::set_threshold(1ul);
+  math::GemmParallelConfig::reset_parallel_gemms();
+
+  const madness::cblas::CBLAS_TRANSPOSE ops[] =
+      { madness::cblas::NoTrans, madness::cblas::Trans };
+  const integer sizes[][3] = { {300, 280, 70}, {33, 500, 17}, {600, 5, 40}, {1, 1, 900} };
+
+  const integer min_block_size = math::GemmParallelConfig::min_block_size;
+  std::size_t parallel = 0ul;
+  for(const integer block : { min_block_size, integer(256) }) {
+    math::GemmParallelConfig::set_block_size(block);
+    for(const auto& size : sizes) {
+      const integer m = size[0], n = size[1], k = size[2];
+      for(const madness::cblas::CBLAS_TRANSPOSE op_a : ops) {
+        for(const madness::cblas::CBLAS_TRANSPOSE op_b : ops) {
+          // Use padded leading dimensions
+          const integer lda = (op_a == madness::cblas::NoTrans ? k : m) + 3;
+          const integer ldb = (op_b == madness::cblas::NoTrans ? n : k) + 1;
+          const integer ldc = n + 2;
+          const std::vector<double> a =
+              make_matrix((op_a == madness::cblas::NoTrans ? m : k) * lda);
+          const std::vector<double> b =
+              make_matrix((op_b == madness::cblas::NoTrans ? k : n) * ldb);
+          std::vector<double> reference = make_matrix(m * ldc);
+          std::vector<double> c = reference;
+
+          math::gemm(op_a, op_b, m, n, k, 2.0, a.data(), lda, b.data(), ldb,
+              3.0, reference.data(), ldc);
+          math::parallel_gemm(op_a, op_b, m, n, k, 2.0, a.data(), lda,
+              b.data(), ldb, 3.0, c.data(), ldc);
+
+          BOOST_CHECK_EQUAL_COLLECTIONS(c.begin(), c.end(),
+              reference.begin(), reference.end());
+          if(madness::ThreadPool::size() > 0ul)
+            parallel += ((m > 1) || (n > 1) ? 1ul : 0ul);
+        }
+      }
+    }
+  }
+
+  // Result matrices with a single element are not split
+  BOOST_CHECK_EQUAL(math::GemmParallelConfig::parallel_gemms(), parallel);
+}
+
+BOOST_AUTO_TEST_CASE( tensor_gemm )
+{
+  Tensor<double> left(Range(40, 8, 60));
+  for(std::size_t i = 0ul; i < left.size(); ++i)
+    left[i] = double(i % 13ul);
+  Tensor<double> right(Range(8, 60, 50));
+  for(std::size_t i = 0ul; i < right.size(); ++i)
+    right[i] = double(i % 7ul);
+  const math::GemmHelper gemm_helper(madness::cblas::NoTrans,
+      madness::cblas::NoTrans, 2u, 3u, 3u);
+
+  const Tensor<double> reference = left.gemm(right, 2.0, gemm_helper);
+
+  math::GemmParallelConfig::set_threshold(1ul);
+  math::GemmParallelConfig::set_block_size(math::GemmParallelConfig::min_block_size);
+  const Tensor<double> result = left.gemm(right, 2.0, gemm_helper);
+  Tensor<double> accumulate = reference.clone();
+  accumulate.gemm(left, right, 2.0, gemm_helper);
+
+  for(std::size_t i = 0ul; i < reference.size(); ++i) {
+    BOOST_CHECK_EQUAL(result[i], reference[i]);
+    BOOST_CHECK_EQUAL(accumulate[i], 2.0 * reference[i]);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
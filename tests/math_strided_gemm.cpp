@@ -0,0 +1,156 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/math/strided_gemm.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct StridedGemmFixture {
+  typedef Tensor<int> tensor_type;
+
+  StridedGemmFixture() { }
+
+  ~StridedGemmFixture() { }
+
+  static tensor_type make_tensor(const std::vector<std::size_t>& lower,
+      const std::vector<std::size_t>& upper)
+  {
+    tensor_type result(tensor_type::range_type(lower, upper));
+    for(std::size_t i = 0ul; i < result.size(); ++i)
+      result[i] = GlobalFixture::world->rand() % 27;
+    return result;
+  }
+
+  /// Generate all permutations of rank \c n
+  static std::vector<Permutation> permutations(const unsigned int n) {
+    std::vector<unsigned int> p(n);
+    for(unsigned int i = 0u; i < n; ++i)
+      p[i] = i;
+
+    std::vector<Permutation> result;
+    do {
+      result.emplace_back(p);
+    } while(std::next_permutation(p.begin(), p.end()));
+
+    return result;
+  }
+
+  /// Check native layout contractions of all argument layouts
+
+  /// \param gemm_helper The contraction of the arguments in matrix form
+  /// \param left The left-hand argument in matrix form
+  /// \param right The right-hand argument in matrix form
+  /// \return The number of supported layout pairs
+  static unsigned int check_layouts(const math::GemmHelper& gemm_helper,
+      const tensor_type& left, const tensor_type& right)
+  {
+    const tensor_type reference = left.gemm(right, 3, gemm_helper);
+
+    unsigned int supported = 0u;
+    for(const Permutation& left_perm : permutations(left.range().rank())) {
+      for(const Permutation& right_perm : permutations(right.range().rank())) {
+        // Construct the native layout arguments
+        const tensor_type left_native = permute(left, -left_perm);
+        const tensor_type right_native = permute(right, -right_perm);
+
+        const math::StridedGemm strided_gemm(gemm_helper, left_native.range(),
+            left_perm, right_native.range(), right_perm);
+        BOOST_CHECK_EQUAL(strided_gemm.is_valid(),
+            math::StridedGemm::is_supported(gemm_helper, left_perm, right_perm));
+        if(! strided_gemm.is_valid())
+          continue;
+        ++supported;
+
+        // Check the contraction to a new tensor
+        tensor_type result = left_native.gemm(right_native, 3, gemm_helper,
+            left_perm, right_perm);
+        BOOST_CHECK_EQUAL(result.range(), reference.range());
+        for(std::size_t i = 0ul; i < result.size(); ++i)
+          BOOST_CHECK_EQUAL(result[i], reference[i]);
+
+        // Check the contraction to an existing tensor
+        result.gemm(left_native, right_native, 3, gemm_helper, left_perm,
+            right_perm);
+        for(std::size_t i = 0ul; i < result.size(); ++i)
+          BOOST_CHECK_EQUAL(result[i], 2 * reference[i]);
+      }
+    }
+
+    return supported;
+  }
+
+}; // StridedGemmFixture
+
+BOOST_FIXTURE_TEST_SUITE( strided_gemm_suite, StridedGemmFixture )
+
+BOOST_AUTO_TEST_CASE( matrix_form )
+{
+  // Arguments in matrix form are always supported
+  const madness::cblas::CBLAS_TRANSPOSE ops[2] =
+      { madness::cblas::NoTrans, madness::cblas::Trans };
+  for(auto left_op : ops)
+    for(auto right_op : ops)
+      BOOST_CHECK(math::StridedGemm::is_supported(
+          math::GemmHelper(left_op, right_op, 4u, 4u, 4u),
+          Permutation(), Permutation()));
+}
+
+BOOST_AUTO_TEST_CASE( rank3 )
+{
+  // C[m,n] = A[m,k1,k2] * B[k1,k2,n]
+  const math::GemmHelper gemm_helper(madness::cblas::NoTrans,
+      madness::cblas::NoTrans, 2u, 3u, 3u);
+  const tensor_type left = make_tensor({1, 2, 3}, {6, 5, 7});
+  const tensor_type right = make_tensor({2, 3, 4}, {5, 7, 10});
+
+  // Interleaved layouts, e.g. A[k1,m,k2], are supported, but not all layouts
+  const unsigned int supported = check_layouts(gemm_helper, left, right);
+  BOOST_CHECK(supported > 1u);
+  BOOST_CHECK(supported < 36u);
+  BOOST_CHECK(math::StridedGemm::is_supported(gemm_helper,
+      Permutation({1, 0, 2}), Permutation()));
+  BOOST_CHECK(math::StridedGemm::is_supported(gemm_helper,
+      Permutation({0, 2, 1}), Permutation({1, 0, 2})));
+}
+
+BOOST_AUTO_TEST_CASE( rank4 )
+{
+  // C[m1,m2,n1,n2] = A[m1,m2,k1,k2] * B[k1,k2,n1,n2]
+  const math::GemmHelper gemm_helper(madness::cblas::NoTrans,
+      madness::cblas::NoTrans, 4u, 4u, 4u);
+  const tensor_type left = make_tensor({0, 0, 0, 0}, {3, 4, 2, 5});
+  const tensor_type right = make_tensor({0, 0, 0, 0}, {2, 5, 3, 2});
+
+  BOOST_CHECK(check_layouts(gemm_helper, left, right) > 1u);
+}
+
+BOOST_AUTO_TEST_CASE( trans )
+{
+  // C[m,n1,n2] = A[k,m] * B[n1,n2,k]
+  const math::GemmHelper gemm_helper(madness::cblas::Trans,
+      madness::cblas::Trans, 3u, 2u, 3u);
+  const tensor_type left = make_tensor({0, 0}, {7, 3});
+  const tensor_type right = make_tensor({0, 0, 0}, {4, 5, 7});
+
+  BOOST_CHECK(check_layouts(gemm_helper, left, right) > 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -154,4 +154,28 @@ BOOST_AUTO_TEST_CASE( binary )
   delete [] b;
   delete [] c;
 }
+
+BOOST_AUTO_TEST_CASE( blocked )
+{
+  // Matrices larger than a panel are transposed in panels
+  const std::size_t m = TiledArray::math::TransposePanel::value * 2ul + 13ul;
+  const std::size_t n = TiledArray::math::TransposePanel::value * 3ul + 5ul;
+  const std::size_t mn = m * n;
+
+  std::vector<int> a(mn), b(mn, 0);
+
+  GlobalFixture::world->srand(1764);
+  for(std::size_t i = 0ul; i < mn; ++i)
+    a[i] = GlobalFixture::world->rand() % 42;
+
+  const auto op = [] (const int arg) { return arg * 3; };
+  const auto copy_op = [] (int* b, const int a) { *b = a; };
+
+  TiledArray::math::transpose(op, copy_op, m, n, m, b.data(), n, a.data());
+
+  for(std::size_t i = 0ul; i < m; ++i)
+    for(std::size_t j = 0ul; j < n; ++j)
+      BOOST_CHECK_EQUAL(b[j * m + i], op(a[i * n + j]));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
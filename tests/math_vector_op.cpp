@@ -0,0 +1,217 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/math/vector_op.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct VectorOpFixture {
+
+  VectorOpFixture() : isa(math::SimdConfig::isa()) {
+    GlobalFixture::world->srand(27);
+  }
+
+  ~VectorOpFixture() { math::SimdConfig::set_isa(isa); }
+
+  // Construct a vector of n random elements
+  template <typename T>
+  static std::vector<T> make_vector(const std::size_t n) {
+    std::vector<T> result(n);
+    for(std::size_t i = 0ul; i < n; ++i)
+      result[i] = T(GlobalFixture::world->rand() % 101) / T(8) - T(6);
+    return result;
+  }
+
+  // Check the element-wise operations of all instruction sets
+  template <typename T>
+  static void check_vector_ops() {
+    for(int isa = math::SimdConfig::generic; isa <= math::SimdConfig::supported(); ++isa) {
+      math::SimdConfig::set_isa(math::SimdConfig::Isa(isa));
+      BOOST_CHECK_EQUAL(math::SimdConfig::isa(), isa);
+
+      // Lengths that are not a multiple of the vector width check the
+      // scalar remainder loops of the kernels
+      for(std::size_t n = 0ul; n < 70ul; n += 7ul) {
+        const std::vector<T> left = make_vector<T>(n);
+        const std::vector<T> right = make_vector<T>(n);
+        std::vector<T> result(n);
+
+        math::vector_op(math::AddOp(), n, result.data(), left.data(), right.data());
+        for(std::size_t i = 0ul; i < n; ++i)
+          BOOST_CHECK_EQUAL(result[i], left[i] + right[i]);
+
+        math::vector_op(math::SubtOp(), n, result.data(), left.data(), right.data());
+        for(std::size_t i = 0ul; i < n; ++i)
+          BOOST_CHECK_EQUAL(result[i], left[i] - right[i]);
+
+        math::vector_op(math::MultOp(), n, result.data(), left.data(), right.data());
+        for(std::size_t i = 0ul; i < n; ++i)
+          BOOST_CHECK_EQUAL(result[i], left[i] * right[i]);
+
+        math::vector_op(math::ScaleOp<T>(3), n, result.data(), left.data());
+        for(std::size_t i = 0ul; i < n; ++i)
+          BOOST_CHECK_EQUAL(result[i], left[i] * T(3));
+
+        math::vector_op(math::AddScaleOp<T>(-2), n, result.data(), left.data(), right.data());
+        for(std::size_t i = 0ul; i < n; ++i)
+          BOOST_CHECK_EQUAL(result[i], (left[i] + right[i]) * T(-2));
+
+        result = left;
+        math::inplace_vector_op(math::AddToOp(), n, result.data(), right.data());
+        for(std::size_t i = 0ul; i < n; ++i)
+          BOOST_CHECK_EQUAL(result[i], left[i] + right[i]);
+
+        result = left;
+        math::inplace_vector_op(math::SubtToOp(), n, result.data(), right.data());
+        for(std::size_t i = 0ul; i < n; ++i)
+          BOOST_CHECK_EQUAL(result[i], left[i] - right[i]);
+
+        result = left;
+        math::inplace_vector_op(math::MultToOp(), n, result.data(), right.data());
+        for(std::size_t i = 0ul; i < n; ++i)
+          BOOST_CHECK_EQUAL(result[i], left[i] * right[i]);
+
+        result = left;
+        math::inplace_vector_op(math::ScaleToOp<int>(5), n, result.data());
+        for(std::size_t i = 0ul; i < n; ++i)
+          BOOST_CHECK_EQUAL(result[i], left[i] * T(5));
+
+        result = left;
+        math::inplace_vector_op(math::AddToScaleOp<T>(0.5), n, result.data(), right.data());
+        for(std::size_t i = 0ul; i < n; ++i)
+          BOOST_CHECK_EQUAL(result[i], (left[i] + right[i]) * T(0.5));
+      }
+    }
+  }
+
+  // Check the reductions of all instruction sets
+  template <typename T>
+  static void check_reduce_ops() {
+    for(int isa = math::SimdConfig::generic; isa <= math::SimdConfig::supported(); ++isa) {
+      math::SimdConfig::set_isa(math::SimdConfig::Isa(isa));
+
+      for(std::size_t n = 0ul; n < 70ul; n += 7ul) {
+        const std::vector<T> left = make_vector<T>(n);
+        const std::vector<T> right = make_vector<T>(n);
+
+        T sum = 0, squared_norm = 0, dot = 0;
+        for(std::size_t i = 0ul; i < n; ++i) {
+          sum += left[i];
+          squared_norm += left[i] * left[i];
+          dot += left[i] * right[i];
+        }
+
+        // The elements are multiples of 1/8, so the sums are exact
+        T result = 1;
+        math::reduce_op(math::AddToOp(), n, result, left.data());
+        BOOST_CHECK_EQUAL(result, sum + T(1));
+
+        result = 0;
+        math::reduce_op(math::SquareAddOp(), n, result, left.data());
+        BOOST_CHECK_EQUAL(result, squared_norm);
+
+        result = 0;
+        math::reduce_op(math::DotOp(), n, result, left.data(), right.data());
+        BOOST_CHECK_EQUAL(result, dot);
+      }
+    }
+  }
+
+  // Check strided copies of all instruction sets
+  template <typename T>
+  static void check_strided_ops() {
+    for(int isa = math::SimdConfig::generic; isa <= math::SimdConfig::supported(); ++isa) {
+      math::SimdConfig::set_isa(math::SimdConfig::Isa(isa));
+
+      for(std::size_t stride = 1ul; stride < 5ul; ++stride) {
+        for(std::size_t n = 0ul; n < 40ul; n += 13ul) {
+          const std::vector<T> strided = make_vector<T>(n * stride);
+          std::vector<T> result(n);
+
+          math::gather_vector(n, strided.data(), stride, result.data());
+          for(std::size_t i = 0ul; i < n; ++i)
+            BOOST_CHECK_EQUAL(result[i], strided[i * stride]);
+
+          std::vector<T> scattered(n * stride, T(0));
+          math::scatter_vector(n, result.data(), scattered.data(), stride);
+          for(std::size_t i = 0ul; i < scattered.size(); ++i)
+            BOOST_CHECK_EQUAL(scattered[i], (i % stride ? T(0) : strided[i]));
+        }
+      }
+    }
+  }
+
+  math::SimdConfig::Isa isa;
+}; // VectorOpFixture
+
+BOOST_FIXTURE_TEST_SUITE( vector_op_suite, VectorOpFixture )
+
+BOOST_AUTO_TEST_CASE( set_isa )
+{
+  const math::SimdConfig::Isa supported = math::SimdConfig::supported();
+
+  math::SimdConfig::set_isa(math::SimdConfig::generic);
+  BOOST_CHECK_EQUAL(math::SimdConfig::isa(), math::SimdConfig::generic);
+
+  // Check that the instruction set is limited to those of the CPU
+  math::SimdConfig::set_isa(math::SimdConfig::avx512);
+  BOOST_CHECK_EQUAL(math::SimdConfig::isa(), supported);
+}
+
+BOOST_AUTO_TEST_CASE( vector_ops )
+{
+  check_vector_ops<double>();
+  check_vector_ops<float>();
+}
+
+BOOST_AUTO_TEST_CASE( reduce_ops )
+{
+  check_reduce_ops<double>();
+  check_reduce_ops<float>();
+}
+
+BOOST_AUTO_TEST_CASE( strided_ops )
+{
+  check_strided_ops<double>();
+  check_strided_ops<float>();
+  check_strided_ops<int>();
+}
+
+BOOST_AUTO_TEST_CASE( generic_ops )
+{
+  // Operations on elements without vector kernels use the portable loops
+  const std::vector<int> left = make_vector<int>(37ul);
+  const std::vector<int> right = make_vector<int>(37ul);
+  std::vector<int> result(37ul);
+
+  math::vector_op(math::AddOp(), 37ul, result.data(), left.data(), right.data());
+  for(std::size_t i = 0ul; i < result.size(); ++i)
+    BOOST_CHECK_EQUAL(result[i], left[i] + right[i]);
+
+  int dot = 0;
+  math::reduce_op(math::DotOp(), 37ul, dot, left.data(), right.data());
+  int expected = 0;
+  for(std::size_t i = 0ul; i < left.size(); ++i)
+    expected += left[i] * right[i];
+  BOOST_CHECK_EQUAL(dot, expected);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,171 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/numa.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct NumaFixture {
+
+  NumaFixture() : enabled(NumaConfig::enabled()) { }
+
+  ~NumaFixture() {
+    NumaConfig::set_enabled(enabled);
+    TilePool::release();
+  }
+
+  bool enabled;
+}; // NumaFixture
+
+BOOST_FIXTURE_TEST_SUITE( numa_suite, NumaFixture )
+
+BOOST_AUTO_TEST_CASE( parse_id_list )
+{
+  const std::vector<std::size_t> ids = detail::parse_id_list("0-3,8,10-11");
+  const std::vector<std::size_t> expected = {0, 1, 2, 3, 8, 10, 11};
+  BOOST_CHECK_EQUAL_COLLECTIONS(ids.begin(), ids.end(), expected.begin(), expected.end());
+
+  BOOST_CHECK(detail::parse_id_list("").empty());
+  BOOST_CHECK_EQUAL(detail::parse_id_list("5\n").size(), 1ul);
+}
+
+BOOST_AUTO_TEST_CASE( topology )
+{
+  BOOST_CHECK_GE(NumaConfig::nodes(), 1ul);
+  BOOST_CHECK_LT(NumaConfig::node(), NumaConfig::nodes());
+  BOOST_CHECK_EQUAL(NumaConfig::counters().size(), NumaConfig::nodes());
+
+  // Touched memory is on one of the nodes, or its node is not known
+  std::vector<double> data(1024ul, 1.0);
+  BOOST_CHECK_LE(NumaConfig::node_of(data.data()), NumaConfig::nodes());
+}
+
+BOOST_AUTO_TEST_CASE( enabled )
+{
+  // Placement is opt-in, since it adds a system call to large pooled frees
+  NumaConfig::set_enabled(false);
+  BOOST_CHECK(! NumaConfig::enabled());
+  NumaConfig::set_enabled(true);
+  BOOST_CHECK(NumaConfig::enabled());
+}
+
+BOOST_AUTO_TEST_CASE( pool )
+{
+  NumaConfig::set_enabled(true);
+  TilePool::release();
+  TilePool::reset_stats();
+
+  // Blocks that are freed on the node of their pages stay in the thread
+  // cache, and other blocks are returned to the cache of their node
+  PoolAllocator<double> alloc;
+  const std::size_t n = TilePool::numa_block_size;
+  double* const p = alloc.allocate(n);
+  std::fill_n(p, n, 1.0);
+  const std::size_t block_node = NumaConfig::node_of(p);
+  const std::size_t node = NumaConfig::node();
+  alloc.deallocate(p, n);
+  double* const q = alloc.allocate(n);
+  alloc.deallocate(q, n);
+
+  if((NumaConfig::nodes() == 1ul) || (block_node == node)) {
+    BOOST_CHECK_EQUAL(q, p);
+    BOOST_CHECK_EQUAL(TilePool::remote_frees(), 0ul);
+  } else if(block_node < NumaConfig::nodes()) {
+    BOOST_CHECK_NE(q, p);
+    BOOST_CHECK_GE(TilePool::remote_frees(), 1ul);
+  }
+  BOOST_CHECK_EQUAL(TilePool::allocations(), 2ul);
+
+  // Check that the pages of a block that is first touched by this thread
+  // are placed on its node
+  if(NumaConfig::nodes() > 1ul) {
+    double* const r = alloc.allocate(n);
+    std::fill_n(r, n, 1.0);
+    const std::size_t r_node = NumaConfig::node_of(r);
+    if(r_node < NumaConfig::nodes())
+      BOOST_CHECK_EQUAL(r_node, NumaConfig::node());
+    alloc.deallocate(r, n);
+  }
+}
+
+#if 0
+// This test case is used to measure remote memory traffic of tiles that are
+// produced and consumed by task threads, with and without NUMA placement.
+// Both modes use the same producer tasks, so only the pool placement
+// differs. It should only be enabled on multi-socket nodes, and human eyes
+// are examining the output. Run it with MAD_BIND set, so task threads do not
+// migrate between nodes.
+
+BOOST_AUTO_TEST_CASE( benchmark )
+{
+  typedef Tensor<double, PoolAllocator<double> > TensorP;
+  World& world = *GlobalFixture::world;
+  const Range range(256, 256);
+  const std::size_t ntiles = 512ul;
+  const int repeat = 10;
+
+  for(int numa = 0; numa < 2; ++numa) {
+    NumaConfig::set_enabled(numa);
+    TilePool::release();
+    TilePool::reset_stats();
+    std::atomic<std::size_t> remote_tiles(0ul);
+
+    const std::vector<NumaCounters> start_counters = NumaConfig::counters();
+    const double start = madness::wall_time();
+    for(int r = 0; r < repeat; ++r) {
+      std::vector<Future<TensorP> > tiles;
+      tiles.reserve(ntiles);
+      for(std::size_t i = 0ul; i < ntiles; ++i)
+        tiles.push_back(world.taskq.add([range] () { return TensorP(range, 1.0); }));
+
+      std::vector<Future<double> > sums;
+      sums.reserve(ntiles);
+      for(std::size_t i = 0ul; i < ntiles; ++i)
+        sums.push_back(world.taskq.add([&remote_tiles] (const TensorP& tile) {
+          if(NumaConfig::node_of(tile.data()) != NumaConfig::node())
+            ++remote_tiles;
+          return tile.scale(2.0).sum();
+        }, tiles[i]));
+
+      for(std::size_t i = 0ul; i < ntiles; ++i)
+        BOOST_CHECK_EQUAL(sums[i].get(), 2.0 * double(range.volume()));
+    }
+    const double time = madness::wall_time() - start;
+    const std::vector<NumaCounters> finish_counters = NumaConfig::counters();
+
+    std::cout << "NUMA placement: " << (numa ? "on" : "off")
+              << "\nThreads: " << madness::ThreadPool::size() + 1
+              << "\nTime: " << time << " s"
+              << "\nRemote tiles: " << remote_tiles << " of " << ntiles * repeat
+              << "\nPool hit rate: " << TilePool::hit_rate()
+              << "\nPool remote frees: " << TilePool::remote_frees() << "\n";
+    for(std::size_t node = 0ul; node < finish_counters.size(); ++node) {
+      const NumaCounters counters = finish_counters[node] - start_counters[node];
+      std::cout << "Node " << node << ": local_node = " << counters.local_node
+                << " other_node = " << counters.other_node
+                << " numa_miss = " << counters.numa_miss
+                << " numa_foreign = " << counters.numa_foreign << "\n";
+    }
+  }
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
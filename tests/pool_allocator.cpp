@@ -0,0 +1,150 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/tensor/pool_allocator.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct PoolAllocatorFixture {
+
+  PoolAllocatorFixture() { TilePool::reset_stats(); }
+
+  ~PoolAllocatorFixture() {
+    TilePool::set_huge_pages(false);
+    TilePool::release();
+  }
+
+}; // PoolAllocatorFixture
+
+BOOST_FIXTURE_TEST_SUITE( pool_allocator_suite, PoolAllocatorFixture )
+
+BOOST_AUTO_TEST_CASE( size_class )
+{
+  // Local copies, so the checks do not odr-use the static members
+  const std::size_t classes = TilePool::classes;
+  const std::size_t max_block_size = TilePool::max_block_size;
+
+  // Check that blocks fit the requested size with at most 25% overhead
+  for(std::size_t size = 1ul; size <= (1ul << 20); size += (size / 7ul) + 1ul) {
+    const std::size_t c = TilePool::size_class(size);
+    BOOST_CHECK_LT(c, classes);
+    BOOST_CHECK_GE(TilePool::class_size(c), size);
+    if(size > TilePool::min_block_size)
+      BOOST_CHECK_LE(TilePool::class_size(c), size + size / 4ul);
+    if(c > 0ul)
+      BOOST_CHECK_LT(TilePool::class_size(c - 1ul), size);
+  }
+
+  BOOST_CHECK_EQUAL(TilePool::size_class(max_block_size), classes - 1ul);
+  BOOST_CHECK_EQUAL(TilePool::class_size(classes - 1ul), max_block_size);
+}
+
+BOOST_AUTO_TEST_CASE( allocate )
+{
+  PoolAllocator<double> alloc;
+  BOOST_CHECK(alloc.allocate(0ul) == nullptr);
+  BOOST_CHECK_NO_THROW(alloc.deallocate(nullptr, 0ul));
+
+  double* const p = alloc.allocate(100ul);
+  BOOST_CHECK(p != nullptr);
+  BOOST_CHECK_EQUAL(reinterpret_cast<std::size_t>(p) % TilePool::min_block_size, 0ul);
+  for(std::size_t i = 0ul; i < 100ul; ++i)
+    p[i] = double(i);
+  alloc.deallocate(p, 100ul);
+
+  // Allocations of the same size class reuse the block
+  double* const q = alloc.allocate(99ul);
+  BOOST_CHECK_EQUAL(q, p);
+  alloc.deallocate(q, 99ul);
+
+  BOOST_CHECK_EQUAL(TilePool::allocations(), 2ul);
+  BOOST_CHECK_GE(TilePool::thread_hits(), 1ul);
+  BOOST_CHECK_EQUAL(TilePool::hits(), TilePool::thread_hits());
+  BOOST_CHECK_GE(TilePool::hit_rate(), 0.5);
+
+  // Allocators of different types are interchangeable
+  PoolAllocator<float> float_alloc(alloc);
+  BOOST_CHECK(float_alloc == alloc);
+  BOOST_CHECK(! (float_alloc != alloc));
+}
+
+BOOST_AUTO_TEST_CASE( shared_cache )
+{
+  const std::size_t limit = TilePool::thread_cache_limit();
+  TilePool::set_thread_cache_limit(0ul);
+
+  // Blocks move to the shared cache when the thread cache is full
+  PoolAllocator<int> alloc;
+  int* const p = alloc.allocate(1000ul);
+  alloc.deallocate(p, 1000ul);
+  int* const q = alloc.allocate(1000ul);
+  BOOST_CHECK_EQUAL(q, p);
+  BOOST_CHECK_EQUAL(TilePool::shared_hits(), 1ul);
+
+  // Blocks that do not fit in the shared cache are freed
+  TilePool::release();
+  const std::size_t cache_limit = TilePool::cache_limit();
+  TilePool::set_cache_limit(0ul);
+  alloc.deallocate(q, 1000ul);
+  BOOST_CHECK_EQUAL(TilePool::system_frees(), 1ul);
+
+  TilePool::set_cache_limit(cache_limit);
+  TilePool::set_thread_cache_limit(limit);
+}
+
+BOOST_AUTO_TEST_CASE( huge_pages )
+{
+  TilePool::set_huge_pages(true);
+  BOOST_CHECK(TilePool::huge_pages());
+
+  PoolAllocator<double> alloc;
+  const std::size_t n = TilePool::huge_page_size / sizeof(double);
+  double* const p = alloc.allocate(n);
+  BOOST_CHECK_EQUAL(reinterpret_cast<std::size_t>(p) % TilePool::huge_page_size, 0ul);
+  p[0] = 1.0;
+  p[n - 1ul] = 2.0;
+  alloc.deallocate(p, n);
+}
+
+BOOST_AUTO_TEST_CASE( tensor )
+{
+  typedef Tensor<double, PoolAllocator<double> > TensorP;
+
+  const Range range(7, 11, 13);
+  TensorP a(range);
+  for(std::size_t i = 0ul; i < range.volume(); ++i)
+    a[i] = double(i);
+  TensorP b = a.scale(2.0);
+  TensorP c = a.add(b);
+  for(std::size_t i = 0ul; i < range.volume(); ++i)
+    BOOST_CHECK_EQUAL(c[i], 3.0 * double(i));
+
+  // Temporary tensors of the same size reuse their storage
+  TilePool::reset_stats();
+  for(int i = 0; i < 10; ++i) {
+    TensorP d = a.add(b);
+    BOOST_CHECK_EQUAL(d[range.volume() - 1ul], c[range.volume() - 1ul]);
+  }
+  BOOST_CHECK_EQUAL(TilePool::allocations(), 10ul);
+  BOOST_CHECK_GE(TilePool::hits(), 9ul);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -36,6 +36,12 @@ struct ProcGridFixture {
 
   ~ProcGridFixture() { }
 
+  // Shape of a block diagonal matrix with n x n tiles
+  struct DiagonalShape {
+    std::size_t n;
+    bool is_zero(const std::size_t i) const { return (i / n) != (i % n); }
+  }; // struct DiagonalShape
+
 }; // Fixture
 
 BOOST_FIXTURE_TEST_SUITE( proc_grid_suite, ProcGridFixture )
@@ -154,6 +160,136 @@ BOOST_AUTO_TEST_CASE( random_constructor_test )
   }
 }
 
+BOOST_AUTO_TEST_CASE( layered_constructor_test )
+{
+  GlobalFixture::world->srand(time(NULL));
+
+  for(int test = 0; test < 100; ++test) {
+
+    // Generate random process and matrix sizes
+    const ProcessID nprocs = GlobalFixture::world->rand() % 4095 + 1;
+    const std::size_t layers = GlobalFixture::world->rand() % std::min(nprocs, 16) + 1;
+    const std::size_t rows = GlobalFixture::world->rand() % 1023 + 1;
+    const std::size_t cols = GlobalFixture::world->rand() % 1023 + 1;
+    const std::size_t row_size = rows * ((GlobalFixture::world->rand() % 511) + 1);
+    const std::size_t col_size = cols * ((GlobalFixture::world->rand() % 512) + 1);
+    const std::size_t layer_stride = nprocs / layers;
+
+    // Construct a process grid for a single layer
+    TiledArray::detail::ProcGrid layer_grid(*GlobalFixture::world, 0, layer_stride,
+        rows, cols, row_size, col_size);
+
+    // Check a sample of ranks in the layered process grid
+    for(ProcessID rank = 0; rank < nprocs; rank += 1 + nprocs / 64) {
+      TiledArray::detail::ProcGrid proc_grid(*GlobalFixture::world, rank, nprocs,
+          rows, cols, row_size, col_size, layers);
+
+      // Check that each layer has the same dimensions as a single layer grid
+      BOOST_CHECK_EQUAL(proc_grid.proc_layers(), layers);
+      BOOST_CHECK_EQUAL(proc_grid.proc_rows(), layer_grid.proc_rows());
+      BOOST_CHECK_EQUAL(proc_grid.proc_cols(), layer_grid.proc_cols());
+      BOOST_CHECK_EQUAL(proc_grid.proc_size(), layer_grid.proc_size());
+
+      const std::size_t rank_layer = rank / layer_stride;
+      const std::size_t layer_rank = rank % layer_stride;
+      if((rank_layer < layers) && (layer_rank < layer_grid.proc_size())) {
+        // Check process grid rank
+        BOOST_CHECK_EQUAL(proc_grid.rank_layer(), rank_layer);
+        BOOST_CHECK_EQUAL(proc_grid.rank_row(), ProcessID(layer_rank / layer_grid.proc_cols()));
+        BOOST_CHECK_EQUAL(proc_grid.rank_col(), ProcessID(layer_rank % layer_grid.proc_cols()));
+        BOOST_CHECK_GT(proc_grid.local_size(), 0ul);
+
+        // Check that process mapping stays in this layer or column
+        BOOST_CHECK_EQUAL(proc_grid.map_layer(rank_layer), rank);
+        BOOST_CHECK_EQUAL(proc_grid.map_row(proc_grid.rank_row()), rank);
+        BOOST_CHECK_EQUAL(proc_grid.map_col(proc_grid.rank_col()), rank);
+        BOOST_CHECK_EQUAL(proc_grid.map_layer(0) % layer_stride, layer_rank);
+      } else {
+        // Check processes not included in the process grid
+        BOOST_CHECK_EQUAL(proc_grid.rank_row(), -1);
+        BOOST_CHECK_EQUAL(proc_grid.rank_col(), -1);
+        BOOST_CHECK_EQUAL(proc_grid.local_size(), 0ul);
+      }
+    }
+
+    // Check that the layer slices cover the inner dimension
+    TiledArray::detail::ProcGrid proc_grid0(*GlobalFixture::world, 0, nprocs,
+        rows, cols, row_size, col_size, layers);
+    const std::size_t k = layers + GlobalFixture::world->rand() % 100;
+    BOOST_CHECK_EQUAL(proc_grid0.layer_begin(k, 0), 0ul);
+    BOOST_CHECK_EQUAL(proc_grid0.layer_begin(k, layers), k);
+    for(std::size_t layer = 0ul; layer < layers; ++layer)
+      BOOST_CHECK_LT(proc_grid0.layer_begin(k, layer), proc_grid0.layer_begin(k, layer + 1ul));
+  }
+}
+
+BOOST_AUTO_TEST_CASE( sparse_constructor_test )
+{
+  const std::size_t n = 16ul, size = n * 10ul;
+  const DiagonalShape shape = { n };
+  const ProcessID nprocs = 4;
+
+  // Check that the dense process grid leaves processes without work
+  TiledArray::detail::ProcGrid dense_grid(*GlobalFixture::world, 0, nprocs,
+      n, n, size, size);
+  BOOST_CHECK_EQUAL(dense_grid.proc_rows(), 2ul);
+  BOOST_CHECK_EQUAL(dense_grid.proc_cols(), 2ul);
+
+  for(ProcessID rank = 0; rank < nprocs; ++rank) {
+    TiledArray::detail::ProcGrid proc_grid(*GlobalFixture::world, rank, nprocs,
+        n, n, size, size, n, size, shape, shape);
+
+    // The diagonal result tiles are evenly distributed by a 1D process grid
+    BOOST_CHECK_EQUAL(proc_grid.proc_size(), std::size_t(nprocs));
+    BOOST_CHECK((proc_grid.proc_rows() == 1ul) || (proc_grid.proc_cols() == 1ul));
+
+    std::size_t diagonal_tiles = 0ul;
+    for(std::size_t i = 0ul; i < n; ++i)
+      if((proc_grid.rank_row() == ProcessID(i % proc_grid.proc_rows())) &&
+          (proc_grid.rank_col() == ProcessID(i % proc_grid.proc_cols())))
+        ++diagonal_tiles;
+    BOOST_CHECK_EQUAL(diagonal_tiles, n / nprocs);
+  }
+
+  // Check that the sparse process grid is layered in the same way
+  TiledArray::detail::ProcGrid layered_grid(*GlobalFixture::world, 0, 8,
+      n, n, size, size, n, size, shape, shape, 2ul);
+  BOOST_CHECK_EQUAL(layered_grid.proc_layers(), 2ul);
+  BOOST_CHECK_EQUAL(layered_grid.proc_size(), 4ul);
+}
+
+BOOST_AUTO_TEST_CASE( shift_test )
+{
+  const std::size_t n = 2ul, size = n * 10ul;
+  const ProcessID nprocs = 8;
+
+  for(std::size_t offset = 0ul; offset < 12ul; offset += 3ul) {
+    for(ProcessID rank = 0; rank < nprocs; ++rank) {
+      // The shifted grid of this rank matches the grid of the process that is
+      // shifted onto this rank
+      const ProcessID grid_rank = (rank + nprocs - (offset % nprocs)) % nprocs;
+      TiledArray::detail::ProcGrid proc_grid = TiledArray::detail::ProcGrid(
+          *GlobalFixture::world, rank, nprocs, n, n, size, size).shift(offset);
+      TiledArray::detail::ProcGrid unshifted_grid(*GlobalFixture::world,
+          grid_rank, nprocs, n, n, size, size);
+
+      BOOST_CHECK_EQUAL(proc_grid.proc_offset(), offset % nprocs);
+      BOOST_CHECK_EQUAL(proc_grid.proc_span(), 4ul);
+      BOOST_CHECK_EQUAL(proc_grid.rank_row(), unshifted_grid.rank_row());
+      BOOST_CHECK_EQUAL(proc_grid.rank_col(), unshifted_grid.rank_col());
+      BOOST_CHECK_EQUAL(proc_grid.local_size(), unshifted_grid.local_size());
+
+      // Check that process mapping is shifted
+      if(proc_grid.local_size() != 0ul) {
+        BOOST_CHECK_EQUAL(proc_grid.map_row(proc_grid.rank_row()), rank);
+        BOOST_CHECK_EQUAL(proc_grid.map_col(proc_grid.rank_col()), rank);
+        BOOST_CHECK_EQUAL(proc_grid.map_row(0),
+            (unshifted_grid.map_row(0) + ProcessID(offset)) % nprocs);
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE( make_groups )
 {
   madness::DistributedID did_row(madness::uniqueidT(), 0);
@@ -364,4 +364,36 @@ BOOST_AUTO_TEST_CASE( swap )
   BOOST_CHECK_EQUAL(r.volume(), volume);
 }
 
+BOOST_AUTO_TEST_CASE( inline_storage )
+{
+  // Check copy, move, and swap of ranges with inline and heap storage
+  for(unsigned int rank = 1u; rank <= Range::inline_rank + 2u; ++rank) {
+    const std::vector<std::size_t> lower(rank, 1ul), upper(rank, 3ul);
+    const Range range(lower, upper);
+
+    Range copy(range);
+    BOOST_CHECK_EQUAL(copy, range);
+    BOOST_CHECK(copy.lobound_data() != range.lobound_data());
+
+    Range moved(std::move(copy));
+    BOOST_CHECK_EQUAL(moved, range);
+    BOOST_CHECK_EQUAL(copy.rank(), 0u);
+    BOOST_CHECK(copy.lobound_data() == nullptr);
+
+    Range assigned(2ul, 2ul);
+    assigned = std::move(moved);
+    BOOST_CHECK_EQUAL(assigned, range);
+    BOOST_CHECK_EQUAL(moved.rank(), 0u);
+
+    moved = assigned;
+    BOOST_CHECK_EQUAL(moved, range);
+
+    Range other(4ul, 5ul, 6ul);
+    const Range other_copy(other);
+    other.swap(moved);
+    BOOST_CHECK_EQUAL(other, range);
+    BOOST_CHECK_EQUAL(moved, other_copy);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -20,6 +20,8 @@
 #include "TiledArray/reduce_task.h"
 #include "unit_test_config.h"
 #include <functional>
+#include <memory>
+#include <atomic>
 
 using namespace TiledArray;
 using namespace TiledArray::detail;
@@ -77,8 +79,44 @@ struct ReduceOp {
   {
     result += first1 * second1 + first2 * second2;
   }
+
+  void reset(result_type& result) const { result = result_type(); }
 }; // struct ReduceOp
 
+// Reduction operation on shared integers, where results are reset in place.
+// It counts the resets of the result object that shares its storage with
+// the seed.
+struct SharedReduceOp {
+  typedef std::shared_ptr<int> result_type;
+  typedef int first_argument_type;
+  typedef int second_argument_type;
+
+  SharedReduceOp(const int* seed, std::atomic<int>* seed_resets) :
+    seed_(seed), seed_resets_(seed_resets)
+  { }
+
+  result_type operator()() const { return std::make_shared<int>(0); }
+
+  result_type operator()(const result_type temp) const { return temp; }
+
+  void operator()(result_type& result, const result_type& arg) const {
+    *result += *arg;
+  }
+
+  void operator()(result_type& result, const first_argument_type& first, const second_argument_type& second) const {
+    *result += first * second;
+  }
+
+  void reset(result_type& result) const {
+    if(result.get() == seed_)
+      ++(*seed_resets_);
+    *result = 0;
+  }
+
+  const int* seed_;
+  std::atomic<int>* seed_resets_;
+}; // struct SharedReduceOp
+
 struct ReducePairTaskFixture {
 
   ReducePairTaskFixture() : world(*GlobalFixture::world), rt(world, ReduceOp()) {
@@ -90,6 +128,9 @@ struct ReducePairTaskFixture {
 
 }; // struct ReducePairTaskFixture
 
+// Task function that produces a reduction argument
+int make_argument(const int i) { return i; }
+
 BOOST_FIXTURE_TEST_SUITE( reduce_task_suite, ReduceTaskFixture )
 
 BOOST_AUTO_TEST_CASE( reduce_value )
@@ -228,4 +269,114 @@ BOOST_AUTO_TEST_CASE( reduce_zero )
   BOOST_CHECK_EQUAL(result.get(), 0);
 }
 
+BOOST_AUTO_TEST_CASE( reduce_seed )
+{
+  Future<int> seed;
+  BOOST_CHECK_EQUAL(rt.count(), 0);
+  rt.seed(seed);
+  BOOST_CHECK_EQUAL(rt.count(), 1);
+
+  int sum = 42;
+  for(int i = 0; i < 10; ++i) {
+    sum += i * i;
+    rt.add(i, i);
+  }
+  BOOST_CHECK_EQUAL(rt.count(), 11);
+
+  Future<int> result = rt.submit();
+
+  // The result is not ready until the seed is set
+  BOOST_CHECK(!(result.probe()));
+  seed.set(42);
+
+  BOOST_CHECK_EQUAL(result.get(), sum);
+}
+
+BOOST_AUTO_TEST_CASE( reduce_seed_recycle )
+{
+  // The seed shares its storage with the target, as when the result of a
+  // contraction is added to an existing tile, so the storage of the seed must
+  // not be reset and reused for other results.
+  std::shared_ptr<int> target = std::make_shared<int>(42);
+  std::atomic<int> seed_resets(0);
+  ReducePairTask<SharedReduceOp> task(world,
+      SharedReduceOp(target.get(), &seed_resets));
+  task.seed(Future<std::shared_ptr<int> >(target));
+
+  // Add arguments that are paired with each other, which releases results
+  // for recycling
+  int sum = 42;
+  for(int i = 0; i < 100; ++i) {
+    sum += i * i;
+    task.add(i, i);
+  }
+
+  Future<std::shared_ptr<int> > result = task.submit();
+
+  BOOST_CHECK_EQUAL(*result.get(), sum);
+  BOOST_CHECK_EQUAL(seed_resets.load(), 0);
+}
+
+BOOST_AUTO_TEST_CASE( destroy )
+{
+  BOOST_CHECK_EQUAL(rt.count(), 0);
+  BOOST_REQUIRE_NO_THROW(rt.destroy());
+  BOOST_CHECK(! rt);
+}
+
+BOOST_AUTO_TEST_CASE( reduce_concurrent )
+{
+  // The arguments are produced by tasks, so they become ready concurrently
+  // on all task threads.
+  int sum = 0;
+  for(int i = 0; i < 1000; ++i) {
+    sum += i * i;
+    Future<int> f = world.taskq.add(& make_argument, i);
+    rt.add(f, f);
+  }
+
+  Future<int> result = rt.submit();
+
+  BOOST_CHECK_EQUAL(result.get(), sum);
+}
+
+#ifdef TILEDARRAY_ENABLE_BENCHMARKS
+// This test case is used to measure the throughput of a single reduction
+// that is fed by all task threads (e.g. a result tile of a contraction with
+// a small M x N and a large K). It is only built when TA_BUILD_BENCHMARKS is
+// enabled, and human eyes should be examining the output. Run it with
+// MAD_NUM_THREADS set to the thread counts of interest (e.g. 8, 32, and 64).
+
+BOOST_AUTO_TEST_CASE( benchmark )
+{
+  const int n = 1000000;
+  const int repeat = 5;
+
+  int sum = 0;
+  for(int i = 0; i < n; ++i)
+    sum += (i % 16) * (i % 16);
+
+  double total_time = 0.0;
+  for(int r = 0; r < repeat; ++r) {
+    ReducePairTask<ReduceOp> task(world, ReduceOp());
+
+    const double start = madness::wall_time();
+    for(int i = 0; i < n; ++i) {
+      Future<int> f = world.taskq.add(& make_argument, i % 16);
+      task.add(f, f);
+    }
+    const int result = task.submit().get();
+    total_time += madness::wall_time() - start;
+
+    BOOST_CHECK_EQUAL(result, sum);
+  }
+
+  rt.destroy();
+
+  std::cout << "Threads: " << madness::ThreadPool::size() + 1
+            << "\nAverage reduction time: " << total_time / double(repeat)
+            << " s (" << double(n * repeat) / total_time << " pairs/s)\n";
+}
+#endif // TILEDARRAY_ENABLE_BENCHMARKS
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,104 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2015  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/runtime_config.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct RuntimeConfigFixture {
+
+  RuntimeConfigFixture() :
+    memory_limit(SummaConfig::memory_limit()),
+    sparse_grid(SummaConfig::sparse_grid()),
+    flops_per_element(SummaConfig::grid_flops_per_element()),
+    latency(SummaConfig::grid_latency()),
+    plan_cache_capacity(expressions::ContPlanCache::capacity()),
+    fusion_extent(expressions::TileFusion::extent()),
+    gemm_threshold(math::GemmParallelConfig::threshold()),
+    tensor_threshold(TensorParallelConfig::threshold())
+  { }
+
+  ~RuntimeConfigFixture() {
+    SummaConfig::set_memory_limit(memory_limit);
+    SummaConfig::set_sparse_grid(sparse_grid);
+    SummaConfig::set_grid_cost(flops_per_element, latency);
+    expressions::ContPlanCache::set_capacity(plan_cache_capacity);
+    expressions::TileFusion::enable(fusion_extent);
+    math::GemmParallelConfig::set_threshold(gemm_threshold);
+    TensorParallelConfig::set_threshold(tensor_threshold);
+  }
+
+  std::size_t memory_limit;
+  bool sparse_grid;
+  double flops_per_element;
+  double latency;
+  std::size_t plan_cache_capacity;
+  std::size_t fusion_extent;
+  std::size_t gemm_threshold;
+  std::size_t tensor_threshold;
+}; // RuntimeConfigFixture
+
+BOOST_FIXTURE_TEST_SUITE( runtime_config_suite, RuntimeConfigFixture )
+
+BOOST_AUTO_TEST_CASE( settings )
+{
+  // Check that settings are forwarded to the classes that hold them
+  RuntimeConfig::set_memory_limit(1ul << 20);
+  BOOST_CHECK_EQUAL(SummaConfig::memory_limit(), 1ul << 20);
+  BOOST_CHECK_EQUAL(RuntimeConfig::memory_limit(), 1ul << 20);
+
+  RuntimeConfig::set_sparse_grid(true);
+  RuntimeConfig::set_grid_cost(32.0, 512.0);
+  BOOST_CHECK(SummaConfig::sparse_grid());
+  BOOST_CHECK_EQUAL(SummaConfig::grid_flops_per_element(), 32.0);
+  BOOST_CHECK_EQUAL(SummaConfig::grid_latency(), 512.0);
+
+  RuntimeConfig::set_plan_cache_capacity(8ul);
+  BOOST_CHECK_EQUAL(expressions::ContPlanCache::capacity(), 8ul);
+
+  RuntimeConfig::set_fusion_extent(32ul);
+  BOOST_CHECK(expressions::TileFusion::enabled());
+  BOOST_CHECK_EQUAL(RuntimeConfig::fusion_extent(), 32ul);
+  RuntimeConfig::set_fusion_extent(0ul);
+  BOOST_CHECK(! expressions::TileFusion::enabled());
+
+  RuntimeConfig::set_gemm_threshold(1000ul);
+  BOOST_CHECK_EQUAL(math::GemmParallelConfig::threshold(), 1000ul);
+
+  RuntimeConfig::set_tensor_threshold(1000ul);
+  BOOST_CHECK_EQUAL(TensorParallelConfig::threshold(), 1000ul);
+
+  // Check that settings made through the subsystem classes are visible
+  SummaConfig::set_memory_limit(0ul);
+  BOOST_CHECK_EQUAL(RuntimeConfig::memory_limit(), 0ul);
+}
+
+BOOST_AUTO_TEST_CASE( counters )
+{
+  BOOST_CHECK_EQUAL(RuntimeConfig::skipped_contractions(), SummaConfig::skipped_contractions());
+  BOOST_CHECK_EQUAL(RuntimeConfig::bcast_bytes(), SummaConfig::bcast_bytes());
+  BOOST_CHECK_EQUAL(RuntimeConfig::plan_cache_hits(), expressions::ContPlanCache::hits());
+  BOOST_CHECK_EQUAL(RuntimeConfig::fusions(), expressions::TileFusion::fusions());
+  BOOST_CHECK_EQUAL(RuntimeConfig::parallel_gemms(), math::GemmParallelConfig::parallel_gemms());
+  BOOST_CHECK_EQUAL(RuntimeConfig::parallel_ops(), TensorParallelConfig::parallel_ops());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -181,6 +181,25 @@ BOOST_AUTO_TEST_CASE( copy_constructor )
   BOOST_CHECK_EQUAL(y.sparsity(), sparse_shape.sparsity());
 }
 
+BOOST_AUTO_TEST_CASE( fingerprint )
+{
+  // Shapes with the same zero tile pattern have the same fingerprint
+  const SparseShape<float> y(sparse_shape);
+  BOOST_CHECK_EQUAL(y.fingerprint(), sparse_shape.fingerprint());
+  BOOST_CHECK_EQUAL(sparse_shape.scale(1).fingerprint(), sparse_shape.fingerprint());
+
+  // Shapes with different zero tile patterns have different fingerprints
+  BOOST_CHECK_NE(left.fingerprint(), right.fingerprint());
+
+  // The fingerprint follows the threshold
+  const float threshold = SparseShape<float>::threshold();
+  const std::size_t fingerprint = sparse_shape.fingerprint();
+  SparseShape<float>::threshold(std::numeric_limits<float>::max());
+  BOOST_CHECK_NE(sparse_shape.fingerprint(), fingerprint);
+  SparseShape<float>::threshold(threshold);
+  BOOST_CHECK_EQUAL(sparse_shape.fingerprint(), fingerprint);
+}
+
 BOOST_AUTO_TEST_CASE( permute )
 {
   SparseShape<float> result;
@@ -194,6 +213,54 @@ BOOST_AUTO_TEST_CASE( permute )
   BOOST_CHECK_EQUAL(result.sparsity(), sparse_shape.sparsity());
 }
 
+BOOST_AUTO_TEST_CASE( fuse )
+{
+  // Fuse pairs of adjacent tiles in each dimension
+  std::vector<TiledRange1> fused_ranges;
+  for(unsigned int d = 0u; d < tr.tiles().rank(); ++d) {
+    std::vector<std::size_t> boundaries;
+    std::size_t i = 0ul;
+    for(auto it = tr.data()[d].begin(); it != tr.data()[d].end(); ++it, ++i)
+      if((i % 2ul) == 0ul)
+        boundaries.push_back(it->first);
+    boundaries.push_back(tr.data()[d].elements().second);
+    fused_ranges.push_back(TiledRange1(boundaries.begin(), boundaries.end()));
+  }
+  const TiledRange fused_tr(fused_ranges.begin(), fused_ranges.end());
+
+  SparseShape<float> result;
+  BOOST_REQUIRE_NO_THROW(result = sparse_shape.fuse(tr, fused_tr));
+  BOOST_CHECK_EQUAL(result.data().range(), fused_tr.tiles());
+
+  // Compute the expected norms of the fused tiles
+  std::vector<float> norms(fused_tr.tiles().volume(), 0.0f);
+  std::vector<bool> non_zero(norms.size(), false);
+  for(std::size_t i = 0ul; i < tr.tiles().volume(); ++i) {
+    if(sparse_shape.is_zero(i)) continue;
+    const Range range = tr.make_tile_range(i);
+    const std::size_t f = fused_tr.tiles().ordinal(
+        fused_tr.element_to_tile(range.lobound()));
+    const float norm = sparse_shape[i] * float(range.volume());
+    norms[f] += norm * norm;
+    non_zero[f] = true;
+  }
+
+  // Check that the fused tiles are zero only if all of their tiles are zero
+  std::size_t zero_tile_count = 0ul;
+  for(std::size_t f = 0ul; f < norms.size(); ++f) {
+    BOOST_CHECK_EQUAL(result.is_zero(f), ! non_zero[f]);
+    if(non_zero[f]) {
+      const float norm = std::sqrt(norms[f]) / float(fused_tr.make_tile_range(f).volume());
+      BOOST_CHECK_CLOSE(result[f], std::max(norm, SparseShape<float>::threshold()), tolerance);
+    } else {
+      BOOST_CHECK_EQUAL(result[f], 0.0f);
+      ++zero_tile_count;
+    }
+  }
+
+  BOOST_CHECK_CLOSE(result.sparsity(), float(zero_tile_count) / float(norms.size()), tolerance);
+}
+
 BOOST_AUTO_TEST_CASE( block )
 {
   auto less = std::less<std::size_t>();
@@ -1108,4 +1175,60 @@ BOOST_AUTO_TEST_CASE( gemm_perm )
   BOOST_CHECK_CLOSE(result.sparsity(), float(zero_tile_count) / float(tr.tiles().volume()), tolerance);
 }
 
+BOOST_AUTO_TEST_CASE( gemm_batch )
+{
+  // The leading dimension is a batch dimension
+  const std::size_t B = tr.tiles().extent_data()[0];
+  const std::size_t M = tr.tiles().extent_data()[1];
+  const std::size_t K = tr.tiles().extent_data()[2];
+  const std::size_t N = tr.tiles().extent_data()[1];
+
+  size_type zero_tile_count = 0ul;
+
+  // Evaluate the batched contraction of sparse shapes, i.e. the result
+  // r(b,i,j) = left(b,i,k) * right(b,k,j)
+  math::GemmHelper gemm_helper(madness::cblas::NoTrans, madness::cblas::NoTrans,
+      3u, 3u, 3u, 1u);
+  SparseShape<float> result;
+  BOOST_REQUIRE_NO_THROW(result = left.gemm(right, -7.2, gemm_helper));
+
+  // Check that the result is correct
+  std::array<std::size_t, 3> i = {{ 0, 0, 0 }};
+  for(i[0] = 0ul; i[0] < B; ++i[0]) {
+    const TiledRange1::range_type r_0 = tr.data()[0].tile(i[0]);
+    const float size_0 = r_0.second - r_0.first;
+
+    for(i[1] = 0ul; i[1] < M; ++i[1]) {
+      for(i[2] = 0ul; i[2] < N; ++i[2]) {
+
+        // Compute expected value, where the norms of the batch tile are
+        // scaled by the batch tile volume
+        double expected = 0.0;
+        for(std::size_t k = 0ul; k < K; ++k) {
+          const TiledRange1::range_type r_k = tr.data()[2].tile(k);
+          const double size_k = r_k.second - r_k.first;
+          const std::array<std::size_t, 3> l = {{ i[0], i[1], k }};
+          const std::array<std::size_t, 3> r = {{ i[0], k, i[2] }};
+          expected += left.data()[l] * right.data()[r] * size_k * size_k;
+        }
+        expected *= 7.2 * size_0;
+        if(expected < SparseShape<float>::threshold())
+          expected = 0.0;
+
+        BOOST_CHECK_CLOSE(double(result[i]), expected, tolerance * 10.0);
+
+        // Check zero threshold
+        if(result[i] < SparseShape<float>::threshold()) {
+          BOOST_CHECK(result.is_zero(i));
+          ++zero_tile_count;
+        } else {
+          BOOST_CHECK(! result.is_zero(i));
+        }
+      }
+    }
+  }
+
+  BOOST_CHECK_CLOSE(result.sparsity(), float(zero_tile_count) / float(B * M * N), tolerance);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
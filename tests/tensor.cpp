@@ -466,5 +466,138 @@ BOOST_AUTO_TEST_CASE( binary_perm_op ) {
 }
 
 
+BOOST_AUTO_TEST_CASE( parallel_ops ) {
+  std::array<std::size_t, GlobalFixture::dim> start, finish;
+  for(unsigned int i = 0u; i < GlobalFixture::dim; ++i) {
+    start[i] = i;
+    finish[i] = 2u * i + 7u;
+  }
+  const range_type range(start, finish);
+  TensorN a(range), b(range);
+  rand_fill(18, a.size(), a.data());
+  rand_fill(431, b.size(), b.data());
+  Tensor<double> d(range);
+  for(std::size_t i = 0ul; i < d.size(); ++i)
+    d[i] = double(a[i]) / 8.0;
+
+  // Compute the reference results with single-threaded operations
+  BOOST_REQUIRE(! TensorParallelConfig::enabled());
+  const TensorN unary_ref = a.unary([] (const int value) { return value * 3; });
+  const TensorN binary_ref = a.binary(b, [] (const int l, const int r) { return l - r; });
+  const Tensor<double> scale_ref = d.scale(2.0);
+  const Tensor<double> add_ref = d.add(d, 0.5);
+  const int sum_ref = a.sum();
+  const int min_ref = a.min();
+  const double dot_ref = d.dot(d);
+
+  // Split all tensor operations into blocks
+  TensorParallelConfig::set_threshold(16ul);
+  TensorParallelConfig::reset_parallel_ops();
+  BOOST_CHECK(TensorParallelConfig::enabled());
+
+  TensorN x = a.unary([] (const int value) { return value * 3; });
+  for(std::size_t i = 0ul; i < x.size(); ++i)
+    BOOST_CHECK_EQUAL(x[i], unary_ref[i]);
+
+  x = a.binary(b, [] (const int l, const int r) { return l - r; });
+  for(std::size_t i = 0ul; i < x.size(); ++i)
+    BOOST_CHECK_EQUAL(x[i], binary_ref[i]);
+
+  x = a.clone();
+  x.inplace_binary(b, [] (int& l, const int r) { l -= r; });
+  for(std::size_t i = 0ul; i < x.size(); ++i)
+    BOOST_CHECK_EQUAL(x[i], binary_ref[i]);
+
+  Tensor<double> y = d.scale(2.0);
+  for(std::size_t i = 0ul; i < y.size(); ++i)
+    BOOST_CHECK_EQUAL(y[i], scale_ref[i]);
+
+  y = d.add(d, 0.5);
+  for(std::size_t i = 0ul; i < y.size(); ++i)
+    BOOST_CHECK_EQUAL(y[i], add_ref[i]);
+
+  // Check that partial results are combined with the join operation
+  BOOST_CHECK_EQUAL(a.sum(), sum_ref);
+  BOOST_CHECK_EQUAL(a.min(), min_ref);
+  BOOST_CHECK_CLOSE(d.dot(d), dot_ref, 1.0e-10);
+
+  BOOST_CHECK_GE(TensorParallelConfig::parallel_ops(), 8ul);
+
+  // Check that tensors below the threshold are not split
+  TensorParallelConfig::set_threshold(range.volume() + 1ul);
+  TensorParallelConfig::reset_parallel_ops();
+  x = a.unary([] (const int value) { return value * 3; });
+  BOOST_CHECK_EQUAL(TensorParallelConfig::parallel_ops(), 0ul);
+
+  TensorParallelConfig::set_threshold(0ul);
+}
+
+BOOST_AUTO_TEST_CASE( parallel_permute ) {
+  const std::array<std::size_t, 4> start = {{0ul, 0ul, 0ul, 0ul}};
+  const std::array<std::size_t, 4> finish = {{24ul, 42ul, 16ul, 30ul}};
+  TensorN x(range_type(start, finish));
+  rand_fill(1693, x.size(), x.data());
+
+  // Check permutations with split matrices, matrix rows, and block copies
+  std::array<unsigned int, 4> p = {{0,1,2,3}};
+  TensorParallelConfig::set_threshold(16ul);
+  TensorParallelConfig::reset_parallel_ops();
+  while(std::next_permutation(p.begin(), p.end())) {
+    Permutation perm(p.begin(), p.end());
+
+    TensorN px = x.permute(perm);
+
+    for(std::size_t i = 0ul; i < x.size(); ++i) {
+      std::size_t pi = px.range().ordinal(perm * x.range().idx(i));
+      BOOST_CHECK_EQUAL(px[pi], x[i]);
+    }
+  }
+  BOOST_CHECK_GE(TensorParallelConfig::parallel_ops(), 1ul);
+  TensorParallelConfig::set_threshold(0ul);
+}
+
+#if 0
+// This test case is used to measure the bandwidth of tensor permutations. It
+// permutes a 4-index tensor of 100 MB with all rank-4 permutations, using one
+// thread and all task threads. It should only be enabled when changes are
+// made to the permutation or transpose kernels, and human eyes are examining
+// the output.
+
+BOOST_AUTO_TEST_CASE( permute_benchmark ) {
+  const std::array<std::size_t, 4> start = {{0ul, 0ul, 0ul, 0ul}};
+  const std::array<std::size_t, 4> finish = {{60ul, 64ul, 56ul, 58ul}};
+  Tensor<double> x(range_type(start, finish));
+  for(std::size_t i = 0ul; i < x.size(); ++i)
+    x[i] = double(i);
+  const int repeat = 5;
+
+  for(int threads = 0; threads < 2; ++threads) {
+    TensorParallelConfig::set_threshold(threads ? 1ul << 16 : 0ul);
+
+    double total_time = 0.0;
+    std::array<unsigned int, 4> p = {{0,1,2,3}};
+    do {
+      Permutation perm(p.begin(), p.end());
+
+      const double start = madness::wall_time();
+      for(int r = 0; r < repeat; ++r)
+        Tensor<double> px = x.permute(perm);
+      const double time = (madness::wall_time() - start) / double(repeat);
+      total_time += time;
+
+      std::cout << "Permutation " << perm << ": " << time << " s ("
+                << double(2ul * sizeof(double) * x.size()) / time * 1.0e-9
+                << " GB/s)\n";
+    } while(std::next_permutation(p.begin(), p.end()));
+
+    std::cout << "Threads: " << (threads ? madness::ThreadPool::size() + 1 : 1)
+              << "\nTotal time: " << total_time << " s\n";
+  }
+
+  TensorParallelConfig::set_threshold(0ul);
+}
+#endif
+
+
 BOOST_AUTO_TEST_SUITE_END()
 
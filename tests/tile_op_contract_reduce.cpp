@@ -93,6 +93,26 @@ BOOST_AUTO_TEST_CASE( make_result )
 
 }
 
+BOOST_AUTO_TEST_CASE( reset )
+{
+  ContractReduce<tensor_type, tensor_type, tensor_type>
+  op(madness::cblas::NoTrans, madness::cblas::NoTrans, 1, 2u, 2u, 2u);
+
+  // Check that an empty result stays empty
+  tensor_type result;
+  BOOST_REQUIRE_NO_THROW(op.reset(result));
+  BOOST_CHECK(result.empty());
+
+  // Check that the elements are set to zero and the storage is kept
+  result = make_tensor(0, 0, 5, 7);
+  const int* const data = result.data();
+  BOOST_REQUIRE_NO_THROW(op.reset(result));
+  BOOST_CHECK_EQUAL(result.range(), tensor_type::range_type(5, 7));
+  BOOST_CHECK_EQUAL(result.data(), data);
+  for(std::size_t i = 0ul; i < result.size(); ++i)
+    BOOST_CHECK_EQUAL(result[i], 0);
+}
+
 
 #ifdef TA_EXCEPTION_ERROR
 BOOST_AUTO_TEST_CASE( permute_empty )
@@ -105,8 +125,6 @@ BOOST_AUTO_TEST_CASE( permute_empty )
 }
 #endif // TA_EXCEPTION_ERROR
 
-// TODO: Test non-empty permutation
-
 BOOST_AUTO_TEST_CASE( matrix_multiply )
 {
   // Set dimension constants
@@ -214,6 +232,171 @@ BOOST_AUTO_TEST_CASE( matrix_multiply )
   BOOST_CHECK_EQUAL(result_map, C);
 }
 
+BOOST_AUTO_TEST_CASE( matrix_multiply_pairs )
+{
+  // Set dimension constants, where the two pairs have different inner sizes
+  const std::size_t
+      left_outer_start = 2, left_outer_finish = 20,
+      inner1_start = 3, inner1_finish = 30,
+      inner2_start = 30, inner2_finish = 37,
+      right_outer_start = 4, right_outer_finish = 40;
+
+  const madness::cblas::CBLAS_TRANSPOSE ops[2] =
+      { madness::cblas::NoTrans, madness::cblas::Trans };
+
+  for(auto left_op : ops) {
+    for(auto right_op : ops) {
+      // Construct tensors
+      tensor_type left1 = (left_op == madness::cblas::NoTrans ?
+          make_tensor(left_outer_start, inner1_start, left_outer_finish, inner1_finish) :
+          make_tensor(inner1_start, left_outer_start, inner1_finish, left_outer_finish));
+      tensor_type left2 = (left_op == madness::cblas::NoTrans ?
+          make_tensor(left_outer_start, inner2_start, left_outer_finish, inner2_finish) :
+          make_tensor(inner2_start, left_outer_start, inner2_finish, left_outer_finish));
+      tensor_type right1 = (right_op == madness::cblas::NoTrans ?
+          make_tensor(inner1_start, right_outer_start, inner1_finish, right_outer_finish) :
+          make_tensor(right_outer_start, inner1_start, right_outer_finish, inner1_finish));
+      tensor_type right2 = (right_op == madness::cblas::NoTrans ?
+          make_tensor(inner2_start, right_outer_start, inner2_finish, right_outer_finish) :
+          make_tensor(right_outer_start, inner2_start, right_outer_finish, inner2_finish));
+
+      ContractReduce<tensor_type, tensor_type, tensor_type>
+      op(left_op, right_op, 3, 2u, 2u, 2u);
+
+      // Compute the reference with one contraction per pair
+      tensor_type reference;
+      op(reference, left1, right1);
+      op(reference, left2, right2);
+
+      // Contract both pairs into an empty result
+      tensor_type result;
+      BOOST_REQUIRE_NO_THROW(op(result, left1, right1, left2, right2));
+
+      BOOST_CHECK_EQUAL(result.range(), reference.range());
+      for(std::size_t i = 0ul; i < result.size(); ++i)
+        BOOST_CHECK_EQUAL(result[i], reference[i]);
+
+      // Contract both pairs into a non-empty result
+      BOOST_REQUIRE_NO_THROW(op(result, left1, right1, left2, right2));
+      op(reference, left1, right1);
+      op(reference, left2, right2);
+
+      for(std::size_t i = 0ul; i < result.size(); ++i)
+        BOOST_CHECK_EQUAL(result[i], reference[i]);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( permute_result )
+{
+  const madness::cblas::CBLAS_TRANSPOSE ops[2] =
+      { madness::cblas::NoTrans, madness::cblas::Trans };
+
+  for(auto left_op : ops) {
+    for(auto right_op : ops) {
+      // Construct tensors
+      tensor_type left = (left_op == madness::cblas::NoTrans ?
+          make_tensor(2, 3, 20, 30) : make_tensor(3, 2, 30, 20));
+      tensor_type right = (right_op == madness::cblas::NoTrans ?
+          make_tensor(3, 4, 30, 40) : make_tensor(4, 3, 40, 30));
+
+      ContractReduce<tensor_type, tensor_type, tensor_type>
+      op(left_op, right_op, 3, 2u, 2u, 2u);
+      ContractReduce<tensor_type, tensor_type, tensor_type>
+      perm_op(left_op, right_op, 3, 2u, 2u, 2u, Permutation({1, 0}));
+
+      // Compute the reference by permuting the contracted tile
+      tensor_type reference;
+      op(reference, left, right);
+      op(reference, left, right, left, right);
+      reference = permute(reference, Permutation({1, 0}));
+
+      // Compute the permuted result
+      tensor_type result;
+      BOOST_REQUIRE_NO_THROW(perm_op(result, left, right));
+      BOOST_REQUIRE_NO_THROW(perm_op(result, left, right, left, right));
+      BOOST_REQUIRE_NO_THROW(result = perm_op(result));
+
+      BOOST_CHECK_EQUAL(result.range(), reference.range());
+      for(std::size_t i = 0ul; i < result.size(); ++i)
+        BOOST_CHECK_EQUAL(result[i], reference[i]);
+    }
+  }
+
+  // Check outer dimension swaps and other permutations of a higher rank result
+  tensor_type left = make_tensor(2, 3, 4, 6, 7, 8);
+  tensor_type right = make_tensor(4, 5, 6, 8, 9, 10);
+  ContractReduce<tensor_type, tensor_type, tensor_type>
+  op(madness::cblas::NoTrans, madness::cblas::NoTrans, 1, 4u, 3u, 3u);
+  tensor_type product;
+  op(product, left, right);
+
+  const Permutation perms[3] =
+      { Permutation({2, 3, 0, 1}), Permutation({1, 0, 2, 3}), Permutation({3, 2, 1, 0}) };
+  for(const Permutation& perm : perms) {
+    ContractReduce<tensor_type, tensor_type, tensor_type>
+    perm_op(madness::cblas::NoTrans, madness::cblas::NoTrans, 1, 4u, 3u, 3u, perm);
+
+    const tensor_type reference = permute(product, perm);
+    tensor_type result;
+    BOOST_REQUIRE_NO_THROW(perm_op(result, left, right));
+    BOOST_REQUIRE_NO_THROW(result = perm_op(result));
+
+    BOOST_CHECK_EQUAL(result.range(), reference.range());
+    for(std::size_t i = 0ul; i < result.size(); ++i)
+      BOOST_CHECK_EQUAL(result[i], reference[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( mixed_precision )
+{
+  typedef TiledArray::Tensor<float> float_tensor_type;
+  typedef TiledArray::Tensor<double> double_tensor_type;
+
+  // Construct tensors, where the values are exact in single precision
+  const tensor_type left = make_tensor(2, 3, 20, 30);
+  const tensor_type left2 = make_tensor(2, 30, 20, 37);
+  const tensor_type right = make_tensor(3, 4, 30, 40);
+  const tensor_type right2 = make_tensor(30, 4, 37, 40);
+  const tensor_type rightT = make_tensor(4, 3, 40, 30);
+
+  ContractReduce<tensor_type, tensor_type, tensor_type>
+  op(madness::cblas::NoTrans, madness::cblas::NoTrans, 3, 2u, 2u, 2u);
+  ContractReduce<double_tensor_type, float_tensor_type, float_tensor_type>
+  mixed_op(madness::cblas::NoTrans, madness::cblas::NoTrans, 3, 2u, 2u, 2u);
+
+  // Compute the reference in integer arithmetic
+  tensor_type reference;
+  op(reference, left, right);
+  op(reference, left, right, left2, right2);
+
+  // Contract single precision arguments into a double precision result
+  double_tensor_type result;
+  BOOST_REQUIRE_NO_THROW(mixed_op(result, float_tensor_type(left),
+      float_tensor_type(right)));
+  BOOST_REQUIRE_NO_THROW(mixed_op(result, float_tensor_type(left),
+      float_tensor_type(right), float_tensor_type(left2), float_tensor_type(right2)));
+
+  BOOST_CHECK_EQUAL(result.range(), reference.range());
+  for(std::size_t i = 0ul; i < result.size(); ++i)
+    BOOST_CHECK_EQUAL(result[i], double(reference[i]));
+
+  // Check that arguments in their native layout are permuted to matrix form
+  ContractReduce<double_tensor_type, float_tensor_type, float_tensor_type>
+  native_op(madness::cblas::NoTrans, madness::cblas::NoTrans, 3, 2u, 2u, 2u,
+      Permutation(), Permutation(), Permutation({1, 0}));
+  double_tensor_type native_result;
+  BOOST_REQUIRE_NO_THROW(native_op(native_result, float_tensor_type(left),
+      float_tensor_type(rightT)));
+
+  tensor_type native_reference;
+  op(native_reference, left, permute(rightT, Permutation({1, 0})));
+
+  BOOST_CHECK_EQUAL(native_result.range(), native_reference.range());
+  for(std::size_t i = 0ul; i < native_result.size(); ++i)
+    BOOST_CHECK_EQUAL(native_result[i], double(native_reference[i]));
+}
+
 BOOST_AUTO_TEST_CASE( tensor_contract1 )
 {
   // Set dimension constants